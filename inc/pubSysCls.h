@@ -43,6 +43,7 @@
 // Use C++ lib strings
 #include <string>
 #include <vector>
+#include <initializer_list>
 
 //																			  *
 //*****************************************************************************
@@ -54,6 +55,7 @@
 // NAME																	      *
 // 	pubSysCls.h forward references
 													/** \cond INTERNAL_DOC **/	
+class CTelemetryPoller;
 namespace sFnd 
 {
 	class INode;
@@ -226,6 +228,7 @@ class MN_EXPORT ValueBase : public IObjWithNode
 	friend class CPMstatusAdv;
 	friend class CPMouts;
 	friend class CPMmotion;
+	friend class IPort;
 private:
 	double m_scaleToUser;
 	nodeparam m_paramNum;
@@ -233,6 +236,13 @@ private:
 	bool m_exists;
 	bool m_isVolatile;
 	bool m_refreshOnAccess;
+	bool m_snapshotMode;
+	int m_sampleSlot;				// Port telemetry slot, -1 if none
+	double m_maxAge;
+	bool m_skipSameWrites;
+	bool m_shadowValid;
+	double m_shadowReq;				// Last value written
+	double m_shadowNode;			// What the node held after, base units
 													/** \endcond **/
 public:
 	/**
@@ -309,6 +319,114 @@ public:
 	\return True if the value of this parameter can change after refresh.
 	**/
 	bool IsVolatile() { return m_isVolatile; }
+
+	/**
+		\brief Adjust the snapshot mode setting
+
+		In snapshot mode a value sampled by its port's telemetry poller is
+		read from the poller's latest snapshot on every access. The read
+		never waits on the network. A value the poller is not sampling
+		behaves as if snapshot mode were off. An explicit Refresh still
+		reads the node.
+
+		\param[in] newState Set true to read from the telemetry snapshot.
+
+		\see sFnd::IPort::TelemetryStart to start sampling values.
+		\see SampleTimeMsec for the age of the snapshot value.
+	**/
+	void SnapshotMode(bool newState) { m_snapshotMode = newState; }
+
+	/**
+		\brief Return the snapshot mode state
+
+		\return True if accesses are served from the telemetry snapshot.
+	**/
+	bool SnapshotMode() { return m_snapshotMode; }
+
+	/**
+		\brief Time stamp of the latest snapshot sample of this value
+
+		Snapshot reads do not change the value object, so they are safe
+		from any number of threads. The poller can publish between a value
+		read and this call, the time returned is then a little newer than
+		the value read.
+
+		\return The SysManager::TimeStampMsec time the poller's latest
+		sample of this value was taken, zero if it is not sampled.
+
+		\CODE_SAMPLE_HDR
+		double posn = myNode.Motion.PosnMeasured;
+		double age = myMgr.TimeStampMsec()
+				   - myNode.Motion.PosnMeasured.SampleTimeMsec();
+		\endcode
+	**/
+	double SampleTimeMsec();
+
+	/**
+		\brief Share recent reads of a real-time parameter
+
+		A refresh of a real-time parameter, such as status or measured
+		position, normally reads the node every time. With a max age set,
+		a refresh within \a maxAgeMsec of the last node read returns that
+		read instead, and threads refreshing the parameter together share a
+		single read. This cuts the network load of several threads polling
+		the same value.
+
+		The setting applies to the parameter on the node, every copy of
+		this value shares it. It is lost when the node is re-initialized.
+
+		\param[in] maxAgeMsec Oldest read to reuse in milliseconds, zero to
+		read the node on every refresh.
+
+		\note Clear-on-read parameters, such as the accumulating status
+		registers, and non real-time parameters cannot take a max age.
+
+		\CODE_SAMPLE_HDR
+		// Let the polling threads share reads up to 2 ms old
+		myNode.Status.RT.MaxAgeMsec(2);
+		myNode.Motion.PosnMeasured.MaxAgeMsec(2);
+		\endcode
+	**/
+	void MaxAgeMsec(double maxAgeMsec);
+
+	/**
+		\brief Return the max age of shared reads
+
+		\return The max age in milliseconds, zero if every refresh reads
+		the node.
+	**/
+	double MaxAgeMsec() { return m_maxAge; }
+
+	/**
+		\brief Adjust the write elision setting
+
+		Numeric values remember the last value written and what the node
+		held afterwards. Writing the same run-time value again is skipped
+		while the node's cached copy of the parameter still matches, which
+		saves a network round trip each time. A cache invalidation from the
+		node forces the parameter to be re-read before a write is skipped.
+		Volatile parameters and non-volatile defaults are always written.
+
+		The default is true for this setting.
+
+		\param[in] newState Set false to send every write to the node.
+
+		\CODE_SAMPLE_HDR
+		// This is written each move but usually has not changed
+		myNode.Motion.VelLimit = 500;
+		\endcode
+	**/
+	void SkipSameWrites(bool newState) {
+		m_skipSameWrites = newState;
+		m_shadowValid = false;
+	}
+
+	/**
+		\brief Return the write elision setting
+
+		\return True if writes of an unchanged value are skipped.
+	**/
+	bool SkipSameWrites() { return m_skipSameWrites; }
 													/** \cond INTERNAL_DOC **/
 protected:
 	/// Set Valid state
@@ -324,6 +442,19 @@ protected:
 	void Exists(bool newState);
 	/// Set the volatile state
 	void IsVolatile(bool newState) {m_isVolatile = newState;}
+	/// True if the telemetry poller can serve this value
+	virtual bool canSample() { return false; }
+	/// Get our latest telemetry sample if in snapshot mode
+	bool readSample(double &value, void *raw, size_t rawSize,
+					double &sampleTime);
+	/// True if the node still holds the result of writing \a newValue
+	bool shadowMatch(double newValue);
+	/// Record that writing \a newValue left \a nodeValue at the node
+	void shadowSet(double newValue, double nodeValue) {
+		m_shadowReq = newValue;
+		m_shadowNode = nodeValue;
+		m_shadowValid = true;
+	}
 public:
 	virtual ~ValueBase() {};
 													/** \endcond **/
@@ -383,6 +514,7 @@ class MN_EXPORT ValueDouble : public ValueBase
 	friend class IStatus;
 	friend class ISetup;
 	friend class ISetupEx;
+	friend class IPort;
 
 protected:
 	// Source of parameter value
@@ -664,6 +796,9 @@ protected:
 													/** \cond INTERNAL_DOC **/
 	// Construction to wire to our node object
 	ValueDouble(INode &node, nodeparam pNum, enum _srcs src = VIA_PARAM);
+	bool canSample() { return true; }
+	// Update from the telemetry snapshot, returns false if not sampled
+	bool snapshot(double &userValue);
 													/** \endcond **/
 };
 //																			  *
@@ -1448,6 +1583,7 @@ class MN_EXPORT ValueStatus : public ValueBase
 													/** \cond INTERNAL_DOC **/
 	friend class IStatus;
 	friend class IAttnNode;
+	friend class IPort;
 private:
 	mnStatusReg m_lastValue;
 	mnStatusReg m_currentValue;
@@ -1638,6 +1774,10 @@ protected:
 												/** \cond INTERNAL_DOC **/
 	// Construction to wire to our node object
 	ValueStatus(INode &node, nodeparam pNum, bool clearOnReadType);
+	// Sampling would consume the bits of clear on read types
+	bool canSample() { return !m_clearOnRead; }
+	// Update from the telemetry snapshot, returns false if not sampled
+	bool snapshot(mnStatusReg &reg);
 												/** \endcond **/
 };
 //																			  *
@@ -2618,6 +2758,105 @@ public:
 	**/
 	virtual void TriggerMovesInGroup(size_t groupNumber) = 0;
 
+	/**
+		\brief Get the number of commands allowed in the ring right now.
+
+		\return Simultaneous commands allowed on this port's network.
+
+		This equals #CmdWindowMax unless #CmdWindowAdaptive is set, in which
+		case it follows the measured response latency of the ring.
+	**/
+	virtual size_t CmdWindow() = 0;
+	/**
+		\brief Get the most commands allowed in the ring at once.
+
+		\return The command window ceiling.
+	**/
+	virtual size_t CmdWindowMax() = 0;
+	/**
+		\brief Set the most commands allowed in the ring at once.
+
+		\param[in] newMax Command window ceiling, 1 to 14.
+
+		\note The port is restarted and the network re-enumerated to install
+		the new ceiling.
+	**/
+	virtual void CmdWindowMax(size_t newMax) = 0;
+	/**
+		\brief Query if the command window adapts to the ring's latency.
+
+		\return true if the command window adapts.
+	**/
+	virtual bool CmdWindowAdaptive() = 0;
+	/**
+		\brief Let the command window adapt to the ring's latency.
+
+		\param[in] adaptive Set true to adapt the window between one command
+		and #CmdWindowMax. Set false to always allow #CmdWindowMax.
+
+		The window grows while the response latency stays near the best seen
+		and shrinks when responses start queuing in the nodes or time out.
+		This setting is kept when the port restarts.
+	**/
+	virtual void CmdWindowAdaptive(bool adaptive) = 0;
+	/**
+		\brief Get the command latency summary for this port.
+
+		\param[in] latClass Command group to summarize, MN_LAT_ALL for every
+		command.
+		\param[in] resetWindow Set true to clear the samples summarized so
+		the next call covers a new window.
+		\return Round trip percentiles, maximum and time-out count.
+
+		The round trip of every command is kept in a histogram by node and
+		command group from the moment the port opens. Comparing the groups
+		and nodes shows whether a slow cycle comes from one node, one kind
+		of command or the whole link.
+
+		\CODE_SAMPLE_HDR
+		// Look at the parameter reads over one machine cycle
+		myPort.Adv.LatencyStats(MN_LAT_GET_PARAM, true);
+		// ... run the cycle ...
+		mnLatencyStats reads = myPort.Adv.LatencyStats(MN_LAT_GET_PARAM, true);
+		printf("%u reads, p99 %.2f ms, max %.2f ms\n",
+			   reads.Count, reads.P99, reads.Max);
+		\endcode
+	**/
+	virtual mnLatencyStats LatencyStats(mnLatencyClass latClass = MN_LAT_ALL,
+										bool resetWindow = false) = 0;
+	/**
+		\brief Get the command latency summary for one node on this port.
+
+		\param[in] nodeIndex Node to summarize.
+		\param[in] latClass Command group to summarize, MN_LAT_ALL for every
+		command.
+		\param[in] resetWindow Set true to clear the samples summarized.
+		\return Round trip percentiles, maximum and time-out count.
+
+		Move group triggers are not addressed to a node, they are only
+		included in the port's summary.
+	**/
+	virtual mnLatencyStats LatencyStats(size_t nodeIndex,
+										mnLatencyClass latClass,
+										bool resetWindow = false) = 0;
+	/**
+		\brief Get the group shutdown stop latency summary for this port.
+
+		\param[in] resetWindow Set true to clear the samples summarized so
+		the next call covers a new window.
+		\return Latency percentiles and maximum.
+
+		Group shutdown stops are sent by a thread of their own that does
+		not wait for the command pacing window. Each node keeps one of its
+		slots of the ring for its stop, so other commands to a node do not
+		delay it either. Each sample runs from the event, the CTS fall
+		seen by the serial port, the arrival of a node status event or an
+		IPort::GrpShutdown.ShutdownInitiate call, to the stops being written
+		to the port. Requests made while the port is offline include the
+		time until it is back online. Only the largest value is a true
+		worst case bound, the percentiles are histogram estimates.
+	**/
+	virtual mnLatencyStats StopLatencyStats(bool resetWindow = false) = 0;
 
 	bool Supported();
 													/** \cond INTERNAL_DOC **/
@@ -2673,10 +2912,19 @@ class MN_EXPORT IPort
 {
 													/** \cond INTERNAL_DOC **/
 	friend class CPMportAdv;
+	friend class ValueBase;
 public:
 protected:
 	/// Port index number, zero based.
 	netaddr m_netNumber;
+	/// Background sampler, created on first use
+	CTelemetryPoller *m_pTelemetry;
+	/// Copy the latest sample of \a owner in telemetry slot \a slot
+	bool readTelemetry(const ValueBase *owner, size_t slot, double &value,
+					   void *raw, size_t rawSize, double &sampleTime);
+	/// Refresh \a values and return when each response arrived
+	void refreshGroup(ValueBase *const values[], size_t nValues,
+					  double *readTimes);
 public:
 													/** \endcond **/
 
@@ -2774,6 +3022,135 @@ public:
 	**/
 	virtual void NodeStop(mgNodeStopReg stopType = STOP_TYPE_IGNORE) = 0;
 
+	/**
+		\brief Refresh a group of values from any nodes on this port
+
+		\param[in] values Array of the values to refresh. NULL entries are
+		skipped.
+		\param[in] nValues Number of entries in \a values.
+
+		The reads the values need are sent to the nodes as one pipelined
+		burst instead of one command and response at a time. Each value is
+		then refreshed as by ValueBase::Refresh, which reports any error.
+		Values for nodes on other ports are refreshed individually.
+
+		\CODE_SAMPLE_HDR
+		// Sample the positions of two axes together
+		myPort.RefreshGroup({ &axisX.Motion.PosnMeasured,
+							  &axisY.Motion.PosnMeasured });
+		\endcode
+
+		\see sFnd::INode::RefreshGroup for a single node.
+	**/
+	void RefreshGroup(ValueBase *const values[], size_t nValues);
+	/**
+		\brief Refresh a list of values from any nodes on this port
+
+		\param[in] values List of the values to refresh.
+	**/
+	void RefreshGroup(std::initializer_list<ValueBase *> values) {
+		RefreshGroup(values.begin(), values.size());
+	}
+
+	/**
+		\brief Capture the state of every node on this port in one sweep
+
+		\param[out] snap Updated with the measured position, velocity,
+		torque and real-time status of each node.
+
+		All the reads are sent as one pipelined burst, so the samples are
+		taken about one ring latency apart rather than one round trip per
+		read. The time each sample arrived and the spread of the sweep are
+		returned with the values. The values of the nodes' parameter
+		objects are refreshed as well.
+
+		\CODE_SAMPLE_HDR
+		// Compare the gantry's Y axes at the same instant
+		mnMachineSnapshot snap;
+		myPort.Snapshot(snap);
+		double ySkew = snap.PosnMeasured[1] - snap.PosnMeasured[2];
+		printf("Y difference %.0f counts, sweep skew %.3f ms\n",
+			   ySkew, snap.SkewMsec);
+		\endcode
+	**/
+	void Snapshot(mnMachineSnapshot &snap);
+
+	/**
+		\brief Start sampling values in the background
+
+		\param[in] values Array of the values to sample, all from nodes on
+		this port.
+		\param[in] nValues Number of entries in \a values, at most 128.
+		\param[in] periodMs Time between samples in milliseconds.
+
+		A thread for this port reads the values every \a periodMs as one
+		pipelined burst and publishes them in a snapshot with the time they
+		were sampled. Values in snapshot mode are read from the snapshot
+		without waiting on the network, from any thread. The first sample
+		is taken before this returns.
+
+		Floating point values and the real-time status register can be
+		sampled. Clear on read registers cannot, sampling would clear the
+		bits the application is waiting for. Calling this again replaces
+		the values sampled.
+
+		\CODE_SAMPLE_HDR
+		// Sample the axis state every 5 ms
+		myPort.TelemetryStart({ &myNode.Motion.PosnMeasured,
+								&myNode.Motion.VelMeasured,
+								&myNode.Motion.TrqMeasured,
+								&myNode.Motion.PosnTracking,
+								&myNode.Status.RT }, 5);
+		myNode.Motion.PosnMeasured.SnapshotMode(true);
+		// This read does not touch the network
+		double posn = myNode.Motion.PosnMeasured;
+		\endcode
+
+		\see sFnd::ValueBase::SnapshotMode to read from the snapshot.
+		\see TelemetryStop to stop sampling.
+	**/
+	void TelemetryStart(ValueBase *const values[], size_t nValues,
+						double periodMs);
+	/**
+		\brief Start sampling a list of values in the background
+
+		\param[in] values List of the values to sample.
+		\param[in] periodMs Time between samples in milliseconds.
+	**/
+	void TelemetryStart(std::initializer_list<ValueBase *> values,
+						double periodMs) {
+		TelemetryStart(values.begin(), values.size(), periodMs);
+	}
+	/**
+		\brief Stop background sampling
+
+		The values sampled go back to reading the node when accessed.
+	**/
+	void TelemetryStop();
+
+	/**
+		\brief Load configuration files into the nodes on this port
+
+		\param[in] filePaths Configuration file for each node, indexed by
+		node. NULL entries skip the node.
+		\param[in] nNodes Number of entries in \a filePaths.
+
+		This works like sFnd::ISetup::ConfigLoad on every node at once.
+		Each node's current settings are read in pipelined bursts and only
+		the items that differ from its file are written. The nodes that
+		were written to are restarted one at a time once every load is
+		done, so their new settings take effect. A node whose settings
+		already match its file is left untouched, so reloading an
+		unchanged configuration takes very little time.
+
+		\CODE_SAMPLE_HDR
+		// Reconfigure a two axis machine for the next product
+		const char *files[] = { "axisX.mtr", "axisY.mtr" };
+		myPort.ConfigLoad(files, 2);
+		\endcode
+	**/
+	void ConfigLoad(const char *const filePaths[], size_t nNodes);
+
 	/**
 		\brief Group Shutdown Feature
 
@@ -3192,7 +3569,9 @@ public:
 		function should not run for extended periods of time. The function is
 		also restricted from running any network based command. This includes
 		parameter accesses and node commands. This function should signal other threads to
-		restart themselves or other lightweight signaling mechanisms.
+		restart themselves or other lightweight signaling mechanisms. Calls
+		for one port are serialized, handlers on different ports may run at
+		the same time.
 
 		\CODE_SAMPLE_HDR
 		// Example showing a Attention Handler function
@@ -5911,6 +6290,37 @@ public:
 	bool EnableReq(){
 		return Outs.EnableReq();
 	}
+
+	/**
+		\brief Refresh a group of this node's values together
+
+		\param[in] values Array of the values to refresh. NULL entries are
+		skipped.
+		\param[in] nValues Number of entries in \a values.
+
+		This is a faster way to refresh several volatile values than calling
+		Refresh on each one, the reads are sent as one pipelined burst.
+
+		\CODE_SAMPLE_HDR
+		// Sample position, velocity and torque together
+		myNode.RefreshGroup({ &myNode.Motion.PosnMeasured,
+							  &myNode.Motion.VelMeasured,
+							  &myNode.Motion.TrqMeasured });
+		\endcode
+
+		\see sFnd::IPort::RefreshGroup for values from several nodes.
+	**/
+	void RefreshGroup(ValueBase *const values[], size_t nValues) {
+		Port.RefreshGroup(values, nValues);
+	}
+	/**
+		\brief Refresh a list of this node's values together
+
+		\param[in] values List of the values to refresh.
+	**/
+	void RefreshGroup(std::initializer_list<ValueBase *> values) {
+		Port.RefreshGroup(values.begin(), values.size());
+	}
 protected:
 													/** \cond INTERNAL_DOC **/
 	// Construction
@@ -6110,6 +6520,27 @@ public:
 	*/
 	void PortsOpen(int portCount);
 
+	/**
+		\brief Keep node parameter caches in a directory.
+
+		\param[in] dirPath Existing directory to hold the cache files, NULL
+		or empty to turn the cache off.
+
+		Nodes found by later PortsOpen calls are checked against their
+		cache file with a short burst of reads. A match fills in their
+		read-only values, and their non-volatile values while they still
+		run the configuration file last loaded and a sample of them reads
+		back the same, without reading each one. A node's file is written
+		when its port closes from the values read while it was open, so
+		the first open of a node costs no extra reads.
+
+		\CODE_SAMPLE_HDR
+		myMgr->ParamCacheDir("/var/cache/sFoundation");
+		myMgr->PortsOpen(1);
+		\endcode
+	**/
+	void ParamCacheDir(const char *dirPath);
+
 	/**
 		\brief Close all operations down and close the ports.
 
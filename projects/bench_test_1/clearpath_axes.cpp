@@ -24,6 +24,9 @@
 #define TIME_TILL_TIMEOUT		2500000 //The timeout used for homing(ms)
 //#define ACC_LIM_CNTS_PER_SEC2	640000000
 #define MAX_VEL_LIM				2000
+#define PATH_CHORD_ERROR		0.01	// Largest distance from an arc to its chords (mm)
+#define PATH_TOLERANCE			0.01	// Largest distance from a joined path point to its move (mm)
+#define PATH_TIMEOUT_MARGIN		2000	// Time allowed beyond a path's planned duration (ms)
 
 using namespace sFnd;
 namespace fs = std::filesystem;
@@ -43,6 +46,35 @@ bool move_is_done_f(class IPort& SC4_port) {
 	return true;	// If all nodes are done, return true.
 }
 
+void machine::map_nodes_f() {
+
+	/// Summary: Numbers the nodes of every open port into one machine-wide list, port 0's nodes first.
+	/// Params: None
+	/// Returns: Void
+	/// Notes:	Each port runs its own threads, so spreading the nodes over several hubs keeps the
+	///			per-port command rate up as axes are added. The config vectors are indexed by this numbering.
+
+	node_port.clear();
+	node_on_port.clear();
+	for (size_t iPort = 0; iPort < port_count; iPort++) {
+		IPort& SC4_port = SC4_mgr->Ports(iPort);
+		for (size_t iNode = 0; iNode < SC4_port.NodeCount(); iNode++) {
+			node_port.push_back(iPort);
+			node_on_port.push_back(iNode);
+		}
+	}
+}
+
+INode& machine::node_f(size_t iNode) {
+
+	/// Summary: Returns the node at a machine-wide node index
+	/// Params: iNode: index into the list built by map_nodes_f()
+	/// Returns: INode reference on whichever port holds the node
+	/// Notes:
+
+	return SC4_mgr->Ports(node_port[iNode]).Nodes(node_on_port[iNode]);
+}
+
 std::vector<double> push_back_string_f(std::vector<double> input_vector, std::string input_str, char delimiter) {
 
 	/// Summary: Takes string of vector and fills into the back of an input vector using std::vector.push_back()
@@ -174,14 +206,13 @@ int machine::set_config_f() {
 	///							to have these in the config .txt file. -TH
 
 	try {
-		IPort& SC4_port = SC4_mgr->Ports(0);
 		// Iterate through each node in the machine
-		for (size_t iNode = 0; iNode < SC4_port.NodeCount(); iNode++) {
-			SC4_port.Nodes(iNode).AccUnit(INode::COUNTS_PER_SEC2);			// set acceleration limit tracking unit
-			SC4_port.Nodes(iNode).VelUnit(INode::COUNTS_PER_SEC);				// set velocity limit unit
-			SC4_port.Nodes(iNode).Motion.AccLimit = config.machine_accel_limit;		// set acceleration limit
-			SC4_port.Nodes(iNode).Motion.VelLimit = config.machine_velocity_limit;	// set default velocity limit
-			SC4_port.Nodes(iNode).Motion.PosnMeasured.AutoRefresh(true);
+		for (size_t iNode = 0; iNode < node_port.size(); iNode++) {
+			node_f(iNode).AccUnit(INode::COUNTS_PER_SEC2);			// set acceleration limit tracking unit
+			node_f(iNode).VelUnit(INode::COUNTS_PER_SEC);				// set velocity limit unit
+			node_f(iNode).Motion.AccLimit = config.machine_accel_limit;		// set acceleration limit
+			node_f(iNode).Motion.VelLimit = config.machine_velocity_limit;	// set default velocity limit
+			node_f(iNode).Motion.PosnMeasured.AutoRefresh(true);
 		}
 		return 1;
 	}
@@ -202,17 +233,26 @@ std::vector<double> machine::measure_position_f() {
 	/// Summary: Measures position of all axes by measuring all non-follower nodes and converting to real space.
 	/// Params: None
 	/// Returns: Double vector of real-space position measured on leader nodes.
-	/// Notes: 
-
-	IPort& SC4_port = SC4_mgr->Ports(0);	// Create Port object
-	int machine_num_axes = config.machine_num_axes;
+	/// Notes:	Each port is measured in one sweep, so the nodes on one hub are sampled together. The ports are
+	///			swept one after another, so positions on different hubs are from different moments. The time
+	///			of each port's sweep is left in position_sample_ms. Nodes found beyond the configured node
+	///			count are skipped.
 
 	std::vector<double> position(config.node_is_follower.size());	// Initialize position vector
 
-	int dim_ind = 0;
-	// Measure each node's position and fill them into a vector
-	for (size_t iNode = 0; iNode < SC4_port.NodeCount(); iNode++) {
-		position[iNode] = (SC4_port.Nodes(iNode).Motion.PosnMeasured) * config.node_sign[iNode];
+	position_sample_ms.assign(port_count, 0);
+	size_t machine_node = 0;
+	for (size_t iPort = 0; iPort < port_count; iPort++) {
+		mnMachineSnapshot snap;
+		SC4_mgr->Ports(iPort).Snapshot(snap);
+		position_sample_ms[iPort] = snap.SweepStartMsec;
+		for (size_t iNode = 0; iNode < snap.NodeCount; iNode++, machine_node++) {
+			if (machine_node >= position.size() || machine_node >= config.node_sign.size()) {
+				printf("Port %zu node %zu is not in the machine config, not measured\n", iPort, iNode);
+				continue;
+			}
+			position[machine_node] = snap.PosnMeasured[iNode] * config.node_sign[machine_node];
+		}
 	}
 
 	position = position * config.node_lead_per_cnt;	//convert count-space to real-space
@@ -234,8 +274,6 @@ std::vector<double> machine::move_linear_f(std::vector<double> input_vec, bool t
 	/// Returns: Function returns a vector of the measured position of the machine after the movement is completed (or after it times out).
 	/// Notes:	
 
-	IPort& SC4_port = SC4_mgr->Ports(0);	// Create a shortcut for the port
-
 	// Initialize position vectors to be used in velocity calculations
 	std::vector<double> end_pos;
 	std::vector<double> vel_vec;
@@ -258,29 +296,43 @@ std::vector<double> machine::move_linear_f(std::vector<double> input_vec, bool t
 	double node_machine_velocity_limit;
 
 	// Set up trigger group  & velocity for all nodes
-	for (size_t iNode = 0; iNode < SC4_port.NodeCount(); iNode++) {
+	for (size_t iNode = 0; iNode < node_port.size(); iNode++) {
 		node_axis = config.node_parent_axis[iNode];
 
 		// Convert velocity to counts/s and apply limit
 		node_machine_velocity_limit = vel_vec[node_axis] / lead_per_cnt[iNode];
-		SC4_port.Nodes(iNode).Motion.VelLimit = abs(node_machine_velocity_limit);
+		node_f(iNode).Motion.VelLimit = abs(node_machine_velocity_limit);
 
 		//Convert distance to counts and set up trigger
 		node_input_cnts = input_vec[node_axis] / lead_per_cnt[iNode] * node_sign[iNode];
-		SC4_port.Nodes(iNode).Motion.Adv.TriggerGroup(1);	// add all to same trigger group
-		SC4_port.Nodes(iNode).Motion.Adv.MovePosnStart(node_input_cnts, target_is_absolute, true);
+		node_f(iNode).Motion.Adv.TriggerGroup(1);	// add all to same trigger group
+		node_f(iNode).Motion.Adv.MovePosnStart(node_input_cnts, target_is_absolute, true);
+	}
+	// Trigger groups do not span hubs, so fire each port's group back to back
+	for (size_t iPort = 0; iPort < port_count; iPort++) {
+		IPort& SC4_port = SC4_mgr->Ports(iPort);
+		if (SC4_port.NodeCount() > 0) {
+			SC4_port.Nodes(0).Motion.Adv.TriggerMovesInMyGroup();
+		}
 	}
-	SC4_port.Nodes(0).Motion.Adv.TriggerMovesInMyGroup();	// Trigger group
 
 
 	double timeout = SC4_mgr->TimeStampMsec() + TIME_TILL_TIMEOUT; //define a timeout in case the node is unable to enable or takes too long
-	while (!move_is_done_f(SC4_port)) {
+	size_t iPort = 0;
+	while (iPort < port_count) {
+		IPort& SC4_port = SC4_mgr->Ports(iPort);
+		if (move_is_done_f(SC4_port)) {
+			iPort++;	// This hub is finished, move on to the next one
+			continue;
+		}
 		//printf("%00008.2f   ", SC4_mgr->TimeStampMsec() - timeout + TIME_TILL_TIMEOUT);
 		//print_vector_f(measurePosn(), "");
 		if (SC4_mgr->TimeStampMsec() > timeout) {
 			printf("Error: timed out waiting for move to complete\n");
 			msg_user_f("press any key to continue."); //pause so the user can see the error message; waits for user to press a key
-			SC4_port.NodeStop();	// Stops the nodes at their current position
+			for (size_t iStop = 0; iStop < port_count; iStop++) {
+				SC4_mgr->Ports(iStop).NodeStop();	// Stops the nodes at their current position
+			}
 			return measure_position_f();
 		}
 	}
@@ -291,6 +343,189 @@ std::vector<double> machine::move_linear_f(std::vector<double> input_vec, bool t
 	return end_pos;
 }
 
+path_limits machine::path_limits_f() {
+
+	/// Summary: Fills the path limits from the machine config
+	/// Params: None
+	/// Returns: Limits for move_path_f(), which the caller may adjust before the move
+	/// Notes:	machine_accel_limit is a node limit in counts/s^2, as set_config_f() loads it. The config has no
+	///			separate deceleration limit, so lowering decel here is what makes the moves asymmetric.
+
+	path_limits limits;
+	limits.velocity = config.machine_velocity_limit;
+	limits.accel = config.machine_accel_limit;
+	limits.decel = config.machine_accel_limit;
+	limits.chord_error = PATH_CHORD_ERROR;
+	limits.path_tolerance = PATH_TOLERANCE;
+	return limits;
+}
+
+size_t machine::queue_move_f(size_t iNode, const planned_move& move, bool triggered) {
+
+	/// Summary: Loads one node's part of a planned move into the node's move buffer
+	/// Params:	iNode: machine-wide node index
+	///			move: the planned move
+	///			triggered: the move waits for the node's trigger group
+	/// Returns: Number of additional moves the node will accept
+	/// Notes:	Kinematic limits apply to the next issued move, so the moves already buffered keep their own.
+
+	INode& the_node = node_f(iNode);
+	const node_move& node = move.nodes[iNode];
+
+	if (node.counts == 0) {
+		// Hold still for as long as the other nodes move
+		the_node.Motion.DwellMs = node.dwell_ms;
+		return the_node.Motion.Adv.MovePosnStart(0, false, triggered, true);
+	}
+	the_node.Motion.VelLimit = node.vel_limit;
+	the_node.Motion.AccLimit = node.acc_limit;
+	if (move.head_length > 0 || move.tail_length > 0) {
+		the_node.Motion.Adv.HeadTailVelLimit = node.head_tail_vel;
+		the_node.Motion.Adv.HeadDistance = node.head_cnts;
+		the_node.Motion.Adv.TailDistance = node.tail_cnts;
+		return the_node.Motion.Adv.MovePosnHeadTailStart(node.counts, false, triggered,
+			move.head_length > 0, move.tail_length > 0);
+	}
+	if (move.decel != move.accel) {
+		the_node.Motion.Adv.DecelLimit = node.decel_limit;
+		return the_node.Motion.Adv.MovePosnAsymStart(node.counts, false, triggered);
+	}
+	return the_node.Motion.Adv.MovePosnStart(node.counts, false, triggered);
+}
+
+std::vector<double> machine::move_path_f(std::vector<path_element> path, path_limits limits) {
+
+	/// Summary: Runs a path of lines and arcs by streaming the planned moves into every node's move buffer.
+	///			The nodes run their buffered moves back to back, so the host never holds the machine between moves.
+	/// Params:	path: lines and arcs in absolute machine units, starting from the current position
+	///			limits: kinematic limits and tolerances of the path, see path_limits_f()
+	/// Returns: Function returns a vector of the measured position of the machine after the path is completed (or after it times out).
+	/// Notes:	The first move is triggered on every hub once the path is queued or a buffer is full. After that
+	///			each node starts its next move as it finishes the last, and the planner gives every node of a
+	///			move the same duration, so they stay in step. Each buffered move still ends at rest, so the
+	///			machine pauses at the points the planner keeps: corners, and arc chords beyond the tolerance.
+	///			Nodes with different RAS settings would leave the path, so such a path is refused.
+	///			Trigger groups do not span hubs, so each hub is triggered in turn and starts later than the
+	///			one before by the time its trigger took. The hubs' moves then run back to back with the same
+	///			durations, so that skew holds for the whole path and puts the nodes of a later hub up to the
+	///			skew times the path speed behind. The time each port's trigger returned is left in
+	///			path_trigger_ms, so the skew is measured to within one command round trip, and a warning is
+	///			printed if it could take the path beyond path_tolerance.
+
+	std::vector<double> start = measure_position_f();
+
+	// Every node must smooth its moves the same way
+	limits.jerk_time_ms = node_f(0).Motion.JrkLimitDelay;
+	for (size_t iNode = 1; iNode < node_port.size(); iNode++) {
+		if (node_f(iNode).Motion.JrkLimitDelay.Value() != limits.jerk_time_ms) {
+			printf("Error: nodes have different RAS settings, the path was not run\n");
+			msg_user_f("press any key to continue."); //pause so the user can see the error message; waits for user to press a key
+			return start;
+		}
+	}
+
+	std::vector<double> node_cnts_per_unit = config.node_sign / config.node_lead_per_cnt;
+	std::vector<planned_move> plan = plan_path_f(start, path, limits, config.node_parent_axis, node_cnts_per_unit);
+	if (plan.empty()) { return start; }
+
+	double path_ms = 0;
+	double peak_speed = 0;
+	for (size_t iMove = 0; iMove < plan.size(); iMove++) {
+		path_ms += plan[iMove].duration_ms;
+		peak_speed = std::max(peak_speed, plan[iMove].speed);
+	}
+
+	for (size_t iNode = 0; iNode < node_port.size(); iNode++) {
+		node_f(iNode).Motion.Adv.TriggerGroup(1);	// add all to same trigger group
+	}
+
+	std::vector<size_t> room(node_port.size(), 1);	// Moves each node will still accept
+	bool triggered = false;
+	bool timed_out = false;
+	double start_time = 0;
+	double timeout = 0;
+	for (size_t iMove = 0; iMove < plan.size() && !timed_out; iMove++) {
+		for (size_t iNode = 0; iNode < node_port.size() && !timed_out; iNode++) {
+			// Wait for the node to finish a move if its buffer is full
+			while (room[iNode] == 0) {
+				node_f(iNode).Status.RT.Refresh();
+				if (node_f(iNode).Status.RT.Value().cpm.MoveBufAvail) {
+					room[iNode] = 1;
+				}
+				else if (SC4_mgr->TimeStampMsec() > timeout) {
+					timed_out = true;
+					break;
+				}
+				else {
+					SC4_mgr->Delay(1);
+				}
+			}
+			if (!timed_out) {
+				room[iNode] = queue_move_f(iNode, plan[iMove], iMove == 0);
+			}
+		}
+
+		// Start once the whole path is queued or a buffer is full. Trigger groups do not span hubs,
+		// so fire each port's group back to back and time how far apart the hubs started.
+		if (!triggered && !timed_out
+			&& (iMove + 1 == plan.size() || *std::min_element(room.begin(), room.end()) == 0)) {
+			path_trigger_ms.assign(port_count, 0);
+			double first_ms = 0;
+			double last_ms = 0;
+			for (size_t iPort = 0; iPort < port_count; iPort++) {
+				IPort& SC4_port = SC4_mgr->Ports(iPort);
+				if (SC4_port.NodeCount() > 0) {
+					SC4_port.Nodes(0).Motion.Adv.TriggerMovesInMyGroup();
+					path_trigger_ms[iPort] = SC4_mgr->TimeStampMsec();
+					if (first_ms == 0) { first_ms = path_trigger_ms[iPort]; }
+					last_ms = path_trigger_ms[iPort];
+				}
+			}
+			triggered = true;
+			start_time = SC4_mgr->TimeStampMsec();
+			timeout = start_time + path_ms + PATH_TIMEOUT_MARGIN;
+			double skew_ms = last_ms - first_ms;
+			if (skew_ms / 1000 * peak_speed > limits.path_tolerance) {
+				printf("Warning: hubs started %.2f ms apart, up to %.4f off the path\n",
+					skew_ms, skew_ms / 1000 * peak_speed);
+			}
+		}
+	}
+
+	// Let the rest of the path run, then wait for every hub to finish
+	if (!timed_out) {
+		double now = SC4_mgr->TimeStampMsec();
+		if (start_time + path_ms > now) {
+			SC4_mgr->Delay(uint32_t(start_time + path_ms - now));
+		}
+		size_t iPort = 0;
+		while (iPort < port_count) {
+			if (move_is_done_f(SC4_mgr->Ports(iPort))) {
+				iPort++;	// This hub is finished, move on to the next one
+			}
+			else if (SC4_mgr->TimeStampMsec() > timeout) {
+				timed_out = true;
+				break;
+			}
+		}
+	}
+	if (timed_out) {
+		printf("Error: timed out waiting for path to complete\n");
+		msg_user_f("press any key to continue."); //pause so the user can see the error message; waits for user to press a key
+		for (size_t iStop = 0; iStop < port_count; iStop++) {
+			SC4_mgr->Ports(iStop).NodeStop();	// Stops the nodes at their current position
+		}
+	}
+
+	// Put back the acceleration limit move_linear_f() relies on
+	for (size_t iNode = 0; iNode < node_port.size(); iNode++) {
+		node_f(iNode).Motion.AccLimit = config.machine_accel_limit;
+	}
+
+	Sleep(SHORT_DELAY);
+	return measure_position_f();	// Measure ending position of machine to return
+}
+
 int machine::enable_nodes_f() {
 
 	/// Summary: Enables all nodes on a port and prints detected node data
@@ -298,13 +533,12 @@ int machine::enable_nodes_f() {
 	/// Returns: Int of -2 to imply fialure, 1 to imply success
 	/// Notes: 
 
-	IPort& SC4_port = SC4_mgr->Ports(0);			// Create a shortcut for the port
 	printf("\n===== Detected Node Data =====\n");
 	printf("        Type || FW Version || Serial # || Model\n");
 	try {
-		for (size_t iNode = 0; iNode < SC4_port.NodeCount(); iNode++) {
+		for (size_t iNode = 0; iNode < node_port.size(); iNode++) {
 			// Create a shortcut reference for a node
-			INode& the_node = SC4_port.Nodes(iNode);
+			INode& the_node = node_f(iNode);
 
 			the_node.EnableReq(false);				//Ensure Node is disabled before loading config file
 
@@ -340,8 +574,8 @@ int machine::enable_nodes_f() {
 		}
 		// Prints the User-defined node IDs for the user to check
 		printf("\n===== User Node IDs =====\n");
-		for (size_t iNode = 0; iNode < SC4_port.NodeCount(); iNode++) {
-			printf("Node[%d]: %s\n", int(iNode), SC4_port.Nodes(iNode).Info.UserID.Value());
+		for (size_t iNode = 0; iNode < node_port.size(); iNode++) {
+			printf("Node[%d]: %s\n", int(iNode), node_f(iNode).Info.UserID.Value());
 		}
 		return 1;
 	}
@@ -365,11 +599,10 @@ int machine::disable_nodes_f() {
 	/// Notes: 
 
 	try {
-		IPort& SC4_port = SC4_mgr->Ports(0);
 		printf("\nDisabling nodes\n");
-		for (size_t iNode = 0; iNode < SC4_port.NodeCount(); iNode++) {
+		for (size_t iNode = 0; iNode < node_port.size(); iNode++) {
 			// Create a shortcut reference for a node
-			SC4_port.Nodes(iNode).EnableReq(false);
+			node_f(iNode).EnableReq(false);
 		}
 		return 1;
 	}
@@ -398,8 +631,6 @@ int machine::home_axis_f(int axis_id) {
 	printf("\n===== Homing Axis =====\n");
 
 	try {
-		IPort& SC4_port = SC4_mgr->Ports(0);	// Create a shortcut for the port
-
 		// Useful Variable Shortcuts
 		const int machine_num_axes = config.machine_num_axes;
 		std::vector<double> node_is_follower = config.node_is_follower;
@@ -415,7 +646,7 @@ int machine::home_axis_f(int axis_id) {
 			// Single-node axes can simply use built-in clearpath homing methods
 
 			int iNode = std::distance(node_axis.begin(), std::find(node_axis.begin(), node_axis.end(), axis_id)); // index of node
-			INode& the_node = SC4_port.Nodes(iNode);	// shortcut to node
+			INode& the_node = node_f(iNode);	// shortcut to node
 
 			if (the_node.Motion.Homing.HomingValid())
 			{
@@ -428,7 +659,7 @@ int machine::home_axis_f(int axis_id) {
 			}
 
 			double timeout = SC4_mgr->TimeStampMsec() + TIME_TILL_TIMEOUT;	//define a timeout in case the node is unable to enable
-			while (!SC4_port.Nodes(iNode).Motion.Homing.WasHomed()) {
+			while (!the_node.Motion.Homing.WasHomed()) {
 				if (SC4_mgr->TimeStampMsec() > timeout) {
 					printf("Node[%d] did not complete homing:  \n\t -Ensure Homing settings have been defined through ClearView. \n\t -Check for alerts/Shutdowns \n\t -Ensure timeout is longer than the longest possible homing move.\n", iNode);
 					msg_user_f("Press any key to continue."); //pause so the user can see the error message; waits for user to press a key
@@ -450,58 +681,65 @@ int machine::home_axis_f(int axis_id) {
 			double posn = 0;				// position on axis for adjusting zero point
 
 			// Prep triggered velocity move for all nodes on axis
-			for (size_t iNode = 0; iNode < SC4_port.NodeCount(); iNode++) {
+			for (size_t iNode = 0; iNode < node_port.size(); iNode++) {
 				if (config.node_parent_axis[iNode] == axis_id) {
 
 					// Set Velocity Limits for homing
 					double node_machine_velocity_limit = config.homing_speed / config.node_lead_per_cnt[iNode] * config.node_sign[iNode];
-					SC4_port.Nodes(iNode).Motion.VelLimit = abs(node_machine_velocity_limit);
+					node_f(iNode).Motion.VelLimit = abs(node_machine_velocity_limit);
 
 					// Set up trigger
-					SC4_port.Nodes(iNode).Motion.Adv.TriggerGroup(1);	// add all to same trigger group
-					SC4_port.Nodes(iNode).Motion.Adv.MoveVelStart(-node_machine_velocity_limit, true);
-					SC4_port.Nodes(iNode).Motion.Homing.SignalInvalid();
+					node_f(iNode).Motion.Adv.TriggerGroup(1);	// add all to same trigger group
+					node_f(iNode).Motion.Adv.MoveVelStart(-node_machine_velocity_limit, true);
+					node_f(iNode).Motion.Homing.SignalInvalid();
 					axis_nodes.push_back(iNode);
 					was_homed.push_back(false);
 					lastnode = iNode;
 				}
 			}
-			SC4_port.Nodes(lastnode).Motion.Adv.TriggerMovesInMyGroup();	// Trigger group
+			// Trigger group on every hub holding a node of this axis
+			std::vector<bool> port_triggered(port_count, false);
+			for (size_t i = 0; i < axis_nodes.size(); i++) {
+				if (!port_triggered[node_port[axis_nodes[i]]]) {
+					node_f(axis_nodes[i]).Motion.Adv.TriggerMovesInMyGroup();
+					port_triggered[node_port[axis_nodes[i]]] = true;
+				}
+			}
 
 			// Read limit switches and poll for homed nodes
 			while (std::any_of(was_homed.begin(), was_homed.end(), [](bool i) { return !i; })) {
 				for (int i = 0; i < axis_nodes.size(); i++) {	//For each node on axis
 					size_t iNode = axis_nodes[i];
-					if (SC4_port.Nodes(iNode).Motion.Homing.WasHomed() || was_homed[i]) {	// Skip if node was homed
+					if (node_f(iNode).Motion.Homing.WasHomed() || was_homed[i]) {	// Skip if node was homed
 						// (Aug 26, 2022) I do not know why it needs the ...Homing.WasHomed() condition, since this is not
 						// really updated, as far as I can tell, but it does not work without it. -TH
 						continue;
 					}
-					else if (!leader_home_found && SC4_port.Nodes(iNode).Status.RT.Value().cpm.InA) {
+					else if (!leader_home_found && node_f(iNode).Status.RT.Value().cpm.InA) {
 						// NEW LEADER FOUND
-						SC4_port.Nodes(iNode).Motion.NodeStop(STOP_TYPE_ABRUPT);	// Stop Node
+						node_f(iNode).Motion.NodeStop(STOP_TYPE_ABRUPT);	// Stop Node
 						leader = iNode;												// Define Node as leader
 						leader_home_found = true;
-						SC4_port.Nodes(iNode).Motion.Homing.SignalComplete();
+						node_f(iNode).Motion.Homing.SignalComplete();
 						was_homed[i] = true;
-						posn = SC4_port.Nodes(iNode).Motion.PosnMeasured;
-						SC4_port.Nodes(iNode).Motion.AddToPosition(-posn);
+						posn = node_f(iNode).Motion.PosnMeasured;
+						node_f(iNode).Motion.AddToPosition(-posn);
 						continue;
 					}
-					else if (leader_home_found && !SC4_port.Nodes(iNode).Status.RT.Value().cpm.InA) {
+					else if (leader_home_found && !node_f(iNode).Status.RT.Value().cpm.InA) {
 						// Leader has been found, but this node is not activating the limit switch yet, reduce its speed
 						double node_machine_velocity_limit = (config.homing_speed / divisor) / config.node_lead_per_cnt[iNode];
-						SC4_port.Nodes(iNode).Motion.VelLimit = abs(node_machine_velocity_limit);
-						SC4_port.Nodes(iNode).Motion.Adv.MoveVelStart(-node_machine_velocity_limit, false);
+						node_f(iNode).Motion.VelLimit = abs(node_machine_velocity_limit);
+						node_f(iNode).Motion.Adv.MoveVelStart(-node_machine_velocity_limit, false);
 						continue;
 					}
-					else if (leader_home_found && SC4_port.Nodes(iNode).Status.RT.Value().cpm.InA) {
+					else if (leader_home_found && node_f(iNode).Status.RT.Value().cpm.InA) {
 						// Follower limit switch activated, stop node
-						SC4_port.Nodes(iNode).Motion.NodeStop(STOP_TYPE_ABRUPT);
-						SC4_port.Nodes(iNode).Motion.Homing.SignalComplete();
+						node_f(iNode).Motion.NodeStop(STOP_TYPE_ABRUPT);
+						node_f(iNode).Motion.Homing.SignalComplete();
 						was_homed[i] = true;
-						posn = SC4_port.Nodes(iNode).Motion.PosnMeasured;
-						SC4_port.Nodes(iNode).Motion.AddToPosition(-posn);
+						posn = node_f(iNode).Motion.PosnMeasured;
+						node_f(iNode).Motion.AddToPosition(-posn);
 
 						continue;
 					}
@@ -520,10 +758,10 @@ int machine::home_axis_f(int axis_id) {
 			config.machine_velocity_limit = prev_limit;	// Preserves previous velocity limit
 
 			// Set each node's zero point to its current position
-			for (size_t iNode = 0; iNode < SC4_port.NodeCount(); iNode++) {
+			for (size_t iNode = 0; iNode < node_port.size(); iNode++) {
 				if (config.node_parent_axis[iNode] == axis_id) {
-					posn = SC4_port.Nodes(iNode).Motion.PosnMeasured;
-					SC4_port.Nodes(iNode).Motion.AddToPosition(-posn);
+					posn = node_f(iNode).Motion.PosnMeasured;
+					node_f(iNode).Motion.AddToPosition(-posn);
 				}
 			}
 		}
@@ -546,7 +784,7 @@ int machine::home_axis_f(int axis_id) {
 
 int machine::open_ports_f() {
 
-	/// Summary: Searches for viable SC Hub Ports and opens the first one
+	/// Summary: Searches for viable SC Hub Ports and opens all of them
 	/// Params: 
 	/// Returns: 
 	/// Notes: thirth@ucsd.edu
@@ -554,7 +792,7 @@ int machine::open_ports_f() {
 //	accelerometer YEI;
 //	YEI.initialize_f();
 
-	size_t port_count = 0;
+	port_count = 0;
 	std::vector<std::string> comHubPorts;
 
 	//Create the SysManager object. This object will coordinate actions among various ports
@@ -579,10 +817,13 @@ int machine::open_ports_f() {
 		if (port_count <= 0) {
 		}
 		else {
-			SC4_mgr->PortsOpen(port_count);				//Open the port
-			IPort& SC4_port = SC4_mgr->Ports(0);
-			printf(" Port[%d]: state=%d, nodes=%d\n",
-				SC4_port.NetNumber(), SC4_port.OpenState(), SC4_port.NodeCount());
+			SC4_mgr->PortsOpen(port_count);				//Open the ports
+			for (size_t iPort = 0; iPort < port_count; iPort++) {
+				IPort& SC4_port = SC4_mgr->Ports(iPort);
+				printf(" Port[%d]: state=%d, nodes=%d\n",
+					SC4_port.NetNumber(), SC4_port.OpenState(), SC4_port.NodeCount());
+			}
+			map_nodes_f();
 
 		}
 		return port_count;
@@ -15,6 +15,7 @@
 #include "pubSysCls.h"	
 #include <vector>
 #include "vector_operators.hpp"
+#include "path_planner.hpp"
 //#include "YEI_functions.hpp"
 
 /*-------------------------------- Defines ---------------------------------*/
@@ -24,11 +25,17 @@
 class machine {
 private:
 	sFnd::SysManager* SC4_mgr;
+	size_t port_count = 0;
+	std::vector<size_t> node_port;		// Port of each machine node
+	std::vector<size_t> node_on_port;	// Index of each machine node on its port
 	void load_config_f(char delimiter);
 	int open_ports_f();
+	void map_nodes_f();
+	sFnd::INode& node_f(size_t iNode);
 	int enable_nodes_f();
 	int disable_nodes_f();
 	int set_config_f();
+	size_t queue_move_f(size_t iNode, const planned_move& move, bool triggered);
 	void close_ports_f();
 public:
 	struct mech_config
@@ -50,8 +57,12 @@ public:
 		bool remote_mode = false;
 	} settings;
 	std::vector<double> current_position;
+	std::vector<double> position_sample_ms;	// Sweep time of each port in the last measure_position_f()
+	std::vector<double> path_trigger_ms;	// Time each port's trigger returned in the last move_path_f(), 0 for none
 	std::vector<double> measure_position_f();
 	std::vector<double> move_linear_f(std::vector<double> input_vec, bool target_is_absolute);
+	path_limits path_limits_f();
+	std::vector<double> move_path_f(std::vector<path_element> path, path_limits limits);
 	int home_axis_f(int axis_id);
 	int start_up_f();
 	void shut_down_f();
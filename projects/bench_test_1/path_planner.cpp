@@ -0,0 +1,284 @@
+/****************************************************************************
+ Module
+	path_planner.cpp
+ Description
+	This is a set of functions that turn a machine-space path of lines and
+	arcs into synchronized sequences of node moves in counts. The moves are
+	sized so that every node of a move runs the same profile scaled to its
+	own distance, which keeps the tool on the straight line between points
+	and lets each node's move buffer be streamed without the host waiting
+	between moves.
+
+*****************************************************************************/
+
+/*----------------------------- Include Files ------------------------------*/
+#include "path_planner.hpp"
+#include "vector_operators.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/*--------------------------- External Variables ---------------------------*/
+/*----------------------------- Module Defines -----------------------------*/
+#define PI						3.14159265358979323846
+#define MAX_ARC_STEP			(PI / 4)	// Largest arc angle one chord may span (rad)
+
+/*------------------------------ Module Types ------------------------------*/
+/*---------------------------- Module Variables ----------------------------*/
+
+/*--------------------- Module Function Prototypes -------------------------*/
+static double point_segment_distance_f(const std::vector<double>& p,
+	const std::vector<double>& a, const std::vector<double>& b);
+static double profile_ms_f(double length, double speed, double accel, double decel);
+static double head_tail_profile_ms_f(double length, double speed, double accel,
+	double ht_speed, double head_length, double tail_length);
+
+/*------------------------------ Module Code -------------------------------*/
+
+std::vector<std::vector<double>> flatten_path_f(const std::vector<double>& start,
+	const std::vector<path_element>& path, double chord_error) {
+
+	/// Summary: Replaces the arcs of a path by chords, returning the path as a list of points
+	/// Params:	start: absolute machine position the path starts from
+	///			path: lines and arcs in absolute machine units, each starting where the last ended
+	///			chord_error: largest distance allowed between an arc and its chords
+	/// Returns: The start point followed by the end point of every line and chord
+	/// Notes:	An arc whose end equals its start is a full circle. Axes outside the arc's plane move linearly
+	///			along the arc, giving a helix. If the end is not on the start's radius, the radius changes linearly.
+
+	std::vector<std::vector<double>> points;
+	std::vector<double> from = start;
+	points.push_back(start);
+
+	for (size_t iElem = 0; iElem < path.size(); iElem++) {
+		const path_element& elem = path[iElem];
+		if (!elem.is_arc) {
+			points.push_back(elem.end);
+			from = elem.end;
+			continue;
+		}
+
+		size_t a0 = elem.plane_axis[0];
+		size_t a1 = elem.plane_axis[1];
+		double start_radius = std::hypot(from[a0] - elem.center[a0], from[a1] - elem.center[a1]);
+		double end_radius = std::hypot(elem.end[a0] - elem.center[a0], elem.end[a1] - elem.center[a1]);
+		double start_angle = std::atan2(from[a1] - elem.center[a1], from[a0] - elem.center[a0]);
+		double sweep = std::atan2(elem.end[a1] - elem.center[a1], elem.end[a0] - elem.center[a0]) - start_angle;
+
+		// Sweep the arc the requested way round, a zero sweep being a full circle
+		if (elem.clockwise && sweep >= 0) {
+			sweep -= 2 * PI;
+		}
+		else if (!elem.clockwise && sweep <= 0) {
+			sweep += 2 * PI;
+		}
+
+		// A chord spanning angle a leaves the arc by r(1 - cos(a/2))
+		double radius = std::max(start_radius, end_radius);
+		double max_step = MAX_ARC_STEP;
+		if (chord_error > 0 && chord_error < radius) {
+			max_step = std::min(max_step, 2 * std::acos(1 - chord_error / radius));
+		}
+		size_t n_chords = std::max<size_t>(1, size_t(std::ceil(std::fabs(sweep) / max_step)));
+
+		for (size_t iChord = 1; iChord < n_chords; iChord++) {
+			double frac = double(iChord) / n_chords;
+			double angle = start_angle + sweep * frac;
+			double r = start_radius + (end_radius - start_radius) * frac;
+			std::vector<double> point = from + ((elem.end - from) | frac);
+			point[a0] = elem.center[a0] + r * std::cos(angle);
+			point[a1] = elem.center[a1] + r * std::sin(angle);
+			points.push_back(point);
+		}
+		points.push_back(elem.end);
+		from = elem.end;
+	}
+	return points;
+}
+
+std::vector<std::vector<double>> join_segments_f(const std::vector<std::vector<double>>& points,
+	double tolerance) {
+
+	/// Summary: Joins runs of nearly collinear segments into single segments
+	/// Params:	points: path points, as returned by flatten_path_f()
+	///			tolerance: largest distance a dropped point may have from the segment replacing it
+	/// Returns: The points kept, the first and last always among them
+	/// Notes:	The nodes stop at the end of every buffered move, so each point dropped here is a stop saved.
+
+	std::vector<std::vector<double>> joined;
+	if (points.empty()) { return joined; }
+	joined.push_back(points[0]);
+
+	size_t iStart = 0;
+	size_t iEnd = 1;
+	while (iEnd < points.size()) {
+		// Try to carry the segment from points[iStart] on to the next point
+		bool can_join = iEnd + 1 < points.size();
+		for (size_t iPoint = iStart + 1; can_join && iPoint <= iEnd; iPoint++) {
+			can_join = point_segment_distance_f(points[iPoint], points[iStart], points[iEnd + 1]) <= tolerance;
+		}
+		if (can_join) {
+			iEnd++;
+			continue;
+		}
+		joined.push_back(points[iEnd]);
+		iStart = iEnd;
+		iEnd++;
+	}
+	return joined;
+}
+
+std::vector<planned_move> plan_path_f(const std::vector<double>& start,
+	const std::vector<path_element>& path, const path_limits& limits,
+	const std::vector<double>& node_axis, const std::vector<double>& node_cnts_per_unit) {
+
+	/// Summary: Plans the node moves that run a path
+	/// Params:	start: absolute machine position the path starts from
+	///			path: lines and arcs in absolute machine units
+	///			limits: kinematic limits and tolerances of the path
+	///			node_axis: machine axis each node drives
+	///			node_cnts_per_unit: counts per machine unit of each node, signed by the node's direction
+	/// Returns: The moves in order, each holding one relative move per node
+	/// Notes:	Every node of a move gets the move's path profile scaled by its own distance, so the nodes
+	///			start and finish together and the tool stays on the straight line between points. The node
+	///			RAS filter turns each trapezoid into a jerk-limited profile. It is the same linear filter on
+	///			every node, so the scaled profiles stay in step only if all nodes share one RAS setting.
+	///			Counts are rounded against the start, so rounding never builds up along the path.
+	///			A node with no counts in a move dwells through it instead, taking its RAS time like a
+	///			moving node. Dwells are whole milliseconds, with the remainder carried to the next dwell.
+	///			The approach speed is held over approach_length at the start of the first move and the end
+	///			of the last, as head and tail moves. Head and tail moves have no separate deceleration.
+
+	std::vector<planned_move> plan;
+	std::vector<std::vector<double>> points = join_segments_f(
+		flatten_path_f(start, path, limits.chord_error), limits.path_tolerance);
+
+	size_t n_nodes = node_axis.size();
+	std::vector<double> issued_cnts(n_nodes, 0.0);	// Counts issued since the start
+	std::vector<double> dwell_carry(n_nodes, 0.0);	// Dwell time owed to stationary nodes
+	std::vector<double> from = start;
+
+	for (size_t iPoint = 1; iPoint < points.size(); iPoint++) {
+		planned_move move;
+		move.end = points[iPoint];
+		move.nodes.resize(n_nodes);
+
+		// Round each node's target against the start
+		bool any_counts = false;
+		for (size_t iNode = 0; iNode < n_nodes; iNode++) {
+			size_t axis = size_t(node_axis[iNode]);
+			double target = std::round((move.end[axis] - start[axis]) * node_cnts_per_unit[iNode]);
+			move.nodes[iNode].counts = int32_t(target - issued_cnts[iNode]);
+			any_counts = any_counts || move.nodes[iNode].counts != 0;
+		}
+		if (!any_counts) { continue; }	// Too short to move a count, carried into the next move
+
+		move.length = std::sqrt(vector_sum((move.end - from) ^ 2));
+
+		// Fit the path limits to the node limits. A node's counts per path length set how much of
+		// the path's acceleration it sees. Its speed is the path speed's share along its axis, so it
+		// stays within limits.velocity on that axis, give or take a count of rounding, and needs no
+		// bound of its own.
+		move.speed = limits.velocity;
+		move.accel = std::numeric_limits<double>::infinity();
+		move.decel = std::numeric_limits<double>::infinity();
+		for (size_t iNode = 0; iNode < n_nodes; iNode++) {
+			if (move.nodes[iNode].counts == 0) { continue; }
+			double ratio = std::abs(move.nodes[iNode].counts) / move.length;
+			move.accel = std::min(move.accel, limits.accel / ratio);
+			move.decel = std::min(move.decel, limits.decel / ratio);
+		}
+
+		// Approach speed at the ends of the path
+		if (limits.approach_speed > 0 && limits.approach_speed < move.speed) {
+			if (plan.empty()) {
+				move.head_length = std::min(limits.approach_length, move.length);
+			}
+			if (iPoint + 1 == points.size()) {
+				move.tail_length = std::min(limits.approach_length, move.length);
+			}
+			if (move.head_length + move.tail_length > move.length) {
+				move.head_length = move.tail_length = move.length / 2;
+			}
+		}
+		bool head_tail = move.head_length > 0 || move.tail_length > 0;
+		if (head_tail) {
+			move.decel = move.accel;
+			move.duration_ms = head_tail_profile_ms_f(move.length, move.speed, move.accel,
+				limits.approach_speed, move.head_length, move.tail_length);
+		}
+		else {
+			move.duration_ms = profile_ms_f(move.length, move.speed, move.accel, move.decel);
+		}
+
+		for (size_t iNode = 0; iNode < n_nodes; iNode++) {
+			node_move& node = move.nodes[iNode];
+			if (node.counts == 0) {
+				dwell_carry[iNode] += move.duration_ms;
+				node.dwell_ms = uint32_t(std::round(dwell_carry[iNode]));
+				dwell_carry[iNode] -= node.dwell_ms;
+				continue;
+			}
+			double ratio = std::abs(node.counts) / move.length;
+			node.vel_limit = move.speed * ratio;
+			node.acc_limit = move.accel * ratio;
+			node.decel_limit = move.decel * ratio;
+			if (head_tail) {
+				node.head_tail_vel = limits.approach_speed * ratio;
+				node.head_cnts = uint32_t(std::round(move.head_length * ratio));
+				node.tail_cnts = uint32_t(std::round(move.tail_length * ratio));
+			}
+			issued_cnts[iNode] += node.counts;
+		}
+		move.duration_ms += limits.jerk_time_ms;
+		plan.push_back(move);
+		from = move.end;
+	}
+	return plan;
+}
+
+static double point_segment_distance_f(const std::vector<double>& p,
+	const std::vector<double>& a, const std::vector<double>& b) {
+
+	/// Summary: Distance from point p to the segment from a to b
+
+	std::vector<double> ab = b - a;
+	double len2 = vector_sum(ab ^ 2);
+	double t = 0;
+	if (len2 > 0) {
+		t = std::clamp(vector_sum((p - a) * ab) / len2, 0.0, 1.0);
+	}
+	return std::sqrt(vector_sum((p - (a + (ab | t))) ^ 2));
+}
+
+static double profile_ms_f(double length, double speed, double accel, double decel) {
+
+	/// Summary: Duration of a trapezoidal profile, as the node runs it
+	/// Notes:	Mirrors IMotionAdv::MovePosnAsymDurationMsec() without the RAS time
+
+	double accel_time = speed / accel;
+	double decel_time = speed / decel;
+	double ramp_length = (accel_time + decel_time) * speed / 2;
+	if (ramp_length >= length) {
+		// Peak speed is never reached, the profile is a smaller similar triangle
+		return (accel_time + decel_time) * std::sqrt(length / ramp_length) * 1000;
+	}
+	return (accel_time + decel_time + (length - ramp_length) / speed) * 1000;
+}
+
+static double head_tail_profile_ms_f(double length, double speed, double accel,
+	double ht_speed, double head_length, double tail_length) {
+
+	/// Summary: Duration of a head and tail profile, as the node runs it
+	/// Notes:	Mirrors IMotionAdv::MovePosnHeadTailDurationMsec() without the RAS time
+
+	double ht_ramp_length = ht_speed * ht_speed / accel / 2;
+	double ht_slew_length = std::max(0.0, head_length - ht_ramp_length)
+		+ std::max(0.0, tail_length - ht_ramp_length);
+	ht_slew_length = std::max(0.0, std::min(ht_slew_length, length - 2 * ht_ramp_length));
+	return profile_ms_f(length - ht_slew_length, speed, accel, accel) + ht_slew_length / ht_speed * 1000;
+}
+/*----------------------------- Test Harness -------------------------------*/
+
+/*------------------------------- Footnotes --------------------------------*/
+/*------------------------------ End of file -------------------------------*/
@@ -0,0 +1,77 @@
+/****************************************************************************
+ Module
+	path_planner.hpp
+ Description
+	This is a set of functions that turn a machine-space path of lines and
+	arcs into synchronized sequences of node moves in counts. The moves are
+	sized so that every node of a move runs the same profile scaled to its
+	own distance, which keeps the tool on the straight line between points
+	and lets each node's move buffer be streamed without the host waiting
+	between moves.
+
+*****************************************************************************/
+#ifndef PATH_PLANNER_HPP_
+#define PATH_PLANNER_HPP_
+/*----------------------------- Include Files ------------------------------*/
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/*-------------------------------- Defines ---------------------------------*/
+
+/*--------------------------------- Types ----------------------------------*/
+
+struct path_element {
+	std::vector<double> end;			// End point in absolute machine units
+	bool is_arc = false;				// Arc from the previous end point, otherwise a line
+	std::vector<double> center;			// Arc center, only the plane axes are used
+	size_t plane_axis[2] = { 0, 1 };	// Axes spanning the plane of the arc
+	bool clockwise = false;				// Arc direction seen from the plane's normal
+};
+
+struct path_limits {
+	double velocity = 0;				// Path speed limit (machine units/s)
+	double accel = 0;					// Acceleration limit of every node (counts/s^2)
+	double decel = 0;					// Deceleration limit of every node (counts/s^2)
+	double jerk_time_ms = 0;			// RAS smoothing time of the nodes (ms)
+	double chord_error = 0;				// Largest distance from an arc to its chords (machine units)
+	double path_tolerance = 0;			// Largest distance from a joined point to its move (machine units)
+	double approach_speed = 0;			// Path speed at the path's start and end, 0 for none
+	double approach_length = 0;			// Path length run at approach_speed at each end (machine units)
+};
+
+struct node_move {
+	int32_t counts = 0;					// Relative move (counts)
+	double vel_limit = 0;				// Velocity limit (counts/s)
+	double acc_limit = 0;				// Acceleration limit (counts/s^2)
+	double decel_limit = 0;				// Deceleration limit (counts/s^2)
+	double head_tail_vel = 0;			// Head and tail velocity limit (counts/s)
+	uint32_t head_cnts = 0;				// Head distance, 0 for no head
+	uint32_t tail_cnts = 0;				// Tail distance, 0 for no tail
+	uint32_t dwell_ms = 0;				// Dwell after a move of no counts (ms)
+};
+
+struct planned_move {
+	std::vector<double> end;			// End point in absolute machine units
+	double length = 0;					// Path length (machine units)
+	double speed = 0;					// Path speed limit (machine units/s)
+	double accel = 0;					// Path acceleration (machine units/s^2)
+	double decel = 0;					// Path deceleration (machine units/s^2)
+	double head_length = 0;				// Path length run at approach speed at the start
+	double tail_length = 0;				// Path length run at approach speed at the end
+	double duration_ms = 0;				// Duration of the move, RAS time included
+	std::vector<node_move> nodes;		// One move per node
+};
+
+/*------------------------------- Variables --------------------------------*/
+
+/*---------------------- Public Function Prototypes ------------------------*/
+std::vector<std::vector<double>> flatten_path_f(const std::vector<double>& start,
+	const std::vector<path_element>& path, double chord_error);
+std::vector<std::vector<double>> join_segments_f(const std::vector<std::vector<double>>& points,
+	double tolerance);
+std::vector<planned_move> plan_path_f(const std::vector<double>& start,
+	const std::vector<path_element>& path, const path_limits& limits,
+	const std::vector<double>& node_axis, const std::vector<double>& node_cnts_per_unit);
+/*------------------------------ End of file -------------------------------*/
+#endif /* PATH_PLANNER_HPP_ */
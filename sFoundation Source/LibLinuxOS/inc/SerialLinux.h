@@ -0,0 +1,346 @@
+//	SerialLinux.h - Definition of the CSerial class for POSIX termios
+//
+//	Copyright (C) 1999-2003 Ramon de Klein (Ramon.de.Klein@ict.nl)
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+#include <tekEventsLinux.h>
+#include <errno.h>
+#include <signal.h>
+
+#ifndef __SERIAL_H
+#define __SERIAL_H
+
+
+//////////////////////////////////////////////////////////////////////
+//
+// CSerial - Linux termios wrapper for serial communications
+//
+// This presents the same interface as the Win32 CSerial so CSerialEx
+// runs unchanged. Differences from the Win32 version:
+//
+//	- Reads wait in epoll on the port and an eventfd, so a packet's
+//	  first byte and a cancel both wake the reader without polling.
+//	  CancelCommIo signals the eventfd, standing in for CancelIo.
+//	- There is no WaitCommEvent. A watcher thread blocks in TIOCMIWAIT
+//	  and wakes CommEventWaitInitiate on each CTS edge, which then reads
+//	  the UART interrupt counters (TIOCGICOUNT) for the cause. Breaks
+//	  and line errors raise no modem interrupt, they are picked up by a
+//	  SERIAL_LINE_POLL_MS sample of the counters. Drivers without
+//	  TIOCMIWAIT, such as pseudo-terminals, fall back to sampling the
+//	  counters or the CTS level every SERIAL_MODEM_POLL_MS.
+//	- Rates that have no Bxxx constant are set via termios2/BOTHER.
+//	- The driver is asked for ASYNC_LOW_LATENCY and USB adapters that
+//	  expose a latency_timer are set to their minimum.
+//
+// Copyright (C) 1999-2003 Ramon de Klein
+//                         (Ramon.de.Klein@ict.nl)
+
+// Modem line/counter sample period while waiting for comm events on
+// drivers that cannot wait for a CTS edge. This is the worst case CTS
+// latency on those drivers.
+#define SERIAL_MODEM_POLL_MS	2
+// Counter sample period for breaks and line errors when CTS edges are
+// delivered by TIOCMIWAIT. A CTS edge closer than a few microseconds
+// behind the one before can also wait this long.
+#define SERIAL_LINE_POLL_MS		20
+// Signal that releases the TIOCMIWAIT watcher when the port closes. It
+// is only claimed while its disposition is the default.
+#define SERIAL_WAKE_SIGNAL		(SIGRTMIN+5)
+
+class CSerial
+{
+// Class enumerations
+public:
+	// These are return codes from serial API. They generally map
+	// into the host OS's errno list except for the items
+	// at the end of the list.
+	typedef enum
+	{
+		API_ERROR_SUCCESS = 0,
+		// Between here and	API_ERROR_TIMEOUT are
+		// mapped to the errno codes.
+		API_ERROR_TIMEOUT = 0x84010001,
+		API_ERROR_PORT_SETUP,
+		API_ERROR_INVALID_HANDLE,
+		API_ERROR_INVALID_ARG,
+		API_ERROR_PORT_UNAVAILABLE,
+		API_ERROR_UNKNOWN
+	}
+	SERAPI_ERR;
+	// Communication events (bit encoded, Win32 values)
+	typedef enum
+	{
+		EEventUnknown  	   = -1,			// Unknown event
+		EEventNone  	   = 0,				// Event trigged without cause
+		EEventBreak 	   = 0x0040,		// A break was detected on input
+		EEventCTS   	   = 0x0008,		// The CTS signal changed state
+		EEventDSR   	   = 0x0010,		// The DSR signal changed state
+		EEventError 	   = 0x0080,		// A line-status error occurred
+		EEventRing  	   = 0x0100,		// A ring indicator was detected
+		EEventRLSD  	   = 0x0020,		// The RLSD signal changed state
+		EEventRecv  	   = 0x0001,		// Data is received on input
+		EEventRcvEv 	   = 0x0002,		// Event character was received on input
+		EEventSend		   = 0x0004,		// Last character on output was sent
+		EEventPrinterError = 0x0200,		// Printer error occured
+		EEventRx80Full	   = 0x0400,		// Receive buffer is 80 percent full
+		EEventProviderEvt1 = 0x0800,		// Provider specific event 1
+		EEventProviderEvt2 = 0x1000,		// Provider specific event 2
+	}
+	EEvent;
+
+	// Data bits (5-8)
+	typedef enum
+	{
+		EDataUnknown = -1,			// Unknown
+		EData5       =  5,			// 5 bits per byte
+		EData6       =  6,			// 6 bits per byte
+		EData7       =  7,			// 7 bits per byte
+		EData8       =  8			// 8 bits per byte (default)
+	}
+	EDataBits;
+
+	// Parity scheme
+	typedef enum
+	{
+		EParUnknown = -1,			// Unknown
+		EParNone    = 0,			// No parity (default)
+		EParOdd     = 1,			// Odd parity
+		EParEven    = 2,			// Even parity
+		EParMark    = 3,			// Mark parity
+		EParSpace   = 4				// Space parity
+	}
+	EParity;
+
+	// Stop bits
+	typedef enum
+	{
+		EStopUnknown = -1,			// Unknown
+		EStop1       = 0,			// 1 stopbit (default)
+		EStop2       = 2			// 2 stopbits
+	}
+	EStopBits;
+
+	// return constant for unknown baud rate
+	static const nodeulong EBaudUnknown = 0;
+
+	// Handshaking
+	typedef enum
+	{
+		EHandshakeUnknown		= -1,	// Unknown
+		EHandshakeOff			=  0,	// No handshaking
+		EHandshakeHardware		=  1,	// Hardware handshaking (RTS/CTS)
+		EHandshakeSoftware		=  2	// Software handshaking (XON/XOFF)
+	}
+	EHandshake;
+
+	// DTR
+	typedef enum
+	{
+		EDTRClear		= 0,	// Clear - (Volt DTR = -5)
+		EDTRSet			= true,	// Set - (Volt DTR = 5)
+	}
+	EDTR;
+
+	// RTS
+	typedef enum
+	{
+		ERTSClear		= 0,	// Clear - (Volt RTS = -5)
+		ERTSSet			= true,	// Set - (Volt RTS = 5)
+	}
+	ERTS;
+
+	// Timeout settings
+	typedef enum
+	{
+		EReadTimeoutUnknown		= -1,	// Unknown
+		EReadTimeoutNonblocking	=  0,	// Always return immediately
+		EReadTimeoutBlocking	=  1	// Block until everything is retrieved
+	}
+	EReadTimeout;
+
+	// Communication errors	(bit encoded, Win32 values)
+	typedef enum
+	{
+		EErrorUnknown = 0,			// Unknown
+		EErrorBreak   = 0x0010,		// Break condition detected
+		EErrorFrame   = 0x0008,		// Framing error
+		EErrorIOE     = 0x0400,		// I/O device error
+		EErrorMode    = 0x8000,		// Unsupported mode
+		EErrorOverrun = 0x0002,		// Character buffer overrun, next byte is lost
+		EErrorRxOver  = 0x0001,		// Input buffer overflow, byte lost
+		EErrorParity  = 0x0004,		// Input parity error
+		EErrorTxFull  = 0x0100		// Output buffer full
+	}
+	EError;
+
+	// Port availability
+	typedef enum
+	{
+		EPortUnknownError = -1,		// Unknown state
+		EPortAvailable    =  0,		// Port is available
+		EPortNotAvailable =  1,		// Port is not present
+		EPortInUse        =  2		// Port is in use
+	}
+	EPort;
+
+// Construction
+public:
+	CSerial();
+	virtual ~CSerial();
+
+// Operations
+public:
+	// Check if particular port is available (static method).
+	static EPort CheckPort (LPCTSTR lpszDevice);
+
+	// Open the serial communications for a particular port. You
+	// need to use the full devicename (i.e. "/dev/ttyUSB0") to open the
+	// port. The queue sizes and overlapped flag are accepted for
+	// compatibility; the tty layer owns its buffers.
+	virtual SERAPI_ERR Open (LPCTSTR lpszDevice, DWORD dwInQueue = 0, DWORD dwOutQueue = 0, bool fOverlapped = true);
+
+	// Close the serial port.
+	virtual SERAPI_ERR Close (void);
+
+	// Setup the communication settings such as baudrate, databits,
+	// parity and stopbits. Any rate the driver can generate is
+	// accepted, not just the standard Bxxx rates.
+	virtual SERAPI_ERR Setup (nodeulong = 9600,
+						EDataBits eDataBits = EData8,
+						EParity   eParity   = EParNone,
+						EStopBits eStopBits = EStop1,
+						EDTR eDTRBit = EDTRClear,
+						ERTS eRTSBit = ERTSClear);
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	// Communications Event Interface. Provides signals upon various
+	// normal serial communications events such as break condition detect.
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+protected:
+	CCEvent m_commEvent;
+public:
+	// Set the event mask, which indicates what events should be
+	// monitored. Changing the mask releases a pending wait with
+	// EEventNone like the Win32 version.
+	virtual SERAPI_ERR SetEventMask (DWORD dwMask = EEventBreak|EEventError|EEventRecv|EEventCTS);
+
+	// Block until one of the events enabled via SetEventMask occurs or
+	// ForceCommEvent is called. Returns an error if the port closes.
+	virtual SERAPI_ERR CommEventWaitInitiate();
+	// This is the communications notification event, must outlive the thread
+	bool WaitForCommEvent(unsigned int timeOutMS) {
+		return m_commEvent.WaitFor(timeOutMS);
+	}
+	void ForceCommEvent() {
+		m_commEvent.SetEvent();
+	}
+	// Determine what caused the event to trigger
+	EEvent GetEventType (void);
+
+
+	// Obtain communication settings
+	virtual nodeulong  GetBaudrate    (void);
+	virtual DWORD      GetEventMask   (void);
+
+	// Write data to the serial port.
+	virtual SERAPI_ERR Write (const void* pData, size_t iLen, DWORD* pdwWritten = 0, DWORD dwTimeout = INFINITE);
+	virtual SERAPI_ERR Write (const char *pString, DWORD* pdwWritten = 0, DWORD dwTimeout = INFINITE);
+
+	// Read data from the serial port.
+	virtual SERAPI_ERR Read (void* pData, size_t iLen, DWORD* pdwRead = 0, DWORD dwTimeout = INFINITE);
+
+	// Send a break
+	virtual SERAPI_ERR Break (DWORD breakDurationMs);
+
+
+	// Obtain the error
+	EError GetError (void);
+
+	// Obtain the port's file descriptor
+	int GetCommHandle (void)		{ return m_fd; }
+
+	// Check if com-port is opened
+	bool IsOpen (void) const		{ return (m_fd >= 0); }
+
+
+	// Obtain CTS/DSR/RING/RLSD settings
+	bool GetDTR (void);
+	void SetDTR(bool EDTRBit);
+	bool GetRTS (void);
+	void SetRTS(bool ERTSBit);
+	bool GetCTS (void);
+	bool GetDSR (void);
+
+	// Released by CancelCommIo for compatibility with the Win32 reader
+	CCEvent m_rdEvent;
+
+// Attributes
+protected:
+	SERAPI_ERR	m_lLastError;	// Last serial error
+	SERAPI_ERR	m_lLastRdError;	// Last serial read error
+	SERAPI_ERR	m_lLastWrError;	// Last serial write error
+	CCCriticalSection ReadLock;				// Internal structure lock
+public:
+	// Obtain last error status
+	SERAPI_ERR GetLastError (void) const	{ return m_lLastError; }
+	// Obtain last error status
+	SERAPI_ERR GetLastWrError (void) const	{ return m_lLastWrError; }
+	// Obtain last error status
+	SERAPI_ERR GetLastRdError (void) const	{ return m_lLastRdError; }
+
+protected:
+	int		m_fd;				// Port file descriptor, -1 if closed
+	int		m_wakeFd;			// eventfd signalled by CancelCommIo
+	int		m_epollFd;			// Read waits on m_fd and m_wakeFd
+	EEvent	m_eEvent;			// Event type
+	DWORD	m_dwEventMask;		// Event mask
+	EDTR	m_DTRBit;			// Dtr Bit
+	ERTS	m_RTSBit;			// Rts Bit
+	nodeulong m_baudRate;		// Rate set by Setup
+	// Last TIOCGICOUNT sample for event detection
+	struct {
+		int cts, brk, frame, overrun, parity, bufOverrun;
+	} m_iCount;
+	bool	m_iCountOK;			// Driver supports TIOCGICOUNT
+	bool	m_lastCTS;			// CTS level for drivers without counters
+	DWORD	m_errPending;		// EError bits seen since last GetError
+	pthread_t m_modemThread;	// TIOCMIWAIT watcher
+	bool	m_modemThreadUp;	// m_modemThread needs a join
+	volatile bool m_modemStop;	// Tells the watcher to exit
+	volatile bool m_modemWaitOK;// Watcher is delivering CTS edges
+
+	// Sample the modem lines and counters, returning new events
+	DWORD sampleEvents(void);
+	// Start and stop the TIOCMIWAIT watcher
+	void startModemWatch(void);
+	void stopModemWatch(void);
+	static void *modemWatch(void *pSerial);
+	// Apply the driver low latency flags
+	void setLowLatency(const char *lpszDevice);
+
+protected:
+	// Purge all buffers
+	SERAPI_ERR Purge (void);
+	// Release a reader blocked in Read
+	SERAPI_ERR CancelCommIo (void);
+	// Read operations can be blocking or non-blocking. This selects
+	// the termios VMIN/VTIME pair; Read itself waits in epoll so the
+	// VTIME inter-character timer never adds latency.
+	virtual LONG SetupReadTimeouts (EReadTimeout eReadTimeout);
+};
+
+#endif	// __SERIAL_H
@@ -0,0 +1,537 @@
+//*****************************************************************************
+// DESCRIPTION:
+/**
+	\file
+	Thin layer to create POSIX synchronization objects with the same
+	interface as the WIN32 versions in tekEventsWin32.h.
+
+**/
+//
+// CREATION DATE:
+//		10/18/2026 09:12:40
+//
+// COPYRIGHT NOTICE:
+//		(C)Copyright 2004-2026  Teknic, Inc.  All rights reserved.
+//
+//		This copyright notice must be reproduced in any copy, modification,
+//		or portion thereof merged into another program. A copy of the
+//		copyright notice must be included in the object library of a user
+//		program.
+//																			  *
+//*****************************************************************************
+#ifndef __TEKEVENTS_H__
+#define	__TEKEVENTS_H__
+
+
+
+//*****************************************************************************
+// NAME																          *
+// 	tekEventsLinux.h headers
+//
+	#include <string.h>
+	#include <assert.h>
+	#include <pthread.h>
+	#include "tekTypes.h"
+//																			  *
+//*****************************************************************************
+
+
+
+
+
+//*****************************************************************************
+// NAME																          *
+// 	tekEventsLinux.h constants
+//
+//
+
+#ifndef NULL
+#define NULL 0
+#endif
+
+// Define a the "infinite" timeout to match Win32
+#define SYNC_INFINITE  0xFFFFFFFF
+#ifndef INFINITE
+#define INFINITE SYNC_INFINITE
+#endif
+#define LPSECURITY_ATTRIBUTES void *
+typedef void *HANDLE;
+
+// Hint to the processor that we are spinning on a memory location
+#if defined(__i386__)||defined(__x86_64__)
+#define CPU_RELAX() __builtin_ia32_pause()
+#elif defined(__aarch64__)||defined(__arm__)
+#define CPU_RELAX() __asm__ __volatile__("yield" ::: "memory")
+#else
+#define CPU_RELAX() __sync_synchronize()
+#endif
+
+
+// Forward references
+class CCMTLock;
+class CCMTSyncObject;
+class CCSemaphore;
+class CCMutex;
+class CCEvent;
+class CCCriticalSection;
+class CCspinEvent;
+class CCseqLock;
+class CCmappedFile;
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		class CCMTSyncObject
+//
+//	DESCRIPTION:
+///		Multi-threaded synchronization object pure virtual base class. The
+///		POSIX objects are built from a mutex and condition variable, the
+///		condition waits use the monotonic clock so time-outs are immune to
+///		wall clock changes.
+///
+/// 	Detailed description.
+//
+//	SYNOPSIS:
+class CCMTSyncObject
+{
+protected:
+	pthread_mutex_t m_mutex;
+	pthread_cond_t m_cond;
+	// Wait on m_cond, with m_mutex held, until <deadline>. Returns false
+	// on time-out.
+	bool condWait(const struct timespec *deadline);
+	// Compute the deadline <timeOut> milliseconds from now
+	static void deadlineAfter(Uint32 timeOut, struct timespec *deadline);
+public:
+
+	CCMTSyncObject();
+	virtual ~CCMTSyncObject();
+
+	bool isOK() {
+		return(true);
+	}
+
+	virtual  bool   Lock(Uint32 dwTimeout = SYNC_INFINITE) = 0;
+	virtual  bool   Unlock() = 0;
+	// Counted unlocks are for semaphores, everything else unlocks once
+	virtual  bool   Unlock(int32 /*lCount*/, int32 * /*lpPrevCount*/=NULL)
+	{
+		return Unlock();
+	}
+
+};
+//																			  *
+//*****************************************************************************
+
+
+//---------------------------------------------------------------
+class CCMTLock
+{
+public:
+  	CCMTLock(CCMTSyncObject *pArgObj,
+  			 Uint32 unlockCount=1,
+  			 Uint32 dwTimeout=SYNC_INFINITE)
+	{
+		pObj = pArgObj;
+		UnlockCount = unlockCount;
+	  	assert(pObj);
+	  	pObj->Lock(dwTimeout);
+	}
+ 	~CCMTLock()
+	{
+	  int32 prevCnt;
+	  pObj->Unlock(UnlockCount,&prevCnt);
+	}
+protected:
+  	Uint32 UnlockCount;
+  	CCMTSyncObject *pObj;
+};
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		class CCSemaphore
+//
+//	DESCRIPTION:
+///		The classic resource counting mutual exclusion device.  A request
+///		to Lock is blocked via the scheduler until some other thread
+///		Unlocks the resource. Optionally multiple "counts" can be made
+///		available if required.
+///
+/// 	Detailed description.
+//
+//	SYNOPSIS:
+class CCSemaphore : public CCMTSyncObject
+{
+private:
+	long m_count;						// Items available
+	long m_maxCount;					// Most items available
+public:
+  	CCSemaphore(long lInitialCount = 1,
+			  long lMaxCount = 1,
+	          LPSECURITY_ATTRIBUTES lpsaAttributes = NULL);
+
+	// Take one item, waiting up to <dwTimeout> for it
+	virtual bool Lock(Uint32 dwTimeout = SYNC_INFINITE);
+
+	// Release one item
+  	virtual bool Unlock()
+	{
+	  	return Unlock(1, NULL);
+	}
+
+	// Release multiple items and return the count that was left.
+  	virtual bool Unlock(long lCount, long *lPrevCount = NULL);
+};
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		class CCMutex
+//
+//	DESCRIPTION:
+///		A scheduler based critical section mutual exclusion object. Like
+///		the WIN32 mutex the owner may lock it recursively.
+///
+/// 	Detailed description.
+//
+//	SYNOPSIS:
+class CCMutex : public CCMTSyncObject
+{
+private:
+	pthread_t m_owner;					// Owning thread
+	unsigned m_depth;					// Owner's lock count
+public:
+  	CCMutex(bool bInitiallyOwn = false,
+	      LPSECURITY_ATTRIBUTES lpsaAttribute = NULL);
+
+	virtual bool Lock(Uint32 dwTimeout = SYNC_INFINITE);
+  	bool Unlock();
+};
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		class CCEvent
+//
+//	DESCRIPTION:
+///		A scheduler based blocking event. Multiple threads can wait for the
+///		underlying event to "signal" via SetEvent to restart
+///		their execution. There is an optional time-out for the wait.
+///
+/// 	Detailed description.
+//
+//	SYNOPSIS:
+class CCEvent : public CCMTSyncObject
+{
+private:
+	bool m_signalled;					// Event is set
+	bool m_manualReset;					// Stays set until ResetEvent
+public:
+//	unsigned context;					// Some arbitrary context
+
+	CCEvent(bool bInitiallyOwn = false,
+		  bool bManualReset = true,
+	      LPSECURITY_ATTRIBUTES lpsaAttribute = NULL);
+
+	// Signal and leave signalled our event
+	bool SetEvent();
+
+	// Un-signal and block waiters
+	bool ResetEvent();
+
+	// Cause the calling thread to block until "signalled" or TimeOut
+	// occurs. Returns TRUE if wait was signalled normally.
+	bool WaitFor(unsigned TimeOut=SYNC_INFINITE);
+
+	bool Lock(Uint32 dwTimeout = SYNC_INFINITE)
+	{
+		return WaitFor(dwTimeout);
+	}
+
+	bool Unlock()
+	{
+	  	return true;
+	}
+};
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		class CCCriticalSection
+//
+//	DESCRIPTION:
+///		Create a critical section lockout. This is recursive like the
+///		WIN32 critical section.
+///
+/// 	\param xxx description
+///		\return description
+///
+/// 	Detailed description.
+//
+//	SYNOPSIS:
+class CCCriticalSection
+{
+public:
+  	CCCriticalSection()
+	{
+		pthread_mutexattr_t attr;
+		pthread_mutexattr_init(&attr);
+		pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+		pthread_mutex_init(&m_sect, &attr);
+		pthread_mutexattr_destroy(&attr);
+	}
+
+  	~CCCriticalSection()
+	{
+		pthread_mutex_destroy(&m_sect);
+	}
+
+	pthread_mutex_t *GetHandle()
+	{
+	  return &m_sect;
+	}
+	bool Unlock()
+	{
+	  	pthread_mutex_unlock(&m_sect);
+	  	return true;
+	}
+	// Critical sections wait for as long as it takes
+	bool Lock(Uint32 /*dwTimeout*/=SYNC_INFINITE)
+	{
+	  	pthread_mutex_lock(&m_sect);
+	  	return true;
+	}
+protected:
+  pthread_mutex_t m_sect;
+};
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		class CCatomicUpdate
+//
+//	DESCRIPTION:
+/**
+	Atomic increment and decrement / test object.
+**/
+//	SYNOPSIS:
+class CCatomicUpdate
+{
+private:
+	volatile LONG m_value;
+public:
+	CCatomicUpdate() {
+		m_value = 0;
+	}
+
+	LONG Incr() {
+		return __sync_add_and_fetch(&m_value, 1);
+	}
+
+	LONG Decr() {
+		return __sync_sub_and_fetch(&m_value, 1);
+	}
+
+	// Add <delta> and return the new value
+	LONG Add(LONG delta) {
+		return __sync_add_and_fetch(&m_value, delta);
+	}
+
+	LONG Value() const {
+		return m_value;
+	}
+
+	// Keep the memory accesses before this ahead of those after it
+	static void Fence() {
+		__sync_synchronize();
+	}
+
+	// Read the value, later reads are not moved ahead of it
+	LONG Fetch() const {
+		LONG value = m_value;
+		__sync_synchronize();
+		return value;
+	}
+
+	void Set(LONG newValue) {
+		__sync_lock_test_and_set(&m_value, newValue);
+		__sync_synchronize();
+	}
+
+	// Change to <newValue> and return the value it replaced
+	LONG Exchange(LONG newValue) {
+		LONG was;
+		do {
+			was = m_value;
+		} while (!__sync_bool_compare_and_swap(&m_value, was, newValue));
+		return was;
+	}
+
+	// Change to <newValue> only if it is <expected>, returns true if changed
+	bool Swap(LONG expected, LONG newValue) {
+		return __sync_bool_compare_and_swap(&m_value, expected, newValue);
+	}
+};
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		class CCseqLock
+//
+//	DESCRIPTION:
+/**
+	Sequence lock for data with a single writer and readers that must never
+	block. The writer brackets each update with WriteBegin and WriteEnd. A
+	reader copies the data between ReadBegin and ReadRetry and copies it
+	again if ReadRetry reports the writer was active.
+**/
+//	SYNOPSIS:
+class CCseqLock
+{
+private:
+	volatile LONG m_seq;				// Odd while an update is under way
+public:
+	CCseqLock() {
+		m_seq = 0;
+	}
+
+	void WriteBegin() {
+		__sync_add_and_fetch(&m_seq, 1);
+	}
+
+	void WriteEnd() {
+		__sync_add_and_fetch(&m_seq, 1);
+	}
+
+	// Wait out an update and return the sequence to check the copy with
+	LONG ReadBegin() const {
+		LONG seq;
+		while ((seq = m_seq) & 1)
+			CPU_RELAX();
+		__sync_synchronize();
+		return seq;
+	}
+
+	// Returns true if the data copied since <seq> must be copied again
+	bool ReadRetry(LONG seq) const {
+		__sync_synchronize();
+		return m_seq != seq;
+	}
+};
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		class CCspinEvent
+//
+//	DESCRIPTION:
+/**
+	Completion signal for short waits. Each SetEvent advances a count. A
+	waiter takes a Ticket before starting the work it waits on and returns
+	once the count moves past it. The waiter spins briefly before it blocks
+	and the blocking event is only signalled if a waiter has blocked.
+**/
+//	SYNOPSIS:
+class CCspinEvent
+{
+private:
+	volatile LONG m_count;				// Signals so far
+	volatile LONG m_blocked;			// Waiters blocked on m_event
+	CCEvent m_event;					// Auto-reset blocking fallback
+public:
+	CCspinEvent() : m_event(false, false) {
+		m_count = 0;
+		m_blocked = 0;
+	}
+
+	// Get the ticket to wait on for the next signal
+	LONG Ticket() {
+		return m_count;
+	}
+
+	// Restart the waiters
+	void SetEvent();
+
+	// Wait for a signal after <ticket>. Returns false on time-out.
+	bool WaitFor(LONG ticket, unsigned TimeOut=SYNC_INFINITE);
+
+	bool isOK() {
+		return m_event.isOK();
+	}
+};
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		class CCmappedFile
+//
+//	DESCRIPTION:
+/**
+	File accessed through memory mapped views. A writable file is created
+	empty and grown with Extend, the new space reads as zero. Any number of
+	views may be mapped at once, each must start at a multiple of
+	Granularity() and be released with Unmap.
+**/
+//	SYNOPSIS:
+class CCmappedFile
+{
+private:
+	int m_fd;							// File, -1 if closed
+	bool m_writable;					// Opened for writing
+public:
+	CCmappedFile();
+	~CCmappedFile();
+
+	// Open <path>, created empty when <writable>. Returns false on failure.
+	bool Open(const char *path, bool writable);
+	void Close();
+
+	// Current length of the file in octets
+	Uint64 Size() const;
+
+	// Grow a writable file to <newSize> octets
+	bool Extend(Uint64 newSize);
+
+	// Map <len> octets at <offset>, NULL on failure
+	void *Map(Uint64 offset, size_t len);
+
+	// Release a view returned by Map
+	static void Unmap(void *view, size_t len);
+
+	// Start writing a view's changes to the file
+	static void Flush(void *view, size_t len);
+
+	// Views start at a multiple of this
+	static size_t Granularity();
+
+	bool isOK() const;
+};
+//																			  *
+//*****************************************************************************
+
+
+
+#endif
+//=============================================================================
+//	END OF FILE tekEventsLinux.h
+//=============================================================================
@@ -0,0 +1,1204 @@
+//	SerialLinux.cpp - Implementation of the CSerial class for POSIX termios
+//
+//	Copyright (C) 1999-2003 Ramon de Klein (Ramon.de.Klein@ict.nl)
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+//////////////////////////////////////////////////////////////////////
+// Include the standard header files
+
+#include "SerialEx.h"
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <limits.h>
+#include <time.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/ioctl.h>
+#include <linux/serial.h>
+
+
+//////////////////////////////////////////////////////////////////////
+// Debug tracing
+
+#define TRACE_PORT		0
+
+// glibc does not export the termios2 interface used for arbitrary rates,
+// the layout matches the kernel's asm/termbits.h. TCGETS2/TCSETS2 expand
+// sizeof(struct termios2) so the tag must match too.
+#if defined(TCGETS2)
+struct termios2 {
+	tcflag_t c_iflag;
+	tcflag_t c_oflag;
+	tcflag_t c_cflag;
+	tcflag_t c_lflag;
+	cc_t c_line;
+	cc_t c_cc[19];
+	speed_t c_ispeed;
+	speed_t c_ospeed;
+};
+#ifndef BOTHER
+#define BOTHER 0010000
+#endif
+#endif
+
+// Error numbers that mean the port cannot be used by us
+static CSerial::SERAPI_ERR translateOSerrToSerErr(int errNum)
+{
+	switch (errNum) {
+	case ENOENT:
+	case ENODEV:
+	case ENXIO:
+	case EACCES:
+	case EBUSY:
+		// The specified port does not exist or is owned by another
+		return CSerial::API_ERROR_PORT_UNAVAILABLE;
+
+	default:
+		// Something else is wrong
+		return CSerial::SERAPI_ERR(errNum);
+	}
+}
+
+// Sleep for <ms> milliseconds
+static void serSleep(DWORD ms)
+{
+	struct timespec ts;
+	ts.tv_sec = ms / 1000;
+	ts.tv_nsec = (long)(ms % 1000) * 1000000L;
+	while (nanosleep(&ts, &ts) && errno == EINTR)
+		;
+}
+
+// Interrupts TIOCMIWAIT, nothing else to do
+static void serWakeHandler(int)
+{
+}
+
+// Milliseconds on the monotonic clock
+static Uint32 serTickMs()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (Uint32)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+// Map <rate> to its Bxxx constant, returns false for non-standard rates
+static bool baudToSpeed(nodeulong rate, speed_t *pSpeed)
+{
+	static const struct { nodeulong rate; speed_t speed; } speeds[] = {
+		{ 9600, B9600 }, { 19200, B19200 }, { 38400, B38400 },
+		{ 57600, B57600 }, { 115200, B115200 }, { 230400, B230400 },
+		#ifdef B460800
+		{ 460800, B460800 },
+		#endif
+		#ifdef B921600
+		{ 921600, B921600 },
+		#endif
+		#ifdef B1000000
+		{ 1000000, B1000000 },
+		#endif
+		#ifdef B2000000
+		{ 2000000, B2000000 },
+		#endif
+	};
+	for (size_t i = 0; i < sizeof(speeds)/sizeof(speeds[0]); i++) {
+		if (speeds[i].rate == rate) {
+			*pSpeed = speeds[i].speed;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CSerial::CSerial
+//
+//	AUTHOR:
+//		Ramon de Klein (Ramon.de.Klein@ict.nl)
+//
+//	DESCRIPTION:
+///		Construction/Destruction
+//
+//	SYNOPSIS:
+CSerial::CSerial ()
+	: m_lLastError(API_ERROR_SUCCESS)
+	, m_fd(-1)
+	, m_eEvent(EEventNone)
+	, m_dwEventMask(0)
+	, m_DTRBit(EDTRClear)
+	, m_RTSBit(ERTSClear)
+	, m_baudRate(EBaudUnknown)
+	, m_iCountOK(false)
+	, m_lastCTS(false)
+	, m_errPending(0)
+	, m_modemThreadUp(false)
+	, m_modemStop(false)
+	, m_modemWaitOK(false)
+{
+	m_wakeFd = m_epollFd = -1;
+	memset(&m_iCount, 0, sizeof(m_iCount));
+	m_lLastRdError = m_lLastWrError = API_ERROR_UNKNOWN;
+}
+
+CSerial::~CSerial ()
+{
+	// If the device is already closed,
+	// then we don't need to do anything.
+	if (m_fd >= 0) {
+		// Close implicitly
+		Close();
+	}
+}
+//																			 *
+//****************************************************************************
+
+CSerial::EPort CSerial::CheckPort (LPCTSTR lpszDevice)
+{
+	int fd = ::open(lpszDevice, O_RDWR|O_NOCTTY|O_NONBLOCK|O_CLOEXEC);
+	if (fd < 0) {
+		switch (errno) {
+		case ENOENT:
+		case ENODEV:
+		case ENXIO:
+			return EPortNotAvailable;
+		case EBUSY:
+		case EACCES:
+			return EPortInUse;
+		default:
+			return EPortUnknownError;
+		}
+	}
+	::close(fd);
+	return EPortAvailable;
+}
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CSerial::Open
+//
+//	DESCRIPTION:
+///		Open the port for exclusive raw access. The read side is set to
+///		return immediately with what has arrived, Read waits in epoll.
+///		The queue sizes and overlapped flag are Win32 settings and are
+///		ignored, the kernel sizes the tty buffers.
+//
+//	SYNOPSIS:
+CSerial::SERAPI_ERR CSerial::Open (
+	LPCTSTR lpszDevice,
+	DWORD /*dwInQueue*/,
+	DWORD /*dwOutQueue*/,
+	bool /*fOverlapped*/)
+{
+	struct termios tio;
+
+	// Reset error state
+	m_lLastError = API_ERROR_SUCCESS;
+
+	// Check if the port isn't already opened
+	if (m_fd >= 0)
+	{
+		m_lLastError = CSerial::SERAPI_ERR(EALREADY);
+		_RPTF0(_CRT_WARN,"CSerial::Open - Port already opened\n");
+		return m_lLastError;
+	}
+
+	// Open the device, O_NONBLOCK so a missing carrier cannot hang us
+	m_fd = ::open(lpszDevice, O_RDWR|O_NOCTTY|O_NONBLOCK|O_CLOEXEC);
+	#if TRACE_PORT
+		_RPTF1(_CRT_WARN, "CSerial::Open port = fd=%d\n", m_fd);
+	#endif
+	if (m_fd < 0) {
+		// Display error
+		m_lLastError = translateOSerrToSerErr(errno);
+		_RPTF1(_CRT_WARN, "CSerial::Open - Unable to open port err=%d\n", errno);
+		return m_lLastError;
+	}
+	// Match the Win32 share mode of 0
+	if (::ioctl(m_fd, TIOCEXCL) < 0 && errno != ENOTTY) {
+		m_lLastError = translateOSerrToSerErr(errno);
+		Close();
+		return API_ERROR_PORT_UNAVAILABLE;
+	}
+	// Raw mode with the receiver on and modem control lines ignored
+	if (::tcgetattr(m_fd, &tio) < 0) {
+		m_lLastError = translateOSerrToSerErr(errno);
+		_RPTF0(_CRT_WARN,"CSerial::Open - Not a terminal device\n");
+		Close();
+		return API_ERROR_PORT_SETUP;
+	}
+	::cfmakeraw(&tio);
+	tio.c_cflag |= CLOCAL|CREAD;
+	tio.c_cflag &= ~CRTSCTS;
+	tio.c_iflag &= ~(IXON|IXOFF|IXANY);
+	tio.c_cc[VMIN] = 0;
+	tio.c_cc[VTIME] = 0;
+	if (::tcsetattr(m_fd, TCSANOW, &tio) < 0) {
+		m_lLastError = translateOSerrToSerErr(errno);
+		Close();
+		return API_ERROR_PORT_SETUP;
+	}
+	// From here on waits happen in epoll, the descriptor can block
+	::fcntl(m_fd, F_SETFL, ::fcntl(m_fd, F_GETFL) & ~O_NONBLOCK);
+
+	// Read waits for data on the port or a cancel on the eventfd
+	m_wakeFd = ::eventfd(0, EFD_NONBLOCK|EFD_CLOEXEC);
+	m_epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+	if (m_wakeFd < 0 || m_epollFd < 0) {
+		SERAPI_ERR fdErr = CSerial::SERAPI_ERR(errno);
+		Close();
+		m_lLastError = fdErr;
+		return m_lLastError;
+	}
+	struct epoll_event ev;
+	ev.events = EPOLLIN;
+	ev.data.fd = m_fd;
+	::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_fd, &ev);
+	ev.data.fd = m_wakeFd;
+	::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &ev);
+
+	setLowLatency(lpszDevice);
+
+	// Setup outputs used for brakes to engage brake
+	SetDTR(m_DTRBit==EDTRSet);
+	SetRTS(m_RTSBit==ERTSSet);
+
+	// Setup the default communication mask
+	SetEventMask();
+
+	// Non-blocking reads is default
+	SetupReadTimeouts(EReadTimeoutNonblocking);
+
+	// Baseline the line counters so old events are not reported
+	m_iCountOK = true;
+	m_errPending = 0;
+	sampleEvents();
+	m_errPending = 0;
+
+	// CTS edges now arrive as events where the driver allows
+	startModemWatch();
+
+	// Return successful
+	return m_lLastError;
+}
+
+
+CSerial::SERAPI_ERR CSerial::Close (void)
+{
+	// Reset error state
+	m_lLastError = API_ERROR_SUCCESS;
+
+	// If the device is already closed,
+	// then we don't need to do anything.
+	if (m_fd < 0)
+		return m_lLastError;
+
+	// Insure all open work has stopped
+	stopModemWatch();
+	CancelCommIo();
+	m_commEvent.SetEvent();
+	ReadLock.Lock();
+	#if TRACE_PORT
+		_RPTF1(_CRT_WARN, "CSerial::Close port; fd=%d\n", m_fd);
+	#endif
+	::close(m_fd);
+	m_fd = -1;
+	if (m_epollFd >= 0)
+		::close(m_epollFd);
+	if (m_wakeFd >= 0)
+		::close(m_wakeFd);
+	m_wakeFd = m_epollFd = -1;
+	ReadLock.Unlock();
+
+	// Return successful
+	return m_lLastError;
+}
+//																			 *
+//****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CSerial::setLowLatency
+//
+//	DESCRIPTION:
+///		Ask the tty driver to push received characters to us without
+///		buffering delay. USB adapters (FTDI and friends) also batch input
+///		for their latency timer, 16ms by default, set it to its 1ms
+///		minimum when the sysfs attribute is writable. Both are best effort,
+///		pseudo-terminals and unprivileged users just run slower.
+//
+//	SYNOPSIS:
+void CSerial::setLowLatency(const char *lpszDevice)
+{
+	struct serial_struct ss;
+	if (::ioctl(m_fd, TIOCGSERIAL, &ss) == 0) {
+		ss.flags |= ASYNC_LOW_LATENCY;
+		if (::ioctl(m_fd, TIOCSSERIAL, &ss) < 0) {
+			_RPTF1(_CRT_WARN,"CSerial::Open - ASYNC_LOW_LATENCY failed err=%d\n", errno);
+		}
+	}
+
+	char realDev[PATH_MAX];
+	char sysPath[PATH_MAX + 64];
+	const char *base;
+	if (!::realpath(lpszDevice, realDev))
+		return;
+	base = strrchr(realDev, '/');
+	base = base ? base + 1 : realDev;
+	snprintf(sysPath, sizeof(sysPath),
+			 "/sys/bus/usb-serial/devices/%s/latency_timer", base);
+	int fd = ::open(sysPath, O_WRONLY|O_CLOEXEC);
+	if (fd >= 0) {
+		if (::write(fd, "1", 1) != 1) {
+			_RPTF1(_CRT_WARN,"CSerial::Open - latency_timer failed err=%d\n", errno);
+		}
+		::close(fd);
+	}
+}
+//																			 *
+//****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CSerial::Setup
+//
+//	DESCRIPTION:
+///		Set the line format and rate. Rates without a Bxxx constant, such
+///		as the network rates selected by infcSetNetRate, are programmed
+///		directly with termios2/BOTHER.
+//
+//	SYNOPSIS:
+CSerial::SERAPI_ERR CSerial::Setup (
+		nodeulong eBaudrate,
+		EDataBits eDataBits,
+		EParity eParity,
+		EStopBits eStopBits,
+		EDTR eDTRBit,
+		ERTS eRTSBit)
+{
+	struct termios tio;
+	speed_t speed;
+	bool stdRate;
+
+	// Reset error state
+	m_lLastError = API_ERROR_SUCCESS;
+
+	// Check if the device is open
+	if (m_fd < 0)
+	{
+		// Set the internal error code
+		m_lLastError = API_ERROR_INVALID_HANDLE;
+
+		// Issue an error and quit
+		_RPTF0(_CRT_WARN,"CSerial::Setup - Device is not opened\n");
+		return m_lLastError;
+	}
+
+	if (::tcgetattr(m_fd, &tio) < 0)
+	{
+		// Obtain the error code
+		m_lLastError = translateOSerrToSerErr(errno);
+		// Display a warning
+		_RPTF0(_CRT_WARN,"CSerial::Setup - Unable to obtain termios information\n");
+		return m_lLastError;
+	}
+
+	// Set the new data
+	tio.c_cflag &= ~(CSIZE|CSTOPB|PARENB|PARODD|CMSPAR);
+	switch (eDataBits) {
+	case EData5: tio.c_cflag |= CS5; break;
+	case EData6: tio.c_cflag |= CS6; break;
+	case EData7: tio.c_cflag |= CS7; break;
+	default:	 tio.c_cflag |= CS8; break;
+	}
+	switch (eParity) {
+	case EParOdd:	tio.c_cflag |= PARENB|PARODD; break;
+	case EParEven:	tio.c_cflag |= PARENB; break;
+	case EParMark:	tio.c_cflag |= PARENB|PARODD|CMSPAR; break;
+	case EParSpace:	tio.c_cflag |= PARENB|CMSPAR; break;
+	default: break;
+	}
+	if (eStopBits == EStop2)
+		tio.c_cflag |= CSTOPB;
+
+	// Standard rates go through termios, others are fixed up below
+	stdRate = baudToSpeed(eBaudrate, &speed);
+	if (stdRate)
+		::cfsetspeed(&tio, speed);
+
+	// Set the new termios structure
+	if (::tcsetattr(m_fd, TCSANOW, &tio) < 0)
+	{
+		// Obtain the error code
+		m_lLastError = translateOSerrToSerErr(errno);
+
+		// Display a warning
+		_RPTF1(_CRT_WARN,"CSerial::Setup - Unable to set termios information, err=%d\n", errno);
+		return m_lLastError;
+	}
+
+	if (!stdRate) {
+	#if defined(TCGETS2)
+		struct termios2 tio2;
+		if (::ioctl(m_fd, TCGETS2, &tio2) == 0) {
+			tio2.c_cflag &= ~CBAUD;
+			tio2.c_cflag |= BOTHER;
+			tio2.c_ispeed = tio2.c_ospeed = (speed_t)eBaudrate;
+			if (::ioctl(m_fd, TCSETS2, &tio2) < 0) {
+				m_lLastError = API_ERROR_INVALID_ARG;
+				_RPTF1(_CRT_WARN,"CSerial::Setup - Rate %lu not supported\n", (unsigned long)eBaudrate);
+				return m_lLastError;
+			}
+		}
+		else if (errno != ENOTTY && errno != EINVAL) {
+			m_lLastError = translateOSerrToSerErr(errno);
+			return m_lLastError;
+		}
+	#else
+		m_lLastError = API_ERROR_INVALID_ARG;
+		return m_lLastError;
+	#endif
+	}
+	m_baudRate = eBaudrate;
+
+	SetDTR(eDTRBit == EDTRSet);
+	SetRTS(eRTSBit == ERTSSet);
+	// Return successful
+	return m_lLastError;
+}
+//																			 *
+//****************************************************************************
+
+
+CSerial::SERAPI_ERR CSerial::SetEventMask (DWORD dwEventMask)
+{
+	// Reset error state
+	m_lLastError = API_ERROR_SUCCESS;
+
+	// Check if the device is open
+	if (m_fd < 0)
+	{
+		// Set the internal error code
+		m_lLastError = API_ERROR_INVALID_HANDLE;
+
+		// Issue an error and quit
+		_RPTF0(_CRT_WARN,"CSerial::SetMask - Device is not opened\n");
+		return m_lLastError;
+	}
+
+	// Save event mask and release any waiter with EEventNone
+	m_dwEventMask = dwEventMask;
+	m_commEvent.SetEvent();
+	return m_lLastError;
+}
+//																			 *
+//****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CSerial::sampleEvents
+//
+//	DESCRIPTION:
+///		Compare the driver's interrupt counters with the last sample and
+///		return the EEvent bits for what changed. Line errors are
+///		accumulated for GetError. Drivers without TIOCGICOUNT are
+///		watched for CTS level changes only.
+//
+//	SYNOPSIS:
+DWORD CSerial::sampleEvents(void)
+{
+	DWORD evts = 0, errs = 0;
+	struct serial_icounter_struct ic;
+
+	if (m_iCountOK && ::ioctl(m_fd, TIOCGICOUNT, &ic) == 0) {
+		if (ic.cts != m_iCount.cts)
+			evts |= EEventCTS;
+		if (ic.brk != m_iCount.brk) {
+			evts |= EEventBreak;
+			errs |= EErrorBreak;
+		}
+		if (ic.frame != m_iCount.frame)
+			errs |= EErrorFrame;
+		if (ic.overrun != m_iCount.overrun)
+			errs |= EErrorOverrun;
+		if (ic.parity != m_iCount.parity)
+			errs |= EErrorParity;
+		if (ic.buf_overrun != m_iCount.bufOverrun)
+			errs |= EErrorRxOver;
+		m_iCount.cts = ic.cts;
+		m_iCount.brk = ic.brk;
+		m_iCount.frame = ic.frame;
+		m_iCount.overrun = ic.overrun;
+		m_iCount.parity = ic.parity;
+		m_iCount.bufOverrun = ic.buf_overrun;
+		if (errs & ~EErrorBreak)
+			evts |= EEventError;
+		if (errs)
+			__sync_fetch_and_or(&m_errPending, errs);
+	}
+	else {
+		bool cts;
+		m_iCountOK = false;
+		cts = GetCTS();
+		if (cts != m_lastCTS)
+			evts |= EEventCTS;
+		m_lastCTS = cts;
+	}
+	return evts;
+}
+//																			 *
+//****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CSerial::startModemWatch/stopModemWatch
+//
+//	DESCRIPTION:
+///		Run a thread that blocks in TIOCMIWAIT and signals the comm event
+///		on each CTS edge. The ioctl can only be released by a signal, so
+///		SERIAL_WAKE_SIGNAL is claimed with a handler that does nothing and
+///		no SA_RESTART. If the signal belongs to the application, or the
+///		driver has no TIOCMIWAIT, m_modemWaitOK stays false and
+///		CommEventWaitInitiate polls as before.
+//
+//	SYNOPSIS:
+void CSerial::startModemWatch(void)
+{
+	struct sigaction sa, was;
+
+	m_modemStop = false;
+	m_modemWaitOK = false;
+	if (::sigaction(SERIAL_WAKE_SIGNAL, NULL, &was) < 0)
+		return;
+	if ((was.sa_flags & SA_SIGINFO) || was.sa_handler != serWakeHandler) {
+		if ((was.sa_flags & SA_SIGINFO) || was.sa_handler != SIG_DFL)
+			return;
+		memset(&sa, 0, sizeof(sa));
+		sa.sa_handler = serWakeHandler;
+		sigemptyset(&sa.sa_mask);
+		if (::sigaction(SERIAL_WAKE_SIGNAL, &sa, NULL) < 0)
+			return;
+	}
+	m_modemWaitOK = true;
+	if (::pthread_create(&m_modemThread, NULL, modemWatch, this) != 0) {
+		m_modemWaitOK = false;
+		return;
+	}
+	m_modemThreadUp = true;
+}
+
+void CSerial::stopModemWatch(void)
+{
+	if (!m_modemThreadUp)
+		return;
+	m_modemStop = true;
+	// A signal that lands before the watcher blocks is lost, repeat
+	// until it has left
+	while (::pthread_tryjoin_np(m_modemThread, NULL) == EBUSY) {
+		::pthread_kill(m_modemThread, SERIAL_WAKE_SIGNAL);
+		serSleep(1);
+	}
+	m_modemThreadUp = false;
+	m_modemWaitOK = false;
+}
+
+void *CSerial::modemWatch(void *pSerial)
+{
+	CSerial *pPort = (CSerial *)pSerial;
+	sigset_t wake;
+
+	sigemptyset(&wake);
+	sigaddset(&wake, SERIAL_WAKE_SIGNAL);
+	::pthread_sigmask(SIG_UNBLOCK, &wake, NULL);
+	while (!pPort->m_modemStop) {
+		if (::ioctl(pPort->m_fd, TIOCMIWAIT, TIOCM_CTS) < 0) {
+			if (errno == EINTR)
+				continue;
+			// Driver cannot wait on the modem lines, fall back to polling
+			pPort->m_modemWaitOK = false;
+			pPort->m_commEvent.SetEvent();
+			break;
+		}
+		pPort->m_commEvent.SetEvent();
+	}
+	return NULL;
+}
+//																			 *
+//****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CSerial::CommEventWaitInitiate
+//
+//	DESCRIPTION:
+///		Wait for one of the events that are enabled via SetEventMask. The
+///		comm event is signalled by the TIOCMIWAIT watcher on a CTS edge,
+///		by ForceCommEvent and by a mask change. Each wake samples the
+///		counters for the cause, a wake with none reports EEventNone.
+///
+///		Between wakes the counters are sampled every SERIAL_LINE_POLL_MS
+///		for breaks and line errors. Without the watcher the sample runs
+///		every SERIAL_MODEM_POLL_MS, which then bounds the CTS latency.
+///
+///		\return 0 when GetEventType has the cause, error if port closed.
+//
+//	SYNOPSIS:
+CSerial::SERAPI_ERR CSerial::CommEventWaitInitiate()
+{
+	DWORD found;
+	for (;;) {
+		if (m_fd < 0) {
+			m_lLastError = API_ERROR_INVALID_HANDLE;
+			return m_lLastError;
+		}
+		// Data is picked up by the blocked reader, never report it
+		found = sampleEvents() & m_dwEventMask & ~DWORD(EEventRecv);
+		if (found) {
+			m_eEvent = EEvent(found);
+			return(API_ERROR_SUCCESS);
+		}
+		if (m_commEvent.WaitFor(m_modemWaitOK ? SERIAL_LINE_POLL_MS
+											  : SERIAL_MODEM_POLL_MS)) {
+			m_commEvent.ResetEvent();
+			if (m_fd < 0)
+				return(API_ERROR_INVALID_HANDLE);
+			m_eEvent = EEvent(sampleEvents() & m_dwEventMask & ~DWORD(EEventRecv));
+			return(API_ERROR_SUCCESS);
+		}
+	}
+}
+//																			  *
+//*****************************************************************************
+
+
+CSerial::EEvent CSerial::GetEventType (void)
+{
+	// Obtain the event
+	EEvent eEvent = m_eEvent;
+
+	// Reset internal event type
+	m_eEvent = EEventNone;
+
+	// Return the current cause
+	return eEvent;
+}
+//																			 *
+//****************************************************************************
+
+
+LONG CSerial::SetupReadTimeouts (EReadTimeout eReadTimeout)
+{
+	struct termios tio;
+
+	// Reset error state
+	m_lLastError = API_ERROR_SUCCESS;
+
+	// Check if the device is open
+	if (m_fd < 0)
+	{
+		// Set the internal error code
+		m_lLastError = API_ERROR_INVALID_HANDLE;
+
+		// Issue an error and quit
+		_RPTF0(_CRT_WARN,"CSerial::SetupReadTimeouts - Device is not opened\n");
+		return m_lLastError;
+	}
+
+	if (::tcgetattr(m_fd, &tio) < 0)
+	{
+		m_lLastError = translateOSerrToSerErr(errno);
+		return m_lLastError;
+	}
+
+	// VTIME is left at zero in both modes, the inter-character timer
+	// would hold completed packets for up to a tenth of a second.
+	switch (eReadTimeout)
+	{
+	case EReadTimeoutBlocking:
+		tio.c_cc[VMIN] = 1;
+		tio.c_cc[VTIME] = 0;
+		break;
+	case EReadTimeoutNonblocking:
+		tio.c_cc[VMIN] = 0;
+		tio.c_cc[VTIME] = 0;
+		break;
+	default:
+		// This shouldn't be possible
+		m_lLastError = API_ERROR_INVALID_ARG;
+		return m_lLastError;
+	}
+
+	if (::tcsetattr(m_fd, TCSANOW, &tio) < 0)
+	{
+		m_lLastError = translateOSerrToSerErr(errno);
+		_RPTF0(_CRT_WARN,"CSerial::SetupReadTimeouts - Unable to set timeout information\n");
+		return m_lLastError;
+	}
+
+	// Return successful
+	return m_lLastError;
+}
+//																			 *
+//****************************************************************************
+
+nodeulong CSerial::GetBaudrate (void)
+{
+	// Reset error state
+	m_lLastError = API_ERROR_SUCCESS;
+
+	// Check if the device is open
+	if (m_fd < 0)
+	{
+		// Set the internal error code
+		m_lLastError = API_ERROR_INVALID_HANDLE;
+
+		// Issue an error and quit
+		_RPTF0(_CRT_WARN,"CSerial::GetBaudrate - Device is not opened\n");
+		return EBaudUnknown;
+	}
+	return m_baudRate;
+}
+//																			 *
+//****************************************************************************
+
+
+bool CSerial::GetDTR(void)
+{
+	return m_DTRBit == EDTRSet;
+}
+
+void CSerial::SetDTR(bool EDTRBit)
+{
+	int bits = TIOCM_DTR;
+	m_DTRBit = EDTRBit ? EDTRSet : EDTRClear;
+	if (m_fd >= 0)
+		::ioctl(m_fd, EDTRBit ? TIOCMBIS : TIOCMBIC, &bits);
+}
+
+bool CSerial::GetRTS(void)
+{
+	return m_RTSBit == ERTSSet;
+}
+
+void CSerial::SetRTS(bool ERTSBit)
+{
+	int bits = TIOCM_RTS;
+	m_RTSBit = ERTSBit ? ERTSSet : ERTSClear;
+	if (m_fd >= 0)
+		::ioctl(m_fd, ERTSBit ? TIOCMBIS : TIOCMBIC, &bits);
+}
+//																			 *
+//****************************************************************************
+
+DWORD CSerial::GetEventMask (void)
+{
+	// Reset error state
+	m_lLastError = API_ERROR_SUCCESS;
+
+	// Check if the device is open
+	if (m_fd < 0)
+	{
+		// Set the internal error code
+		m_lLastError = API_ERROR_INVALID_HANDLE;
+
+		// Issue an error and quit
+		_RPTF0(_CRT_WARN,"CSerial::GetEventMask - Device is not opened\n");
+		return 0;
+	}
+
+	// Return the event mask
+	return m_dwEventMask;
+}
+//																			 *
+//****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CSerial Write
+//
+//	DESCRIPTION:
+//		Write data to port, waiting as long as <dwTimeout> for room.
+//
+//	SYNOPSIS:
+CSerial::SERAPI_ERR CSerial::Write (const void* pData, size_t iLen,
+					 DWORD* pdwWritten, DWORD dwTimeout)
+{
+	const char *pNext = (const char *)pData;
+	Uint32 startAt = serTickMs(), waited;
+	struct pollfd pfd;
+	ssize_t nOut;
+	int waitMs;
+
+	// Reset error state
+	m_lLastWrError = API_ERROR_SUCCESS;
+
+	// Use our own variable for write count
+	DWORD dwWritten;
+	if (pdwWritten == 0) {
+		pdwWritten = &dwWritten;
+	}
+
+	// Reset the number of bytes written
+	*pdwWritten = 0;
+
+	// Check if the device is open
+	if (m_fd < 0) {
+		// Set the internal error code
+		m_lLastWrError = API_ERROR_INVALID_HANDLE;
+
+		// Issue an error and quit
+		_RPTF0(_CRT_WARN,"CSerial::Write - Device is not opened\n");
+		return m_lLastWrError;
+	}
+
+	while (iLen) {
+		waitMs = -1;
+		if ((Uint32)dwTimeout != INFINITE) {
+			waited = serTickMs() - startAt;
+			waitMs = waited >= (Uint32)dwTimeout ? 0 : int((Uint32)dwTimeout - waited);
+		}
+		pfd.fd = m_fd;
+		pfd.events = POLLOUT;
+		pfd.revents = 0;
+		int rc = ::poll(&pfd, 1, waitMs);
+		if (rc < 0 && errno == EINTR)
+			continue;
+		if (rc < 0) {
+			m_lLastWrError = CSerial::SERAPI_ERR(errno);
+			break;
+		}
+		if (rc == 0) {
+			m_lLastWrError = API_ERROR_TIMEOUT;
+			break;
+		}
+		nOut = ::write(m_fd, pNext, iLen);
+		if (nOut < 0) {
+			if (errno == EINTR || errno == EAGAIN)
+				continue;
+			m_lLastWrError = CSerial::SERAPI_ERR(errno);
+			_RPTF1(_CRT_WARN,"CSerial::Write - Unable to write the data err=%d\n", errno);
+			break;
+		}
+		pNext += nOut;
+		iLen -= size_t(nOut);
+		*pdwWritten += DWORD(nOut);
+	}
+
+	// Return the result
+	return m_lLastWrError;
+}
+
+CSerial::SERAPI_ERR CSerial::Write (const char *pString, DWORD* pdwWritten, DWORD dwTimeout)
+{
+	// Determine the length of the string
+	return Write(pString,strlen(pString),pdwWritten,dwTimeout);
+}
+//																			 *
+//****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CSerialEx::GetCharsAvailable
+//
+//	DESCRIPTION:
+///		Return the count of characters available for reading.
+//
+//	SYNOPSIS:
+LONG CSerialEx::GetCharsAvailable(void)
+{
+	int nAvail;
+	if (m_fd >= 0 && ::ioctl(m_fd, FIONREAD, &nAvail) == 0) {
+		return(nAvail);
+	}
+	return(0);
+}
+
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CSerial::Read
+//
+//	DESCRIPTION:
+///		Wait as long as <dwTimeout> for data and return what has arrived.
+///		A time-out returns success with nothing read, as on Win32.
+///		CancelCommIo releases the wait with ECANCELED.
+///
+///		\return 0 if SUCCESS, else an error code.
+//
+//	SYNOPSIS:
+CSerial::SERAPI_ERR CSerial::Read(void* pData, size_t iLen, DWORD* pdwRead, DWORD dwTimeout)
+{
+	struct epoll_event evs[2];
+	bool dataReady = false, cancelled = false, hungUp = false;
+	uint64_t wakes;
+	int rc, i, waitMs;
+	ssize_t nIn;
+
+	// Reset error state
+	m_lLastRdError = API_ERROR_SUCCESS;
+
+	// Use our own variable for read count
+	DWORD dwRead;
+	if (pdwRead == 0) {
+		pdwRead = &dwRead;
+	}
+	// Reset the number of bytes read
+	*pdwRead = 0;
+
+	// Check if the device is open
+	if (m_fd < 0) {
+		// Set the internal error code
+		m_lLastRdError = API_ERROR_INVALID_HANDLE;
+
+		// Issue an error and quit
+		_RPTF0(_CRT_WARN, "CSerial::Read - Device is not opened\n");
+		return m_lLastRdError;
+	}
+
+	ReadLock.Lock();
+	waitMs = ((Uint32)dwTimeout == INFINITE) ? -1 : int(dwTimeout);
+	do {
+		rc = ::epoll_wait(m_epollFd, evs, 2, waitMs);
+	} while (rc < 0 && errno == EINTR);
+	if (rc < 0)
+		m_lLastRdError = CSerial::SERAPI_ERR(errno);
+	for (i = 0; i < rc; i++) {
+		if (evs[i].data.fd == m_wakeFd)
+			cancelled = true;
+		else if (evs[i].events & EPOLLIN)
+			dataReady = true;
+		else if (evs[i].events & (EPOLLHUP|EPOLLERR))
+			hungUp = true;
+	}
+
+	if (cancelled) {
+		// Consume the cancel so the next reader blocks
+		if (::read(m_wakeFd, &wakes, sizeof(wakes)) < 0) {
+			_RPTF1(_CRT_WARN, "CSerial::Read - wake read err=%d\n", errno);
+		}
+		m_lLastRdError = CSerial::SERAPI_ERR(ECANCELED);
+	}
+	else if (dataReady) {
+		nIn = ::read(m_fd, pData, iLen);
+		if (nIn > 0)
+			*pdwRead = DWORD(nIn);
+		else if (nIn < 0 && errno != EAGAIN && errno != EINTR)
+			m_lLastRdError = CSerial::SERAPI_ERR(errno);
+	}
+	else if (hungUp) {
+		// Device gone; hold off for the time-out or a cancel so callers
+		// that retry on error do not spin.
+		struct pollfd pfd;
+		pfd.fd = m_wakeFd;
+		pfd.events = POLLIN;
+		if (::poll(&pfd, 1, waitMs) > 0) {
+			if (::read(m_wakeFd, &wakes, sizeof(wakes)) < 0) {
+				_RPTF1(_CRT_WARN, "CSerial::Read - wake read err=%d\n", errno);
+			}
+		}
+		m_lLastRdError = CSerial::SERAPI_ERR(EIO);
+	}
+	ReadLock.Unlock();
+	return m_lLastRdError;
+}
+//																			 *
+//****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CSerial::CancelCommIo
+//
+//	DESCRIPTION:
+///		Release a thread blocked in Read.
+//
+//	SYNOPSIS:
+CSerial::SERAPI_ERR CSerial::CancelCommIo (void)
+{
+	uint64_t one = 1;
+	if (m_wakeFd >= 0) {
+		// A saturated counter already has a cancel pending
+		if (::write(m_wakeFd, &one, sizeof(one)) < 0 && errno != EAGAIN)
+			return CSerial::SERAPI_ERR(errno);
+	}
+	m_rdEvent.SetEvent();
+	return API_ERROR_SUCCESS;
+}
+//																			 *
+//****************************************************************************
+
+CSerial::SERAPI_ERR CSerial::Purge()
+{
+	// Reset error state
+	m_lLastError = API_ERROR_SUCCESS;
+
+	// Check if the device is open
+	if (m_fd < 0) {
+		// Set the internal error code
+		m_lLastError = API_ERROR_INVALID_HANDLE;
+
+		// Issue an error and quit
+		_RPTF0(_CRT_WARN,"CSerial::Purge - Device is not opened\n");
+		return m_lLastError;
+	}
+	// Clear any break that maybe in progress
+	::ioctl(m_fd, TIOCCBRK);
+	// Drop anything queued either way
+	if (::tcflush(m_fd, TCIOFLUSH) < 0) {
+		m_lLastError = CSerial::SERAPI_ERR(errno);
+		_RPTF1(_CRT_WARN,"CSerial::Purge - tcflush failed result %d\n", m_lLastError);
+	}
+	// Clear the accumulated errors
+	__sync_fetch_and_and(&m_errPending, 0);
+	// Return successfully
+	return m_lLastError;
+}
+//																			 *
+//****************************************************************************
+
+
+CSerial::SERAPI_ERR CSerial::Break (DWORD breakDurationMs)
+{
+	// Reset error state
+	m_lLastError = API_ERROR_SUCCESS;
+
+	// Check if the device is open
+	if (m_fd < 0)
+	{
+		// Set the internal error code
+		m_lLastError = API_ERROR_INVALID_HANDLE;
+
+		// Issue an error and quit
+		_RPTF0(_CRT_WARN,"CSerial::Break - Device is not opened\n");
+		return m_lLastError;
+	}
+
+	// Set the port in break mode for a little while. Pseudo-terminals
+	// have no line to break, let them through.
+	if (::ioctl(m_fd, TIOCSBRK) < 0) {
+		if (errno == ENOTTY || errno == EINVAL)
+			return m_lLastError;
+		m_lLastError = API_ERROR_PORT_UNAVAILABLE;
+		return(m_lLastError);
+	}
+	serSleep(breakDurationMs);
+	if (::ioctl(m_fd, TIOCCBRK) < 0) {
+		m_lLastError = API_ERROR_PORT_UNAVAILABLE;
+		return(m_lLastError);
+	}
+
+	// Return successfully
+	return m_lLastError;
+}
+//																			 *
+//****************************************************************************
+
+CSerial::EError CSerial::GetError (void)
+{
+	// Reset error state
+	m_lLastError = API_ERROR_SUCCESS;
+
+	// Check if the device is open
+	if (m_fd < 0)
+	{
+		// Set the internal error code
+		m_lLastError = API_ERROR_INVALID_HANDLE;
+
+		// Issue an error and quit
+		_RPTF0(_CRT_WARN,"CSerial::GetError - Device is not opened\n");
+		return EErrorUnknown;
+	}
+
+	// Return and clear the errors seen since last time
+	return EError(__sync_fetch_and_and(&m_errPending, 0));
+}
+//																			 *
+//****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CSerial::GetCTS/GetDSR
+//
+//	DESCRIPTION:
+///		Read the modem status lines. Devices without modem control, such
+///		as pseudo-terminals, report the lines asserted as a three wire
+///		link has nothing to say otherwise.
+//
+//	SYNOPSIS:
+bool CSerial::GetCTS (void)
+{
+	int lines;
+
+	// Reset error state
+	m_lLastError = API_ERROR_SUCCESS;
+
+	if (::ioctl(m_fd, TIOCMGET, &lines) < 0)
+	{
+		if (errno == ENOTTY || errno == EINVAL)
+			return true;
+		// Obtain the error code
+		m_lLastError = (SERAPI_ERR)errno;
+		// Display a warning
+		_RPTF0(_CRT_WARN,"CSerial::GetCTS - Unable to obtain the modem status\n");
+		return false;
+	}
+	// Determine if CTS is on
+	return (lines & TIOCM_CTS) != 0;
+}
+//																			 *
+//****************************************************************************
+
+bool CSerial::GetDSR (void)
+{
+	int lines;
+
+	// Reset error state
+	m_lLastError = API_ERROR_SUCCESS;
+
+	if (::ioctl(m_fd, TIOCMGET, &lines) < 0)
+	{
+		if (errno == ENOTTY || errno == EINVAL)
+			return true;
+		// Obtain the error code
+		m_lLastError = (SERAPI_ERR)errno;
+		// Display a warning
+		_RPTF0(_CRT_WARN,"CSerial::GetDSR - Unable to obtain the modem status\n");
+		return false;
+	}
+	// Determine if DSR is on
+	return (lines & TIOCM_DSR) != 0;
+}
+//																			 *
+//****************************************************************************
@@ -0,0 +1,426 @@
+//*****************************************************************************
+// NAME
+//		tekEventsLinux.cpp
+//
+// DESCRIPTION:
+///		POSIX implementations of operating system events, mutexes
+///		and other common synchronization mechanisms.
+//
+// CREATION DATE:
+//		10/18/2026 09:12:40
+//
+// COPYRIGHT NOTICE:
+//		(C)Copyright 2010-2026  Teknic, Inc.  All rights reserved.
+//
+//		This copyright notice must be reproduced in any copy, modification,
+//		or portion thereof merged into another program. A copy of the
+//		copyright notice must be included in the object library of a user
+//		program.
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																          *
+// 	tekEventsLinux.cpp headers
+//
+	#include "tekTypes.h"
+	#include "tekEventsLinux.h"
+	#include <assert.h>
+	#include <errno.h>
+	#include <time.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+//																			  *
+//*****************************************************************************
+
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	tekEventsLinux.cpp constants
+//
+//
+// Polls of the count before a CCspinEvent waiter blocks
+#define SPIN_EVENT_SPINS	4000
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		class CCMTSyncObject implementation
+//
+//	DESCRIPTION:
+///		Create the mutex and monotonic clock condition shared by the
+///		derived objects.
+//
+//	SYNOPSIS:
+CCMTSyncObject::CCMTSyncObject()
+{
+	pthread_condattr_t attr;
+	pthread_mutex_init(&m_mutex, NULL);
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&m_cond, &attr);
+	pthread_condattr_destroy(&attr);
+}
+
+
+CCMTSyncObject::~CCMTSyncObject()
+{
+	pthread_cond_destroy(&m_cond);
+	pthread_mutex_destroy(&m_mutex);
+}
+
+
+void CCMTSyncObject::deadlineAfter(Uint32 timeOut, struct timespec *deadline)
+{
+	clock_gettime(CLOCK_MONOTONIC, deadline);
+	deadline->tv_sec += timeOut / 1000;
+	deadline->tv_nsec += (long)(timeOut % 1000) * 1000000L;
+	if (deadline->tv_nsec >= 1000000000L) {
+		deadline->tv_sec++;
+		deadline->tv_nsec -= 1000000000L;
+	}
+}
+
+
+bool CCMTSyncObject::condWait(const struct timespec *deadline)
+{
+	if (!deadline) {
+		pthread_cond_wait(&m_cond, &m_mutex);
+		return true;
+	}
+	return pthread_cond_timedwait(&m_cond, &m_mutex, deadline) != ETIMEDOUT;
+}
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		class CCSemaphore implementation
+//
+//	DESCRIPTION:
+///		Counting semaphore limited to <lMaxCount> items.
+//
+//	SYNOPSIS:
+CCSemaphore::CCSemaphore(long lInitialCount, long lMaxCount,
+						 LPSECURITY_ATTRIBUTES /*lpsaAttributes*/)
+{
+	m_count = lInitialCount;
+	m_maxCount = lMaxCount;
+}
+
+
+bool CCSemaphore::Lock(Uint32 dwTimeout)
+{
+	struct timespec deadline, *pDeadline = NULL;
+	bool ok = true;
+	if (dwTimeout != SYNC_INFINITE) {
+		deadlineAfter(dwTimeout, &deadline);
+		pDeadline = &deadline;
+	}
+	pthread_mutex_lock(&m_mutex);
+	while (m_count == 0 && (ok = condWait(pDeadline)))
+		;
+	// A wake may have raced the time-out
+	ok = m_count > 0;
+	if (ok)
+		m_count--;
+	pthread_mutex_unlock(&m_mutex);
+	return ok;
+}
+
+
+bool CCSemaphore::Unlock(long lCount, long *lPrevCount)
+{
+	bool ok;
+	pthread_mutex_lock(&m_mutex);
+	if (lPrevCount)
+		*lPrevCount = m_count;
+	ok = lCount > 0 && m_count + lCount <= m_maxCount;
+	if (ok) {
+		m_count += lCount;
+		pthread_cond_broadcast(&m_cond);
+	}
+	pthread_mutex_unlock(&m_mutex);
+	return ok;
+}
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		class CCMutex implementation
+//
+//	DESCRIPTION:
+///		Recursive owner tracking mutex with time-out.
+//
+//	SYNOPSIS:
+CCMutex::CCMutex(bool bInitiallyOwn, LPSECURITY_ATTRIBUTES /*lpsaAttribute*/)
+{
+	m_depth = 0;
+	if (bInitiallyOwn) {
+		m_owner = pthread_self();
+		m_depth = 1;
+	}
+}
+
+
+bool CCMutex::Lock(Uint32 dwTimeout)
+{
+	struct timespec deadline, *pDeadline = NULL;
+	pthread_t self = pthread_self();
+	bool ok = true;
+	if (dwTimeout != SYNC_INFINITE) {
+		deadlineAfter(dwTimeout, &deadline);
+		pDeadline = &deadline;
+	}
+	pthread_mutex_lock(&m_mutex);
+	if (m_depth && pthread_equal(m_owner, self)) {
+		m_depth++;
+		pthread_mutex_unlock(&m_mutex);
+		return true;
+	}
+	while (m_depth && (ok = condWait(pDeadline)))
+		;
+	ok = m_depth == 0;
+	if (ok) {
+		m_owner = self;
+		m_depth = 1;
+	}
+	pthread_mutex_unlock(&m_mutex);
+	return ok;
+}
+
+
+bool CCMutex::Unlock()
+{
+	bool ok;
+	pthread_mutex_lock(&m_mutex);
+	ok = m_depth && pthread_equal(m_owner, pthread_self());
+	if (ok && --m_depth == 0)
+		pthread_cond_signal(&m_cond);
+	pthread_mutex_unlock(&m_mutex);
+	return ok;
+}
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		class CCEvent implementation
+//
+//	DESCRIPTION:
+///		Manual or auto-reset event. An auto-reset event releases a single
+///		waiter and returns to the reset state.
+//
+//	SYNOPSIS:
+CCEvent::CCEvent(bool bInitiallyOwn, bool bManualReset,
+				 LPSECURITY_ATTRIBUTES /*lpsaAttribute*/)
+{
+	m_signalled = bInitiallyOwn;
+	m_manualReset = bManualReset;
+}
+
+
+bool CCEvent::SetEvent()
+{
+	pthread_mutex_lock(&m_mutex);
+	m_signalled = true;
+	if (m_manualReset)
+		pthread_cond_broadcast(&m_cond);
+	else
+		pthread_cond_signal(&m_cond);
+	pthread_mutex_unlock(&m_mutex);
+	return true;
+}
+
+
+bool CCEvent::ResetEvent()
+{
+	pthread_mutex_lock(&m_mutex);
+	m_signalled = false;
+	pthread_mutex_unlock(&m_mutex);
+	return true;
+}
+
+
+bool CCEvent::WaitFor(unsigned TimeOut)
+{
+	struct timespec deadline, *pDeadline = NULL;
+	bool ok;
+	if (TimeOut != SYNC_INFINITE) {
+		deadlineAfter(TimeOut, &deadline);
+		pDeadline = &deadline;
+	}
+	pthread_mutex_lock(&m_mutex);
+	while (!m_signalled && condWait(pDeadline))
+		;
+	ok = m_signalled;
+	if (ok && !m_manualReset)
+		m_signalled = false;
+	pthread_mutex_unlock(&m_mutex);
+	return ok;
+}
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		class CCspinEvent implementation
+//
+//	DESCRIPTION:
+///		Spin then block completion signal, see tekEventsLinux.h.
+//
+//	SYNOPSIS:
+void CCspinEvent::SetEvent()
+{
+	__sync_add_and_fetch(&m_count, 1);
+	// Only enter the kernel if someone gave up spinning
+	if (m_blocked)
+		m_event.SetEvent();
+}
+
+bool CCspinEvent::WaitFor(LONG ticket, unsigned TimeOut)
+{
+	struct timespec startAt, now;
+	Uint32 waited, waitFor;
+	bool signalled;
+	int spin;
+
+	for (spin = 0; spin < SPIN_EVENT_SPINS; spin++) {
+		if (m_count != ticket)
+			return true;
+		CPU_RELAX();
+	}
+	// Announce ourselves before the final check so SetEvent cannot miss us
+	clock_gettime(CLOCK_MONOTONIC, &startAt);
+	__sync_add_and_fetch(&m_blocked, 1);
+	while (!(signalled = (m_count != ticket))) {
+		waitFor = SYNC_INFINITE;
+		if (TimeOut != SYNC_INFINITE) {
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			waited = (Uint32)((now.tv_sec - startAt.tv_sec) * 1000
+					 + (now.tv_nsec - startAt.tv_nsec) / 1000000);
+			if (waited >= TimeOut)
+				break;
+			waitFor = TimeOut - waited;
+		}
+		// Stale signals just cause another look at the count
+		m_event.WaitFor(waitFor);
+	}
+	__sync_sub_and_fetch(&m_blocked, 1);
+	return signalled;
+}
+//																			  *
+//*****************************************************************************
+
+//*****************************************************************************
+//	NAME																	  *
+//		class CCmappedFile
+//
+//	DESCRIPTION:
+///		Memory mapped file built on mmap. Extend uses ftruncate so the new
+///		space is sparse until written.
+//
+//	SYNOPSIS:
+CCmappedFile::CCmappedFile()
+{
+	m_fd = -1;
+	m_writable = false;
+}
+
+CCmappedFile::~CCmappedFile()
+{
+	Close();
+}
+
+bool CCmappedFile::Open(const char *path, bool writable)
+{
+	Close();
+	m_writable = writable;
+	if (writable)
+		m_fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	else
+		m_fd = open(path, O_RDONLY);
+	return(m_fd >= 0);
+}
+
+void CCmappedFile::Close()
+{
+	if (m_fd >= 0)
+		close(m_fd);
+	m_fd = -1;
+}
+
+Uint64 CCmappedFile::Size() const
+{
+	struct stat info;
+	if (m_fd < 0 || fstat(m_fd, &info) != 0)
+		return(0);
+	return(Uint64(info.st_size));
+}
+
+bool CCmappedFile::Extend(Uint64 newSize)
+{
+	if (m_fd < 0 || !m_writable)
+		return(false);
+	if (newSize <= Size())
+		return(true);
+	return(ftruncate(m_fd, off_t(newSize)) == 0);
+}
+
+void *CCmappedFile::Map(Uint64 offset, size_t len)
+{
+	void *view;
+	if (m_fd < 0)
+		return(NULL);
+	view = mmap(NULL, len, m_writable ? PROT_READ | PROT_WRITE : PROT_READ,
+				MAP_SHARED, m_fd, off_t(offset));
+	return(view == MAP_FAILED ? NULL : view);
+}
+
+void CCmappedFile::Unmap(void *view, size_t len)
+{
+	if (view)
+		munmap(view, len);
+}
+
+void CCmappedFile::Flush(void *view, size_t len)
+{
+	if (view)
+		msync(view, len, MS_ASYNC);
+}
+
+size_t CCmappedFile::Granularity()
+{
+	return(size_t(sysconf(_SC_PAGESIZE)));
+}
+
+bool CCmappedFile::isOK() const
+{
+	return(m_fd >= 0);
+}
+//																			  *
+//*****************************************************************************
+
+
+
+//=============================================================================
+//	END OF FILE tekEventsLinux.cpp
+//=============================================================================
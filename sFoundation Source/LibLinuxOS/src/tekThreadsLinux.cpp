@@ -0,0 +1,337 @@
+//*****************************************************************************
+// NAME
+//		tekThreadsLinux.cpp
+//
+// DESCRIPTION:
+/**
+		\file
+		POSIX threads implementation of the CThread virtual base class.
+**/
+//
+// CREATION DATE:
+//		10/18/2026 10:02:17
+//
+// COPYRIGHT NOTICE:
+//		(C)Copyright 2004-2026  Teknic, Inc.  All rights reserved.
+//
+//		This copyright notice must be reproduced in any copy, modification,
+//		or portion thereof merged into another program. A copy of the
+//		copyright notice must be included in the object library of a user
+//		program.
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME	  																	  *
+// 	tekThreadsLinux.cpp headers
+//
+	#include "tekTypes.h"
+	#include "tekThreads.h"
+	#include <errno.h>
+	#include <time.h>
+	#include <unistd.h>
+	#include <sys/syscall.h>
+//																			  *
+//*****************************************************************************
+
+
+
+
+//*****************************************************************************
+// NAME	  																	  *
+// 	tekThreadsLinux.cpp constants
+//
+//
+// Time to wait for a thread to acknowledge termination
+const Uint32 THREAD_TERM_TIMEOUT_MS = 1500;
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																		  *
+//		CThread::Sleep
+//
+// DESCRIPTION
+//		Wait efficiently
+//
+// SYNOPSIS
+void CThread::Sleep(Uint32 milliseconds)
+{
+	struct timespec ts;
+	ts.tv_sec = milliseconds / 1000;
+	ts.tv_nsec = (long)(milliseconds % 1000) * 1000000L;
+	while (nanosleep(&ts, &ts) && errno == EINTR)
+		;
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+// NAME																		  *
+//		CThread::ThreadEntry
+// Static thread entry point
+void *CThread::ThreadEntry(void *pArgs)
+{
+	CThread *thrd = static_cast<CThread *>(pArgs);
+	// Wait for LaunchThread to store m_hThread, Terminating() tests it
+	thrd->m_exitSection.Lock();
+	thrd->m_exitSection.Unlock();
+	thrd->m_idThread = thrd->m_idThreadSaved = (unsigned)CurrentThreadID();
+	// Setup random number generator
+	srand(1);				// reset random # gen
+	srand(thrd->m_seed);	// set the seed
+	// Fire off the derived Run function
+	thrd->m_status = (void *)(intptr_t)thrd->Run(thrd->m_context);
+	// Signal completion event
+	if (thrd->m_lclOwnTerm)
+		*thrd->m_pTermFlag = true;
+#ifdef THREAD_SLOTS
+	// Generate signal
+	thrd->Shutdown.emit();
+#endif
+	void *status = thrd->m_status;
+	thrd->m_TermEvent.SetEvent();
+	// WARNING: do not touch thrd after this - it can be freed
+	return status;
+}
+//																			  *
+//*****************************************************************************
+
+//*****************************************************************************
+// NAME	  																	  *
+//		CThread::CThread
+//
+// DESCRIPTION:
+//		Construction/Destruction
+//
+// SYNOPSIS:
+CThread::CThread()
+{
+	constructInit(false);
+}
+
+CThread::~CThread()
+{
+	if (m_lclOwnTerm)
+		*m_pTermFlag = true;
+	if (m_hThread)	{
+		TerminateAndWait();
+	}
+	if (m_lclOwnTerm)
+		delete m_pTermFlag;
+
+	m_hThread = 0;
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+// NAME	  																	  *
+//		CThread::constructInit
+//
+// DESCRIPTION:
+//
+//
+// SYNOPSIS:
+void CThread::constructInit(nodebool /*isCom*/)
+{
+	m_pTermFlag = new nodebool;
+	m_lclOwnTerm = true;
+	*m_pTermFlag = false;
+	m_hThread = 0;
+	m_idThread = m_idThreadSaved = 0;
+	m_running = false;
+	m_seed = 1;
+	m_status = NULL;
+	m_lastErr = 0;
+	m_context = NULL;
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+// NAME	  																	  *
+//		CThread::LaunchThread
+//
+// DESCRIPTION:
+//		Launch the thread. The Win32 <priority> levels are not applied,
+//		raising a POSIX thread's priority requires privileges the
+//		library cannot assume.
+//
+// RETURNS:
+//		HANDLE
+//
+// SYNOPSIS:
+HANDLE CThread::LaunchThread(void *context, int /*priority*/)
+{
+	int err;
+	m_context = context;
+	// Forget last cancel
+	*m_pTermFlag = false;
+	m_TermEvent.ResetEvent();
+	m_exitSection.Lock();
+	m_running = true;
+	// Thread start here
+	err = pthread_create(&m_hThread, NULL, ThreadEntry, (void*)this);
+	if (err) {
+		m_hThread = 0;
+		m_running = false;
+		m_lastErr = nodeulong(err);
+		m_exitSection.Unlock();
+		throw m_lastErr;
+	}
+	m_exitSection.Unlock();
+	return (HANDLE)m_hThread;
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+// NAME	  																	  *
+//		CThread::SetTerminateFlag
+//
+// DESCRIPTION:
+//		Set the terminate flag to another source
+//
+// SYNOPSIS:
+void CThread::SetTerminateFlag(nodebool *flag)
+{
+	// Return the existing flag if we own it now
+	if (m_lclOwnTerm) {
+		delete m_pTermFlag;
+		m_lclOwnTerm = false;			// Delegate delete
+	}
+	m_pTermFlag = flag;
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+// NAME	  																	  *
+//		CThread::Terminate
+//
+// DESCRIPTION:
+//		Initiate the terminate sequence.
+//
+// RETURNS:
+//		Handle to wait on for on exit.
+//
+// SYNOPSIS:
+HANDLE CThread::Terminate(void)
+{
+	// Thread still OK?
+	if (m_hThread) {
+		if (m_pTermFlag && !(*m_pTermFlag)) {
+			if (m_lclOwnTerm)
+				*m_pTermFlag = true;
+			#ifdef THREAD_SLOTS
+				ShuttingDown.emit();
+			#endif
+		}
+	}
+	// Insure we break through the parking event
+	m_ThreadParkedEvent.SetEvent();
+	return (HANDLE)m_hThread;
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+// NAME	  																	  *
+//		CThread::TerminateAndWait
+//
+// DESCRIPTION:
+//		Initiate thread termination and wait for termination to complete.
+//
+// SYNOPSIS:
+void CThread::TerminateAndWait(void)
+{
+	Terminate();
+	WaitForTerm();
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+// NAME	  																	  *
+//		CThread::WaitForTerm
+//
+// DESCRIPTION:
+//		Wait for the thread to terminate. A thread that does not finish
+//		its Run function in time is detached rather than killed, POSIX
+//		has no safe equivalent of TerminateThread.
+//
+// RETURNS:
+//		nodebool: TRUE if normal termination
+//
+// SYNOPSIS:
+nodebool CThread::WaitForTerm(void)
+{
+	nodebool exitState = false;
+	// Lock state from thread
+	m_exitSection.Lock();
+	// Thread already dead!
+	if (!m_running || !m_hThread) {
+		exitState = true;
+	}
+	// Waiting on ourselves would deadlock, just detach
+	else if (pthread_equal(m_hThread, pthread_self())) {
+		pthread_detach(m_hThread);
+		m_hThread = 0;
+		m_running = false;
+	}
+	else {
+		exitState = m_TermEvent.WaitFor(THREAD_TERM_TIMEOUT_MS);
+		if (exitState)
+			pthread_join(m_hThread, NULL);
+		else
+			pthread_detach(m_hThread);
+		// We get here because we are dead or hung, make sure atomic state
+		// reflects this.
+		m_hThread = 0;
+		m_idThread = 0;
+		m_running = false;
+	}
+	// Unlock state from thread
+	m_exitSection.Unlock();
+	return(exitState);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CThread::CurrentThreadID
+//
+//	DESCRIPTION:
+///		Returns the kernel thread ID for the currently running thread, as
+///		shown by ps and gdb.
+//
+//	SYNOPSIS:
+nodeulong CThread::CurrentThreadID()
+{
+	return(nodeulong(syscall(SYS_gettid)));
+}
+nodeulong CThread::UIthreadID()
+{
+	return(nodeulong(syscall(SYS_gettid)));
+}
+//																			  *
+//*****************************************************************************
+
+
+//=============================================================================
+//	END OF FILE tekThreadsLinux.cpp
+//=============================================================================
@@ -71,6 +71,9 @@ class CCSemaphore;
 class CCMutex;
 class CCEvent;
 class CCCriticalSection;
+class CCspinEvent;
+class CCseqLock;
+class CCmappedFile;
 //																			  *
 //*****************************************************************************
 
@@ -375,7 +378,7 @@ public:
 class CCatomicUpdate
 {
 private:
-	LONG m_value;
+	volatile LONG m_value;
 public:
 	CCatomicUpdate() {
 		m_value = 0;
@@ -388,6 +391,182 @@ public:
 	LONG Decr() {
 		return InterlockedDecrement(&m_value);
 	}
+
+	// Add <delta> and return the new value
+	LONG Add(LONG delta) {
+		return InterlockedExchangeAdd(&m_value, delta) + delta;
+	}
+
+	LONG Value() const {
+		return m_value;
+	}
+
+	// Keep the memory accesses before this ahead of those after it
+	static void Fence() {
+		MemoryBarrier();
+	}
+
+	// Read the value, later reads are not moved ahead of it
+	LONG Fetch() const {
+		LONG value = m_value;
+		MemoryBarrier();
+		return value;
+	}
+
+	// Change to <newValue> and return the value it replaced
+	LONG Exchange(LONG newValue) {
+		return InterlockedExchange(&m_value, newValue);
+	}
+
+	void Set(LONG newValue) {
+		InterlockedExchange(&m_value, newValue);
+	}
+
+	// Change to <newValue> only if it is <expected>, returns true if changed
+	bool Swap(LONG expected, LONG newValue) {
+		return InterlockedCompareExchange(&m_value, newValue, expected)
+			== expected;
+	}
+};
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		class CCseqLock
+//
+//	DESCRIPTION:
+/**
+	Sequence lock for data with a single writer and readers that must never
+	block. The writer brackets each update with WriteBegin and WriteEnd. A
+	reader copies the data between ReadBegin and ReadRetry and copies it
+	again if ReadRetry reports the writer was active.
+**/
+//	SYNOPSIS:
+class CCseqLock
+{
+private:
+	volatile LONG m_seq;				// Odd while an update is under way
+public:
+	CCseqLock() {
+		m_seq = 0;
+	}
+
+	void WriteBegin() {
+		InterlockedIncrement(&m_seq);
+	}
+
+	void WriteEnd() {
+		InterlockedIncrement(&m_seq);
+	}
+
+	// Wait out an update and return the sequence to check the copy with
+	LONG ReadBegin() const {
+		LONG seq;
+		while ((seq = m_seq) & 1)
+			YieldProcessor();
+		MemoryBarrier();
+		return seq;
+	}
+
+	// Returns true if the data copied since <seq> must be copied again
+	bool ReadRetry(LONG seq) const {
+		MemoryBarrier();
+		return m_seq != seq;
+	}
+};
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		class CCspinEvent
+//
+//	DESCRIPTION:
+/**
+	Completion signal for short waits. Each SetEvent advances a count. A
+	waiter takes a Ticket before starting the work it waits on and returns
+	once the count moves past it. The waiter spins briefly before it blocks
+	and the kernel event is only signalled if a waiter has blocked.
+**/
+//	SYNOPSIS:
+class CCspinEvent
+{
+private:
+	volatile LONG m_count;				// Signals so far
+	volatile LONG m_blocked;			// Waiters blocked on m_event
+	CCEvent m_event;					// Auto-reset blocking fallback
+public:
+	CCspinEvent() : m_event(false, false) {
+		m_count = 0;
+		m_blocked = 0;
+	}
+
+	// Get the ticket to wait on for the next signal
+	LONG Ticket() {
+		return m_count;
+	}
+
+	// Restart the waiters
+	void SetEvent();
+
+	// Wait for a signal after <ticket>. Returns false on time-out.
+	bool WaitFor(LONG ticket, unsigned TimeOut=SYNC_INFINITE);
+
+	bool isOK() {
+		return m_event.isOK();
+	}
+};
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		class CCmappedFile
+//
+//	DESCRIPTION:
+/**
+	File accessed through memory mapped views. A writable file is created
+	empty and grown with Extend, the new space reads as zero. Any number of
+	views may be mapped at once, each must start at a multiple of
+	Granularity() and be released with Unmap.
+**/
+//	SYNOPSIS:
+class CCmappedFile
+{
+private:
+	HANDLE m_hFile;						// File, INVALID_HANDLE_VALUE if closed
+	bool m_writable;					// Opened for writing
+public:
+	CCmappedFile();
+	~CCmappedFile();
+
+	// Open <path>, created empty when <writable>. Returns false on failure.
+	bool Open(const char *path, bool writable);
+	void Close();
+
+	// Current length of the file in octets
+	Uint64 Size() const;
+
+	// Grow a writable file to <newSize> octets
+	bool Extend(Uint64 newSize);
+
+	// Map <len> octets at <offset>, NULL on failure
+	void *Map(Uint64 offset, size_t len);
+
+	// Release a view returned by Map
+	static void Unmap(void *view, size_t len);
+
+	// Start writing a view's changes to the file
+	static void Flush(void *view, size_t len);
+
+	// Views start at a multiple of this
+	static size_t Granularity();
+
+	bool isOK() const;
 };
 //																			  *
 //*****************************************************************************
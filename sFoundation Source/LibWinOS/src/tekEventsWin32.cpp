@@ -259,6 +259,166 @@ bool CCEvent::WaitFor(unsigned TimeOut)
 
 
 
+//*****************************************************************************
+//	NAME																	  *
+//		class CCspinEvent
+//
+//	DESCRIPTION:
+///		Spin then block completion signal.
+//
+//	SYNOPSIS:
+
+// Polls of the count before a waiter blocks
+#define SPIN_EVENT_SPINS	4000
+
+void CCspinEvent::SetEvent()
+{
+	InterlockedIncrement(&m_count);
+	// Only enter the kernel if someone gave up spinning
+	if (m_blocked)
+		m_event.SetEvent();
+}
+
+bool CCspinEvent::WaitFor(LONG ticket, unsigned TimeOut)
+{
+	DWORD startAt, waited, waitFor;
+	bool signalled;
+	int spin;
+
+	for (spin = 0; spin < SPIN_EVENT_SPINS; spin++) {
+		if (m_count != ticket)
+			return true;
+		YieldProcessor();
+	}
+	// Announce ourselves before the final check so SetEvent cannot miss us
+	startAt = GetTickCount();
+	InterlockedIncrement(&m_blocked);
+	while (!(signalled = (m_count != ticket))) {
+		waitFor = INFINITE;
+		if (TimeOut != SYNC_INFINITE) {
+			waited = GetTickCount() - startAt;
+			if (waited >= TimeOut)
+				break;
+			waitFor = TimeOut - waited;
+		}
+		// Stale signals just cause another look at the count
+		m_event.WaitFor(waitFor);
+	}
+	InterlockedDecrement(&m_blocked);
+	return signalled;
+}
+//																			  *
+//*****************************************************************************
+
+//*****************************************************************************
+//	NAME																	  *
+//		class CCmappedFile
+//
+//	DESCRIPTION:
+///		Memory mapped file. A mapping object sized to the file is made for
+///		each view and closed once the view holds it. Extend grows the file
+///		by creating a larger mapping object, SetEndOfFile is refused while
+///		views are mapped.
+//
+//	SYNOPSIS:
+CCmappedFile::CCmappedFile()
+{
+	m_hFile = INVALID_HANDLE_VALUE;
+	m_writable = false;
+}
+
+CCmappedFile::~CCmappedFile()
+{
+	Close();
+}
+
+bool CCmappedFile::Open(const char *path, bool writable)
+{
+	Close();
+	m_writable = writable;
+	m_hFile = CreateFileA(path,
+				writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+				FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+				writable ? CREATE_ALWAYS : OPEN_EXISTING,
+				FILE_ATTRIBUTE_NORMAL, NULL);
+	return(m_hFile != INVALID_HANDLE_VALUE);
+}
+
+void CCmappedFile::Close()
+{
+	if (m_hFile != INVALID_HANDLE_VALUE)
+		CloseHandle(m_hFile);
+	m_hFile = INVALID_HANDLE_VALUE;
+}
+
+Uint64 CCmappedFile::Size() const
+{
+	LARGE_INTEGER size;
+	if (m_hFile == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_hFile, &size))
+		return(0);
+	return(Uint64(size.QuadPart));
+}
+
+bool CCmappedFile::Extend(Uint64 newSize)
+{
+	HANDLE hMap;
+	if (m_hFile == INVALID_HANDLE_VALUE || !m_writable)
+		return(false);
+	if (newSize <= Size())
+		return(true);
+	hMap = CreateFileMapping(m_hFile, NULL, PAGE_READWRITE,
+							 DWORD(newSize >> 32), DWORD(newSize), NULL);
+	if (hMap == NULL)
+		return(false);
+	CloseHandle(hMap);
+	return(true);
+}
+
+void *CCmappedFile::Map(Uint64 offset, size_t len)
+{
+	HANDLE hMap;
+	void *view;
+	if (m_hFile == INVALID_HANDLE_VALUE)
+		return(NULL);
+	hMap = CreateFileMapping(m_hFile, NULL,
+				m_writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, NULL);
+	if (hMap == NULL)
+		return(NULL);
+	view = MapViewOfFile(hMap, m_writable ? FILE_MAP_WRITE : FILE_MAP_READ,
+						 DWORD(offset >> 32), DWORD(offset), len);
+	// The view keeps the mapping alive
+	CloseHandle(hMap);
+	return(view);
+}
+
+void CCmappedFile::Unmap(void *view, size_t len)
+{
+	if (view)
+		UnmapViewOfFile(view);
+}
+
+void CCmappedFile::Flush(void *view, size_t len)
+{
+	if (view)
+		FlushViewOfFile(view, len);
+}
+
+size_t CCmappedFile::Granularity()
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return(size_t(info.dwAllocationGranularity));
+}
+
+bool CCmappedFile::isOK() const
+{
+	return(m_hFile != INVALID_HANDLE_VALUE);
+}
+//																			  *
+//*****************************************************************************
+
+
+
 //============================================================================= 
 //	END OF FILE tekEventsWin32.cpp
 //=============================================================================
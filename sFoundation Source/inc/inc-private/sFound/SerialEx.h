@@ -41,6 +41,7 @@
 #include "tekEvents.h"
 // StdLib inclusions
 #include <deque>
+#include <vector>
 
 // Maximum polling delay for break detector
 #define COMM_EVT_BRK_DLY_MS		100
@@ -48,6 +49,9 @@
 // Maximum number of characters to read from port at a time
 #define READ_BUF_LEN			4096
 
+// Maximum number of packets framed into a single port write
+#define SEND_PKTS_PER_WRITE		16
+
 // Set to 1 to record highest packet depth
 #define RECORD_PKT_DEPTH		1
 
@@ -115,6 +119,7 @@ typedef struct  _CSerialExErrReportInfo {
 		Uint32 RXCHARcnt;
 		Uint32 RXFLAGcnt;
 		Uint32 RX80FUllcnt;
+		double CTSfallAt;				// Time of the last CTS fall (ms)
 	// Reset value to zero
 	void clear() {
 		BREAKcnt=0;
@@ -128,6 +133,7 @@ typedef struct  _CSerialExErrReportInfo {
 		RXCHARcnt=0;
 		RXFLAGcnt=0;
 		RX80FUllcnt=0;
+		CTSfallAt=0;
 	};
 } CSerialExErrReportInfo;
 //																			   *
@@ -215,6 +221,18 @@ public:
 		return(pTheChar);
 	};
 
+	// Take all the characters as one span at <pChars>. The span is valid
+	// until the next flush.
+	size_t takeChars(const char *&pChars) {
+		size_t nChars;
+		m_lock.Lock();
+		pChars = &m_buffer[m_head];
+		nChars = m_size - m_head;
+		m_head = m_size;
+		m_lock.Unlock();
+		return(nChars);
+	};
+
 	// Get the next character
 	bool getChar(char &theChar) {
 		m_lock.Lock();
@@ -350,6 +368,7 @@ public:
 	// Packet Interface
 	bool GetPkt(packetbuf &buffer);
 	bool SendPkt(packetbuf &bufferLen);
+	bool SendPkts(packetbuf *buffers, size_t count);
 	bool IsPacketAvailable();
 
 	// Serial Port Interface
@@ -418,6 +437,8 @@ protected:
 
 	// Packets to send up to application layer
 	std::deque<packetbuf *> m_finishedPackets;
+	// Packets framed from the current chunk, read thread only
+	std::vector<packetbuf *> m_rxBatch;
 
 	// Overlap structures for writing
 	CCEvent  m_evtWrOverlap;
@@ -449,9 +470,9 @@ public:
 	}
 
 	// - - - - - - - - - - - - - - - - - - - - - -
-	// Packet parser states
+	// Packet parser states, open to derived test parsers
 	// - - - - - - - - - - - - - - - - - - - - - -
-private:
+protected:
 	bool inHighPrioState() {
 		return(m_state == READ_STATE_HP_PAYLOAD);
 	}
@@ -483,10 +504,12 @@ private:
 		ErrorReportClear();
 	}
 
-	// This function is used to process serial characters out of the
-	// m_rdBuffer and signal the upper packet loop we have something.
+	// These functions are used to frame the serial characters out of the
+	// m_rdBuffer and batch the packets for the upper packet loop.
 	bool TestAndPushHiPacket(char nextChar);
-	void ProcessNextChar(char nextChar);
+	bool FrameSpan(packetbuf &pkt, unsigned &pktIndx, unsigned &checksum,
+				   const char *&pChunk, const char *pEnd);
+	void ProcessChunk(const char *pChunk, size_t nChars);
 public:
 	// Reset port items and work in progress
 	void Flush();
@@ -497,9 +520,13 @@ public:
 	CCCriticalSection m_SendPacketToAppLock;
 
 	// Send a packet to the application
-	void SendPacketToApp(packetbuf &packet, BOOL convert7To8Bit);
+	void SendPacketToApp(packetbuf &packet, BOOL convert7To8Bit,
+						 bool batch = false);
 	// Create an error packet and send to the application
-	void SendErrToApp(mnNetErrs errorType, unsigned addr, unsigned data);
+	void SendErrToApp(mnNetErrs errorType, unsigned addr, unsigned data,
+					  bool batch = false);
+	// Send the read thread's batched packets to the application
+	void SendBatchToApp();
 	void convert7to8(packetbuf& inBuf, packetbuf& outBuf);
 	void convert8to7(packetbuf& inBuf, packetbuf& outBuf);
 
@@ -0,0 +1,103 @@
+//*****************************************************************************
+// DESCRIPTION:
+///		\file
+///		Decoder that unpacks data acquisition packets with word shifts
+///		instead of compiler bit fields.
+//
+// CREATION DATE:
+//		10/18/2026 15:10:44
+//
+// COPYRIGHT NOTICE:
+//		(C)Copyright 2026  Teknic, Inc.  All rights reserved.
+//
+//		This copyright notice must be reproduced in any copy, modification,
+//		or portion thereof merged into another program. A copy of the
+//		copyright notice must be included in the object library of a user
+//		program.
+//																			  *
+//*****************************************************************************
+/// \cond INTERNAL_DOC
+
+#ifndef __DACQDECODE_H__
+#define __DACQDECODE_H__
+//*****************************************************************************
+// NAME																	      *
+// 	dacqDecode.h headers included
+//
+	#include "tekTypes.h"
+	#include "pubDataAcq.h"
+	#include <stddef.h>
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	dacqDecode.h constants
+//
+// Octets in one packet on the link
+#define DACQ_PACKET_OCTETS		6
+// Bit positions of the dacqPacket fields in the packet's 48 bit little
+// endian word
+#define DACQ_SEQ_SHIFT			0
+#define DACQ_T0P0_SHIFT			2
+#define DACQ_T0P1_SHIFT			(DACQ_T0P0_SHIFT + P0_BITS)
+#define DACQ_STATE0_SHIFT		24
+#define DACQ_STATE1_SHIFT		32
+#define DACQ_IO0_SHIFT			40
+#define DACQ_IO1_SHIFT			44
+// Within a state octet
+#define DACQ_TRIGGER_SHIFT		3
+#define DACQ_EXCEPTION_SHIFT	4
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	dacqDecoded
+//
+// DESCRIPTION
+//	Destination arrays for dacqDecodePackets. Packet n fills entry n of
+//	sequence and entries 2n and 2n+1 of the per point arrays. A NULL array
+//	is skipped.
+//
+typedef struct _dacqDecoded {
+	float *trace;					// Trace 0, normalized to +/-1
+	Uint8 *moveState;				// dacqSTATES
+	Uint8 *exception;				// dacqEXCPS
+	Uint8 *io;						// Trigger, inputs and output packed as
+									// the read thread stores them in trace 1
+	Uint8 *sequence;				// Sequence indicator, one per packet
+} dacqDecoded;
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	dacqDecode.h function prototypes
+//
+// Load the packet at <raw> as a 48 bit little endian word
+static inline Uint64 dacqPacketWord(const Uint8 *raw)
+{
+	return(Uint64(raw[0]) | (Uint64(raw[1]) << 8) | (Uint64(raw[2]) << 16)
+		| (Uint64(raw[3]) << 24) | (Uint64(raw[4]) << 32)
+		| (Uint64(raw[5]) << 40));
+}
+
+// Unpack <nPackets> packets, the first at <raw> and each <stride> octets
+// after the last, into <out>
+void dacqDecodePackets(const Uint8 *raw, size_t stride, size_t nPackets,
+					   const dacqDecoded &out);
+//																			  *
+//*****************************************************************************
+
+#endif
+/// \endcond
+//=============================================================================
+//	END OF FILE dacqDecode.h
+//=============================================================================
@@ -0,0 +1,190 @@
+//*****************************************************************************
+// DESCRIPTION:
+///		\file
+///		Merger that places the data acquisition points of several nodes,
+///		and samples taken by the host, on one timeline and emits them as
+///		multi-channel frames.
+//
+// CREATION DATE:
+//		10/18/2026 16:25:09
+//
+// COPYRIGHT NOTICE:
+//		(C)Copyright 2026  Teknic, Inc.  All rights reserved.
+//
+//		This copyright notice must be reproduced in any copy, modification,
+//		or portion thereof merged into another program. A copy of the
+//		copyright notice must be included in the object library of a user
+//		program.
+//																			  *
+//*****************************************************************************
+/// \cond INTERNAL_DOC
+
+#ifndef __DATAACQMERGER_H__
+#define __DATAACQMERGER_H__
+//*****************************************************************************
+// NAME																	      *
+// 	dataAcqMerger.h headers included
+//
+	#include "dataAcqRecorder.h"
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	dataAcqMerger.h constants
+//
+// Most streams and frame channels merged
+#define DACQ_MERGE_MAX_STREAMS		8
+#define DACQ_MERGE_MAX_CHANNELS		16
+// Samples held per stream, must be a power of two
+#define DACQ_MERGE_HISTORY			4096
+// Points read from a node per ring access
+#define DACQ_MERGE_PULL_PTS			256
+// Node time spanned by the envelope before the clock rate is measured
+#define DACQ_MERGE_RATE_SPAN_MS		2000.0
+// Node time of each envelope window, and the windows kept
+#define DACQ_MERGE_ENV_WINDOW_MS	250.0
+#define DACQ_MERGE_ENV_WINDOWS		32
+// Largest clock rate error believed, as a fraction
+#define DACQ_MERGE_RATE_MAX_ERR		0.005
+// Node points interpolated across at most this many sample periods
+#define DACQ_MERGE_GAP_PERIODS		4
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	dacqMergeFrame
+//
+// DESCRIPTION
+//	One merged frame. Channel n of the frame is the channel the nth
+//	AddNodeChannel or AddHostChannel call returned.
+//
+typedef struct _dacqMergeFrame {
+	double time;						// infcCoreTime of the frame (msec.)
+	Uint32 validMask;					// Bit n set if channel n has a value
+	float value[DACQ_MERGE_MAX_CHANNELS];
+} dacqMergeFrame;
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		class CDataAcqMerger
+//
+//	DESCRIPTION:
+/**
+	Align the data acquisition streams of several nodes, and samples the
+	host records itself, on the infcCoreTime timeline.
+
+	Each node's point times are mapped to host time with a linear model
+	of its clock. The model is fitted to the arrival times of the node's
+	points. Transit only ever delays a point, so the arrivals with the
+	least delay mark the clock and the rest are noise above them. The
+	earliest arrival of each DACQ_MERGE_ENV_WINDOW_MS of node time is kept
+	as the lower envelope of the arrivals, the rate is a line fitted to
+	the lower half of that envelope once it spans DACQ_MERGE_RATE_SPAN_MS,
+	and the offset puts the line under the earliest arrival. Points lost
+	on the link are already skipped in the node's time stamps. A restart
+	of the node's acquisition is seen as its time stamps going backwards
+	and starts a new model, keeping the rate.
+
+	Frames are emitted at a fixed period once every stream has passed the
+	frame time, each channel linearly interpolated between the samples on
+	either side. A stream more than the allowed lag behind the newest is
+	not waited for, its channels are left invalid in the frames it missed.
+
+	The merger is used from one thread. It reads the nodes' points itself,
+	so nothing else may read them while it runs. Construct it on the heap,
+	it holds the stream histories.
+**/
+//	SYNOPSIS:
+class CDataAcqMerger
+{
+private:
+	// One sample of a stream on the host timeline
+	typedef struct _mergeSample {
+		double time;
+		float value[DACQ_REC_STREAM_CHANNELS];
+		bool valid;
+	} mergeSample;
+	// A node, or one host channel
+	typedef struct _mergeStream {
+		multiaddr addr;						// Node read, if not the host
+		bool isHost;
+		Uint16 nChannels;
+		Uint8 sources[DACQ_REC_STREAM_CHANNELS];
+		Uint16 slots[DACQ_REC_STREAM_CHANNELS];	// Frame channel of each
+		double maxGapMs;					// Longest span interpolated
+		// Clock model, host time = node time * scale + offset
+		bool clockSet;
+		double scale;
+		double offset;
+		double lastNode;					// Latest node time mapped
+		// Lower envelope, the earliest arrival of each window
+		double winStart;					// Node time the window began
+		double winNode, winHost;			// Its earliest arrival so far
+		Uint32 envHead, nEnv;				// Newest slot, slots filled
+		double envNode[DACQ_MERGE_ENV_WINDOWS];
+		double envHost[DACQ_MERGE_ENV_WINDOWS];
+		// History, head and tail count samples
+		Uint32 head, tail;
+		mergeSample hist[DACQ_MERGE_HISTORY];
+	} mergeStream;
+	size_t m_nStreams;
+	size_t m_nChannels;
+	mergeStream m_streams[DACQ_MERGE_MAX_STREAMS];
+	// Stream of each frame channel
+	Uint8 m_chanStream[DACQ_MERGE_MAX_CHANNELS];
+	double m_periodMs;						// Time between frames
+	double m_maxLagMs;						// Longest wait for a stream
+	bool m_started;							// m_nextTime is set
+	double m_nextTime;						// Time of the next frame
+	Uint32 m_overruns;						// Samples lost to full histories
+	// Points read from a node
+	mnDataAcqPt m_pts[DACQ_MERGE_PULL_PTS];
+	// Start a new clock model at node time <node>, arrived at <host>
+	void clockStart(mergeStream &st, double node, double host);
+	// Fit the clock model to another arrival
+	void clockUpdate(mergeStream &st, double node, double host);
+	// Fit the clock rate to the lower envelope
+	void clockFit(mergeStream &st);
+	// Add a sample to the stream's history and return it, NULL if it is
+	// not after the latest
+	mergeSample *append(mergeStream &st, double time);
+public:
+	CDataAcqMerger();
+	// Merge <source> of node <addr>'s points. Returns the frame channel,
+	// or -1 if there is no room or merging has started.
+	int AddNodeChannel(multiaddr addr, dacqRecSource source);
+	// Merge samples given to PushHost, at most <maxGapMs> apart. Returns
+	// the frame channel, or -1 if there is no room or merging has started.
+	int AddHostChannel(double maxGapMs);
+	// Emit a frame every <periodMs>, waiting at most <maxLagMs> for a
+	// stream that falls behind
+	cnErrCode Start(double periodMs, double maxLagMs);
+	// Add a host sample taken at infcCoreTime <timeMs>
+	cnErrCode PushHost(int channel, double timeMs, float value);
+	// Read the points waiting at each node
+	cnErrCode Pull();
+	// Get the next frame, returns false if it is not complete yet
+	bool Next(dacqMergeFrame &frame);
+	// Node clock rate against the host's for <channel>, 1 if not measured
+	double ClockRate(int channel) const;
+	// Samples dropped because Next was not called often enough
+	Uint32 Overruns() const { return m_overruns; }
+};
+//																			  *
+//*****************************************************************************
+
+#endif
+/// \endcond
+//=============================================================================
+//	END OF FILE dataAcqMerger.h
+//=============================================================================
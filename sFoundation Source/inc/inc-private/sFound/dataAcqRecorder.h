@@ -0,0 +1,324 @@
+//*****************************************************************************
+// DESCRIPTION:
+///		\file
+///		Recorder that streams data acquisition points from a set of nodes
+///		into a memory mapped, column oriented file, and the reader for
+///		that file.
+//
+// CREATION DATE:
+//		10/18/2026 14:02:31
+//
+// COPYRIGHT NOTICE:
+//		(C)Copyright 2026  Teknic, Inc.  All rights reserved.
+//
+//		This copyright notice must be reproduced in any copy, modification,
+//		or portion thereof merged into another program. A copy of the
+//		copyright notice must be included in the object library of a user
+//		program.
+//																			  *
+//*****************************************************************************
+/// \cond INTERNAL_DOC
+
+#ifndef __DATAACQRECORDER_H__
+#define __DATAACQRECORDER_H__
+//*****************************************************************************
+// NAME																	      *
+// 	dataAcqRecorder.h headers included
+//
+	#include "tekTypes.h"
+	#include "tekThreads.h"
+	#include "tekEvents.h"
+	#include "pubNetAPI.h"
+	#include "pubDataAcq.h"
+	#include "mnErrors.h"
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	dataAcqRecorder.h constants
+//
+// File and chunk signatures and the layout version
+#define DACQ_REC_MAGIC			0x52514144		// "DAQR"
+#define DACQ_REC_CHUNK_MAGIC	0x4b4e4843		// "CHNK"
+#define DACQ_REC_VERSION		1
+// Size of the header region and of each chunk. A multiple of the view
+// granularity on every supported system.
+#define DACQ_REC_CHUNK_BYTES	65536
+// Chunks added each time the file is grown
+#define DACQ_REC_EXTENT_CHUNKS	64
+// Most nodes and channels in one file
+#define DACQ_REC_MAX_STREAMS	64
+#define DACQ_REC_MAX_CHANNELS	256
+// Most channels recorded from one node
+#define DACQ_REC_STREAM_CHANNELS 8
+// Name and units string lengths, including the terminator
+#define DACQ_REC_NAME_LEN		32
+#define DACQ_REC_UNITS_LEN		16
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	dacqRecSource
+//
+// DESCRIPTION
+//	The part of a data acquisition point a channel records.
+//
+typedef enum _dacqRecSource {
+	DACQ_REC_TRACE0,				// TraceValue[0]
+	DACQ_REC_TRACE1,				// TraceValue[1]
+	DACQ_REC_TRACE2,				// TraceValue[2]
+	DACQ_REC_TRACE3,				// TraceValue[3]
+	DACQ_REC_MOVE_STATE,			// MoveState
+	DACQ_REC_EXCEPTION,				// Exception
+	DACQ_REC_VALID,					// 1 for a valid point, 0 after a gap
+	DACQ_REC_SOURCES
+} dacqRecSource;
+
+// Value of <source> in point <pt> as a recorded float
+static inline float dacqRecSourceValue(const mnDataAcqPt &pt, Uint8 source)
+{
+	switch (source) {
+	case DACQ_REC_TRACE0:
+	case DACQ_REC_TRACE1:
+	case DACQ_REC_TRACE2:
+	case DACQ_REC_TRACE3:
+		return(pt.TraceValue[source - DACQ_REC_TRACE0]);
+	case DACQ_REC_MOVE_STATE:
+		return(float(pt.MoveState));
+	case DACQ_REC_EXCEPTION:
+		return(float(pt.Exception));
+	default:
+		return(pt.Valid ? 1.0f : 0.0f);
+	}
+}
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	dacqRecState
+//
+// DESCRIPTION
+//	Recording state kept in the file header.
+//
+typedef enum _dacqRecState {
+	DACQ_REC_RECORDING = 1,			// The writer is still adding points
+	DACQ_REC_CLOSED,				// The writer finished normally
+	DACQ_REC_FAILED					// The writer stopped on a file error
+} dacqRecState;
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	Recording file layout
+//
+// DESCRIPTION
+//	The file starts with a DACQ_REC_CHUNK_BYTES header region followed by
+//	chunks of the same size. Each chunk holds rows of one stream, the
+//	points of one node, stored as float columns of rowCapacity entries.
+//	Column 0 is the point time in milliseconds after the chunk's baseTime,
+//	column n is the stream's channel n-1. A stored value converts to its
+//	units as value * scale + offset.
+//
+//	The writer fills a chunk before counting it in the header's chunks
+//	and publishes each chunk's rows after the column data, so a reader
+//	may follow the file while it is still being written.
+//
+#pragma pack(push,1)
+typedef struct _dacqRecStream {
+	Uint32 addr;						// Node multi-address
+	Uint16 firstChannel;				// Its first entry in the channel table
+	Uint16 nChannels;					// Channels recorded from the node
+	Uint16 rowCapacity;					// Rows in each of its chunks
+	Uint16 spare;
+	Uint32 dropped;						// Points lost to a full node ring
+	double pointPeriodMs;				// Nominal time between points
+} dacqRecStream;
+
+typedef struct _dacqRecChannel {
+	Uint16 stream;						// Stream the channel belongs to
+	Uint16 source;						// dacqRecSource recorded
+	Uint32 spare;
+	double scale;						// Units per stored value
+	double offset;						// Units at a stored zero
+	char name[DACQ_REC_NAME_LEN];
+	char units[DACQ_REC_UNITS_LEN];
+} dacqRecChannel;
+
+typedef struct _dacqRecHeader {
+	Uint32 magic;						// DACQ_REC_MAGIC
+	Uint16 version;						// DACQ_REC_VERSION
+	Uint16 nStreams;					// Entries in streams
+	Uint32 chunkBytes;					// DACQ_REC_CHUNK_BYTES
+	Uint16 nChannels;					// Entries in channels
+	Uint16 state;						// dacqRecState
+	volatile Uint32 chunks;				// Chunks started by the writer
+	Uint32 spare;
+	int64 startTime;					// Seconds since 1970 at the start
+	dacqRecStream streams[DACQ_REC_MAX_STREAMS];
+	dacqRecChannel channels[DACQ_REC_MAX_CHANNELS];
+} dacqRecHeader;
+
+typedef struct _dacqRecChunk {
+	Uint32 magic;						// DACQ_REC_CHUNK_MAGIC
+	Uint16 stream;						// Stream the rows belong to
+	Uint16 rowCapacity;					// Rows each column has room for
+	volatile Uint32 rows;				// Rows written so far
+	Uint32 gaps;						// Rows marked invalid
+	Uint64 firstRow;					// Stream row number of row 0
+	double baseTime;					// Point time of row 0 (msec.)
+} dacqRecChunk;
+#pragma pack(pop)
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	dacqRecChannelDef
+//
+// DESCRIPTION
+//	A channel to record, as given to CDataAcqRecorder::Start.
+//
+typedef struct _dacqRecChannelDef {
+	multiaddr addr;						// Node recorded
+	dacqRecSource source;				// Part of its points recorded
+	double scale;						// Units per stored value
+	double offset;						// Units at a stored zero
+	const char *name;					// Channel name, may be NULL
+	const char *units;					// Units name, may be NULL
+} dacqRecChannelDef;
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		class CDataAcqRecorder
+//
+//	DESCRIPTION:
+/**
+	Drain the data acquisition rings of a set of nodes into a recording
+	file. The points are read in place from each node's ring and written
+	straight into the mapped chunk, all state is sized at construction so
+	nothing is allocated while recording.
+
+	The nodes must already be in data acquisition mode, the recorder only
+	consumes their points. Nothing else may read the recorded nodes' points
+	while it runs.
+**/
+//	SYNOPSIS:
+class CDataAcqRecorder : public CThread
+{
+private:
+	// Writer state of one stream
+	typedef struct _streamState {
+		multiaddr addr;						// Node drained
+		Uint16 nChannels;					// Channels recorded
+		Uint16 rowCapacity;					// Rows per chunk
+		Uint8 sources[DACQ_REC_STREAM_CHANNELS];
+		dacqRecChunk *pChunk;				// Chunk being filled, or NULL
+		float *pCols;						// Its first column
+		Uint32 rows;						// Rows written to it
+		Uint64 nextRow;						// Rows recorded from the node
+	} streamState;
+	CCmappedFile m_file;
+	dacqRecHeader *m_pHdr;					// Mapped header region
+	Uint32 m_chunks;						// Chunks handed out
+	Uint32 m_fileChunks;					// Chunks the file has room for
+	double m_pollMs;						// Time between drains
+	size_t m_nStreams;
+	streamState m_streams[DACQ_REC_MAX_STREAMS];
+	cnErrCode m_lastErr;					// Why recording failed
+	// Wakes the writer early to stop
+	CCEvent m_wake;
+	// Serializes Start and Stop
+	CCCriticalSection m_ctlLock;
+	// Move a stream to a new chunk starting at point time <baseTime>
+	bool newChunk(size_t iStream, double baseTime);
+	// Record every point waiting in the stream's ring
+	bool drain(size_t iStream);
+	// Publish the rows of the stream's chunk and release its view
+	void closeChunk(size_t iStream);
+	// Finish the file and release it
+	void closeFile(dacqRecState state);
+	int Run(void *context);
+public:
+	CDataAcqRecorder();
+	~CDataAcqRecorder();
+	// Create <path> and record the <nDefs> channels in <defs>, draining
+	// the nodes every <pollMs>.
+	cnErrCode Start(const char *path, const dacqRecChannelDef defs[],
+					size_t nDefs, double pollMs);
+	// Record the points still waiting and close the file
+	cnErrCode Stop();
+	// Wake a sleeping writer to terminate
+	HANDLE Terminate();
+	// MN_OK unless recording stopped on a file error
+	cnErrCode Status() const { return m_lastErr; }
+};
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		class CDataAcqRecReader
+//
+//	DESCRIPTION:
+/**
+	Read a recording file, including one still being written. Chunks() and
+	Rows() report how far the writer has got, the data they cover never
+	changes afterwards.
+**/
+//	SYNOPSIS:
+class CDataAcqRecReader
+{
+private:
+	CCmappedFile m_file;
+	const dacqRecHeader *m_pHdr;			// Mapped header region
+	const dacqRecChunk *m_pChunk;			// Mapped chunk, or NULL
+public:
+	CDataAcqRecReader();
+	~CDataAcqRecReader();
+	// Open a recording file
+	cnErrCode Open(const char *path);
+	void Close();
+	// The file header
+	const dacqRecHeader *Header() const { return m_pHdr; }
+	// Number of chunks started by the writer
+	Uint32 Chunks() const;
+	// Map chunk <chunk>, returns NULL if it has not been started
+	const dacqRecChunk *Chunk(Uint32 chunk);
+	// Rows of the mapped chunk that are complete
+	Uint32 Rows() const;
+	// Column <col> of the mapped chunk, 0 holds the point times
+	const float *Column(size_t col) const;
+	// Convert a value stored for channel <chan> to its units
+	double Scaled(size_t chan, float stored) const {
+		return stored * m_pHdr->channels[chan].scale
+			+ m_pHdr->channels[chan].offset;
+	}
+};
+//																			  *
+//*****************************************************************************
+
+#endif
+/// \endcond
+//=============================================================================
+//	END OF FILE dataAcqRecorder.h
+//=============================================================================
@@ -150,7 +150,32 @@ MN_EXPORT cnErrCode MN_DECL infcRunCommand(
 		netaddr cNum,						// Port index
 		packetbuf *theCommand,				// Ptr to buffered command
 		packetbuf *theResponse);			// Ptr to response area
-		
+
+// Completion function for commands submitted via infcRunCommandAsync. It is
+// called from the port's read thread when the response arrives, the command
+// times out or the command is flushed away. Commands cannot be run from it.
+typedef void (nodeCallback *infcCmdAsyncCallback)(
+		netaddr cNum,						// Port index
+		cnErrCode theErr,					// Outcome of the command
+		packetbuf *theResponse,				// Response area given at submit
+		void *context);						// Context given at submit
+
+// Pipelined command submission, returns once the command is on the wire.
+MN_EXPORT cnErrCode MN_DECL infcRunCommandAsync(
+		netaddr cNum,						// Port index
+		packetbuf *theCommand,				// Ptr to buffered command
+		packetbuf *theResponse,				// Ptr to response area
+		infcCmdAsyncCallback completeFunc,	// Ptr to completion function
+		void *context);						// Passed to <completeFunc>
+
+// Run a set of commands sent back to back, waits for all the responses.
+MN_EXPORT cnErrCode MN_DECL infcRunCommandBatch(
+		netaddr cNum,						// Port index
+		packetbuf *theCommands,				// Ptr to array of commands
+		packetbuf *theResponses,			// Ptr to array of response areas
+		size_t nCmds,						// Number of commands
+		double *theDoneTimes);				// Ptr to completion times or NULL
+
 // Microsecond level time stamp
 MN_EXPORT double MN_DECL infcCoreTime(void);
 
@@ -238,6 +263,34 @@ MN_EXPORT cnErrCode MN_DECL infcBackgroundPollControl(
 MN_EXPORT cnErrCode MN_DECL infcSetCmdQueueLimit(
 		netaddr cNum,				// Network 
 		nodeulong nCmds);			// Number of commands allowed at once
+
+// Let the cmd window adapt below the queue limit to the ring's latency
+MN_EXPORT cnErrCode MN_DECL infcSetCmdWindowAdaptive(
+		netaddr cNum,				// Network
+		nodebool adaptive);			// Window adapts if TRUE
+
+// Get the cmd window now in use and its ceiling (the cmd queue limit)
+MN_EXPORT cnErrCode MN_DECL infcGetCmdWindow(
+		netaddr cNum,				// Network
+		nodeulong *pWindow,			// Commands allowed at once now
+		nodeulong *pCeiling,		// Most commands allowed at once
+		nodebool *pAdaptive);		// Window adapts if TRUE
+
+// Get the command latency summary for a node, or the whole port if <theNode>
+// is MN_API_MAX_NODES, optionally starting a new window
+MN_EXPORT cnErrCode MN_DECL infcGetLatencyStats(
+		netaddr cNum,				// Network
+		nodeaddr theNode,			// Node or MN_API_MAX_NODES
+		mnLatencyClass latClass,	// Command group or MN_LAT_ALL
+		nodebool reset,				// Clear what was summarized if TRUE
+		mnLatencyStats *pStats);	// Summary
+
+// Get the group shutdown stop latency summary, optionally starting a new
+// window
+MN_EXPORT cnErrCode MN_DECL infcGetStopLaneStats(
+		netaddr cNum,				// Network
+		nodebool reset,				// Clear what was summarized if TRUE
+		mnLatencyStats *pStats);	// Summary
 		
 MN_EXPORT cnErrCode MN_DECL infcGetOnlineState(
 		netaddr cNum,
@@ -492,6 +545,32 @@ MN_EXPORT cnErrCode MN_DECL infcGetDataAcqPtCount(
 		
 MN_EXPORT cnErrCode MN_DECL infcFlushDataAcq(
 		multiaddr multiAddr);
+
+// Zero-copy read, the points stay in the ring until released
+MN_EXPORT cnErrCode MN_DECL infcPeekDataAcqPts(
+		multiaddr multiAddr,
+		const mnDataAcqPt **ppPts,
+		nodeulong *pPtsAvail);
+
+MN_EXPORT cnErrCode MN_DECL infcReleaseDataAcqPts(
+		multiaddr multiAddr,
+		nodeulong ptsUsed);
+
+// Latest point time paired with the host time it arrived
+MN_EXPORT cnErrCode MN_DECL infcGetDataAcqClock(
+		multiaddr multiAddr,
+		double *pNodeMs,
+		double *pHostMs);
+
+// Nominal time between points
+MN_EXPORT cnErrCode MN_DECL infcGetDataAcqPeriod(
+		multiaddr multiAddr,
+		double *pPeriodMs);
+
+MN_EXPORT cnErrCode MN_DECL infcGetDataAcqDropped(
+		multiaddr multiAddr,
+		nodebool reset,
+		nodeulong *pDropped);
 /// \endcond
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
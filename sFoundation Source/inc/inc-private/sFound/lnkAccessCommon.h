@@ -68,10 +68,21 @@ class CSerialEx;
 #define RECV_DEPTH				SEND_DEPTH
 // Depth of the Attention Buffer. Add one more than this will yield overflow.
 #define ATTN_OVERFLOW_LVL		32
-// Depth of the Data Acquisition buffer at each node.
-#define DATAACQ_OVERFLOW_LVL	2000
+// Depth of the Data Acquisition ring at each node, must be a power of two
+#define DATAACQ_RING_LEN		2048
 // Number of simultaneous command in ring default
 #define N_CMDS_IN_RING			3
+// Upper limit of the simultaneous commands in ring setting
+#define N_CMDS_IN_RING_MAX		14
+// Adaptive command window: estimated commands queued in the ring beyond what
+// it carries. The window grows below the low mark and shrinks above the high.
+#define PACE_BACKLOG_GROW		0.5
+#define PACE_BACKLOG_SHRINK		1.5
+// In-flight commands held outside the pacing window for the stop lane, one
+// stop per node. A node may have the whole window and its stop in flight.
+#define STOP_LANE_SLOTS			MN_API_MAX_NODES
+// Retry period of a stop request made while the port was not online
+#define STOP_LANE_RETRY_MS		50
 
 // XML based error text
 #define LNK_ACCESS_XML_ERR_TXT "/MNuserDriver20.xml"
@@ -280,6 +291,8 @@ public:
 		mnClassInfo mnCpScInfo;
 		// Last device ID set
 		devID_t LastIDs[MN_API_MAX_NODES];	
+		// Raw serial number of each node, kept in the last good inventory
+		Uint32 SerNums[MN_API_MAX_NODES];
 		// Construction
 		_netInfoByType() {
 			isValid = false;
@@ -320,6 +333,9 @@ public:
 	netStateInfo *pNCS;
 	// Current node information, value caches, construction/destruction
 	byNodeDB NodeInfo[MN_API_MAX_NODES];
+	// Guards each node's value DB entries, held across the node read of
+	// a parameter so concurrent readers of a max age value share it
+	CCCriticalSection SharedReadLock[MN_API_MAX_NODES];
 	// Set when something was discovered for diagStats
 	nodebool diagsAvailable[MN_API_MAX_NODES+1];
 	// Autonomously delivered stats
@@ -336,6 +352,8 @@ public:
 	portSpec PhysPortSpecifier;
 	// Number of simultaneous commands allowed in ring
 	nodeulong NumCmdsInRing;
+	// Adapt the command window below NumCmdsInRing to the ring's latency
+	nodebool CmdWindowAdaptive;
 
 	// Initializing "stack"	counter. Maintained by infcSetInitializeMode.
 	// When this counter decrements back to zero, we signal we are "online",
@@ -357,6 +375,9 @@ public:
 	struct _netInfoByType InventoryNow;
 	// Information saved when net went online
 	struct _netInfoByType InventoryLast;
+	// Inventory of the last complete enumeration, a re-attach checks the
+	// nodes found against it before skipping the enumeration
+	struct _netInfoByType InventoryGood;
 
 	// Current attention states
 	attnReg drvrAttnMask[MN_API_MAX_NODES];
@@ -480,24 +501,42 @@ typedef struct _profileStats {
 //	This structure a node's data acquisition information.
 //
 typedef struct _dataAcqInfo {
-	// Interface Lock
+	// Consumer lock, the read thread never takes it
 	CCCriticalSection AcqLock;
-	// Point not transferred to application
-	std::queue<mnDataAcqPt> Points;
+	// Points not transferred to application. The read thread is the only
+	// writer of the slots and Head, the consumers only move Tail. Both
+	// count points forever and are masked into the ring.
+	mnDataAcqPt Points[DATAACQ_RING_LEN];
+	CCatomicUpdate Head;
+	CCatomicUpdate Tail;
+	// Points dropped because the ring was full
+	CCatomicUpdate Dropped;
 	// Sequence check
 	nodelong SeqCheck;
 	// Set when have lost samples in Points
 	nodebool Overflow;
+	// Set to mark the next point stored as following a gap
+	nodebool GapPending;
 	// Samples since the start of acquisition
 	nodeulong SampleCount;
 	// The time between samples
 	double SampRateMilliSec;
+	// Latest point time and the host time it arrived, under ClockSeq
+	CCseqLock ClockSeq;
+	double ClockNodeMs;
+	double ClockHostMs;
 	// Construction initialization
 	_dataAcqInfo() {
 		SampRateMilliSec = 0;
 		SeqCheck = 0;
 		Overflow = FALSE;
+		GapPending = FALSE;
 		SampleCount = 0;
+		ClockNodeMs = ClockHostMs = 0;
+	}
+	// Points waiting for the consumer
+	nodeulong Count() const {
+		return((nodeulong)((Uint32)Head.Fetch() - (Uint32)Tail.Value()));
 	}
 } dataAcqInfo;
 //																			  *
@@ -518,49 +557,142 @@ typedef struct _dataAcqInfo {
 //  This is a command response tracking database element. After a command is
 //	sent the information in this structure is used to copy the response to the
 //	waiting thread and signal its restart.
+//
+//	Each respNodeList owns a ring of these. The commanding threads, serialized
+//	by the command lock, fill and publish trackers at the ring's put index.
+//	Only the read thread, or a thread that has halted it, retires them at the
+//	take index. Everyone else changes a tracker through its <state> with
+//	compare-and-swap, using the token of the send it expects.
+
+// respTrackInfo::state values, the upper bits hold TRK_TOKEN(nSentAtAddr)
+#define TRK_PENDING			0			// Sent, response expected
+#define TRK_CLAIMED			1			// Read thread is storing the response
+#define TRK_DONE			2			// Response delivered
+#define TRK_CANCELED		3			// Abandoned, read thread will retire it
+#define TRK_EXPIRED			4			// Timed-out, read thread will retire it
+#define TRK_STATE_MASK		7
+#define TRK_TOKEN(sendCnt)	((LONG)((sendCnt) << 3))
+
 typedef struct _respTrackInfo {
-	struct _respTrackInfo *next;		// Ptr to next response waiting thread
+	CCatomicUpdate state;				// Token and TRK_xxx state
 	nodebool bufOK;						// TRUE if the buf has data
 	packetbuf *buf;						// User's response location
 	// This event blocks the commanding thread from running until
 	// the response is detected.
-	CCEvent evtRespWait;
+	CCspinEvent evtRespWait;
 	Uint32 sendSerNum;					// Sending serial number
 	Uint32 nSentAtAddr;					// sendCnt for this node
 	double cmdStartAt;					// Time-stamp at start of infcSendCommand
 	double funcStartAt;					// Time-stamp at start of infcRunCommand
 	mnCompletionInfo stats;				// Command completion statistics
+	// Set for infcRunCommandAsync submissions, no thread waits on the event
+	infcCmdAsyncCallback asyncFunc;		// User's completion function
+	void *asyncContext;					// User's completion context
+	nodebool stopLane;					// Holds a stop lane slot, not a pacing slot
 	// Construct an empty tracking info record
 	_respTrackInfo() {
 		bufOK = false;
 		buf = NULL;
-		next = NULL;
 		sendSerNum = nSentAtAddr = 0;
 		cmdStartAt = 0;
+		asyncFunc = NULL;
+		asyncContext = NULL;
+		stopLane = FALSE;
 	}
 } respTrackInfo;
 
-// This is the main by-node tracking database element. It holds the list of
+// A finished asynchronous command waiting for the read thread to deliver
+// it to the completion function outside of the command lock.
+typedef struct _respAsyncDone {
+	infcCmdAsyncCallback func;			// User's completion function
+	void *context;						// User's completion context
+	packetbuf *buf;						// User's response location
+	cnErrCode err;						// Outcome of the command
+} respAsyncDone;
+
+// This is the main by-node tracking database element. It holds the ring of
 // expected responses for a particular node as well as error information and
 // some by-node statistics.
 typedef struct _respNodeList {
-	respTrackInfo *head;				// Head (oldest) waiter on the net
-	respTrackInfo *tail;				// Tail (newest) waiter on the net
+	respTrackInfo *trk;					// Tracker ring, power of 2 long
+	Uint32 trkMask;						// Ring length - 1
+	CCatomicUpdate putIdx;				// Next tracker to send with
+	CCatomicUpdate takeIdx;				// Oldest tracker awaiting response
 	packetbuf errPkt;					// Error packet
 	Uint32 sendCnt;						// Sending count
 	Uint32 respCnt;						// Receive count
 	// Construct an empty by node tracker
 	_respNodeList() {
-		head = tail = NULL;
+		trk = NULL;
+		trkMask = 0;
 		sendCnt = respCnt = -1;
 		errPkt.Byte.BufferSize = 0;
 	}
+	// Tracker for ring index <idx>
+	respTrackInfo *at(Uint32 idx) {
+		return &trk[idx & trkMask];
+	}
+	// Number of trackers awaiting responses
+	Uint32 count() {
+		return (Uint32)putIdx.Value() - (Uint32)takeIdx.Value();
+	}
+	// Oldest tracker awaiting a response, NULL if none
+	respTrackInfo *head() {
+		return count() ? at(takeIdx.Value()) : NULL;
+	}
 } respNodeList;
 //																			  *
 //*****************************************************************************
 
 
 
+//*****************************************************************************
+// NAME																          *
+// 	latencyHist class
+//
+// DESCRIPTION
+//		Log-linear histogram of command round trips in microseconds. Each
+//		power of two is split into LAT_HIST_SUBS buckets, which bounds the
+//		error to 1/LAT_HIST_SUBS. Any thread may record or collect, the
+//		read thread records round trips and the stop lane its stop times.
+//		Buckets are counted up atomically and the maximum raised by
+//		compare and swap, and they are taken by atomic exchange when
+//		collecting with reset so no sample is lost between windows.
+//
+#define LAT_HIST_SUB_BITS	4							// Log2 of LAT_HIST_SUBS
+#define LAT_HIST_SUBS		(1<<LAT_HIST_SUB_BITS)		// Buckets per octave
+#define LAT_HIST_OCTAVES	21							// Up to 2^26 usec, ~67 s
+#define LAT_HIST_BUCKETS	(2*LAT_HIST_SUBS + LAT_HIST_OCTAVES*LAT_HIST_SUBS)
+
+class latencyHist {
+private:
+	CCatomicUpdate m_bucket[LAT_HIST_BUCKETS];
+	CCatomicUpdate m_max;				// Largest sample (usec)
+	CCatomicUpdate m_timeouts;			// Commands that timed-out
+	static unsigned bucketOf(Uint32 usec);
+	static Uint32 bucketTop(unsigned bucket);
+public:
+	// Add a round trip of <msec>
+	void record(double msec);
+	// Count a command that timed-out
+	void recordTimeout() {
+		m_timeouts.Incr();
+	}
+	// Add our counts to <counts>, <pMax> and <pTimeouts>, clearing them
+	// if <reset> is set
+	void collect(Uint32 counts[LAT_HIST_BUCKETS], Uint32 *pMax,
+				 Uint32 *pTimeouts, nodebool reset);
+	// Summarize gathered <counts>
+	static void summarize(const Uint32 counts[LAT_HIST_BUCKETS], Uint32 maxUsec,
+						  Uint32 timeouts, mnLatencyStats *pStats);
+	// Command group of <pCmd>
+	static mnLatencyClass classOf(const packetbuf *pCmd);
+};
+//																			  *
+//*****************************************************************************
+
+
+
 //*****************************************************************************
 // NAME																          *
 // 	autoDiscoverThread class
@@ -748,6 +880,39 @@ private:
 //*****************************************************************************
 
 
+//*****************************************************************************
+// NAME																          *
+// 	netStopLaneThread class
+//
+// DESCRIPTION
+//		Sends the group shutdown node stops for one port as soon as they are
+//		requested. Its commands bypass the pacing window, using the
+//		STOP_LANE_SLOTS held back for it, so a busy port does not delay them.
+//		A node's tracker ring has room for its stop past the window.
+//
+class netStopLaneThread : public CThread
+{
+private:
+	netStateInfo *pNCS;						// Our net context
+	packetbuf m_cmds[MN_API_MAX_NODES];		// Stops being sent
+	packetbuf m_resps[MN_API_MAX_NODES];	// Their responses
+	// Send a stop to every node in the group shutdown
+	void sendStops();
+
+public:
+	// Construction/Destruction
+	netStopLaneThread(netStateInfo *pTheNetInfo);
+	~netStopLaneThread();
+
+	// CThread overrides for terminate
+	void *Terminate();
+protected:
+	int Run(void *context);				// Control function
+};
+//																			  *
+//*****************************************************************************
+
+
 //*****************************************************************************
 // NAME																          *
 // 	netStateInfo class
@@ -792,7 +957,7 @@ public:
 	// Set this to cause all threads to terminate
 	nodebool SelfDestruct;				// Net wide self-destruct flag
 
-	nodeulong nRespOutstanding;			// Number of responses waiting
+	CCatomicUpdate nRespOutstanding;	// Number of responses waiting
 	nodeulong nPktsSent;				// Number of packets sent
 	nodeulong nPktsRcvd;				// Number of packets received
 
@@ -816,6 +981,23 @@ public:
 
 	nodeulong RingCmdsMax;				// Max # of simultaneous cmds in ring
 	CCSemaphore CmdPaceSemaphore;		// Command pacing semaphore
+
+	// Adaptive command window. The window is the number of pacing slots
+	// the commanding threads may use, the rest of the <RingCmdsMax> slots
+	// are parked here. Protected by PaceLock.
+	CCCriticalSection PaceLock;			// Command window lock
+	nodebool PaceAdaptive;				// Window follows ring latency
+	nodeulong PaceWindow;				// Current command window
+	nodeulong PaceParked;				// Slots held out of the window
+	nodeulong PaceParkDebt;				// Slots to park as they free up
+	nodeulong PaceRoundCnt;				// Completions in this round
+	nodeulong PaceRoundDepth;			// Deepest ring seen this round
+	double PaceMinRTT;					// Best ring round trip (ms)
+	double PaceSmoothRTT;				// Smoothed ring round trip (ms)
+
+	// Command round trip histograms by node, the last row holds the
+	// control packets. Recorded by the read thread.
+	latencyHist LatHist[MN_API_MAX_NODES+1][MN_LAT_ALL];
 #ifdef _DEBUG
 	long	SemaCount;
 #endif
@@ -824,7 +1006,7 @@ public:
 	// Interrupt events
 	CCEvent IrqEvent;					// IRQ event signaller
 	CCEvent ReadCommEvent;				// Read pacing signaller
-	CCEvent GroupShutdownEvent;			// Group Shutdown signaller
+	CCEvent PollWakeEvent;				// Cuts the poller's delay short
 
 	Uint32 ctsCount;
 
@@ -842,14 +1024,18 @@ public:
 	// Command Tracking State
 	// ---------------------------------
 	// These are the command tracking information records
-	// They contain house keepers, events and tracking info. They are assigned 
-	// via the pTrkTail pointer.  When the tracking is complete it is
-	// put back at the tail.
-	respTrackInfo **pTrkFixedList;		// Ptr to pTrkInfo ptrs
-	respTrackInfo **pTrkList;			// Ptr to pTrkInfo ptrs
-	respTrackInfo **pTrkTail;			// Ptr to available tracker
+	// They contain house keepers, events and tracking info. Each node list
+	// and the control list own a ring of <TrkRingLen> of them, long enough
+	// for every command the pacing semaphore lets into the ring and the
+	// node's stop.
+	respTrackInfo *pTrkStore;			// Storage for all the rings
+	nodeulong TrkRingLen;				// Trackers per ring
 	respNodeList respNodeState[MN_API_MAX_NODES];
 	respNodeList controlNodeState;
+	// Asynchronous commands finish into this queue, owned by the read thread
+	std::queue<respAsyncDone> AsyncDone;
+	CCatomicUpdate nAsyncPending;		// Async cmds not yet delivered
+	double AsyncDueAt;					// Earliest async time-out, 0 if none
 
 
 	CCCriticalSection IOlock;			// ISC-TG I/O RMW lock
@@ -878,6 +1064,17 @@ public:
 	netPollerThread *pPollerThread;
 	Uint32 pollDelayTimeMS;
 
+	// ---------------------------------
+	// Group shutdown stop lane
+	// ---------------------------------
+	netStopLaneThread *pStopLane;		// Sends the group shutdown stops
+	CCSemaphore StopPaceSemaphore;		// In-flight slots kept for stops
+	CCEvent StopLaneEvent;				// Stop request signaller
+	CCCriticalSection StopLaneLock;		// Request time lock
+	double StopReqAt;					// Oldest unserved request, 0 if none
+	double StopBurstReqAt;				// Request time of the stops being sent
+	latencyHist StopLaneHist;			// Request to wire times
+
 	// ---------------------------------
 	// Construct or destroy our instance
 	// ---------------------------------
@@ -898,13 +1095,42 @@ public:
 	// Inquire if current thread is the read thread.
 	nodebool isReadThread();
 
-	// Tracking data base maintainence
-	void removeThisDBitem(
-				respTrackInfo *pRespInfo,
+	// Tracking data base maintainence, read thread only
+	respTrackInfo *claimHeadDBitem(
 				respNodeList *pRespArea);
 
 	void removeHeadDBitem(
-				respNodeList *pRespArea);
+				respNodeList *pRespArea,
+				cnErrCode abandonErr = MN_ERR_CANCELED);
+
+	void reapDBitems();
+
+	// Adaptive command window maintenance
+	void paceAdapt(
+				nodebool adaptive);
+	void paceUpdate(
+				double ringTime,
+				nodeulong ringDepth,
+				nodebool failed);
+	void paceSetWindow(
+				nodeulong newWindow);
+	bool releasePaceSlot();
+
+	// Latency histogram a command is recorded in
+	latencyHist &latHistOf(
+				const packetbuf *pCmd);
+
+	// Ask the stop lane to run the group shutdown for an event at <eventAt>
+	void stopLaneRequest(
+				double eventAt);
+
+	// Asynchronous command completion maintenance
+	void retireAsyncItem(
+				respTrackInfo *pRespInfo,
+				cnErrCode theErr);
+	void expireAsyncItems();
+	void dispatchAsyncDone();
+	void abandonAsyncItems();
 
 	// Waits for network traffic to complete without sending any data
 	void waitForIdle();
@@ -931,6 +1157,12 @@ extern "C" {
 			nodeushort cNum,						// Port Index
 			packetbuf *theCommand);			    // Ptr to buffered command
 
+	// Low Level transmission of several commands in one serial write
+	cnErrCode MN_DECL infcSendCommands(
+			netaddr cNum,						// Port Index
+			packetbuf *theCommands,				// Ptr to buffered commands
+			size_t nCmds);						// Number of commands
+
 	// ---------------------------------
 	// CALLBACK INTERFACES
 	// ---------------------------------
@@ -183,13 +183,19 @@ typedef union _appNodeParam {
 typedef struct _paramValue {
 	double value;					///< Current numeric value (if exists)
 	nodebool exists;				///< Value present
-	nodebool isPolled;				// Value is polled (not used)
+	nodebool fromGroup;				// Sample came from netGetParameterGroup
+	nodeulong generation;			// Cache generation \a exists holds for
+	float maxAge;					// PT_RT reads younger (ms) are shared
+	double readTime;				// infcCoreTime the node read started
 	packetbuf raw;					///< The "raw" octet value
 #ifdef __cplusplus
 	_paramValue() {
 		value = 0;
 		exists = false;
-		isPolled = false;
+		fromGroup = false;
+		generation = 0;
+		maxAge = 0;
+		readTime = 0;
 	}
 #endif
 } paramValue;
@@ -743,6 +749,7 @@ typedef struct _paramBank  {
 	nodeulong nParams;				// Number of parameters in bank
 	const paramInfoLcl *fixedInfoDB;// Fixed parameter info (static alloc)
 	paramValue *valueDB;			// Value database (dynamic alloc)
+	nodeulong valGeneration;		// Bumped to invalidate the bank's values
 } paramBank;
 
 typedef struct _byNodeDiagStats
@@ -794,6 +801,7 @@ typedef struct _byNodeDB  {
 	byNodeClassDB *pClassInfo;		// Class common information
 	deleteFunc delFunc;				// Cleanup and delete function
 	void *pNodeSpecific;			// Ptr to node specific 
+	nodeulong valGeneration;		// Bumped to invalidate the node's values
 	_byNodeDB() {
 		paramBankList = NULL;
 		pNodeSpecific = NULL;
@@ -801,6 +809,7 @@ typedef struct _byNodeDB  {
 		delFunc = NULL;
 		bankCount = 0;
 		rank = 0;
+		valGeneration = 0;
 	}
 } byNodeDB;
 
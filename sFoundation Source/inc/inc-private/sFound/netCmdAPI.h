@@ -50,7 +50,8 @@
 typedef enum _configFmts {
 	CLASSIC,							///< Creates setup compatible file
 	ALL_NON_VOLATILE,					///< CLASSIC + all non-volatile items
-	CLASSIC_NO_RESET					///< Setup compatible file, no reset at end
+	CLASSIC_NO_RESET,					///< Setup compatible file, no reset at end
+	CLASSIC_DIFF						///< CLASSIC_NO_RESET writing only changes
 } configFmts;
 //																			   *
 //******************************************************************************
@@ -83,6 +84,10 @@ MN_EXPORT cnErrCode MN_DECL netReverseAddress(
 MN_EXPORT cnErrCode MN_DECL netEnumerate(
 		netaddr cNum);
 
+// Bring the nodes of the last good inventory back online without a scan
+MN_EXPORT cnErrCode MN_DECL netReattach(
+		netaddr cNum);
+
 //----------------------------------
 // COMMAND INTERFACE
 //----------------------------------
@@ -117,6 +122,16 @@ MN_EXPORT cnErrCode MN_DECL netClrParamCache(
 		multiaddr theMultiAddr,
 		mnParams parameter);
 
+// Serve real-time reads younger than <maxAgeMsec> from the cache
+MN_EXPORT cnErrCode MN_DECL netSetParamMaxAge(
+		multiaddr theMultiAddr,
+		mnParams parameter,
+		double maxAgeMsec);
+
+// Keep node parameter cache files in <dirPath>, NULL turns the cache off
+MN_EXPORT cnErrCode MN_DECL netSetParamCacheDir(
+		const char *dirPath);
+
 // C++ Overloaded parameter accessors with multiaddr argument for numeric
 // parameters.
 MN_EXPORT cnErrCode MN_DECL netGetParameterDbl(
@@ -137,6 +152,15 @@ MN_EXPORT cnErrCode MN_DECL netGetParameterInfo(
 		nodeparam theParam,			// Parameter number
 		paramInfo *pRetValInfo,		// Ptr to returning value info or NULL
 		paramValue *pRetVal);		// Ptr to returning value or NULL
+
+// Read a group of parameters on a port in one pipelined burst for the
+// following netGetParameterInfo calls
+MN_EXPORT cnErrCode MN_DECL netGetParameterGroup(
+		netaddr cNum,				// Port index
+		size_t nParams,				// Number of parameters
+		const multiaddr *theMultiAddrs,	// Node address of each
+		const nodeparam *theParams,	// Parameter number of each
+		double *theReadTimes);		// Response time of each or NULL
 	
 //----------------------------------
 // ALERT INTERFACE
@@ -333,6 +357,13 @@ MN_EXPORT cnErrCode MN_DECL netConfigLoad(
 		multiaddr theMultiAddr,
 		configFmts loadFmt,
 		const char *pFilePath);
+
+// Load a file into each node on a port at once
+MN_EXPORT cnErrCode MN_DECL netConfigLoadPort(
+		netaddr cNum,
+		configFmts loadFmt,
+		size_t nNodes,
+		const char *const *pFilePaths);
 #ifdef __cplusplus
 }
 #endif
@@ -190,12 +190,19 @@ void coreFreeAllNodeInfo(netaddr cNUm);
 // Force flush of all cached values, next read is from the node
 void coreInvalidateValCache(netaddr cNum);
 void coreInvalidateValCacheByNode(netaddr cNum, nodeaddr nodeAddr);
+void coreInvalidateValCacheByBank(netaddr cNum, nodeaddr nodeAddr,
+								  unsigned bank);
 
 // Update the parameter database manually from a double
 cnErrCode coreSetParamFromBytes(multiaddr multiAddr, 
 								 nodeparam paramNum,
 								 nodeuchar *pVal,
 								 unsigned sizeInBytes);
+// Fill the parameter database as though the node was just read
+cnErrCode coreSeedParamValue(multiaddr theMultiAddr,
+							 nodeparam paramNum,
+							 const nodeuchar *pVal,
+							 unsigned sizeInBytes);
 
 // Common initialize logic
 typedef cnErrCode (*coreParamSetupFuncPtr)(multiaddr theMultiAddr);
@@ -0,0 +1,101 @@
+//*****************************************************************************
+// DESCRIPTION:
+///		\file
+///		On-disk cache of the parameter values a node keeps between power
+///		cycles, used to skip the bulk reads when a known node is opened.
+//
+// CREATION DATE:
+//		10/18/2026 08:05:12
+//
+// COPYRIGHT NOTICE:
+//		(C)Copyright 2026  Teknic, Inc.  All rights reserved.
+//
+//		This copyright notice must be reproduced in any copy, modification,
+//		or portion thereof merged into another program. A copy of the
+//		copyright notice must be included in the object library of a user
+//		program.
+//																			  *
+//*****************************************************************************
+/// \cond INTERNAL_DOC
+
+#ifndef __PARAMCACHE_H__
+#define __PARAMCACHE_H__
+//*****************************************************************************
+// NAME																	      *
+// 	paramCache.h headers included
+//
+	#include "tekTypes.h"
+	#include "pubMnNetDef.h"
+	#include "mnErrors.h"
+	#include "mnParamDefs.h"
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	paramCache.h constants
+//
+// Cache file signature and layout version
+#define PARAM_CACHE_MAGIC		0x43504653		// "SFPC"
+#define PARAM_CACHE_VERSION		1
+// Longest cache directory path
+#define PARAM_CACHE_PATH_MAX	256
+// Non-volatile values read back to check a file against its node
+#define PARAM_CACHE_NV_CHECKS	8
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	paramCacheKey
+//
+// DESCRIPTION
+//	Identity and state of a node that a cache file must match. The serial
+//	number, firmware version and part number name the file, the rest is
+//	checked against the file's copy.
+//
+#pragma pack(push,1)
+typedef struct _paramCacheKey {
+	Uint32 serialNum;					// Unit serial number
+	Uint16 fwVers;						// Firmware version
+	Uint16 romSum;						// Firmware checksum
+	Uint16 eeVer;						// Non-volatile layout version
+	Uint16 nvModified;					// Non-volatile changes since config load
+	char partNum[MN_PART_NUM_SIZE+1];	// Part number string
+	char motorFile[MN_FILENAME_SIZE+1];	// Last configuration file loaded
+} paramCacheKey;
+#pragma pack(pop)
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	paramCache.h function prototypes
+//
+// True if a cache directory is set
+nodebool coreParamCacheOn();
+// True if <info> describes a value the cache may hold. Non-volatile values
+// are only held when <withNV> is set.
+nodebool coreParamCacheable(const paramInfo &info, nodebool withNV);
+// Seed the node's value database from its cache file and start tracking
+// the node for coreParamCacheSave
+cnErrCode coreParamCacheLoad(multiaddr theMultiAddr,
+							 const paramCacheKey &key);
+// Write the node's cache file from the values read this session
+cnErrCode coreParamCacheSave(multiaddr theMultiAddr);
+// Remove the node's cache file ahead of a configuration load
+void coreParamCacheForget(multiaddr theMultiAddr);
+//																			  *
+//*****************************************************************************
+
+#endif
+/// \endcond
+//=============================================================================
+//	END OF FILE paramCache.h
+//=============================================================================
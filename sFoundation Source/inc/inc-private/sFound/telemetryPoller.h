@@ -0,0 +1,133 @@
+//*****************************************************************************
+// DESCRIPTION:
+///		\file
+///		Background sampler that refreshes a set of real-time parameters on
+///		one port at a fixed rate and publishes them in a sequence locked
+///		snapshot.
+//
+// CREATION DATE:
+//		10/18/2026 11:20:05
+//
+// COPYRIGHT NOTICE:
+//		(C)Copyright 2026  Teknic, Inc.  All rights reserved.
+//
+//		This copyright notice must be reproduced in any copy, modification,
+//		or portion thereof merged into another program. A copy of the
+//		copyright notice must be included in the object library of a user
+//		program.
+//																			  *
+//*****************************************************************************
+/// \cond INTERNAL_DOC
+
+#ifndef __TELEMETRYPOLLER_H__
+#define __TELEMETRYPOLLER_H__
+//*****************************************************************************
+// NAME																	      *
+// 	telemetryPoller.h headers included
+//
+	#include "tekTypes.h"
+	#include "tekThreads.h"
+	#include "tekEvents.h"
+	#include "pubSysCls.h"
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	telemetryPoller.h constants
+//
+// Most values one port can sample
+#define TELEMETRY_MAX_SAMPLES	128
+// Raw octets kept per sample, enough for the status register
+#define TELEMETRY_RAW_MAX		8
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	telemetrySample
+//
+// DESCRIPTION
+//	One sampled parameter as published in the snapshot.
+//
+typedef struct _telemetrySample {
+	double value;					// Value in base units
+	double sampleTime;				// infcCoreTime of the response, 0 if none
+	Uint8 raw[TELEMETRY_RAW_MAX];	// Leading raw octets
+} telemetrySample;
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		class CTelemetryPoller
+//
+//	DESCRIPTION:
+/**
+	Refresh a set of parameters on a port at a fixed rate. Each pass reads
+	the set as one pipelined burst and publishes the good reads under a
+	sequence lock, readers copy their sample without waiting on the poller
+	or the network.
+
+	The sample set is only changed while the poller is stopped, the slots
+	keep their storage for the life of the poller so a reader holding a
+	stale slot number sees an unsampled slot rather than freed memory.
+**/
+//	SYNOPSIS:
+class CTelemetryPoller : public CThread
+{
+private:
+	netaddr m_cNum;							// Port sampled
+	double m_periodMs;						// Time between bursts
+	size_t m_nSamples;						// Slots in use
+	multiaddr m_addrs[TELEMETRY_MAX_SAMPLES];
+	nodeparam m_params[TELEMETRY_MAX_SAMPLES];
+	sFnd::ValueBase *m_values[TELEMETRY_MAX_SAMPLES];
+	// The published snapshot and its sequence lock
+	CCseqLock m_seq;
+	telemetrySample m_samples[TELEMETRY_MAX_SAMPLES];
+	// Scratch for the next snapshot, poller only
+	telemetrySample m_next[TELEMETRY_MAX_SAMPLES];
+	bool m_nextOK[TELEMETRY_MAX_SAMPLES];
+	double m_readTimes[TELEMETRY_MAX_SAMPLES];
+	// Wakes the poller early to stop
+	CCEvent m_wake;
+	// Serializes Start and Stop
+	CCCriticalSection m_ctlLock;
+	// Read the set and publish it
+	void sampleAll();
+	int Run(void *context);
+public:
+	CTelemetryPoller(netaddr cNum);
+	~CTelemetryPoller();
+	// Sample <values>, read from <addrs> and <params>, every <periodMs>.
+	// The first pass runs before return.
+	cnErrCode Start(sFnd::ValueBase *const values[], const multiaddr *addrs,
+					const nodeparam *params, size_t nValues, double periodMs);
+	// Stop sampling and forget the set
+	void Stop();
+	// Wake a sleeping poller to terminate
+	HANDLE Terminate();
+	// Number of values sampled
+	size_t Count() { return m_nSamples; }
+	// The value in <slot>
+	sFnd::ValueBase *Value(size_t slot) { return m_values[slot]; }
+	// Copy the latest sample of <slot>, false if it has none or <slot>
+	// does not hold <value>
+	bool Read(size_t slot, const sFnd::ValueBase *value,
+			  telemetrySample &sample) const;
+};
+//																			  *
+//*****************************************************************************
+
+#endif
+/// \endcond
+//=============================================================================
+//	END OF FILE telemetryPoller.h
+//=============================================================================
@@ -896,6 +896,15 @@ class SysCPMportAdv : public IPortAdv
 private:
 	SysCPMattnPort m_attnPort;
 	void TriggerMovesInGroup(size_t groupNumber);
+	size_t CmdWindow();
+	size_t CmdWindowMax();
+	void CmdWindowMax(size_t newMax);
+	bool CmdWindowAdaptive();
+	void CmdWindowAdaptive(bool adaptive);
+	mnLatencyStats LatencyStats(mnLatencyClass latClass, bool resetWindow);
+	mnLatencyStats LatencyStats(size_t nodeIndex, mnLatencyClass latClass,
+								bool resetWindow);
+	mnLatencyStats StopLatencyStats(bool resetWindow);
 protected:
 	SysCPMportAdv(IPort &ourPort);
 };
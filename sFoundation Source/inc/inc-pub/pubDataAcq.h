@@ -161,7 +161,9 @@ typedef struct _mnDataAcqPt {
 	nodeushort Sequence;		// Sequencing check
 	nodebool Bool0;				// Spare
     nodebool Bool1;				// Spare
-	nodebool Valid;				// Data gap
+	nodebool Valid;				// Clear on the first point after a gap. When
+								// the host falls behind the newest points
+								// are dropped, those not read yet are kept.
     nodelong Spare[2];			// (unused) Future expansion/padding
 #ifdef __cplusplus
     _mnDataAcqPt() {
@@ -536,6 +536,174 @@ struct _ShutdownInfo {
 typedef struct _ShutdownInfo ShutdownInfo;
 //																			   *
 //******************************************************************************
+
+
+
+//*****************************************************************************
+// NAME	
+//	mnLatencyClass enum
+/**
+	\brief Command groups kept apart by the command latency statistics.
+
+	\see sFnd::IPortAdv::LatencyStats
+**/
+enum _mnLatencyClass {
+	MN_LAT_GET_PARAM,				///< Parameter reads
+	MN_LAT_SET_PARAM,				///< Parameter writes
+	MN_LAT_DATA_COLLECT,			///< Data collection commands
+	MN_LAT_TRIGGER,					///< Move group triggers
+	MN_LAT_NODE_STOP,				///< Node stops
+	MN_LAT_OTHER,					///< Everything else
+	MN_LAT_ALL						///< All of the above combined
+};
+/// \copybrief _mnLatencyClass
+typedef enum _mnLatencyClass mnLatencyClass;
+//																			   *
+//******************************************************************************
+
+
+
+//*****************************************************************************
+// NAME	
+//	mnLatencyStats struct
+/**
+	\brief Command round trip latency summary.
+
+	The latency is the time from the command being written to the port
+	until its response is read back. It covers the host's serial driver,
+	the USB bridge and the nodes themselves. The percentiles are the upper
+	bounds of the histogram buckets they fall in, which are within about
+	6% of the true value.
+
+	\see sFnd::IPortAdv::LatencyStats
+**/
+struct _mnLatencyStats {
+	/**
+		Number of responses measured.
+	**/
+	nodeulong Count;
+	/**
+		Number of commands that timed-out waiting for their response.
+	**/
+	nodeulong Timeouts;
+	/**
+		Median latency in milliseconds.
+	**/
+	double P50;
+	/**
+		90th percentile latency in milliseconds.
+	**/
+	double P90;
+	/**
+		99th percentile latency in milliseconds.
+	**/
+	double P99;
+	/**
+		Largest latency seen in milliseconds.
+	**/
+	double Max;
+#ifdef __cplusplus
+													/** \cond INTERNAL_DOC **/
+	_mnLatencyStats() {
+		Count = Timeouts = 0;
+		P50 = P90 = P99 = Max = 0;
+	}
+													/** \endcond **/
+#endif
+};
+/// \copybrief _mnLatencyStats
+typedef struct _mnLatencyStats mnLatencyStats;
+//																			   *
+//******************************************************************************
+
+
+
+//*****************************************************************************
+// NAME	
+//	mnSnapField enum
+/**
+	\brief Fields captured by a machine snapshot.
+
+	\see sFnd::IPort::Snapshot
+**/
+enum _mnSnapField {
+	MN_SNAP_POSN,					///< Measured position
+	MN_SNAP_VEL,					///< Measured velocity
+	MN_SNAP_TRQ,					///< Measured torque
+	MN_SNAP_STATUS,					///< Real-time status register
+	MN_SNAP_FIELDS					///< Number of fields
+};
+/// \copybrief _mnSnapField
+typedef enum _mnSnapField mnSnapField;
+//																			   *
+//******************************************************************************
+
+
+
+//*****************************************************************************
+// NAME	
+//	mnMachineSnapshot struct
+/**
+	\brief State of every node on a port captured in one sweep.
+
+	Each field is an array indexed by node, so a field can be compared
+	across nodes directly. The values are in each node's current units.
+	The sample times record when each response arrived, two samples with
+	the same time came back in the same serial read.
+
+	\see sFnd::IPort::Snapshot
+**/
+struct _mnMachineSnapshot {
+	/**
+		Number of nodes captured.
+	**/
+	size_t NodeCount;
+	/**
+		SysManager::TimeStampMsec time the sweep was sent.
+	**/
+	double SweepStartMsec;
+	/**
+		Milliseconds between the first and the last sample of the sweep.
+	**/
+	double SkewMsec;
+	/**
+		Measured position of each node.
+	**/
+	double PosnMeasured[MN_API_MAX_NODES];
+	/**
+		Measured velocity of each node.
+	**/
+	double VelMeasured[MN_API_MAX_NODES];
+	/**
+		Measured torque of each node.
+	**/
+	double TrqMeasured[MN_API_MAX_NODES];
+	/**
+		Real-time status register of each node.
+	**/
+	mnStatusReg StatusRT[MN_API_MAX_NODES];
+	/**
+		SysManager::TimeStampMsec time each sample arrived, indexed by
+		field and node.
+	**/
+	double SampleTimeMsec[MN_SNAP_FIELDS][MN_API_MAX_NODES];
+#ifdef __cplusplus
+													/** \cond INTERNAL_DOC **/
+	_mnMachineSnapshot() {
+		NodeCount = 0;
+		SweepStartMsec = SkewMsec = 0;
+		memset(PosnMeasured, 0, sizeof(PosnMeasured));
+		memset(VelMeasured, 0, sizeof(VelMeasured));
+		memset(TrqMeasured, 0, sizeof(TrqMeasured));
+		memset(SampleTimeMsec, 0, sizeof(SampleTimeMsec));
+	}
+													/** \endcond **/
+#endif
+};
+/// \copybrief _mnMachineSnapshot
+typedef struct _mnMachineSnapshot mnMachineSnapshot;
+//																			   *
+//******************************************************************************
 #endif // __TI_COMPILER_VERSION__
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -0,0 +1,312 @@
+//******************************************************************************
+// DESCRIPTION
+/**
+	\file
+	\brief Operating System Specific Programming Interfaces for Linux
+
+	The Linux counterpart of lnkAccessWin32.cpp. Contains the precision
+	time stamps, the error message lookup and the hub port search the
+	common link code relies on.
+**/
+// CREATION DATE:
+//	10/18/2026 Refactored from the Win32 implementation
+//
+// COPYRIGHT NOTICE:
+//	(C)Copyright 2026  Teknic, Inc.  All rights reserved.
+//
+//	This copyright notice must be reproduced in any copy, modification,
+//	or portion thereof merged into another program. A copy of the
+//	copyright notice must be included in the object library of a user
+//	program.
+// 																			   *
+//******************************************************************************
+
+
+/// \cond INTERNAL_DOC
+
+//******************************************************************************
+// NAME																		   *
+// 	lnkAccessLinux.cpp headers
+//
+	// Our driver headers
+	#include "lnkAccessCommon.h"
+	#include "tekThreads.h"
+	// Linux specific headers
+	#include <dirent.h>
+	#include <dlfcn.h>
+	#include <limits.h>
+	#include <stdio.h>
+	#include <stdlib.h>
+	#include <string.h>
+	#include <time.h>
+	#include <fstream>
+	#include <algorithm>
+// 																			   *
+//******************************************************************************
+
+
+
+//******************************************************************************
+// NAME																		   *
+// 	lnkAccessLinux.cpp constants
+//
+// Where the kernel lists the tty devices
+#define SYS_TTY_DIR				"/sys/class/tty"
+// Teknic SC4-HUB USB identification
+#define TEKNIC_SC4_HUB_VID		"2890"
+#define TEKNIC_SC4_HUB_PID		"0213"
+// 																			  *
+//*****************************************************************************
+
+
+
+//******************************************************************************
+// NAME																		   *
+// 	lnkAccessLinux.cpp static variables
+//
+// Library file path, found on first use
+static char m_libPath[PATH_MAX];
+// Base data for infcCoreTime()
+static double coreStartTimeMS = -1;
+// 																			  *
+//*****************************************************************************
+
+
+
+//******************************************************************************
+//	NAME																	   *
+//		coreTimeNow
+//
+//	DESCRIPTION:
+//		Return the monotonic clock in milliseconds.
+//
+//	SYNOPSIS:
+static double coreTimeNow()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return(ts.tv_sec * 1000. + ts.tv_nsec / 1e6);
+}
+//																			   *
+//******************************************************************************
+
+
+
+//******************************************************************************
+//	NAME																	   *
+//		infcCoreTime
+//
+//	DESCRIPTION:
+//		Return the high precision time value. The time starts at the first
+//		call.
+//
+//	RETURNS:
+//		double count in milliseconds
+//
+//	SYNOPSIS:
+MN_EXPORT double MN_DECL infcCoreTime(void)
+{
+	if (coreStartTimeMS < 0)
+		coreStartTimeMS = coreTimeNow();
+	return(coreTimeNow() - coreStartTimeMS);
+}
+//																			   *
+//******************************************************************************
+
+
+
+//****************************************************************************
+//	NAME																	 *
+//		infcVersion
+//
+//	DESCRIPTION:
+//		Return the driver code in 8.8.16 format. Linux builds carry no
+//		version resource, they report 0.
+//
+//	RETURNS:
+//		unsigned long version code
+//
+//	SYNOPSIS:
+MN_EXPORT nodeulong MN_DECL infcVersion(void)
+{
+	return(0);
+}
+//																			 *
+//****************************************************************************
+
+
+
+//****************************************************************************
+//	NAME																	 *
+//		infcFilenameA
+//
+//	DESCRIPTION:
+//		Update the ANSI <fname> string up to <len> chars with the file name of
+//		this library, or of the program it is linked into.
+//
+//	RETURNS:
+//		fname updated
+//
+//	SYNOPSIS:
+MN_EXPORT void MN_DECL infcFileNameA(char *fname, long len)
+{
+	if (len <= 0)
+		return;
+	if (!m_libPath[0]) {
+		Dl_info libInfo;
+		if (dladdr((void *)infcFileNameA, &libInfo) && libInfo.dli_fname)
+			strncpy(m_libPath, libInfo.dli_fname, sizeof(m_libPath) - 1);
+	}
+	strncpy(fname, m_libPath, len);
+	fname[len - 1] = 0;
+}
+//																			 *
+//****************************************************************************
+
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		infcGetDumpDir
+//
+//	DESCRIPTION:
+///		Return the directory where automatic dump files are created with
+///		trailing directory delimitor. This will be "$TMPDIR/Teknic/", or
+///		"/tmp/Teknic/" without TMPDIR.
+//
+//	SYNOPSIS:
+void infcGetDumpDir(
+		char *pStr,						// Ptr to string area
+		nodelong maxLen)
+{
+	const char *tmpDir = getenv("TMPDIR");
+	if (!tmpDir || !tmpDir[0])
+		tmpDir = "/tmp";
+	snprintf(pStr, maxLen, "%s/Teknic/", tmpDir);
+}
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		readSysAttr
+//
+//	DESCRIPTION:
+//		Read the first line of the sysfs attribute <path>.
+//
+//	RETURNS:
+//		The line, empty if the attribute is missing
+//
+//	SYNOPSIS:
+static std::string readSysAttr(const std::string &path)
+{
+	std::ifstream attr(path.c_str());
+	std::string line;
+	if (attr)
+		std::getline(attr, line);
+	return line;
+}
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		infcGetHubPorts
+//
+//	DESCRIPTION:
+///		Return the SC Hub USB port device names. The tty devices whose USB
+///		device has the SC4-HUB's vendor and product IDs are listed as
+///		"/dev/<tty>", in name order.
+//
+//	SYNOPSIS:
+MN_EXPORT cnErrCode MN_DECL infcGetHubPorts(std::vector<std::string> &comHubPorts)
+{
+	DIR *ttyDir;
+	struct dirent *pEntry;
+
+	comHubPorts.clear();
+	ttyDir = opendir(SYS_TTY_DIR);
+	if (!ttyDir)
+		return MN_OK;
+	while ((pEntry = readdir(ttyDir)) != NULL) {
+		if (pEntry->d_name[0] == '.')
+			continue;
+		// The tty's device is the USB interface, its parent the USB device
+		std::string usbDev = std::string(SYS_TTY_DIR "/") + pEntry->d_name
+			+ "/device/..";
+		if (readSysAttr(usbDev + "/idVendor") == TEKNIC_SC4_HUB_VID
+			&& readSysAttr(usbDev + "/idProduct") == TEKNIC_SC4_HUB_PID) {
+			comHubPorts.push_back(std::string("/dev/") + pEntry->d_name);
+		}
+	}
+	closedir(ttyDir);
+	std::sort(comHubPorts.begin(), comHubPorts.end());
+	return MN_OK;
+}
+//																			  *
+//*****************************************************************************
+
+
+
+//****************************************************************************
+//	NAME
+//		infcThreadID
+//
+//	DESCRIPTION:
+//		Return the thread ID of the currently running thread.
+//
+//	SYNOPSIS:
+MN_EXPORT Uint64 MN_DECL infcThreadID()
+{
+	return CThread::CurrentThreadID();
+}
+//																			  *
+//*****************************************************************************
+
+
+
+//****************************************************************************
+//	NAME
+//		infcErrCodeStrA
+//
+//	DESCRIPTION:
+/**
+	Return a descriptive ANSI string for the selected \a cnErrCode in the
+	\a resultStr buffer. The message will be truncated at the \a maxLen
+	location if too long.
+
+	Linux builds have no message table, the code is given in hex as the
+	Win32 version does for codes it cannot find.
+
+	\param[in] lookupCode The error code to lookup.
+	\param[in] maxLen The number of characters in the \a resultStr buffer.
+	\param[in,out] resultStr A pointer to a \a maxLen buffer that the
+				   message will be placed in.
+
+	\return MN_OK if \a resultStr is updated, else failure code.
+**/
+//	SYNOPSIS:
+MN_EXPORT cnErrCode MN_DECL infcErrCodeStrA(
+	cnErrCode lookupCode,
+	Uint16 maxLen,
+	char resultStr[])
+{
+	if (!resultStr || maxLen == 0)
+		return(MN_ERR_BADARG);
+	if (lookupCode == MN_OK)
+		snprintf(resultStr, maxLen, "OK");
+	else
+		snprintf(resultStr, maxLen, "cnErrCode 0x%X", lookupCode);
+	return(MN_OK);
+}
+/// \endcond
+//																			 *
+//****************************************************************************
+
+//=============================================================================
+//	END OF FILE lnkAccessLinux.cpp
+//=============================================================================
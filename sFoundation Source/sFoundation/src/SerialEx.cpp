@@ -30,6 +30,7 @@
 
 	#include "pubMnNetDef.h"
 	#include "lnkAccessCommon.h"
+	#include <string.h>
 	#if (defined(_WIN32)||defined(_WIN64))
 		#include <crtdbg.h>
 	#endif
@@ -73,6 +74,9 @@
 // will most likely be added to the destruction time of this object.
 #define READ_TIME_OUT_MS  200
 
+// Framing characters around the payload
+#define PKT_OVERHEAD_LEN (MN_API_PACKET_HDR_LEN+MN_API_PACKET_TAIL_LEN)
+
 // Print ID in platform normal way
 #ifdef __unix
 #define THREAD_RADIX "%d"
@@ -107,6 +111,133 @@ void DUMP_PKT(const char *msg, packetbuf *buf) {
 
 
 
+//*****************************************************************************
+//	NAME																	  *
+//		spread56to64 / pack64to56
+//
+//	DESCRIPTION:
+//		Word at a time helpers for the link encoding. Seven octets loaded
+//		little endian into a 56-bit word are the same bit stream as eight
+//		7-bit link characters, so the conversion is three shift and mask
+//		steps instead of a shift pair per character.
+//
+//		spread56to64 moves each 7-bit field of <w> into the low bits of its
+//		own octet. pack64to56 is the inverse, the top bit of each octet of
+//		<w> must be clear.
+//
+//	SYNOPSIS:
+static inline Uint64 spread56to64(Uint64 w)
+{
+	w = (w & 0x000000000FFFFFFFULL) | ((w << 4) & 0x0FFFFFFF00000000ULL);
+	w = (w & 0x00003FFF00003FFFULL) | ((w << 2) & 0x3FFF00003FFF0000ULL);
+	w = (w & 0x007F007F007F007FULL) | ((w << 1) & 0x7F007F007F007F00ULL);
+	return(w);
+}
+
+static inline Uint64 pack64to56(Uint64 w)
+{
+	w = (w & 0x007F007F007F007FULL) | ((w >> 1) & 0x3F803F803F803F80ULL);
+	w = (w & 0x00003FFF00003FFFULL) | ((w >> 2) & 0x0FFFC0000FFFC000ULL);
+	w = (w & 0x000000000FFFFFFFULL) | ((w >> 4) & 0x00FFFFFFF0000000ULL);
+	return(w);
+}
+
+// Load <n> octets little endian, independent of the host byte order
+static inline Uint64 loadOctets(const nodechar *s, int n)
+{
+	Uint64 w = 0;
+	while (n-- > 0)
+		w = (w << 8) | (unsigned char)s[n];
+	return(w);
+}
+
+// Store the low <n> octets of <w> little endian
+static inline void storeOctets(nodechar *d, Uint64 w, int n)
+{
+	for (int i = 0; i < n; i++, w >>= 8)
+		d[i] = (nodechar)(w & 0xff);
+}
+
+// Sum the octets of <w>, each octet must be below 0x80
+static inline unsigned sumOctets(Uint64 w)
+{
+	w = (w & 0x00FF00FF00FF00FFULL) + ((w >> 8) & 0x00FF00FF00FF00FFULL);
+	return(unsigned((w * 0x0001000100010001ULL) >> 48));
+}
+
+// Whole group access, a single unaligned move on little endian hosts
+#if defined(_WIN32)||defined(_WIN64)||(defined(__BYTE_ORDER__) \
+	&& __BYTE_ORDER__==__ORDER_LITTLE_ENDIAN__)
+static inline Uint64 loadGroup(const nodechar *s)
+{
+	Uint64 w;
+	memcpy(&w, s, sizeof(w));
+	return(w);
+}
+
+static inline void storeGroup(nodechar *d, Uint64 w)
+{
+	memcpy(d, &w, sizeof(w));
+}
+#else
+static inline Uint64 loadGroup(const nodechar *s)
+{
+	return(loadOctets(s, 8));
+}
+
+static inline void storeGroup(nodechar *d, Uint64 w)
+{
+	storeOctets(d, w, 8);
+}
+#endif
+
+// Load the <n> octets at <s>, fewer than 8, using a whole group move when
+// the buffer ending at <end> has room for it.
+static inline Uint64 loadShort(const nodechar *s, int n, const nodechar *end)
+{
+	if (end - s < 8)
+		return(loadOctets(s, n));
+	return(loadGroup(s) & ((Uint64(1) << (8 * n)) - 1));
+}
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		findStartOfPacket / sumChars
+//
+//	DESCRIPTION:
+//		Span helpers for the packet framer. findStartOfPacket returns the
+//		index of the first character in <pChars> with the start of packet
+//		bit set, or <nChars> if there is none. sumChars returns the
+//		checksum contribution of the span.
+//
+//	SYNOPSIS:
+static inline size_t findStartOfPacket(const char *pChars, size_t nChars)
+{
+	size_t i = 0;
+	// Skip over groups of 8 plain characters
+	while (nChars - i >= 8
+	&& !(loadGroup(&pChars[i]) & 0x8080808080808080ULL))
+		i += 8;
+	while (i < nChars && !(pChars[i] & 0x80))
+		i++;
+	return(i);
+}
+
+static inline unsigned sumChars(const char *pChars, size_t nChars)
+{
+	unsigned sum = 0;
+	while (nChars--)
+		sum += *pChars++;
+	return(sum);
+}
+//																			  *
+//*****************************************************************************
+
+
 //*****************************************************************************
 //	NAME																	  *
 //		CSerialEx Construction/Destruction 
@@ -393,10 +524,10 @@ bool CSerialEx::TestAndPushHiPacket(char nextChar) {
 	if (inHighPrioState()  // Any "restart" in high-prio is bad
 	|| (!MN_PKT_IS_HIGH_PRIO(parser->PktType) && m_state != READ_STATE_IDLE)) {
 		// Create a Fragmentation Error
-		SendErrToApp(ND_ERRNET_FRAG, 0,0);
+		SendErrToApp(ND_ERRNET_FRAG, 0,0, true);
 		PacketParseReset();
 		// Reset processing and reparse this "start of packet"
-		ProcessNextChar(nextChar);
+		ProcessChunk(&nextChar, 1);
 		// Break recursion
 		return(true);
 	}
@@ -423,43 +554,104 @@ bool CSerialEx::TestAndPushHiPacket(char nextChar) {
 
 //*****************************************************************************
 //	NAME																	  *
-//		CSerialEx::ProcessNextChar
+//		CSerialEx::FrameSpan
 //
 //	DESCRIPTION:
-///		This FSM will grab sequential characters from the serial port and 
-///		extract	any detected packets and signal the application when there 
-///		are some available.
+///		Move the run of payload characters at the front of <pChunk> into
+///		the work in progress packet <pkt>. The run ends at the packet's
+///		checksum, at the next start of packet or at <pEnd>, <pChunk> is
+///		advanced past it.
 ///
-/// 	\param xxx description
-///		\return true if we are still processing
+/// 	\param pkt packet being assembled
+/// 	\param pktIndx next character location in <pkt>
+/// 	\param checksum accumulated checksum of <pkt>
+///		\return true if the packet's checksum character was consumed
 /// 
-/// 	Detailed description.
+/// 	The length field arrives in the second character so the run stops
+/// 	there to pick up the real length.
 //
 //	SYNOPSIS:
-inline void CSerialEx::ProcessNextChar(char nextChar)
+bool CSerialEx::FrameSpan(packetbuf &pkt, unsigned &pktIndx,
+						  unsigned &checksum,
+						  const char *&pChunk, const char *pEnd)
 {
+	size_t want, nChars;
+	if (pktIndx < MN_API_PACKET_HDR_LEN)
+		want = MN_API_PACKET_HDR_LEN - pktIndx;
+	else
+		want = pkt.Fld.PktLen + PKT_OVERHEAD_LEN - pktIndx;
+	if (want > size_t(pEnd - pChunk))
+		want = pEnd - pChunk;
+	nChars = findStartOfPacket(pChunk, want);
+	memcpy(&pkt.Byte.Buffer[pktIndx], pChunk, nChars);
+	checksum += sumChars(pChunk, nChars);
+	pktIndx += unsigned(nChars);
+	pChunk += nChars;
+	return(pktIndx >= pkt.Fld.PktLen + PKT_OVERHEAD_LEN);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CSerialEx::ProcessChunk
+//
+//	DESCRIPTION:
+///		This FSM will frame the characters in <pChunk> from the serial port,
+///		extract any detected packets and queue them on the receive batch.
+///		Runs of stray or payload characters are handled as spans, only
+///		the start of packet characters are handled one at a time.
+///
+/// 	\param pChunk characters to frame
+/// 	\param nChars number of characters in <pChunk>
+/// 
+/// 	The parser state carries over between calls so packets may span
+/// 	chunks.
+//
+//	SYNOPSIS:
+void CSerialEx::ProcessChunk(const char *pChunk, size_t nChars)
+{
+	const char *pEnd = pChunk + nChars;
+	size_t nStray;
+	char nextChar;
+
 #if TRACE_LOW_LEVEL
-	_RPT2(_CRT_WARN, "ProcessNextChar(%d): char 0x%02x\n",
-							m_state, nextChar);
+	_RPT2(_CRT_WARN, "ProcessChunk(%d): %d chars\n", m_state, (int)nChars);
 #endif
-	// Parser view of this char
-	packetFields *parser = (packetFields *)&nextChar;
-	// Try and extract the next packet.
-	switch(m_state) {
-	// --------------------------------------------------
-	// WAIT FOR PACKET START (IDLE)
-	// --------------------------------------------------
-	case READ_STATE_IDLE:
-		//we want to fill char 0 first
-		m_hiPrioPktIndx = m_lowPrioPktIndx = 0;
-		// do we have a start of packet?
-		if (parser->StartOfPacket) {
+	// Try and extract the packets.
+	while (pChunk < pEnd && !m_rdAutoFlush
+	&& !((m_pTermFlag != NULL) && (*m_pTermFlag))) {
+		switch(m_state) {
+		// --------------------------------------------------
+		// WAIT FOR PACKET START (IDLE)
+		// --------------------------------------------------
+		case READ_STATE_IDLE:
+			//we want to fill char 0 first
+			m_hiPrioPktIndx = m_lowPrioPktIndx = 0;
+			// Stray octets have been detected! Increment the stray count;
+			// max count of 127
+			nStray = findStartOfPacket(pChunk, pEnd - pChunk);
+			if (nStray) {
+				#if TRACE_STRAY
+					_RPT1(_CRT_WARN, "READ_STATE_IDLE: %d stray\n",
+									 (int)nStray);
+				#endif
+				if (nStray > 127 - m_strayCount)
+					m_strayCount = 127;
+				else
+					m_strayCount += unsigned(nStray);
+				pChunk += nStray;
+				break;
+			}
+			// We have a start of packet
+			nextChar = *pChunk++;
 			// if the stray packet count is > 0, send a stray error packet and zero 
 			// packet count; the data is contained in location [3] of m_strayCount
 			if (m_strayCount>0) {
 				// Construct a error packet: Type=2 (stray), Data=StrayOctetCnt
 				// Stray Error
-				SendErrToApp(ND_ERRNET_STRAY, 0, m_strayCount);
+				SendErrToApp(ND_ERRNET_STRAY, 0, m_strayCount, true);
 				m_strayCount=0;
 				m_pushedState = READ_STATE_IDLE;
 			}
@@ -472,91 +664,79 @@ inline void CSerialEx::ProcessNextChar(char nextChar)
 			m_lowInProcPacket.Fld.PktLen = MN_HDR_LEN_MASK;
 			m_lowChecksum = nextChar;
 			m_state = READ_STATE_LP_PAYLOAD;
-		} 
-		else {
-			// Stray octet has been detected!
-			// Increment stray count; max count of 127
-			if (m_strayCount < 127) {
-				#if TRACE_STRAY
-					_RPT1(_CRT_WARN, "READ_STATE_IDLE: stray 0x%x\n", 
-									 nextChar);
-				#endif
-				m_strayCount++;
-			}
-		}
-		// we are done with this character - either thrown out or processed
-		break;
-		
-	// --------------------------------------------------
-	// PROCESS THE LOW PRIORITY PACKET
-	// --------------------------------------------------
-	case READ_STATE_LP_PAYLOAD:
-		//check to see if we are the start of a high priority packet
-		if (TestAndPushHiPacket(nextChar))
 			break;
-		#define PKT_OVERHEAD_LEN (MN_API_PACKET_HDR_LEN+MN_API_PACKET_TAIL_LEN)
-		// Accumulate characters and calculate the checksum 
-		m_lowInProcPacket.Byte.Buffer[m_lowPrioPktIndx++] = nextChar;
-		m_lowChecksum += nextChar;
-		// Have we reached the checksum?
-		if (m_lowPrioPktIndx >= m_lowInProcPacket.Fld.PktLen+PKT_OVERHEAD_LEN) {
-			#if TRACE_LOW_LEVEL
-			//	printf("Checksum calc:%X Checksum received: %X\n", m_checkSumCalc, m_lowInProcPacket.Byte.Buffer[m_lowInProcPacket.Fld.PktLen+2]);
-			#endif			
-			// Non-zero means corruption					
-			if(m_lowChecksum & 0x7F) {	
-				// Checksum Error!
-				SendErrToApp(ND_ERRNET_CHKSUM, m_lowInProcPacket.Fld.Addr, 0);
-			} 
-			else {
-				// Setup the character length
-				m_lowInProcPacket.Byte.BufferSize=m_lowPrioPktIndx;
-				#if TRACE_LOW_LEVEL
-				DUMP_PKT("LO pkt", &m_lowInProcPacket);
-				#endif
-				// Send the packet to app and wait until it reads it
-				SendPacketToApp(m_lowInProcPacket,true);
+			
+		// --------------------------------------------------
+		// PROCESS THE LOW PRIORITY PACKET
+		// --------------------------------------------------
+		case READ_STATE_LP_PAYLOAD:
+			//check to see if we are the start of a high priority packet
+			if (*pChunk & 0x80) {
+				TestAndPushHiPacket(*pChunk++);
+				break;
+			}
+			// Accumulate characters and calculate the checksum, have we
+			// reached the checksum?
+			if (FrameSpan(m_lowInProcPacket, m_lowPrioPktIndx, m_lowChecksum,
+						  pChunk, pEnd)) {
+				// Non-zero means corruption					
+				if(m_lowChecksum & 0x7F) {	
+					// Checksum Error!
+					SendErrToApp(ND_ERRNET_CHKSUM, m_lowInProcPacket.Fld.Addr,
+								 0, true);
+				} 
+				else {
+					// Setup the character length
+					m_lowInProcPacket.Byte.BufferSize=m_lowPrioPktIndx;
+					#if TRACE_LOW_LEVEL
+					DUMP_PKT("LO pkt", &m_lowInProcPacket);
+					#endif
+					// Queue the packet for the app
+					SendPacketToApp(m_lowInProcPacket, true, true);
+				}
+				// We are done, go idle
+				m_state = READ_STATE_IDLE;
 			}
-			// We are done, go idle
-			m_state = READ_STATE_IDLE;
-		}
-		break;
-	// --------------------------------------------------
-	// PROCESS THE HIGH PRIORITY PACKET
-	// --------------------------------------------------
-	case READ_STATE_HP_PAYLOAD:
-		if (TestAndPushHiPacket(nextChar))
 			break;
-		// Accumulate characters and calculate the checksum 
-		m_hiInProcPacket.Byte.Buffer[m_hiPrioPktIndx++] = nextChar;
-		m_hiChecksum += nextChar;
-		// Have we reached the checksum?
-		 if (m_hiPrioPktIndx >= m_hiInProcPacket.Fld.PktLen+PKT_OVERHEAD_LEN) {
-			// Non-zero means corruption					
-			if(m_hiChecksum & 0x7F) {
-				// Checksum Error!
-				SendErrToApp(ND_ERRNET_CHKSUM, m_hiInProcPacket.Fld.Addr,0 );
-			} 
-			else {
-				// Setup the character length
-				m_hiInProcPacket.Byte.BufferSize=m_hiPrioPktIndx;
-				#if TRACE_LOW_LEVEL
-				DUMP_PKT("HI pkt", &m_hiInProcPacket);
-				#endif
-				// Send the packet to app and wait until it reads it
-				SendPacketToApp(m_hiInProcPacket,true);
+		// --------------------------------------------------
+		// PROCESS THE HIGH PRIORITY PACKET
+		// --------------------------------------------------
+		case READ_STATE_HP_PAYLOAD:
+			if (*pChunk & 0x80) {
+				TestAndPushHiPacket(*pChunk++);
+				break;
 			}
-			// Return to last processing state
-			m_state = m_pushedState;
-			m_pushedState = READ_STATE_IDLE;
-			m_hiPrioPktIndx = 0;
+			// Accumulate characters and calculate the checksum, have we
+			// reached the checksum?
+			if (FrameSpan(m_hiInProcPacket, m_hiPrioPktIndx, m_hiChecksum,
+						  pChunk, pEnd)) {
+				// Non-zero means corruption					
+				if(m_hiChecksum & 0x7F) {
+					// Checksum Error!
+					SendErrToApp(ND_ERRNET_CHKSUM, m_hiInProcPacket.Fld.Addr,
+								 0, true);
+				} 
+				else {
+					// Setup the character length
+					m_hiInProcPacket.Byte.BufferSize=m_hiPrioPktIndx;
+					#if TRACE_LOW_LEVEL
+					DUMP_PKT("HI pkt", &m_hiInProcPacket);
+					#endif
+					// Queue the packet for the app
+					SendPacketToApp(m_hiInProcPacket, true, true);
+				}
+				// Return to last processing state
+				m_state = m_pushedState;
+				m_pushedState = READ_STATE_IDLE;
+				m_hiPrioPktIndx = 0;
+			}
+			break;
+		default:
+			_RPT1(_CRT_ASSERT, "CSerialEx::ProcessChunk unknown state %d\n", m_state);
+			PacketParseReset();
+			// Process the low priority packet
+			break;
 		}
-		break;
-	default:
-		_RPT1(_CRT_ASSERT, "CSerialEx::ProcessNextChar unknown state %d\n", m_state);
-		PacketParseReset();
-		// Process the low priority packet
-		break;
 	}
 }
 //																			  *
@@ -579,9 +759,6 @@ inline void CSerialEx::ProcessNextChar(char nextChar)
 //	SYNOPSIS:
 int CSerialEx::Run(void *context)
 {
-	// Packet parsing current character
-	char thisChar;
-	
 	// Port event statististics
 	#if TRACE_THREAD || TRACE_DESTRUCT
 		_RPT2(_CRT_WARN, "%.1f CSerialEx::Run thread id=" THREAD_RADIX " starting\n", 
@@ -652,15 +829,12 @@ int CSerialEx::Run(void *context)
 		#endif
 		// Process any buffer items based on operational mode
 		if (m_packetMode) {
-			// Process all the characters in our buffer
-			while(m_rdBuffer.getChar(thisChar) && !((m_pTermFlag != NULL) && (*m_pTermFlag)) && !m_rdAutoFlush) {
-				#ifdef _DEBUG
-					static bool dbg=false;
-					if (dbg)
-						_RPT1(_CRT_WARN, "chr=0x%02x\n", 0xff&thisChar);
-				#endif
-				ProcessNextChar(thisChar);
-			}
+			// Frame all the characters in our buffer
+			const char *pChunk;
+			size_t nChunk = m_rdBuffer.takeChars(pChunk);
+			ProcessChunk(pChunk, nChunk);
+			// Hand this chunk's packets to the app together
+			SendBatchToApp();
 			// Reset the buffer for next read
 			m_rdBuffer.flush();
 		}
@@ -714,8 +888,13 @@ void CSerialEx::ProcessEvent(EEvent eEvent)
 		// We are only interested in the CTS falling edge events
 		if((eEvent & CSerial::EEventCTS) && !GetCTS()) {
 			//_RPT0(_CRT_WARN, "CSerialEx::Run got CTS fall\n");
+			// The group shutdown latency is timed from here
+			m_ErrorReport.CTSfallAt = infcCoreTime();
 			INCREMENT_ERRORCNT(m_ErrorReport.CTScnt);
 			m_ThreadParkedEvent.SetEvent();
+			// Wake the packet reader now to start the group shutdown
+			if (m_pUserCommInterrupt)
+				m_pUserCommInterrupt->SetEvent();
 		}
 		// We received the break condition, baud rate changed
 		// and note we received one.
@@ -776,13 +955,15 @@ void CSerialEx::ProcessEvent(EEvent eEvent)
 //	DESCRIPTION:
 ///		Send the <thePacket> to the application layer.
 ///
-/// 	\param xxx description
-///		\return description
+/// 	\param thePacket packet to send
+/// 	\param Convert7To8Bit convert from the link format
+/// 	\param batch hold on the read thread's batch for SendBatchToApp
 /// 
-/// 	Detailed description.
+/// 	Only the read thread may batch.
 //
 //	SYNOPSIS:
-void CSerialEx::SendPacketToApp(packetbuf &thePacket, BOOL Convert7To8Bit)
+void CSerialEx::SendPacketToApp(packetbuf &thePacket, BOOL Convert7To8Bit,
+								bool batch)
 {
 
 #if TRACE_READS
@@ -803,6 +984,10 @@ void CSerialEx::SendPacketToApp(packetbuf &thePacket, BOOL Convert7To8Bit)
 		else {
 			*pkt = thePacket;
 		}
+		if (batch) {
+			m_rxBatch.push_back(pkt);
+			return;
+		}
 		// Lock GetPkt state until we finish setup
 		m_SendPacketToAppLock.Lock();	
 		// We want to actually send, queue to back
@@ -838,12 +1023,14 @@ void CSerialEx::SendPacketToApp(packetbuf &thePacket, BOOL Convert7To8Bit)
 /// 	\param errorType type of error to return
 /// 	\param addr address to report error at
 /// 	\param data extra information to report
+/// 	\param batch hold on the read thread's batch for SendBatchToApp
 ///		\return true if we have data, else was a timeout and no data.
 /// 
 /// 	Detailed description.
 //
 //	SYNOPSIS:
-void CSerialEx::SendErrToApp(mnNetErrs errorType, unsigned addr, unsigned data)
+void CSerialEx::SendErrToApp(mnNetErrs errorType, unsigned addr, unsigned data,
+							 bool batch)
 {
 	// Construct a error packet: Type=0 (frag)
 	packetbuf errpacket;
@@ -857,7 +1044,7 @@ void CSerialEx::SendErrToApp(mnNetErrs errorType, unsigned addr, unsigned data)
 	errpacket.Byte.BufferSize = errpacket.Fld.PktLen + MN_API_PACKET_HDR_LEN;		
 	errpacket.Byte.Buffer[RESP_LOC] = (nodechar)errorType;
 	errpacket.Byte.Buffer[RESP_LOC+1] = (nodechar)data;
-	SendPacketToApp(errpacket, false);
+	SendPacketToApp(errpacket, false, batch);
 	#if TRACE_ERR
 	_RPT3(_CRT_WARN,"CSerialEx::SendErrToApp: errorType = %d ; addr = %d ; data = %d\n",
 					 errorType,addr,data);
@@ -867,6 +1054,43 @@ void CSerialEx::SendErrToApp(mnNetErrs errorType, unsigned addr, unsigned data)
 //*****************************************************************************
 
 
+//*****************************************************************************
+//	NAME																	  *
+//		CSerialEx::SendBatchToApp
+//
+//	DESCRIPTION:
+///		Queue the packets and errors the read thread framed from the last
+///		chunk to the application layer in one locked step and wake the
+///		application once.
+///
+/// 	Packets framed while a flush started are dropped.
+//
+//	SYNOPSIS:
+void CSerialEx::SendBatchToApp()
+{
+	if (m_rxBatch.empty())
+		return;
+	m_SendPacketToAppLock.Lock();
+	if (!m_rdAutoFlush) {
+		m_finishedPackets.insert(m_finishedPackets.end(),
+								 m_rxBatch.begin(), m_rxBatch.end());
+		// Tell application layer we have something new
+		m_AppPacketAvailable = true;
+		m_responsePacketWaiting.SetEvent();
+		if (m_pUserCommInterrupt)
+			m_pUserCommInterrupt->SetEvent();
+	}
+	else {
+		for (size_t i = 0; i < m_rxBatch.size(); i++)
+			delete m_rxBatch[i];
+	}
+	m_SendPacketToAppLock.Unlock();
+	m_rxBatch.clear();
+}
+//																			  *
+//*****************************************************************************
+
+
 //*****************************************************************************
 //	NAME																	  *
 //		CSerialEx::GetPkt
@@ -981,6 +1205,60 @@ bool CSerialEx::SendPkt(packetbuf &buffer)
 
 
 
+//*****************************************************************************
+//	NAME																	  *
+//		CSerialEx::SendPkts
+//
+//	DESCRIPTION:
+///		Send a set of packets to the serial ring channel using as few port
+///		writes as possible.
+///
+/// 	\param buffers Array of \a count packets to send
+///		\return TRUE on success
+/// 
+/// 	Each packet is converted to channel format back to back into one
+///		transmit buffer, up to SEND_PKTS_PER_WRITE packets per write. This
+///		saves the system call and USB-serial latency per packet that
+///		SendPkt incurs for each of a burst of small commands.
+//
+//	SYNOPSIS:
+bool CSerialEx::SendPkts(packetbuf *buffers, size_t count)
+{
+	CSerial::SERAPI_ERR result=API_ERROR_SUCCESS;
+	DWORD nWritten;
+	packetbuf sendBuf;							// Local thread safe copy
+	nodechar txBuf[SEND_PKTS_PER_WRITE*MN_NET_PACKET_MAX];
+	size_t txLen, iPkt;
+	
+	while (count > 0 && result==API_ERROR_SUCCESS) {
+		// Frame the next group of packets back to back
+		for (iPkt = 0, txLen = 0; iPkt < count && iPkt < SEND_PKTS_PER_WRITE; 
+			 iPkt++) {
+			// Clean start of packet
+			buffers[iPkt].Byte.Buffer[0] |= 0x80;	// Set start of packet
+			buffers[iPkt].Byte.Buffer[1] &= ~(0x80);// Insure length field MSB clear
+			convert8to7(buffers[iPkt], sendBuf);	// Convert to channel format
+			memcpy(&txBuf[txLen], sendBuf.Byte.Buffer, sendBuf.Byte.BufferSize);
+			txLen += sendBuf.Byte.BufferSize;
+		}
+		// Send link formatted commands to the port
+		nWritten = 0;
+		result = Write(txBuf, txLen, &nWritten);
+		m_nCharsTX += nWritten;
+		buffers += iPkt;
+		count -= iPkt;
+	}
+	if (result!=API_ERROR_SUCCESS) {
+		_RPTF1(_CRT_WARN,"CSerial::SendPkts - err 0x%x\n", (unsigned int)result);		
+		m_lLastError = result;			
+	} 
+	return(result==API_ERROR_SUCCESS);
+}
+//																			  *
+//*****************************************************************************
+
+
+
 //*****************************************************************************
 //	NAME																	  *
 //		CSerialEx::IsPacketAvailable
@@ -1253,33 +1531,28 @@ void CSerialEx::convert8to7(packetbuf& inBuf, packetbuf& outBuf)
 
 	// Allow caller to lie about length to create frag or stray data
 	int num8 = inBuf.Fld.PktLen;
-	int consumeBytes;
-	int outBytes;
-
-	while(num8 > 0){
-		consumeBytes = num8 >= 7 ? 7 : num8;
-		outBytes = consumeBytes + 1;
-		switch(outBytes) {
-			case 8: d[7] = 0x7f &				 ((unsigned char)s[6] >> 1);
-			// no break OK (special line for Code Analyzer to suppress warning)
-			case 7: d[6] = 0x7f & ((s[6] << 6) | ((unsigned char)s[5] >> 2));
-			// no break OK (special line for Code Analyzer to suppress warning)
-			case 6: d[5] = 0x7f & ((s[5] << 5) | ((unsigned char)s[4] >> 3));
-			// no break OK (special line for Code Analyzer to suppress warning)
-			case 5: d[4] = 0x7f & ((s[4] << 4) | ((unsigned char)s[3] >> 4));
-			// no break OK (special line for Code Analyzer to suppress warning)
-			case 4: d[3] = 0x7f & ((s[3] << 3) | ((unsigned char)s[2] >> 5));
-			// no break OK (special line for Code Analyzer to suppress warning)
-			case 3: d[2] = 0x7f & ((s[2] << 2) | ((unsigned char)s[1] >> 6));
-			// no break OK (special line for Code Analyzer to suppress warning)
-			case 2: d[1] = 0x7f & ((s[1] << 1) | ((unsigned char)s[0] >> 7));
-			// no break OK (special line for Code Analyzer to suppress warning)
-			case 1: d[0] = 0x7f &   s[0];
-			// no break OK (special line for Code Analyzer to suppress warning)
-		}
-		d += outBytes;
-		s += consumeBytes;
-		num8 -= consumeBytes;
+
+	Uint64 w;
+
+	// Whole groups, 7 octets become 8 link characters
+	while(num8 >= 7) {
+		w = spread56to64(loadGroup(s) & 0x00FFFFFFFFFFFFFFULL);
+		storeGroup(d, w);
+		chksum += sumOctets(w);
+		d += 8;
+		s += 7;
+		num8 -= 7;
+	}
+	// A short group of n octets becomes n+1 characters. The last one
+	// carries low bits of the octet past the data, as it always has.
+	if (num8 > 0) {
+		w = spread56to64(loadShort(s, num8 + 1,
+								   &inBuf.Byte.Buffer[MN_NET_PACKET_MAX]));
+		// Drop the fields past the group before summing
+		w &= (Uint64(1) << (8 * (num8 + 1))) - 1;
+		storeOctets(d, w, num8 + 1);
+		chksum += sumOctets(w);
+		d += num8 + 1;
 	}
 	// Adjusts output header for expansion due to 8->7
 	outBuf.Fld.PktLen = (d - origD);
@@ -1288,8 +1561,16 @@ void CSerialEx::convert8to7(packetbuf& inBuf, packetbuf& outBuf)
 	outBuf.Byte.BufferSize = (nodeulong)(inBuf.Byte.BufferSize 
 		+ (d - origD)-inBuf.Fld.PktLen
 		+ MN_API_PACKET_TAIL_LEN);
-	for(unsigned i=0;i<(outBuf.Fld.PktLen+2U);i++) {
-		chksum+=outBuf.Byte.Buffer[i];
+	// The checksum covers the header and the characters. A stray data
+	// length that overflows the header field checksums the short count.
+	if ((d - origD) == outBuf.Fld.PktLen) {
+		chksum += outBuf.Byte.Buffer[0] + outBuf.Byte.Buffer[1];
+	}
+	else {
+		chksum = 0;
+		for(unsigned i=0;i<(outBuf.Fld.PktLen+2U);i++) {
+			chksum+=outBuf.Byte.Buffer[i];
+		}
 	}
 	chksum = (-1*chksum)&0x7f;
 	outBuf.Byte.Buffer[outBuf.Fld.PktLen+2] = (nodechar) chksum;
@@ -1310,12 +1591,40 @@ void CSerialEx::convert7to8(packetbuf& inBuf, packetbuf& outBuf)
 	nodechar *d = &outBuf.Byte.Buffer[RESP_LOC];
 	nodechar *origD = d;
 
-	int i, mod8;
-	for(i = 0; i < num7; ++i) {
-		mod8 = 0x07 & i;
-		*d |= 0xff & (buf7[i] << (8 - mod8));
-		d += mod8 != 0;			// inc. d 7 out of 8 times
-		*d = buf7[i] >> mod8;
+	int i, mod8, nLeft;
+	Uint64 w;
+	// Link characters, 8 characters become 7 octets. Each group also
+	// writes a zero octet past its data that the next group overwrites,
+	// the same trailing write the character loop makes.
+	for (nLeft = num7; nLeft >= 8; nLeft -= 8) {
+		w = loadGroup(buf7);
+		if (w & 0x8080808080808080ULL)
+			break;
+		storeGroup(d, pack64to56(w));
+		buf7 += 8;
+		d += 7;
+	}
+	// The last octet written is not counted in the length
+	if (nLeft > 0 && nLeft < 8) {
+		w = loadShort(buf7, nLeft, &inBuf.Byte.Buffer[MN_NET_PACKET_MAX]);
+		if (!(w & 0x8080808080808080ULL)) {
+			storeOctets(d, pack64to56(w), nLeft);
+			d += nLeft - 1;
+			nLeft = 0;
+		}
+	}
+	if (nLeft > 0) {
+		// Corrupt characters, start over with the original character
+		// loop to keep its sign extension. It assigns each octet before
+		// it merges into it so the partial results above are replaced.
+		buf7 = &inBuf.Byte.Buffer[RESP_LOC];
+		d = origD;
+		for(i = 0; i < num7; ++i) {
+			mod8 = 0x07 & i;
+			*d |= 0xff & (buf7[i] << (8 - mod8));
+			d += mod8 != 0;			// inc. d 7 out of 8 times
+			*d = buf7[i] >> mod8;
+		}
 	}
 	
 	outBuf.Fld.PktLen = (num7==1) ? 1: d - origD;
@@ -1323,9 +1632,6 @@ void CSerialEx::convert7to8(packetbuf& inBuf, packetbuf& outBuf)
 
 }
 //																			  *
-//*****************************************************************************
-
-
 //*****************************************************************************
 //	NAME																	  *
 //		CSerialEx::RegisterUserPktCommEvent
@@ -50,6 +50,7 @@
 	#include "pubIscAPI.h"
 	#include "sFoundResource.h"
 	#include "netCmdPrivate.h"
+	#include "paramCache.h"
 	#include "converterLib.h"
 	#include "iscRegs.h"
 	#include "cpmRegs.h"
@@ -2159,7 +2160,8 @@ static const factoryInitData initTrqData[] =  {
 //		cpmClassDelete
 //
 //	DESCRIPTION:
-//		Delete any memory this node allocated.
+//		Delete any memory this node allocated. The values read while it was
+//		up are written to its parameter cache first.
 //
 //	\return MN_OK if successful
 //
@@ -2175,6 +2177,7 @@ void cpmClassDelete(multiaddr theMultiAddr) {
 	pNodeDB = &SysInventory[cNum].NodeInfo[NODE_ADDR(theMultiAddr)];
 	// Delete if no one else has
 	if (pNodeDB->paramBankList) {
+		coreParamCacheSave(theMultiAddr);
 		for (unsigned iBank = 0; iBank < pNodeDB->bankCount; iBank++){
 			free((void *)(pNodeDB->paramBankList[iBank]).valueDB);
 			(pNodeDB->paramBankList[iBank]).valueDB = NULL;
@@ -2205,6 +2208,59 @@ void cpmClassDelete(multiaddr theMultiAddr) {
 //*****************************************************************************
 
 
+//*****************************************************************************
+//	NAME																	  *
+//		cpmParamCacheSetup
+//
+//	DESCRIPTION:
+//		Read the node's identity and non-volatile state in one burst and
+//		seed its parameter database from the cache file that matches. The
+//		file is written by cpmClassDelete. The cache only saves time,
+//		failures leave the values to be read on first use.
+//
+//	SYNOPSIS:
+static void cpmParamCacheSetup(
+	multiaddr theMultiAddr)
+{
+	static const nodeparam keyParams[] = {
+		CPM_P_SER_NUM, CPM_P_FW_VERS, CPM_P_ROM_SUM, CPM_P_EE_VER,
+		CPM_P_PART_NUM, CPM_P_DRV_CONFIG_CHANGED
+	};
+	const size_t nKeys = sizeof(keyParams)/sizeof(keyParams[0]);
+	multiaddr keyAddrs[nKeys];
+	paramValue keyVals[nKeys];
+	paramCacheKey key;
+	size_t iKey;
+
+	for (iKey = 0; iKey < nKeys; iKey++)
+		keyAddrs[iKey] = theMultiAddr;
+	netGetParameterGroup(NET_NUM(theMultiAddr), nKeys, keyAddrs, keyParams,
+						 NULL);
+	for (iKey = 0; iKey < nKeys; iKey++) {
+		if (netGetParameterInfo(theMultiAddr, mnParams(keyParams[iKey]),
+								NULL, &keyVals[iKey]) != MN_OK)
+			return;
+	}
+	memset(&key, 0, sizeof(key));
+	key.serialNum = Uint32(keyVals[0].value);
+	// The version is scaled, keep its raw bits
+	memcpy(&key.fwVers, keyVals[1].raw.Byte.Buffer, sizeof(key.fwVers));
+	key.romSum = Uint16(keyVals[2].value);
+	key.eeVer = Uint16(keyVals[3].value);
+	memcpy(key.partNum, keyVals[4].raw.Byte.Buffer,
+		   keyVals[4].raw.Byte.BufferSize < MN_PART_NUM_SIZE
+		   ? keyVals[4].raw.Byte.BufferSize : MN_PART_NUM_SIZE);
+	key.nvModified = Uint16(keyVals[5].value);
+	if (cpmGetMotorFileName(theMultiAddr, key.motorFile,
+							MN_FILENAME_SIZE) != MN_OK)
+		return;
+
+	coreParamCacheLoad(theMultiAddr, key);
+}
+//																			  *
+//*****************************************************************************
+
+
 //*****************************************************************************
 //	NAME																	  *
 //		cpmClassSetup
@@ -2281,6 +2337,9 @@ cnErrCode cpmClassSetup(
 				netGetParameter(theMultiAddr,CPM_P_NETERR_APP_OVERRUN,&dummy);
 
 				errRet = coreUpdateParamInfo(theMultiAddr);
+				// Known nodes skip the bulk reads
+				if (errRet == MN_OK && coreParamCacheOn())
+					cpmParamCacheSetup(theMultiAddr);
 			}
 			else
 				errRet = MN_ERR_WRONG_NODE_TYPE;
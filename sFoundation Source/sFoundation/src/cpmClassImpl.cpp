@@ -1649,6 +1649,153 @@ void SysCPMportAdv::TriggerMovesInGroup(size_t groupNumber)
 	}
 }
 
+/**
+\copydoc IPortAdv::CmdWindow
+**/
+size_t SysCPMportAdv::CmdWindow()
+{
+	nodeulong window;
+	cnErrCode theErr = infcGetCmdWindow(m_pPort->NetNumber(), &window,
+										NULL, NULL);
+	if (theErr != MN_OK) {
+		mnErr eInfo;
+		fillInErrs(eInfo, theErr, _TEK_FUNC_SIG_,
+			"Failure to get command window on network %d",
+			m_pPort->NetNumber());
+		throwSystemError(eInfo);
+	}
+	return window;
+}
+
+/**
+\copydoc IPortAdv::CmdWindowMax()
+**/
+size_t SysCPMportAdv::CmdWindowMax()
+{
+	nodeulong ceiling;
+	cnErrCode theErr = infcGetCmdWindow(m_pPort->NetNumber(), NULL,
+										&ceiling, NULL);
+	if (theErr != MN_OK) {
+		mnErr eInfo;
+		fillInErrs(eInfo, theErr, _TEK_FUNC_SIG_,
+			"Failure to get command window limit on network %d",
+			m_pPort->NetNumber());
+		throwSystemError(eInfo);
+	}
+	return ceiling;
+}
+
+/**
+\copydoc IPortAdv::CmdWindowMax(size_t)
+**/
+void SysCPMportAdv::CmdWindowMax(size_t newMax)
+{
+	cnErrCode theErr = infcSetCmdQueueLimit(m_pPort->NetNumber(),
+											nodeulong(newMax));
+	if (theErr != MN_OK) {
+		mnErr eInfo;
+		fillInErrs(eInfo, theErr, _TEK_FUNC_SIG_,
+			"Failure to set command window limit to %d on network %d",
+			newMax, m_pPort->NetNumber());
+		throwSystemError(eInfo);
+	}
+}
+
+/**
+\copydoc IPortAdv::CmdWindowAdaptive()
+**/
+bool SysCPMportAdv::CmdWindowAdaptive()
+{
+	nodebool adaptive;
+	cnErrCode theErr = infcGetCmdWindow(m_pPort->NetNumber(), NULL,
+										NULL, &adaptive);
+	if (theErr != MN_OK) {
+		mnErr eInfo;
+		fillInErrs(eInfo, theErr, _TEK_FUNC_SIG_,
+			"Failure to get command window mode on network %d",
+			m_pPort->NetNumber());
+		throwSystemError(eInfo);
+	}
+	return adaptive != FALSE;
+}
+
+/**
+\copydoc IPortAdv::CmdWindowAdaptive(bool)
+**/
+void SysCPMportAdv::CmdWindowAdaptive(bool adaptive)
+{
+	cnErrCode theErr = infcSetCmdWindowAdaptive(m_pPort->NetNumber(),
+												adaptive ? TRUE : FALSE);
+	if (theErr != MN_OK) {
+		mnErr eInfo;
+		fillInErrs(eInfo, theErr, _TEK_FUNC_SIG_,
+			"Failure to set command window mode on network %d",
+			m_pPort->NetNumber());
+		throwSystemError(eInfo);
+	}
+}
+
+/**
+\copydoc IPortAdv::LatencyStats(mnLatencyClass, bool)
+**/
+mnLatencyStats SysCPMportAdv::LatencyStats(mnLatencyClass latClass,
+										   bool resetWindow)
+{
+	mnLatencyStats stats;
+	cnErrCode theErr = infcGetLatencyStats(m_pPort->NetNumber(),
+										   MN_API_MAX_NODES, latClass,
+										   resetWindow ? TRUE : FALSE, &stats);
+	if (theErr != MN_OK) {
+		mnErr eInfo;
+		fillInErrs(eInfo, theErr, _TEK_FUNC_SIG_,
+			"Failure to get command latency on network %d",
+			m_pPort->NetNumber());
+		throwSystemError(eInfo);
+	}
+	return stats;
+}
+
+/**
+\copydoc IPortAdv::LatencyStats(size_t, mnLatencyClass, bool)
+**/
+mnLatencyStats SysCPMportAdv::LatencyStats(size_t nodeIndex,
+										   mnLatencyClass latClass,
+										   bool resetWindow)
+{
+	mnLatencyStats stats;
+	cnErrCode theErr = MN_ERR_BADARG;
+	if (nodeIndex < MN_API_MAX_NODES)
+		theErr = infcGetLatencyStats(m_pPort->NetNumber(),
+									 nodeaddr(nodeIndex), latClass,
+									 resetWindow ? TRUE : FALSE, &stats);
+	if (theErr != MN_OK) {
+		mnErr eInfo;
+		fillInErrs(eInfo, theErr, _TEK_FUNC_SIG_,
+			"Failure to get command latency of node %d on network %d",
+			nodeIndex, m_pPort->NetNumber());
+		throwSystemError(eInfo);
+	}
+	return stats;
+}
+
+/**
+\copydoc IPortAdv::StopLatencyStats
+**/
+mnLatencyStats SysCPMportAdv::StopLatencyStats(bool resetWindow)
+{
+	mnLatencyStats stats;
+	cnErrCode theErr = infcGetStopLaneStats(m_pPort->NetNumber(),
+											resetWindow ? TRUE : FALSE, &stats);
+	if (theErr != MN_OK) {
+		mnErr eInfo;
+		fillInErrs(eInfo, theErr, _TEK_FUNC_SIG_,
+			"Failure to get stop latency on network %d",
+			m_pPort->NetNumber());
+		throwSystemError(eInfo);
+	}
+	return stats;
+}
+
 //= = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = 
 // SysCPMattnPort Class Implementations
 //= = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = 
@@ -0,0 +1,129 @@
+//*****************************************************************************
+// NAME
+//		dacqDecode.cpp
+//
+// DESCRIPTION:
+/**
+		\file
+		Batch decoder of data acquisition packets.
+**/
+//
+// CREATION DATE:
+//		10/18/2026 15:10:44
+//
+// COPYRIGHT NOTICE:
+//		(C)Copyright 2026  Teknic, Inc.  All rights reserved.
+//
+//		This copyright notice must be reproduced in any copy, modification,
+//		or portion thereof merged into another program. A copy of the
+//		copyright notice must be included in the object library of a user
+//		program.
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	dacqDecode.cpp headers
+//
+	#include "dacqDecode.h"
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	dacqDecode.cpp static functions
+//
+// Sign extend the <bits> wide field at <shift> in <word> and normalize it
+// to +/-1
+static inline float traceValue(Uint64 word, int shift, int bits)
+{
+	int32 field = int32(Uint32(word >> shift) << (32 - bits));
+	return(float(field >> (32 - bits)) / float(1 << (bits - 1)));
+}
+
+// Trigger, inputs and output in the layout the read thread stores in
+// trace 1, from state octet <state> and I/O nibble <io>
+static inline Uint8 ioValue(unsigned state, unsigned io)
+{
+	return(Uint8((((state >> DACQ_TRIGGER_SHIFT) & 1) << (INPUT_BITS + 1))
+		| ((io & ((1 << INPUT_BITS) - 1)) << 1) | ((io >> INPUT_BITS) & 1)));
+}
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		dacqDecodePackets
+//
+//	DESCRIPTION:
+/**
+	Unpack a span of data acquisition packets into separate arrays. Each
+	packet is loaded as one 48 bit little endian word and its fields are
+	taken with shifts and masks, which matches the dacqPacket bit field
+	layout on the host compilers without depending on it. Each array is
+	filled in its own loop so the compiler can vectorize the simple ones.
+
+	\param[in] raw First packet.
+	\param[in] stride Octets from one packet to the next, at least
+	DACQ_PACKET_OCTETS.
+	\param[in] nPackets Packets to decode.
+	\param[out] out The arrays filled, NULL arrays are skipped.
+**/
+//	SYNOPSIS:
+void dacqDecodePackets(const Uint8 *raw, size_t stride, size_t nPackets,
+					   const dacqDecoded &out)
+{
+	const Uint8 *pPkt;
+	Uint64 word;
+	size_t iPkt;
+
+	if (out.trace) {
+		for (iPkt = 0, pPkt = raw; iPkt < nPackets; iPkt++, pPkt += stride) {
+			word = dacqPacketWord(pPkt);
+			out.trace[2 * iPkt] = traceValue(word, DACQ_T0P0_SHIFT, P0_BITS);
+			out.trace[2 * iPkt + 1]
+				= traceValue(word, DACQ_T0P1_SHIFT, P1_BITS);
+		}
+	}
+	// The state octets hold the move state, trigger and exception of
+	// each point
+	if (out.moveState) {
+		for (iPkt = 0, pPkt = raw; iPkt < nPackets; iPkt++, pPkt += stride) {
+			out.moveState[2 * iPkt] = pPkt[DACQ_STATE0_SHIFT / 8] & 7;
+			out.moveState[2 * iPkt + 1] = pPkt[DACQ_STATE1_SHIFT / 8] & 7;
+		}
+	}
+	if (out.exception) {
+		for (iPkt = 0, pPkt = raw; iPkt < nPackets; iPkt++, pPkt += stride) {
+			out.exception[2 * iPkt]
+				= pPkt[DACQ_STATE0_SHIFT / 8] >> DACQ_EXCEPTION_SHIFT;
+			out.exception[2 * iPkt + 1]
+				= pPkt[DACQ_STATE1_SHIFT / 8] >> DACQ_EXCEPTION_SHIFT;
+		}
+	}
+	if (out.io) {
+		for (iPkt = 0, pPkt = raw; iPkt < nPackets; iPkt++, pPkt += stride) {
+			out.io[2 * iPkt] = ioValue(pPkt[DACQ_STATE0_SHIFT / 8],
+									   pPkt[DACQ_IO0_SHIFT / 8]);
+			out.io[2 * iPkt + 1] = ioValue(pPkt[DACQ_STATE1_SHIFT / 8],
+										   pPkt[DACQ_IO1_SHIFT / 8] >> 4);
+		}
+	}
+	if (out.sequence) {
+		for (iPkt = 0, pPkt = raw; iPkt < nPackets; iPkt++, pPkt += stride)
+			out.sequence[iPkt] = pPkt[DACQ_SEQ_SHIFT / 8] & 3;
+	}
+}
+//																			  *
+//*****************************************************************************
+
+
+//=============================================================================
+//	END OF FILE dacqDecode.cpp
+//=============================================================================
@@ -0,0 +1,579 @@
+//*****************************************************************************
+// NAME
+//		dataAcqMerger.cpp
+//
+// DESCRIPTION:
+/**
+		\file
+		Time alignment of data acquisition streams from several nodes and
+		the host.
+**/
+//
+// CREATION DATE:
+//		10/18/2026 16:25:09
+//
+// COPYRIGHT NOTICE:
+//		(C)Copyright 2026  Teknic, Inc.  All rights reserved.
+//
+//		This copyright notice must be reproduced in any copy, modification,
+//		or portion thereof merged into another program. A copy of the
+//		copyright notice must be included in the object library of a user
+//		program.
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	dataAcqMerger.cpp headers
+//
+	#include "dataAcqMerger.h"
+	#include "lnkAccessAPI.h"
+	#include <algorithm>
+	#include <math.h>
+	#include <string.h>
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	dataAcqMerger.cpp constants
+//
+// Index mask of a stream history
+#define HIST_MASK	(DACQ_MERGE_HISTORY - 1)
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqMerger::CDataAcqMerger
+//
+//	DESCRIPTION:
+//		Construction
+//
+//	SYNOPSIS:
+CDataAcqMerger::CDataAcqMerger()
+{
+	m_nStreams = 0;
+	m_nChannels = 0;
+	m_periodMs = 0;
+	m_maxLagMs = 0;
+	m_started = false;
+	m_nextTime = 0;
+	m_overruns = 0;
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqMerger::AddNodeChannel
+//
+//	DESCRIPTION:
+/**
+	Add a frame channel that follows part of a node's data acquisition
+	points. The channels of one node share its stream.
+
+	\param[in] addr The node.
+	\param[in] source The part of its points merged.
+
+	\return The frame channel, -1 if there is no room for it or Start has
+	been called.
+**/
+//	SYNOPSIS:
+int CDataAcqMerger::AddNodeChannel(multiaddr addr, dacqRecSource source)
+{
+	size_t iStream;
+	double periodMs;
+
+	if (m_periodMs > 0 || m_nChannels == DACQ_MERGE_MAX_CHANNELS
+		|| source >= DACQ_REC_SOURCES || NET_NUM(addr) >= NET_CONTROLLER_MAX
+		|| infcGetDataAcqPeriod(addr, &periodMs) != MN_OK)
+		return(-1);
+	for (iStream = 0; iStream < m_nStreams; iStream++) {
+		if (!m_streams[iStream].isHost && m_streams[iStream].addr == addr)
+			break;
+	}
+	if (iStream == m_nStreams) {
+		if (m_nStreams == DACQ_MERGE_MAX_STREAMS)
+			return(-1);
+		m_streams[iStream].addr = addr;
+		m_streams[iStream].isHost = false;
+		m_streams[iStream].nChannels = 0;
+		m_nStreams++;
+	}
+	mergeStream &st = m_streams[iStream];
+	if (st.nChannels == DACQ_REC_STREAM_CHANNELS)
+		return(-1);
+	st.sources[st.nChannels] = Uint8(source);
+	st.slots[st.nChannels] = Uint16(m_nChannels);
+	st.nChannels++;
+	m_chanStream[m_nChannels] = Uint8(iStream);
+	return(int(m_nChannels++));
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqMerger::AddHostChannel
+//
+//	DESCRIPTION:
+/**
+	Add a frame channel fed with PushHost, each host channel is its own
+	stream.
+
+	\param[in] maxGapMs Longest time between samples interpolated across.
+
+	\return The frame channel, -1 if there is no room for it or Start has
+	been called.
+**/
+//	SYNOPSIS:
+int CDataAcqMerger::AddHostChannel(double maxGapMs)
+{
+	if (m_periodMs > 0 || m_nChannels == DACQ_MERGE_MAX_CHANNELS
+		|| m_nStreams == DACQ_MERGE_MAX_STREAMS || !(maxGapMs > 0))
+		return(-1);
+	mergeStream &st = m_streams[m_nStreams];
+	st.addr = MN_UNSET_ADDR;
+	st.isHost = true;
+	st.nChannels = 1;
+	st.slots[0] = Uint16(m_nChannels);
+	st.maxGapMs = maxGapMs;
+	m_chanStream[m_nChannels] = Uint8(m_nStreams++);
+	return(int(m_nChannels++));
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqMerger::Start
+//
+//	DESCRIPTION:
+/**
+	Clear the streams and start merging. The nodes should already be in
+	data acquisition mode, their sample periods set how far apart their
+	points may be interpolated.
+
+	\param[in] periodMs Time between frames.
+	\param[in] maxLagMs Longest a frame waits for a stream that has not
+	reached it.
+
+	\return MN_OK if merging started.
+**/
+//	SYNOPSIS:
+cnErrCode CDataAcqMerger::Start(double periodMs, double maxLagMs)
+{
+	double pointMs;
+
+	if (m_nStreams == 0 || !(periodMs > 0) || !(maxLagMs > 0))
+		return(MN_ERR_BADARG);
+	for (size_t iStream = 0; iStream < m_nStreams; iStream++) {
+		mergeStream &st = m_streams[iStream];
+		st.head = st.tail = 0;
+		st.clockSet = false;
+		st.scale = 1;
+		st.offset = 0;
+		st.lastNode = 0;
+		if (st.isHost)
+			continue;
+		if (infcGetDataAcqPeriod(st.addr, &pointMs) != MN_OK)
+			pointMs = 0;
+		st.maxGapMs = DACQ_MERGE_GAP_PERIODS * pointMs;
+		if (!(st.maxGapMs > 0))
+			st.maxGapMs = maxLagMs;
+	}
+	m_periodMs = periodMs;
+	m_maxLagMs = maxLagMs;
+	m_started = false;
+	m_overruns = 0;
+	return(MN_OK);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqMerger::clockStart
+//
+//	DESCRIPTION:
+//		Start a new clock model from one arrival. A rate already measured
+//		for the node is kept, its crystal has not changed. The envelope
+//		restarts, its node times are from the old run.
+//
+//	SYNOPSIS:
+void CDataAcqMerger::clockStart(mergeStream &st, double node, double host)
+{
+	st.offset = host - node * st.scale;
+	st.lastNode = node;
+	st.winStart = st.winNode = node;
+	st.winHost = host;
+	st.envHead = st.nEnv = 0;
+	st.clockSet = true;
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqMerger::clockUpdate
+//
+//	DESCRIPTION:
+//		Fit the clock model to another arrival. The offset follows the
+//		earliest arrival at once. The earliest arrival of each
+//		DACQ_MERGE_ENV_WINDOW_MS of node time joins the envelope as its
+//		window closes, and the rate is fitted again.
+//
+//	SYNOPSIS:
+void CDataAcqMerger::clockUpdate(mergeStream &st, double node, double host)
+{
+	if (node - st.winStart >= DACQ_MERGE_ENV_WINDOW_MS) {
+		st.envNode[st.envHead] = st.winNode;
+		st.envHost[st.envHead] = st.winHost;
+		st.envHead = (st.envHead + 1) % DACQ_MERGE_ENV_WINDOWS;
+		if (st.nEnv < DACQ_MERGE_ENV_WINDOWS)
+			st.nEnv++;
+		clockFit(st);
+		st.winStart = st.winNode = node;
+		st.winHost = host;
+	}
+	else if (host - node * st.scale < st.winHost - st.winNode * st.scale) {
+		st.winNode = node;
+		st.winHost = host;
+	}
+	if (host - node * st.scale < st.offset)
+		st.offset = host - node * st.scale;
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqMerger::clockFit
+//
+//	DESCRIPTION:
+//		Fit the clock rate to the envelope once it spans
+//		DACQ_MERGE_RATE_SPAN_MS. A least squares line through every
+//		window's earliest arrival is fitted again through the half at or
+//		below it, which drops the windows whose every arrival was held
+//		up. The offset then puts the line under the earliest arrival.
+//
+//	SYNOPSIS:
+void CDataAcqMerger::clockFit(mergeStream &st)
+{
+	double resid[DACQ_MERGE_ENV_WINDOWS];
+	double node0, host0, rate, offset, limit;
+	double sn, sh, snn, snh, n, dn, dh;
+	Uint32 iEnv, iPass, newest, oldest;
+
+	newest = (st.envHead + DACQ_MERGE_ENV_WINDOWS - 1) % DACQ_MERGE_ENV_WINDOWS;
+	oldest = (st.envHead + DACQ_MERGE_ENV_WINDOWS - st.nEnv)
+		% DACQ_MERGE_ENV_WINDOWS;
+	if (st.nEnv < 2
+		|| st.envNode[newest] - st.envNode[oldest] < DACQ_MERGE_RATE_SPAN_MS)
+		return;
+
+	// Fit relative to the oldest window to keep the sums precise
+	node0 = st.envNode[oldest];
+	host0 = st.envHost[oldest];
+	rate = st.scale;
+	limit = HUGE_VAL;
+	for (iPass = 0; ; iPass++) {
+		sn = sh = snn = snh = n = 0;
+		for (iEnv = 0; iEnv < st.nEnv; iEnv++) {
+			dn = st.envNode[iEnv] - node0;
+			dh = st.envHost[iEnv] - host0;
+			if (dh - rate * dn > limit)
+				continue;
+			sn += dn;
+			sh += dh;
+			snn += dn * dn;
+			snh += dn * dh;
+			n++;
+		}
+		if (n < 2 || !(n * snn - sn * sn > 0))
+			return;
+		rate = (n * snh - sn * sh) / (n * snn - sn * sn);
+		if (iPass == 1)
+			break;
+		// Keep the windows at or below the median residual
+		for (iEnv = 0; iEnv < st.nEnv; iEnv++) {
+			resid[iEnv] = (st.envHost[iEnv] - host0)
+				- rate * (st.envNode[iEnv] - node0);
+		}
+		std::nth_element(resid, resid + (st.nEnv - 1) / 2, resid + st.nEnv);
+		limit = resid[(st.nEnv - 1) / 2];
+	}
+	if (rate > 1 + DACQ_MERGE_RATE_MAX_ERR)
+		rate = 1 + DACQ_MERGE_RATE_MAX_ERR;
+	else if (rate < 1 - DACQ_MERGE_RATE_MAX_ERR)
+		rate = 1 - DACQ_MERGE_RATE_MAX_ERR;
+
+	// Put the line under the envelope's earliest arrival
+	offset = HUGE_VAL;
+	for (iEnv = 0; iEnv < st.nEnv; iEnv++) {
+		if (st.envHost[iEnv] - st.envNode[iEnv] * rate < offset)
+			offset = st.envHost[iEnv] - st.envNode[iEnv] * rate;
+	}
+	st.scale = rate;
+	st.offset = offset;
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqMerger::append
+//
+//	DESCRIPTION:
+//		Add a sample at host time \e time to the stream's history and
+//		return it. A sample that is not after the latest is refused with
+//		NULL. When the history is full the oldest sample is dropped.
+//
+//	SYNOPSIS:
+CDataAcqMerger::mergeSample *CDataAcqMerger::append(mergeStream &st,
+													double time)
+{
+	mergeSample *pSample;
+
+	if (st.head != st.tail && time <= st.hist[(st.head - 1) & HIST_MASK].time)
+		return(NULL);
+	if (st.head - st.tail == DACQ_MERGE_HISTORY) {
+		st.tail++;
+		m_overruns++;
+	}
+	pSample = &st.hist[st.head++ & HIST_MASK];
+	pSample->time = time;
+	return(pSample);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqMerger::PushHost
+//
+//	DESCRIPTION:
+/**
+	Add a sample the host took itself.
+
+	\param[in] channel Frame channel from AddHostChannel.
+	\param[in] timeMs infcCoreTime the sample was taken at, later than the
+	channel's previous sample.
+	\param[in] value The sample.
+
+	\return MN_OK if the sample was added.
+**/
+//	SYNOPSIS:
+cnErrCode CDataAcqMerger::PushHost(int channel, double timeMs, float value)
+{
+	mergeSample *pSample;
+
+	if (channel < 0 || size_t(channel) >= m_nChannels || !(m_periodMs > 0))
+		return(MN_ERR_BADARG);
+	mergeStream &st = m_streams[m_chanStream[channel]];
+	if (!st.isHost || (pSample = append(st, timeMs), pSample == NULL))
+		return(MN_ERR_BADARG);
+	pSample->value[0] = value;
+	pSample->valid = true;
+	return(MN_OK);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqMerger::Pull
+//
+//	DESCRIPTION:
+/**
+	Read the points waiting at each node and place them on the host
+	timeline. The clock pair is read after each batch of points, so it is
+	at least as new as they are and comes from the same acquisition run
+	as the last of them.
+
+	\return MN_OK, else the error reading a node's points.
+**/
+//	SYNOPSIS:
+cnErrCode CDataAcqMerger::Pull()
+{
+	cnErrCode theErr;
+	nodeulong nPts, iPt;
+	double node, host;
+	mergeSample *pSample;
+
+	for (size_t iStream = 0; iStream < m_nStreams; iStream++) {
+		mergeStream &st = m_streams[iStream];
+		if (st.isHost)
+			continue;
+		for (;;) {
+			theErr = infcGetDataAcqPt(st.addr, DACQ_MERGE_PULL_PTS, m_pts,
+									  &nPts);
+			if (theErr == MN_ERR_DATAACQ_EMPTY)
+				break;
+			if (theErr != MN_OK)
+				return(theErr);
+			if (infcGetDataAcqClock(st.addr, &node, &host) != MN_OK)
+				break;
+			if (st.clockSet && node >= st.lastNode)
+				clockUpdate(st, node, host);
+			for (iPt = 0; iPt < nPts; iPt++) {
+				// Time going backwards is a restarted acquisition
+				if (!st.clockSet || m_pts[iPt].TimeStamp < st.lastNode)
+					clockStart(st, node, host);
+				st.lastNode = m_pts[iPt].TimeStamp;
+				pSample = append(st, m_pts[iPt].TimeStamp * st.scale
+								 + st.offset);
+				if (!pSample)
+					continue;
+				for (Uint16 iChan = 0; iChan < st.nChannels; iChan++)
+					pSample->value[iChan]
+						= dacqRecSourceValue(m_pts[iPt], st.sources[iChan]);
+				pSample->valid = m_pts[iPt].Valid != 0;
+			}
+			if (nPts < DACQ_MERGE_PULL_PTS)
+				break;
+		}
+	}
+	return(MN_OK);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqMerger::Next
+//
+//	DESCRIPTION:
+/**
+	Get the next frame. The first frame is at the first multiple of the
+	period after every stream has a sample, the rest follow at the period.
+	A frame is complete when every stream has a sample at or after its
+	time, or when the newest sample is more than the allowed lag past it.
+
+	\param[out] frame Updated with the frame.
+
+	\return true if \a frame was updated, else call Pull or PushHost and
+	try again.
+**/
+//	SYNOPSIS:
+bool CDataAcqMerger::Next(dacqMergeFrame &frame)
+{
+	size_t iStream;
+	double t, newest, latest, frac;
+	Uint16 iChan;
+
+	if (!(m_periodMs > 0))
+		return(false);
+	if (!m_started) {
+		t = 0;
+		for (iStream = 0; iStream < m_nStreams; iStream++) {
+			mergeStream &st = m_streams[iStream];
+			if (st.head == st.tail)
+				return(false);
+			if (iStream == 0 || st.hist[st.tail & HIST_MASK].time > t)
+				t = st.hist[st.tail & HIST_MASK].time;
+		}
+		m_nextTime = ceil(t / m_periodMs) * m_periodMs;
+		m_started = true;
+	}
+	t = m_nextTime;
+
+	// Wait for the streams that have not reached the frame unless the
+	// newest is too far ahead of them
+	newest = t;
+	for (iStream = 0; iStream < m_nStreams; iStream++) {
+		mergeStream &st = m_streams[iStream];
+		if (st.head != st.tail
+			&& st.hist[(st.head - 1) & HIST_MASK].time > newest)
+			newest = st.hist[(st.head - 1) & HIST_MASK].time;
+	}
+	for (iStream = 0; iStream < m_nStreams; iStream++) {
+		mergeStream &st = m_streams[iStream];
+		latest = (st.head == st.tail) ? t - m_maxLagMs - 1
+			: st.hist[(st.head - 1) & HIST_MASK].time;
+		if (latest < t && newest - t < m_maxLagMs)
+			return(false);
+	}
+
+	frame.time = t;
+	frame.validMask = 0;
+	memset(frame.value, 0, sizeof(frame.value));
+	for (iStream = 0; iStream < m_nStreams; iStream++) {
+		mergeStream &st = m_streams[iStream];
+		// Drop the samples before the one at or before the frame
+		while (st.head - st.tail >= 2
+			   && st.hist[(st.tail + 1) & HIST_MASK].time <= t)
+			st.tail++;
+		if (st.head == st.tail)
+			continue;
+		const mergeSample &a = st.hist[st.tail & HIST_MASK];
+		if (a.time > t || !a.valid)
+			continue;
+		if (a.time == t) {
+			frac = 0;
+		}
+		else {
+			if (st.head - st.tail < 2)
+				continue;
+			const mergeSample &b = st.hist[(st.tail + 1) & HIST_MASK];
+			if (!b.valid || b.time - a.time > st.maxGapMs)
+				continue;
+			frac = (t - a.time) / (b.time - a.time);
+		}
+		for (iChan = 0; iChan < st.nChannels; iChan++) {
+			frame.value[st.slots[iChan]] = a.value[iChan];
+			if (frac > 0) {
+				frame.value[st.slots[iChan]] += float(frac
+					* (st.hist[(st.tail + 1) & HIST_MASK].value[iChan]
+					   - a.value[iChan]));
+			}
+			frame.validMask |= 1UL << st.slots[iChan];
+		}
+	}
+	m_nextTime += m_periodMs;
+	return(true);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqMerger::ClockRate
+//
+//	DESCRIPTION:
+//		Return the measured rate of the clock of the node behind
+//		\e channel against the host's, 1 until measured or for a host
+//		channel.
+//
+//	SYNOPSIS:
+double CDataAcqMerger::ClockRate(int channel) const
+{
+	if (channel < 0 || size_t(channel) >= m_nChannels)
+		return(1);
+	return(m_streams[m_chanStream[channel]].scale);
+}
+//																			  *
+//*****************************************************************************
+
+
+//=============================================================================
+//	END OF FILE dataAcqMerger.cpp
+//=============================================================================
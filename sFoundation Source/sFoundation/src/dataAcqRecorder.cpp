@@ -0,0 +1,590 @@
+//*****************************************************************************
+// NAME
+//		dataAcqRecorder.cpp
+//
+// DESCRIPTION:
+/**
+		\file
+		Memory mapped, column oriented recorder of data acquisition points.
+**/
+//
+// CREATION DATE:
+//		10/18/2026 14:02:31
+//
+// COPYRIGHT NOTICE:
+//		(C)Copyright 2026  Teknic, Inc.  All rights reserved.
+//
+//		This copyright notice must be reproduced in any copy, modification,
+//		or portion thereof merged into another program. A copy of the
+//		copyright notice must be included in the object library of a user
+//		program.
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	dataAcqRecorder.cpp headers
+//
+	#include "dataAcqRecorder.h"
+	#include "lnkAccessAPI.h"
+	#include <string.h>
+	#include <time.h>
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	dataAcqRecorder.cpp static functions
+//
+// Copy <src> into the fixed length file string <dest>
+static void copyName(char *dest, const char *src, size_t destLen)
+{
+	memset(dest, 0, destLen);
+	if (src)
+		strncpy(dest, src, destLen - 1);
+}
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqRecorder::CDataAcqRecorder
+//
+//	DESCRIPTION:
+//		Construction/Destruction
+//
+//	SYNOPSIS:
+CDataAcqRecorder::CDataAcqRecorder()
+	: m_wake(false, false)
+{
+	m_pHdr = NULL;
+	m_chunks = m_fileChunks = 0;
+	m_pollMs = 0;
+	m_nStreams = 0;
+	m_lastErr = MN_OK;
+	memset(m_streams, 0, sizeof(m_streams));
+}
+
+CDataAcqRecorder::~CDataAcqRecorder()
+{
+	Stop();
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqRecorder::Start
+//
+//	DESCRIPTION:
+/**
+	Create the recording file and start draining the nodes. Channels of the
+	same node form one stream, the streams and their channels keep the
+	order they first appear in \a defs.
+
+	\param[in] path File to create, an existing file is replaced.
+	\param[in] defs The channels to record.
+	\param[in] nDefs Number of channels.
+	\param[in] pollMs Time between drains. The nodes' rings must not fill
+	in this time.
+
+	\return MN_OK if recording started.
+**/
+//	SYNOPSIS:
+cnErrCode CDataAcqRecorder::Start(const char *path,
+								  const dacqRecChannelDef defs[],
+								  size_t nDefs, double pollMs)
+{
+	size_t iDef, iStream, nChan;
+	double periodMs;
+
+	if (!path || nDefs == 0 || nDefs > DACQ_REC_MAX_CHANNELS
+		|| !(pollMs > 0)
+		|| DACQ_REC_CHUNK_BYTES % CCmappedFile::Granularity() != 0)
+		return(MN_ERR_BADARG);
+	for (iDef = 0; iDef < nDefs; iDef++) {
+		if (defs[iDef].source >= DACQ_REC_SOURCES
+			|| NET_NUM(defs[iDef].addr) >= NET_CONTROLLER_MAX
+			|| infcGetDataAcqPeriod(defs[iDef].addr, &periodMs) != MN_OK)
+			return(MN_ERR_BADARG);
+	}
+
+	m_ctlLock.Lock();
+	Stop();
+	if (!m_file.Open(path, true)
+		|| !m_file.Extend(Uint64(DACQ_REC_CHUNK_BYTES)
+						  * (1 + DACQ_REC_EXTENT_CHUNKS))
+		|| (m_pHdr = (dacqRecHeader *)m_file.Map(0, DACQ_REC_CHUNK_BYTES),
+			m_pHdr == NULL)) {
+		m_file.Close();
+		m_ctlLock.Unlock();
+		return(MN_ERR_FILE_OPEN);
+	}
+	m_fileChunks = DACQ_REC_EXTENT_CHUNKS;
+	m_chunks = 0;
+	m_pollMs = pollMs;
+	m_lastErr = MN_OK;
+
+	// Group the channels by node, a node's channels are contiguous in the
+	// channel table
+	memset(m_pHdr, 0, sizeof(dacqRecHeader));
+	m_nStreams = 0;
+	nChan = 0;
+	for (iDef = 0; iDef < nDefs; iDef++) {
+		for (iStream = 0; iStream < m_nStreams; iStream++) {
+			if (m_streams[iStream].addr == defs[iDef].addr)
+				break;
+		}
+		if (iStream < m_nStreams)
+			continue;
+		if (m_nStreams == DACQ_REC_MAX_STREAMS) {
+			closeFile(DACQ_REC_FAILED);
+			m_ctlLock.Unlock();
+			return(MN_ERR_BADARG);
+		}
+		streamState &st = m_streams[m_nStreams];
+		dacqRecStream &hdrStream = m_pHdr->streams[m_nStreams];
+		memset(&st, 0, sizeof(st));
+		st.addr = defs[iDef].addr;
+		hdrStream.addr = st.addr;
+		hdrStream.firstChannel = Uint16(nChan);
+		infcGetDataAcqPeriod(st.addr, &periodMs);
+		hdrStream.pointPeriodMs = periodMs;
+		for (size_t jDef = iDef; jDef < nDefs; jDef++) {
+			if (defs[jDef].addr != st.addr)
+				continue;
+			if (st.nChannels == DACQ_REC_STREAM_CHANNELS) {
+				closeFile(DACQ_REC_FAILED);
+				m_ctlLock.Unlock();
+				return(MN_ERR_BADARG);
+			}
+			dacqRecChannel &chan = m_pHdr->channels[nChan++];
+			chan.stream = Uint16(m_nStreams);
+			chan.source = Uint16(defs[jDef].source);
+			chan.scale = defs[jDef].scale;
+			chan.offset = defs[jDef].offset;
+			copyName(chan.name, defs[jDef].name, DACQ_REC_NAME_LEN);
+			copyName(chan.units, defs[jDef].units, DACQ_REC_UNITS_LEN);
+			st.sources[st.nChannels++] = Uint8(defs[jDef].source);
+		}
+		// The time column plus one per channel
+		st.rowCapacity = Uint16((DACQ_REC_CHUNK_BYTES - sizeof(dacqRecChunk))
+								/ (sizeof(float) * (1 + st.nChannels)));
+		hdrStream.nChannels = st.nChannels;
+		hdrStream.rowCapacity = st.rowCapacity;
+		m_nStreams++;
+	}
+	m_pHdr->nStreams = Uint16(m_nStreams);
+	m_pHdr->nChannels = Uint16(nChan);
+	m_pHdr->chunkBytes = DACQ_REC_CHUNK_BYTES;
+	m_pHdr->version = DACQ_REC_VERSION;
+	m_pHdr->state = DACQ_REC_RECORDING;
+	m_pHdr->startTime = int64(time(NULL));
+	// Readers check the signature last
+	CCatomicUpdate::Fence();
+	m_pHdr->magic = DACQ_REC_MAGIC;
+
+	try {
+		LaunchThread();
+	}
+	catch (...) {
+		closeFile(DACQ_REC_FAILED);
+		m_ctlLock.Unlock();
+		return(MN_ERR_THREAD_CREATE);
+	}
+	m_ctlLock.Unlock();
+	return(MN_OK);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqRecorder::Stop
+//
+//	DESCRIPTION:
+//		Stop the writer once it has recorded the points still waiting, and
+//		close the file. Returns the recording status.
+//
+//	SYNOPSIS:
+cnErrCode CDataAcqRecorder::Stop()
+{
+	m_ctlLock.Lock();
+	TerminateAndWait();
+	if (m_pHdr)
+		closeFile(m_lastErr == MN_OK ? DACQ_REC_CLOSED : DACQ_REC_FAILED);
+	m_ctlLock.Unlock();
+	return(m_lastErr);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqRecorder::Terminate
+//
+//	DESCRIPTION:
+//		Initiate the terminate sequence and cut short the wait for the next
+//		drain.
+//
+//	SYNOPSIS:
+HANDLE CDataAcqRecorder::Terminate()
+{
+	HANDLE hThread = CThread::Terminate();
+	m_wake.SetEvent();
+	return(hThread);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqRecorder::newChunk
+//
+//	DESCRIPTION:
+//		Close the stream's chunk and start the next one in the file, growing
+//		the file by an extent when it is full. Returns false on a file
+//		error.
+//
+//	SYNOPSIS:
+bool CDataAcqRecorder::newChunk(size_t iStream, double baseTime)
+{
+	streamState &st = m_streams[iStream];
+	dacqRecChunk *pChunk;
+
+	closeChunk(iStream);
+	if (m_chunks == m_fileChunks) {
+		if (!m_file.Extend(Uint64(DACQ_REC_CHUNK_BYTES)
+				* (1 + m_fileChunks + DACQ_REC_EXTENT_CHUNKS)))
+			return(false);
+		m_fileChunks += DACQ_REC_EXTENT_CHUNKS;
+	}
+	pChunk = (dacqRecChunk *)m_file.Map(
+		Uint64(DACQ_REC_CHUNK_BYTES) * (1 + m_chunks), DACQ_REC_CHUNK_BYTES);
+	if (!pChunk)
+		return(false);
+
+	pChunk->magic = DACQ_REC_CHUNK_MAGIC;
+	pChunk->stream = Uint16(iStream);
+	pChunk->rowCapacity = st.rowCapacity;
+	pChunk->rows = 0;
+	pChunk->gaps = 0;
+	pChunk->firstRow = st.nextRow;
+	pChunk->baseTime = baseTime;
+	st.pChunk = pChunk;
+	st.pCols = (float *)(pChunk + 1);
+	st.rows = 0;
+
+	// Count the chunk once its header is in place
+	m_chunks++;
+	CCatomicUpdate::Fence();
+	m_pHdr->chunks = m_chunks;
+	return(true);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqRecorder::closeChunk
+//
+//	DESCRIPTION:
+//		Publish the rows of the stream's chunk and release its view.
+//
+//	SYNOPSIS:
+void CDataAcqRecorder::closeChunk(size_t iStream)
+{
+	streamState &st = m_streams[iStream];
+	if (!st.pChunk)
+		return;
+	CCatomicUpdate::Fence();
+	st.pChunk->rows = st.rows;
+	CCmappedFile::Unmap(st.pChunk, DACQ_REC_CHUNK_BYTES);
+	st.pChunk = NULL;
+	st.pCols = NULL;
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqRecorder::drain
+//
+//	DESCRIPTION:
+//		Record the points waiting in the stream's ring, reading them in
+//		place and writing each straight into its chunk's columns. The rows
+//		are published to readers once per drain. Returns false on a file
+//		error.
+//
+//	SYNOPSIS:
+bool CDataAcqRecorder::drain(size_t iStream)
+{
+	streamState &st = m_streams[iStream];
+	const mnDataAcqPt *pPts;
+	nodeulong nPts, iPt, dropped;
+	Uint32 cap = st.rowCapacity;
+	float *pRow;
+
+	while (infcPeekDataAcqPts(st.addr, &pPts, &nPts) == MN_OK) {
+		for (iPt = 0; iPt < nPts; iPt++) {
+			if (!st.pChunk || st.rows == cap) {
+				if (!newChunk(iStream, pPts[iPt].TimeStamp)) {
+					infcReleaseDataAcqPts(st.addr, iPt);
+					return(false);
+				}
+			}
+			pRow = st.pCols + st.rows;
+			pRow[0] = float(pPts[iPt].TimeStamp - st.pChunk->baseTime);
+			for (Uint16 iChan = 0; iChan < st.nChannels; iChan++)
+				pRow[cap * (iChan + 1)]
+					= dacqRecSourceValue(pPts[iPt], st.sources[iChan]);
+			if (!pPts[iPt].Valid)
+				st.pChunk->gaps++;
+			st.rows++;
+			st.nextRow++;
+		}
+		infcReleaseDataAcqPts(st.addr, nPts);
+	}
+	if (st.pChunk) {
+		CCatomicUpdate::Fence();
+		st.pChunk->rows = st.rows;
+	}
+	if (infcGetDataAcqDropped(st.addr, TRUE, &dropped) == MN_OK)
+		m_pHdr->streams[iStream].dropped += dropped;
+	return(true);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqRecorder::closeFile
+//
+//	DESCRIPTION:
+//		Release every view, mark the file with its final state and close
+//		it.
+//
+//	SYNOPSIS:
+void CDataAcqRecorder::closeFile(dacqRecState state)
+{
+	for (size_t iStream = 0; iStream < m_nStreams; iStream++)
+		closeChunk(iStream);
+	m_pHdr->state = Uint16(state);
+	CCmappedFile::Flush(m_pHdr, DACQ_REC_CHUNK_BYTES);
+	CCmappedFile::Unmap(m_pHdr, DACQ_REC_CHUNK_BYTES);
+	m_pHdr = NULL;
+	m_nStreams = 0;
+	m_file.Close();
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqRecorder::Run
+//
+//	DESCRIPTION:
+//		Drain every stream at the poll rate until terminated, then once
+//		more to pick up the points that arrived during the last wait.
+//
+//	SYNOPSIS:
+int CDataAcqRecorder::Run(void * /*context*/)
+{
+	size_t iStream;
+	bool stopping;
+
+	do {
+		stopping = Terminating();
+		for (iStream = 0; iStream < m_nStreams; iStream++) {
+			if (!drain(iStream)) {
+				m_lastErr = MN_ERR_FILE_WRITE;
+				return(0);
+			}
+		}
+		if (!stopping)
+			m_wake.WaitFor(Uint32(m_pollMs + 0.5));
+	} while (!stopping);
+	return(0);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqRecReader::CDataAcqRecReader
+//
+//	DESCRIPTION:
+//		Construction/Destruction
+//
+//	SYNOPSIS:
+CDataAcqRecReader::CDataAcqRecReader()
+{
+	m_pHdr = NULL;
+	m_pChunk = NULL;
+}
+
+CDataAcqRecReader::~CDataAcqRecReader()
+{
+	Close();
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqRecReader::Open
+//
+//	DESCRIPTION:
+//		Open a recording file and map its header.
+//
+//	SYNOPSIS:
+cnErrCode CDataAcqRecReader::Open(const char *path)
+{
+	Close();
+	if (!path || !m_file.Open(path, false))
+		return(MN_ERR_FILE_OPEN);
+	if (m_file.Size() < DACQ_REC_CHUNK_BYTES
+		|| (m_pHdr = (const dacqRecHeader *)
+				m_file.Map(0, DACQ_REC_CHUNK_BYTES), m_pHdr == NULL)) {
+		Close();
+		return(MN_ERR_FILE_OPEN);
+	}
+	if (m_pHdr->magic != DACQ_REC_MAGIC
+		|| m_pHdr->version != DACQ_REC_VERSION
+		|| m_pHdr->chunkBytes != DACQ_REC_CHUNK_BYTES) {
+		Close();
+		return(MN_ERR_FILE_BAD);
+	}
+	CCatomicUpdate::Fence();
+	return(MN_OK);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqRecReader::Close
+//
+//	DESCRIPTION:
+//		Release the views and the file.
+//
+//	SYNOPSIS:
+void CDataAcqRecReader::Close()
+{
+	CCmappedFile::Unmap((void *)m_pChunk, DACQ_REC_CHUNK_BYTES);
+	CCmappedFile::Unmap((void *)m_pHdr, DACQ_REC_CHUNK_BYTES);
+	m_pChunk = NULL;
+	m_pHdr = NULL;
+	m_file.Close();
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqRecReader::Chunks
+//
+//	DESCRIPTION:
+//		Return the number of chunks started by the writer. Their headers
+//		are complete, their rows may still be growing.
+//
+//	SYNOPSIS:
+Uint32 CDataAcqRecReader::Chunks() const
+{
+	Uint32 chunks;
+	if (!m_pHdr)
+		return(0);
+	chunks = m_pHdr->chunks;
+	CCatomicUpdate::Fence();
+	return(chunks);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqRecReader::Chunk
+//
+//	DESCRIPTION:
+//		Map chunk \e chunk in place of the previous one. Returns NULL if
+//		the writer has not started it.
+//
+//	SYNOPSIS:
+const dacqRecChunk *CDataAcqRecReader::Chunk(Uint32 chunk)
+{
+	CCmappedFile::Unmap((void *)m_pChunk, DACQ_REC_CHUNK_BYTES);
+	m_pChunk = NULL;
+	if (chunk >= Chunks())
+		return(NULL);
+	m_pChunk = (const dacqRecChunk *)m_file.Map(
+		Uint64(DACQ_REC_CHUNK_BYTES) * (1 + chunk), DACQ_REC_CHUNK_BYTES);
+	return(m_pChunk);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqRecReader::Rows
+//
+//	DESCRIPTION:
+//		Return the rows of the mapped chunk whose columns are complete.
+//
+//	SYNOPSIS:
+Uint32 CDataAcqRecReader::Rows() const
+{
+	Uint32 rows;
+	if (!m_pChunk)
+		return(0);
+	rows = m_pChunk->rows;
+	CCatomicUpdate::Fence();
+	return(rows);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CDataAcqRecReader::Column
+//
+//	DESCRIPTION:
+//		Return column \e col of the mapped chunk. Column 0 holds the point
+//		times after the chunk's baseTime, column n the stream's channel
+//		n-1. Returns NULL if there is no such column.
+//
+//	SYNOPSIS:
+const float *CDataAcqRecReader::Column(size_t col) const
+{
+	if (!m_pChunk || m_pChunk->stream >= m_pHdr->nStreams
+		|| col > m_pHdr->streams[m_pChunk->stream].nChannels)
+		return(NULL);
+	return((const float *)(m_pChunk + 1) + col * m_pChunk->rowCapacity);
+}
+//																			  *
+//*****************************************************************************
+
+
+//=============================================================================
+//	END OF FILE dataAcqRecorder.cpp
+//=============================================================================
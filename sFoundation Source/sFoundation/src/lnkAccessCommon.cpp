@@ -121,6 +121,7 @@ new controller the current controller is changed.
 #include "netCmdPrivate.h"
 #include "SerialEx.h"
 #include "netCmdAPI.h"
+#include "dacqDecode.h"
 // Std Library
 #include <fstream>
 // System include files
@@ -365,7 +366,7 @@ void DUMP_PKT(netaddr cNum, const char *msg, packetbuf *buf, bool backArrow)
 		return;
 
 	_RPT5(_CRT_WARN, "%.1f %s(%d) %d: %s ", infcCoreTime(), msg, cNum,
-		(int)pNCS->nRespOutstanding, backArrow ? "<-" : "->");
+		(int)pNCS->nRespOutstanding.Value(), backArrow ? "<-" : "->");
 	if (buf->Byte.BufferSize > MN_API_PACKET_MAX)
 		bLen = MN_API_PACKET_MAX;
 	else
@@ -412,7 +413,8 @@ void DUMP_PKT(netaddr cNum, const char *msg, packetbuf *buf, bool backArrow)
 //	SYNOPSIS:
 netStateInfo::netStateInfo(nodeulong ringCmdsMax,
 	netaddr controllerNum)
-	: CmdPaceSemaphore(ringCmdsMax, ringCmdsMax)
+	: CmdPaceSemaphore(ringCmdsMax, ringCmdsMax),
+	  StopPaceSemaphore(STOP_LANE_SLOTS, STOP_LANE_SLOTS)
 {
 	extern int InfcPrioBoostFactor;					// Read thread prio boost
 	cNum = controllerNum;							// Our index
@@ -443,17 +445,25 @@ netStateInfo::netStateInfo(nodeulong ringCmdsMax,
 	SelfDestruct = false;					// No death yet
 
 	RingCmdsMax = ringCmdsMax;				// Save for destruction time
+	// The whole ring is ours until the window is told to adapt
+	PaceAdaptive = FALSE;
+	PaceWindow = ringCmdsMax;
+	PaceParked = PaceParkDebt = 0;
+	PaceRoundCnt = PaceRoundDepth = 0;
+	PaceMinRTT = PaceSmoothRTT = 0;
+	// No stops asked for yet
+	pStopLane = NULL;
+	StopReqAt = StopBurstReqAt = 0;
+	AsyncDueAt = 0;
 											// Adjust select event objects
 	CmdGate.SetEvent();
 	// We start idle
 	CmdsIdle.SetEvent();
 
-	nPktsSent = nPktsRcvd = nRespOutstanding = 0;
+	nPktsSent = nPktsRcvd = 0;
 
 	for (node = 0; node<MN_API_MAX_NODES; node++) {
 		// Initialize the node response databases, assuming no waiters
-		respNodeState[node].head = NULL;
-		respNodeState[node].tail = NULL;
 		respNodeState[node].errPkt.Byte.BufferSize = 0;
 		respNodeState[node].sendCnt = 0;
 		respNodeState[node].respCnt = 0;
@@ -471,8 +481,6 @@ netStateInfo::netStateInfo(nodeulong ringCmdsMax,
 	// Take care of the host's extra diags slot off the end
 	SysInventory[cNum].diagStats[MN_API_MAX_NODES].Clear();
 
-	controlNodeState.head = NULL;
-	controlNodeState.tail = NULL;
 	controlNodeState.errPkt.Byte.BufferSize = 0;
 	controlNodeState.sendCnt = 0;
 	controlNodeState.respCnt = 0;
@@ -488,25 +496,27 @@ netStateInfo::netStateInfo(nodeulong ringCmdsMax,
 	// Create threads
 	ReadThread.SetTerminateFlag(&SelfDestruct);
 
-	// Create trackers for each possible command in progress on this net
-	pTrkFixedList = (respTrackInfo **)malloc(sizeof(respTrackInfo *)*ringCmdsMax);
-	pTrkList = (respTrackInfo **)malloc(sizeof(respTrackInfo *)*ringCmdsMax);
-	for (node = 0; node<ringCmdsMax; node++) {
-		pTrkFixedList[node] = new respTrackInfo;
-		pTrkList[node] = pTrkFixedList[node];
+	// Create a tracker ring for each node and the control packets. A
+	// node may have the whole window in flight and its stop as well.
+	TrkRingLen = 1;
+	while (TrkRingLen < ringCmdsMax + 1)
+		TrkRingLen <<= 1;
+	pTrkStore = new respTrackInfo[TrkRingLen*(MN_API_MAX_NODES + 1)];
+	assert(pTrkStore);
+	for (node = 0; node<MN_API_MAX_NODES; node++) {
+		respNodeState[node].trk = &pTrkStore[TrkRingLen*node];
+		respNodeState[node].trkMask = TrkRingLen - 1;
 	}
-	assert(pTrkList);
+	controlNodeState.trk = &pTrkStore[TrkRingLen*MN_API_MAX_NODES];
+	controlNodeState.trkMask = TrkRingLen - 1;
 	#if TRACE_SIZES
 	_RPT2(_CRT_WARN, "respTrackInfo size=%d(0x%x)\n",
-		sizeof(respTrackInfo)*ringCmdsMax,
-		sizeof(respTrackInfo)*ringCmdsMax);
+		sizeof(respTrackInfo)*TrkRingLen*(MN_API_MAX_NODES + 1),
+		sizeof(respTrackInfo)*TrkRingLen*(MN_API_MAX_NODES + 1));
 	_RPT1(_CRT_WARN, "sizeof(rxTraceBuf)=%d\n", sizeof(rxTraceBuf));
 	_RPT1(_CRT_WARN, "sizeof(txTraceBuf)=%d\n", sizeof(txTraceBuf));
 	_RPT1(_CRT_WARN, "sizeof(traceHeader)=%d\n", sizeof(traceHeader));
 	#endif
-
-	// Insure the tail is initialized
-	pTrkTail = &pTrkList[ringCmdsMax - 1];
 	// Create our discovery thread
 	pAutoDiscover = new autoDiscoverThread;
 	#if TRACE_SIZES
@@ -530,6 +540,10 @@ netStateInfo::netStateInfo(nodeulong ringCmdsMax,
 	pPollerThread = new	netPollerThread(this);
 	pPollerThread->LaunchThread(this);
 
+	// The stop lane runs at the read thread's priority
+	pStopLane = new netStopLaneThread(this);
+	pStopLane->LaunchThread(this, InfcPrioBoostFactor);
+
 	#if TRACE_LOW_LEVEL || TRACE_DESTRUCT
 	_RPT2(_CRT_WARN, "%.1f netStateInfo(new)(%d) finished...\n",
 		infcCoreTime(), cNum);
@@ -595,16 +609,20 @@ netStateInfo::~netStateInfo()
 		pAutoDiscover = NULL;
 	}
 
+	if (pStopLane) {
+		delete pStopLane;
+		pStopLane = NULL;
+	}
+
 	if (pPollerThread) {
 		delete pPollerThread;
 		pPollerThread = NULL;
 	}
 
 	// Restart the the waiting responses
-	for (i = 0; i<RingCmdsMax; i++) {
+	for (i = 0; pTrkStore && i<TrkRingLen*(MN_API_MAX_NODES + 1); i++) {
 		// Signal events waiting for responses
-		if (pTrkFixedList && pTrkFixedList[i])
-			pTrkFixedList[i]->evtRespWait.SetEvent();
+		pTrkStore[i].evtRespWait.SetEvent();
 	}
 	// Make sure those waiting (re)start
 	IrqEvent.SetEvent();
@@ -619,6 +637,8 @@ netStateInfo::~netStateInfo()
 
 	// Wait for read thread to terminate to prevent access violations
 	ReadThread.WaitForTerm();
+	// Tell asynchronous submitters their commands will never finish
+	abandonAsyncItems();
 
 	// Done with serial port now
 	#if TRACE_LOW_LEVEL || TRACE_DESTRUCT
@@ -637,25 +657,14 @@ netStateInfo::~netStateInfo()
 		infcCoreTime(), cNum);
 	#endif
 
-	pTrkTail = NULL;
-	if (pTrkList) {
-		// Return the tracking database memory
-		for (i = 0; i < RingCmdsMax; i++) {
-			pTrkList[i] = NULL;
-		}
-		free(pTrkList);
-		pTrkList = NULL;
-	}
-	if (pTrkFixedList) {
+	if (pTrkStore) {
 		// Return the tracking database memory
-		for (i = 0; i < RingCmdsMax; i++) {
-			if (pTrkFixedList[i]) {
-				delete pTrkFixedList[i];
-				pTrkFixedList[i] = NULL;
-			}
+		for (i = 0; i < MN_API_MAX_NODES; i++) {
+			respNodeState[i].trk = NULL;
 		}
-		free(pTrkFixedList);
-		pTrkFixedList = NULL;
+		controlNodeState.trk = NULL;
+		delete [] pTrkStore;
+		pTrkStore = NULL;
 	}
 
 	// Relieve the Initialization stack in inventory
@@ -792,7 +801,7 @@ unsigned mnNetInvRecords::logSend(packetbuf *cmd, cnErrCode theErr, double timeS
 		// Log the command itself
 		pTxTrace->packet = *cmd;
 		// Log command depth
-		pTxTrace->depth = pNCS->nRespOutstanding;
+		pTxTrace->depth = pNCS->nRespOutstanding.Value();
 		// Log as a failure
 		pTxTrace->failed = (unsigned short)theErr;
 	}
@@ -878,69 +887,120 @@ double mnNetInvRecords::logReceive(
 //******************************************************************************
 
 
+//****************************************************************************
+//	NAME																	 *
+//		netStateInfo::claimHeadDBitem
+//
+//	DESCRIPTION:
+//		Claim the oldest tracker of <pRespArea> for the response just read.
+//		Trackers their senders gave up on are retired on the way, the
+//		response then belongs to the next one as the node answers in order.
+//
+// 		NOTE: Only the read thread, or a thread that halted it, may call
+//		this function.
+//
+//	RETURNS:
+//		The claimed tracker or NULL if no response is expected.
+//
+//	SYNOPSIS:
+respTrackInfo *netStateInfo::claimHeadDBitem(
+	respNodeList *pRespArea)
+{
+	respTrackInfo *pHead;
+	LONG token;
+
+	while ((pHead = pRespArea->head()) != NULL) {
+		token = pHead->state.Value() & ~TRK_STATE_MASK;
+		if (pHead->state.Swap(token | TRK_PENDING, token | TRK_CLAIMED))
+			return(pHead);
+		// Canceled or timed-out, retire it
+		removeHeadDBitem(pRespArea);
+	}
+	return(NULL);
+}
+//																			 *
+//****************************************************************************
+
+
+
 //****************************************************************************
 //	NAME																	 *
 //		netStateInfo::removeHeadDBitem
 //
 //	DESCRIPTION:
-//		Remove the head item from the <respArea> nodelist and relieve the
-//		command pacing semaphore by one item.
+//		Retire the head item of the <respArea> ring and relieve the command
+//		pacing semaphore by one item. A claimed item is completed, one still
+//		pending is abandoned with <abandonErr> and one that timed-out is
+//		logged as such.
 //
-// 		NOTE: The response database should be locked when this function is
-//		called.
+// 		NOTE: Only the read thread, or a thread that halted it, may call
+//		this function.
 //
 //	SYNOPSIS:
 void netStateInfo::removeHeadDBitem(
-	respNodeList *pRespArea)
+	respNodeList *pRespArea,
+	cnErrCode abandonErr)
 {
-	respTrackInfo *pThisInfo, *pNextInfo;		// Parsers of response DB
+	respTrackInfo *pThisInfo;					// Tracker being retired
+	cnErrCode outcome;
+	LONG token;
 	BOOL dataOK;
 
 	// No node list
-	if ((pRespArea == NULL) || (pRespArea->head == NULL)) {
+	pThisInfo = pRespArea ? pRespArea->head() : NULL;
+	if (pThisInfo == NULL) {
 		_RPT0(_CRT_WARN, "removeHeadDBitem: NULL response or head!\n");
 		return;
 	}
 
-	// Init parsers
-	pThisInfo = pRespArea->head;
-	pNextInfo = pThisInfo->next;
-	// Unlink the head and point at tail
-	pRespArea->head = pNextInfo;
-	if (pRespArea->head == NULL) {
-		// Clean up our tail if we are empty
-		pRespArea->tail = NULL;
-	}
-	// Signal we have something
-	//if (pThisInfo->evtRespWait.isOK()) {
-	//_RPT2(_CRT_WARN," removeHeadDB wait event set hndl=0x%0x, %.2f\n",
-	//	pThisInfo->hRespWait, infcCoreTime());
-	pThisInfo->evtRespWait.SetEvent();
-	// Synchronize with others waiting
-	pThisInfo->evtRespWait.WaitFor();
-	//}
-	// Return this tracker to pool
-	++pTrkTail;					// Create space at the end
-	*pTrkTail = pThisInfo;
+	token = pThisInfo->state.Value() & ~TRK_STATE_MASK;
+	if (pThisInfo->state.Swap(token | TRK_CLAIMED, token | TRK_DONE)) {
+		outcome = MN_OK;
+	}
+	else if (pThisInfo->state.Swap(token | TRK_PENDING, token | TRK_CANCELED)) {
+		outcome = abandonErr;
+	}
+	else if ((pThisInfo->state.Value() & TRK_STATE_MASK) == TRK_EXPIRED) {
+		outcome = MN_ERR_RESP_TIMEOUT;
+		// Add failure to the rx log file
+		if (SysInventory[cNum].TraceActive) {
+			packetbuf nullPkt;
+
+			// Create null packet buffer
+			nullPkt.Byte.BufferSize = 0;
+			nullPkt.Byte.Buffer[0] = nullPkt.Byte.Buffer[1] = 0;
+			// Assign a receive trace record
+			SysInventory[cNum].logReceive(&nullPkt, MN_ERR_RESP_TIMEOUT,
+										  pThisInfo, infcCoreTime());
+		}
+		// Back the command window off
+		paceUpdate(0, 0, TRUE);
+		latHistOf(&pThisInfo->stats.cmd).recordTimeout();
+	}
+	else {
+		outcome = abandonErr;
+	}
+	// Queue the completion if nobody is waiting on the event, else
+	// signal we have something
+	if (pThisInfo->asyncFunc)
+		retireAsyncItem(pThisInfo, outcome);
+	else
+		pThisInfo->evtRespWait.SetEvent();
+	// Return this tracker to the senders
+	pRespArea->takeIdx.Incr();
 	// Release the command semaphore allowing one more
-	//_RPT1(_CRT_WARN, "returnHead @ 0x%x\n", pThisInfo);
-	//_RPT2(_CRT_WARN, "Release PACE(removeDBhead) cmd=%d rank=%d\n", pThisInfo->sendSerNum, nRespOutstanding);
+	//_RPT2(_CRT_WARN, "Release PACE(removeDBhead) cmd=%d rank=%d\n", pThisInfo->sendSerNum, nRespOutstanding.Value());
 	// There is one less to expect now
-	#if defined(_DEBUG)
-	dataOK = CmdPaceSemaphore.Unlock(1, &SemaCount);
-	//if ((SysInventory[cNum].NumCmdsInRing-SemaCount)!=nRespOutstanding) {
-	//	_RPT3(_CRT_WARN,"%.1f removeHeadDBitem semaphore mismatch! @%d we think %d\n",
-	//			infcCoreTime(), (SysInventory[cNum].NumCmdsInRing-SemaCount),
-	//			nRespOutstanding);
-	//}
-	#else
-	dataOK = CmdPaceSemaphore.Unlock();
-	#endif
+	if (pThisInfo->stopLane) {
+		pThisInfo->stopLane = FALSE;
+		dataOK = StopPaceSemaphore.Unlock();
+	}
+	else
+		dataOK = releasePaceSlot();
 	if (dataOK) {
 		// Make sure the read thread keeps running
-		if (nRespOutstanding > 0)
-			if (--nRespOutstanding > 0)
-				ReadThread.Start();
+		if (nRespOutstanding.Decr() > 0)
+			ReadThread.Start();
 	}
 	else {
 		infcErrInfo semaErr;
@@ -952,7 +1012,6 @@ void netStateInfo::removeHeadDBitem(
 		_RPT1(_CRT_ERROR, "removeHeadDBitem: semaphore release err 0x%X\n",
 			semaErrCode);
 	}
-	//_RPT1(_CRT_WARN, "returnThis @ 0x%x\n", pThisInfo);
 }
 //																			 *
 //****************************************************************************
@@ -961,96 +1020,452 @@ void netStateInfo::removeHeadDBitem(
 
 //******************************************************************************
 //	NAME																	   *
-//		netStateInfo::removeThisDBitem
+//		netStateInfo::reapDBitems
 //
 //	DESCRIPTION:
-//		This is the function called to remove a database item from the running
-//		queue. The command pacing semaphore is relieved by one item.
+//		Retire the canceled and timed-out trackers at the heads of the
+//		rings. Those behind a live tracker are retired once they reach the
+//		head.
 //
-// 		NOTE: The response database should be locked when this function is
-//		called.
+// 		NOTE: Only the read thread, or a thread that halted it, may call
+//		this function.
 //
 //	SYNOPSIS:
-void netStateInfo::removeThisDBitem(
-	respTrackInfo *pRespInfo,
-	respNodeList *pRespArea)
+void netStateInfo::reapDBitems()
 {
-	respTrackInfo *pThisInfo, *pLastInfo;		// Parsers of response DB
-	BOOL dataOK;
+	respTrackInfo *pHead;
+	respNodeList *pRespArea;
+	LONG state;
+	unsigned i;
 
-	// No node list
-	if ((pRespArea == NULL) || (pRespInfo == NULL) || pRespArea->head == NULL)
-		return;
+	for (i = 0; i <= MN_API_MAX_NODES; i++) {
+		pRespArea = (i < MN_API_MAX_NODES) ? &respNodeState[i]
+										   : &controlNodeState;
+		while ((pHead = pRespArea->head()) != NULL) {
+			state = pHead->state.Value() & TRK_STATE_MASK;
+			if (state != TRK_CANCELED && state != TRK_EXPIRED)
+				break;
+			removeHeadDBitem(pRespArea);
+		}
+	}
+}
+//																			  *
+//*****************************************************************************
 
-	// Init parsers
-	pThisInfo = pLastInfo = pRespArea->head;
-	// Track down database links looking for us
-	while (pThisInfo != NULL) {
-		if (pThisInfo == pRespInfo) {
-			// It's us, remove our entry, are we head?
-			if (pThisInfo == pRespArea->head) {
-				// Yes, change head to next
-				pRespArea->head = pRespInfo->next;
-			}
-			else {
-				// Unlink us from the chain
-				pLastInfo->next = pThisInfo->next;
-			}
-			// Clean up the tail, if we are it
-			if (pRespInfo == pRespArea->tail) {
-				pRespArea->tail = NULL;
-			}
-			break;
+
+
+//******************************************************************************
+//	NAME																	   *
+//		netStateInfo::releasePaceSlot
+//
+//	DESCRIPTION:
+//		Return a command pacing slot freed by a completed command. If the
+//		command window has shrunk, the slot is parked instead of being made
+//		available to the commanding threads.
+//
+//	RETURNS:
+//		true if the slot was returned or parked.
+//
+//	SYNOPSIS:
+bool netStateInfo::releasePaceSlot()
+{
+	bool released;
+
+	PaceLock.Lock();
+	if (PaceParkDebt > 0) {
+		PaceParkDebt--;
+		PaceParked++;
+		released = true;
+	}
+	else {
+		#ifdef _DEBUG
+		released = CmdPaceSemaphore.Unlock(1, &SemaCount);
+		#else
+		released = CmdPaceSemaphore.Unlock();
+		#endif
+	}
+	PaceLock.Unlock();
+	return(released);
+}
+//																			  *
+//*****************************************************************************
+
+
+
+//******************************************************************************
+//	NAME																	   *
+//		netStateInfo::paceSetWindow
+//
+//	DESCRIPTION:
+//		Change the number of pacing slots the commanding threads may use to
+//		<newWindow>, limited to 1..RingCmdsMax. Slots in use when the window
+//		shrinks are parked as their commands complete.
+//
+// 		NOTE: PaceLock should be held when this function is called.
+//
+//	SYNOPSIS:
+void netStateInfo::paceSetWindow(
+	nodeulong newWindow)
+{
+	if (newWindow < 1)
+		newWindow = 1;
+	if (newWindow > RingCmdsMax)
+		newWindow = RingCmdsMax;
+	// Grow by forgiving parking debt first, then releasing parked slots
+	while (PaceWindow < newWindow) {
+		if (PaceParkDebt > 0) {
+			PaceParkDebt--;
 		}
-		// Look at the next item in the list
-		pLastInfo = pThisInfo;
-		pThisInfo = pThisInfo->next;
+		else {
+			PaceParked--;
+			#ifdef _DEBUG
+			CmdPaceSemaphore.Unlock(1, &SemaCount);
+			#else
+			CmdPaceSemaphore.Unlock();
+			#endif
+		}
+		PaceWindow++;
 	}
-	if (pThisInfo == NULL) {
-		// Item not found!
-		_RPT0(_CRT_WARN, "removeDB did not find our item!\n");
+	// Shrink by parking an idle slot or owing one
+	while (PaceWindow > newWindow) {
+		if (CmdPaceSemaphore.Lock(0))
+			PaceParked++;
+		else
+			PaceParkDebt++;
+		PaceWindow--;
+	}
+	PaceRoundCnt = PaceRoundDepth = 0;
+}
+//																			  *
+//*****************************************************************************
+
+
+
+//******************************************************************************
+//	NAME																	   *
+//		netStateInfo::paceAdapt
+//
+//	DESCRIPTION:
+//		Start or stop adapting the command window. Adapting starts from the
+//		default ring depth with fresh latency history, stopping restores the
+//		full window.
+//
+//	SYNOPSIS:
+void netStateInfo::paceAdapt(
+	nodebool adaptive)
+{
+	PaceLock.Lock();
+	PaceAdaptive = adaptive;
+	PaceMinRTT = PaceSmoothRTT = 0;
+	if (adaptive)
+		paceSetWindow(N_CMDS_IN_RING);
+	else
+		paceSetWindow(RingCmdsMax);
+	PaceLock.Unlock();
+}
+//																			  *
+//*****************************************************************************
+
+
+
+//******************************************************************************
+//	NAME																	   *
+//		netStateInfo::paceUpdate
+//
+//	DESCRIPTION:
+//		Adjust the command window from a completed command. <ringTime> is the
+//		time from the end of the command's write to its response and
+//		<ringDepth> the commands in the ring when it was sent.
+//
+//		This works like TCP Vegas: the best round trip seen is the ring's
+//		transit time, the excess of the smoothed round trip over it estimates
+//		the commands waiting in the nodes. Once per window's worth of
+//		completions the window grows if that backlog is small and the window
+//		was full, and shrinks if it is large. A failed command (timeout or
+//		network reject) halves the window.
+//
+//	SYNOPSIS:
+void netStateInfo::paceUpdate(
+	double ringTime,
+	nodeulong ringDepth,
+	nodebool failed)
+{
+	double backlog;
+
+	if (!PaceAdaptive)
+		return;
+	PaceLock.Lock();
+	if (failed) {
+		paceSetWindow(PaceWindow / 2);
+		PaceLock.Unlock();
 		return;
 	}
-	// Signal we have something
-	if (pRespInfo->evtRespWait.isOK()) {
-		#if TRACE_LOW_PRINT
-		_RPT2(_CRT_WARN, "%.1f removeDB wait event set hndl=0x%0lx\n",
-			infcCoreTime(), reinterpret_cast<long>(pRespInfo->evtRespWait.GetHandle()));
-		#endif
-		pRespInfo->evtRespWait.SetEvent();
-		// Synchronize with others waiting
-		pRespInfo->evtRespWait.WaitFor();
-	}
-	// Return this tracker to the end of the pool
-	++pTrkTail;
-	*pTrkTail = pRespInfo;
-	//_RPT1(_CRT_WARN, "returnThis @ 0x%x\n", pRespInfo);
-	// Release the command semaphore allowing one more
-	//_RPT2(_CRT_WARN, "Release PACE(removeDB) cmd=%d rank=%d\n", pRespInfo->sendSerNum, nRespOutstanding);
-	// There is one less to expect now
-	#ifdef _DEBUG
-	dataOK = CmdPaceSemaphore.Unlock(1, &SemaCount);
-	#else
-	dataOK = CmdPaceSemaphore.Unlock();
-	#endif
-	if (dataOK) {
-		if (nRespOutstanding > 0)
-			if (--nRespOutstanding > 0)
-				ReadThread.Start();
-		//_RPT1(_CRT_WARN, "RemoveFromDB outstanding=%d\n",
-		//				(int)nRespOutstanding);
+	if (ringTime <= 0) {
+		PaceLock.Unlock();
+		return;
 	}
-	else {
-		infcErrInfo semaErr;
-		int semaErrCode = GetLastError();
-		semaErr.errCode = MN_ERR_SEND_UNLOCK;
-		semaErr.cNum = cNum;
-		semaErr.node = semaErrCode;
-		infcFireErrCallback(&semaErr);
-		_RPT1(_CRT_ERROR, "removeThisDBitem: semaphore release err 0x%X\n",
-			semaErrCode);
+	// Track the transit time and smoothed round trip
+	if (PaceMinRTT == 0 || ringTime < PaceMinRTT)
+		PaceMinRTT = ringTime;
+	if (PaceSmoothRTT == 0)
+		PaceSmoothRTT = ringTime;
+	else
+		PaceSmoothRTT += (ringTime - PaceSmoothRTT) / 8;
+	if (ringDepth > PaceRoundDepth)
+		PaceRoundDepth = ringDepth;
+	// Decide once per round
+	if (++PaceRoundCnt >= PaceWindow) {
+		backlog = PaceWindow * (1 - PaceMinRTT / PaceSmoothRTT);
+		if (backlog < PACE_BACKLOG_GROW && PaceRoundDepth >= PaceWindow)
+			paceSetWindow(PaceWindow + 1);
+		else if (backlog > PACE_BACKLOG_SHRINK)
+			paceSetWindow(PaceWindow - 1);
+		else
+			PaceRoundCnt = PaceRoundDepth = 0;
 	}
+	PaceLock.Unlock();
+}
+//																			  *
+//*****************************************************************************
+
+
 
+//******************************************************************************
+//	NAME																	   *
+//		latencyHist::bucketOf / bucketTop
+//
+//	DESCRIPTION:
+//		Map a sample to its bucket and a bucket to the largest sample it
+//		holds. Samples below 2*LAT_HIST_SUBS get their own bucket, above
+//		that each power of two is split into LAT_HIST_SUBS buckets.
+//
+//	SYNOPSIS:
+unsigned latencyHist::bucketOf(
+	Uint32 usec)
+{
+	unsigned shift = 0;
+
+	if (usec < 2 * LAT_HIST_SUBS)
+		return(usec);
+	// Shift the sample down to LAT_HIST_SUB_BITS+1 significant bits
+	while ((usec >> shift) >= 2 * LAT_HIST_SUBS)
+		shift++;
+	if (shift > LAT_HIST_OCTAVES)
+		return(LAT_HIST_BUCKETS - 1);
+	return(2 * LAT_HIST_SUBS + (shift - 1) * LAT_HIST_SUBS
+		+ ((usec >> shift) - LAT_HIST_SUBS));
+}
+
+Uint32 latencyHist::bucketTop(
+	unsigned bucket)
+{
+	unsigned shift;
+
+	if (bucket < 2 * LAT_HIST_SUBS)
+		return(bucket);
+	bucket -= 2 * LAT_HIST_SUBS;
+	shift = bucket / LAT_HIST_SUBS + 1;
+	return(((LAT_HIST_SUBS + bucket % LAT_HIST_SUBS + 1) << shift) - 1);
+}
+//																			  *
+//*****************************************************************************
+
+
+
+//******************************************************************************
+//	NAME																	   *
+//		latencyHist::record
+//
+//	DESCRIPTION:
+//		Add a command round trip of <msec> milliseconds.
+//
+// 		NOTE: Any number of threads may record at once. The bucket count is
+//		an atomic increment and the maximum only moves by compare and swap,
+//		so concurrent samples are neither lost nor able to lower it.
+//
+//	SYNOPSIS:
+void latencyHist::record(
+	double msec)
+{
+	Uint32 usec;
+	LONG oldMax;
+
+	if (msec < 0)
+		msec = 0;
+	usec = (msec * 1000 < (double)0x7fffffff) ? (Uint32)(msec * 1000)
+											  : 0x7fffffff;
+	m_bucket[bucketOf(usec)].Incr();
+	// Another recorder may raise, or a collector clear, the maximum
+	// under us
+	do {
+		oldMax = m_max.Value();
+		if ((Uint32)oldMax >= usec)
+			break;
+	} while (!m_max.Swap(oldMax, (LONG)usec));
+}
+//																			  *
+//*****************************************************************************
+
+
+
+//******************************************************************************
+//	NAME																	   *
+//		latencyHist::collect
+//
+//	DESCRIPTION:
+//		Add this histogram into <counts>, <pMax> and <pTimeouts>. With
+//		<reset> the counts are taken out, starting a new window.
+//
+//	SYNOPSIS:
+void latencyHist::collect(
+	Uint32 counts[LAT_HIST_BUCKETS],
+	Uint32 *pMax,
+	Uint32 *pTimeouts,
+	nodebool reset)
+{
+	LONG n;
+	unsigned i;
+
+	for (i = 0; i < LAT_HIST_BUCKETS; i++) {
+		do {
+			n = m_bucket[i].Value();
+		} while (reset && n && !m_bucket[i].Swap(n, 0));
+		counts[i] += (Uint32)n;
+	}
+	do {
+		n = m_max.Value();
+	} while (reset && n && !m_max.Swap(n, 0));
+	if ((Uint32)n > *pMax)
+		*pMax = (Uint32)n;
+	do {
+		n = m_timeouts.Value();
+	} while (reset && n && !m_timeouts.Swap(n, 0));
+	*pTimeouts += (Uint32)n;
+}
+//																			  *
+//*****************************************************************************
+
+
+
+//******************************************************************************
+//	NAME																	   *
+//		latencyHist::summarize
+//
+//	DESCRIPTION:
+//		Fill in <pStats> from collected histogram counts. A percentile is
+//		reported as the top of its bucket, limited by the maximum seen.
+//
+//	SYNOPSIS:
+void latencyHist::summarize(
+	const Uint32 counts[LAT_HIST_BUCKETS],
+	Uint32 maxUsec,
+	Uint32 timeouts,
+	mnLatencyStats *pStats)
+{
+	static const double pctls[] = { 0.50, 0.90, 0.99 };
+	double *results[] = { &pStats->P50, &pStats->P90, &pStats->P99 };
+	Uint32 total = 0, seen = 0, top;
+	unsigned i, iPctl = 0;
+
+	for (i = 0; i < LAT_HIST_BUCKETS; i++)
+		total += counts[i];
+	pStats->Count = total;
+	pStats->Timeouts = timeouts;
+	pStats->Max = maxUsec / 1000.;
+	pStats->P50 = pStats->P90 = pStats->P99 = 0;
+	for (i = 0; i < LAT_HIST_BUCKETS && iPctl < 3 && total; i++) {
+		seen += counts[i];
+		top = bucketTop(i);
+		if (top > maxUsec)
+			top = maxUsec;
+		while (iPctl < 3 && seen >= pctls[iPctl] * total) {
+			*results[iPctl++] = top / 1000.;
+		}
+	}
+}
+//																			  *
+//*****************************************************************************
+
+
+
+//******************************************************************************
+//	NAME																	   *
+//		latencyHist::classOf
+//
+//	DESCRIPTION:
+//		Sort a command into the group its latency is kept with.
+//
+//	SYNOPSIS:
+mnLatencyClass latencyHist::classOf(
+	const packetbuf *pCmd)
+{
+	if (pCmd->Fld.PktType == MN_PKT_TYPE_TRIGGER)
+		return(MN_LAT_TRIGGER);
+	if (pCmd->Fld.PktType != MN_PKT_TYPE_CMD)
+		return(MN_LAT_OTHER);
+	switch (pCmd->Byte.Buffer[CMD_LOC]) {
+	case MN_CMD_GET_PARAM0:
+	case MN_CMD_GET_PARAM1:
+	case MN_CMD_GET_PARAM2:
+		return(MN_LAT_GET_PARAM);
+	case MN_CMD_SET_PARAM0:
+	case MN_CMD_SET_PARAM1:
+	case MN_CMD_SET_PARAM2:
+		return(MN_LAT_SET_PARAM);
+	case MN_CMD_NODE_STOP:
+		return(MN_LAT_NODE_STOP);
+	case ISC_CMD_DATA_COLLECT:
+		return(MN_LAT_DATA_COLLECT);
+	default:
+		return(MN_LAT_OTHER);
+	}
+}
+//																			  *
+//*****************************************************************************
+
+
+
+//******************************************************************************
+//	NAME																	   *
+//		netStateInfo::latHistOf
+//
+//	DESCRIPTION:
+//		Find the latency histogram for the node and command group of
+//		<pCmd>. Control packets are kept in the row past the nodes.
+//
+//	SYNOPSIS:
+latencyHist &netStateInfo::latHistOf(
+	const packetbuf *pCmd)
+{
+	unsigned row = MN_PKT_IS_HIGH_PRIO(pCmd->Fld.PktType)
+		? MN_API_MAX_NODES : pCmd->Fld.Addr % MN_API_MAX_NODES;
+	return(LatHist[row][latencyHist::classOf(pCmd)]);
+}
+//																			  *
+//*****************************************************************************
+
+
+
+//******************************************************************************
+//	NAME																	   *
+//		netStateInfo::stopLaneRequest
+//
+//	DESCRIPTION:
+//		Ask the stop lane to send the group shutdown stops for an event,
+//		such as a CTS fall, seen at <eventAt>. Requests made before the
+//		lane gets to them are served by one set of stops, timed from the
+//		earliest event.
+//
+//	SYNOPSIS:
+void netStateInfo::stopLaneRequest(
+	double eventAt)
+{
+	StopLaneLock.Lock();
+	if (StopReqAt == 0 || eventAt < StopReqAt)
+		StopReqAt = eventAt;
+	SysInventory[cNum].GroupShutdownRequest = true;
+	StopLaneLock.Unlock();
+	StopLaneEvent.SetEvent();
 }
 //																			  *
 //*****************************************************************************
@@ -1067,10 +1482,183 @@ void netStateInfo::removeThisDBitem(
 //	SYNOPSIS:
 void netStateInfo::waitForIdle()
 {
-	while (ReadThread.IsRunning() && !SelfDestruct && nRespOutstanding > 0) {
+	while (ReadThread.IsRunning() && !SelfDestruct && nRespOutstanding.Value() > 0) {
 		infcSleep(100);
 	}
 }
+//																			  *
+//*****************************************************************************
+
+
+
+//******************************************************************************
+//	NAME																	   *
+//		netStateInfo::retireAsyncItem
+//
+//	DESCRIPTION:
+//		Queue the completion of an asynchronous tracker for delivery by the
+//		read thread and return the tracker to its synchronous default.
+//
+// 		NOTE: Only the read thread, or a thread that halted it, may call
+//		this function.
+//
+//	SYNOPSIS:
+void netStateInfo::retireAsyncItem(
+	respTrackInfo *pRespInfo,
+	cnErrCode theErr)
+{
+	respAsyncDone done;
+
+	done.func = pRespInfo->asyncFunc;
+	done.context = pRespInfo->asyncContext;
+	done.buf = pRespInfo->buf;
+	done.err = theErr;
+	AsyncDone.push(done);
+	// The tracker may be reused by a synchronous command
+	pRespInfo->asyncFunc = NULL;
+	pRespInfo->asyncContext = NULL;
+}
+//																			  *
+//*****************************************************************************
+
+
+
+//******************************************************************************
+//	NAME																	   *
+//		netStateInfo::expireAsyncItems
+//
+//	DESCRIPTION:
+//		Time-out the asynchronous commands that have waited longer than the
+//		response time-out. Synchronous commands time themselves out in
+//		infcRunCommand, this does the same for those nobody waits on. The
+//		expired trackers are retired by reapDBitems.
+//
+//		The earliest time-out still to come is left in AsyncDueAt so the
+//		read thread can wake for it.
+//
+// 		NOTE: Only the read thread, or a thread that halted it, may call
+//		this function.
+//
+//	SYNOPSIS:
+void netStateInfo::expireAsyncItems()
+{
+	respTrackInfo *pThisInfo;					// Parser of response DB
+	respNodeList *pRespArea;
+	mnNetInvRecords &theNet = SysInventory[cNum];
+	Uint32 idx, endIdx;
+	LONG token;
+	double now, dueAt, nextDue = 0;
+	unsigned i;
+
+	// Quick exit if there are no asynchronous commands
+	if (nAsyncPending.Value() == 0) {
+		AsyncDueAt = 0;
+		return;
+	}
+
+	now = infcCoreTime();
+	// Scan each node's ring followed by the control packet ring
+	for (i = 0; i <= MN_API_MAX_NODES; i++) {
+		pRespArea = (i < MN_API_MAX_NODES) ? &respNodeState[i]
+										   : &controlNodeState;
+		endIdx = (Uint32)pRespArea->putIdx.Value();
+		for (idx = (Uint32)pRespArea->takeIdx.Value(); idx != endIdx; idx++) {
+			pThisInfo = pRespArea->at(idx);
+			if (!pThisInfo->asyncFunc)
+				continue;
+			dueAt = pThisInfo->cmdStartAt + InfcRespTimeOut;
+			if (now <= dueAt) {
+				// Still running, note when it falls due
+				token = pThisInfo->state.Value() & TRK_STATE_MASK;
+				if (token == TRK_PENDING && (nextDue == 0 || dueAt < nextDue))
+					nextDue = dueAt;
+				continue;
+			}
+			token = pThisInfo->state.Value() & ~TRK_STATE_MASK;
+			if (!pThisInfo->state.Swap(token | TRK_PENDING, token | TRK_EXPIRED))
+				continue;
+			DUMP_PKT(cNum, "**Timeout async cmd ", &pThisInfo->stats.cmd);
+			if (theNet.OpenState == OPENED_ONLINE) {
+				infcErrInfo errInfo;
+				errInfo.errCode = MN_ERR_RESP_TIMEOUT;
+				errInfo.cNum = cNum;
+				infcCopyPktToPkt18(&errInfo.response, &pThisInfo->stats.cmd);
+				errInfo.node = pThisInfo->stats.cmd.Fld.Addr;
+				// Notify the user
+				infcFireErrCallback(&errInfo);
+			}
+		}
+	}
+	AsyncDueAt = nextDue;
+}
+//																			  *
+//*****************************************************************************
+
+
+
+//******************************************************************************
+//	NAME																	   *
+//		netStateInfo::dispatchAsyncDone
+//
+//	DESCRIPTION:
+//		Deliver the finished asynchronous commands to their completion
+//		functions.
+//
+// 		NOTE: Only the read thread, or a thread that halted it, may call
+//		this function.
+//
+//	SYNOPSIS:
+void netStateInfo::dispatchAsyncDone()
+{
+	std::queue<respAsyncDone> ready;
+
+	// Quick exit if there are no asynchronous commands
+	if (nAsyncPending.Value() == 0 || AsyncDone.empty())
+		return;
+
+	std::swap(ready, AsyncDone);
+	nAsyncPending.Add(-(LONG)ready.size());
+
+	while (!ready.empty()) {
+		respAsyncDone &done = ready.front();
+		(*done.func)(cNum, done.err, done.buf, done.context);
+		ready.pop();
+	}
+}
+//																			  *
+//*****************************************************************************
+
+
+
+//******************************************************************************
+//	NAME																	   *
+//		netStateInfo::abandonAsyncItems
+//
+//	DESCRIPTION:
+//		Complete every asynchronous command still in the response database
+//		with MN_ERR_CLOSED. This is used at destruction after the read
+//		thread has exited.
+//
+//	SYNOPSIS:
+void netStateInfo::abandonAsyncItems()
+{
+	respTrackInfo *pThisInfo;					// Parser of response DB
+	respNodeList *pRespArea;
+	Uint32 idx, endIdx;
+	unsigned i;
+
+	for (i = 0; i <= MN_API_MAX_NODES; i++) {
+		pRespArea = (i < MN_API_MAX_NODES) ? &respNodeState[i]
+										   : &controlNodeState;
+		endIdx = (Uint32)pRespArea->putIdx.Value();
+		for (idx = (Uint32)pRespArea->takeIdx.Value(); idx != endIdx; idx++) {
+			pThisInfo = pRespArea->at(idx);
+			if (pThisInfo->asyncFunc)
+				retireAsyncItem(pThisInfo, MN_ERR_CLOSED);
+		}
+	}
+	dispatchAsyncDone();
+}
 /// \endcond																  *
 //*****************************************************************************
 
@@ -1205,12 +1793,30 @@ int readPktThread::Run(void *context)
 			ReadLock.Unlock();
 			//_RPT1(_CRT_WARN, "%.1f Runlock>\n", infcCoreTime());
 
-			// Time to drop out and "poll"
+			// Packets, CTS drops and state changes all signal ReadCommEvent.
+			// Only asynchronous commands need the clock to time them out.
+			// We wake at the earliest of their time-outs, and senders wake
+			// us for a command falling due sooner. A command sent while
+			// the time-outs were being scanned can go unnoticed until the
+			// next scan, so with commands pending we still wake every
+			// RD_THREAD_PREMPTIVE_WAIT, the most such a time-out is late.
+			// Otherwise wake rarely as a backstop.
 			#define RD_THREAD_PREMPTIVE_WAIT 100
+			#define RD_THREAD_IDLE_WAIT 1000
 
 			if (theNet.PortIsOpen()) {
 				// Wait for the interrupt to occur or the timeout
-				waitOK = pNCS->ReadCommEvent.WaitFor(RD_THREAD_PREMPTIVE_WAIT);
+				unsigned rdWait = RD_THREAD_IDLE_WAIT;
+				if (pNCS->nAsyncPending.Value()) {
+					rdWait = RD_THREAD_PREMPTIVE_WAIT;
+					if (pNCS->AsyncDueAt != 0) {
+						double untilDue = pNCS->AsyncDueAt - infcCoreTime();
+						// Round up so the command is due when we wake
+						if (untilDue < rdWait)
+							rdWait = untilDue < 0 ? 1 : (unsigned)untilDue + 1;
+					}
+				}
+				waitOK = pNCS->ReadCommEvent.WaitFor(rdWait);
 			}
 			else {
 				// The port is not open any more, so halt ourselves
@@ -1228,9 +1834,10 @@ int readPktThread::Run(void *context)
 				&& (theNet.OpenState != FLASHING);
 
 			if (ctsEvent && !((m_pTermFlag != NULL) && *m_pTermFlag)) {
-				// Issue node stops if CTS gets de-asserted
-				theNet.GroupShutdownRequest = true;
-				pNCS->GroupShutdownEvent.SetEvent();
+				// Issue node stops if CTS gets de-asserted, timed from
+				// when the serial port saw it fall
+				pNCS->stopLaneRequest(errReport.CTSfallAt != 0
+									  ? errReport.CTSfallAt : infcCoreTime());
 				pNCS->ctsCount = errReport.CTScnt;
 			}
 
@@ -1252,8 +1859,8 @@ int readPktThread::Run(void *context)
 				rxTime = infcCoreTime();
 				eTime = rxTime - eTime;
 
-				// Lock other command starts and housekeepers out here
-				ENTER_LOCK("readThreadProc");
+				// The response database is not locked here, senders only
+				// publish trackers and the read thread alone retires them
 				// How did the read go?
 				if (theErr == MN_OK) {
 					#if TRACE_SEND_RESP
@@ -1290,8 +1897,6 @@ int readPktThread::Run(void *context)
 						theErr = MN_ERR_NULL_RETURN;
 						// Log the outcome
 						theNet.logReceive(&readBuf, theErr, NULL, rxTime);
-						// Release cmd lock on database
-						EXIT_LOCK("readThreadProc (nil buffer)");
 					}
 					else {
 						// Extract address once to "automatic"
@@ -1307,8 +1912,6 @@ int readPktThread::Run(void *context)
 						}
 						// Update statistic
 						pNodeList->respCnt++;
-						// Get the head of our database item
-						pFillInfo = pNodeList->head;
 						// Source from the host?
 						if (readBuf.Fld.Src == MN_SRC_HOST) {
 							// This response originated from the host.
@@ -1319,7 +1922,8 @@ int readPktThread::Run(void *context)
 							bool isNetReject = ((unsigned)readBuf.Fld.PktType == MN_PKT_TYPE_ERROR)
 								&& (pErrPkt->Fld.ErrCls == ND_ERRCLS_NET);
 							if (isNetReject) {
-								EXIT_LOCK("readThreadProc (isNetReject)");
+								// Back the command window off a troubled ring
+								pNCS->paceUpdate(0, 0, TRUE);
 								//In this case, the host noticed a net error while reading in
 								// a packet; increment the host diagStats to signal to those who
 								// might care
@@ -1412,7 +2016,7 @@ int readPktThread::Run(void *context)
 								infcFireErrCallback(&errInfo);
 							}
 							// Expecting response?
-							else if (pFillInfo != NULL) {
+							else if ((pFillInfo = pNCS->claimHeadDBitem(pNodeList)) != NULL) {
 								// Yes, get and remove from the DB
 								#if TRACE_LOW_PRINT&&TRACE_SEND_RESP
 								if (MN_PKT_IS_HIGH_PRIO(readBuf.Fld.PktType)) {
@@ -1453,10 +2057,13 @@ int readPktThread::Run(void *context)
 								if (userCmdCompleteFunc != NULL && theNet.TraceActive) {
 									(*userCmdCompleteFunc)(pNCS->cNum, &pFillInfo->stats);
 								}
+								// Size the command window from this round trip
+								pNCS->paceUpdate(rxTime - pFillInfo->cmdStartAt,
+												 pFillInfo->stats.ringDepth, FALSE);
+								pNCS->latHistOf(&pFillInfo->stats.cmd)
+									.record(rxTime - pFillInfo->cmdStartAt);
 								// We are done using this response, return it back to free pool
 								pNCS->removeHeadDBitem(pNodeList);
-								// Log the outcome
-								EXIT_LOCK("readThreadProc (norm expect)");
 								#if TRACE_HIGH_LEVEL&0
 								_RPT2(_CRT_WARN, "cmd completed net %d in %.2f ms\n", pNCS->cNum, pFillInfo->stats.execTime);
 								#endif
@@ -1472,8 +2079,6 @@ int readPktThread::Run(void *context)
 									case MN_PKT_TYPE_ERROR:
 										theErr = coreGenErrCode(pNCS->cNum, &readBuf, (nodeaddr)errInfo.node);
 										theNet.logReceive(&readBuf, theErr, NULL, rxTime);
-										// Release cmd lock on database
-										EXIT_LOCK("readThreadProc (unsol)");
 										// Create dump file to show context
 										_RPT2(_CRT_WARN, "readThread(%d) MN_PKT_TYPE_ERROR detected by node %d\n",
 											pNCS->cNum, readBuf.Fld.Addr);
@@ -1488,8 +2093,6 @@ int readPktThread::Run(void *context)
 											theErr = MN_ERR_UNSOLICITED;
 										// Log the outcome
 										theNet.logReceive(&readBuf, theErr, NULL, rxTime);
-										// Release cmd lock on database
-										EXIT_LOCK("readThreadProc (unsol)");
 										// Tick the debug log with this information
 										_RPT2(_CRT_WARN, "readThread(%d): unsolicited packet response: node=%d\n",
 											pNCS->cNum, respAddr);
@@ -1497,9 +2100,6 @@ int readPktThread::Run(void *context)
 										break;
 									}
 								}
-								else {
-									EXIT_LOCK("readThreadProc (unexpected)");
-								}
 							}
 						}  // src==MN_SRC_HOST
 						else {  // src==MN_SRC_NODE
@@ -1509,8 +2109,6 @@ int readPktThread::Run(void *context)
 
 								// Log the reception
 							theNet.logReceive(&readBuf, theErr, NULL, rxTime);
-							// Prevent deadlock on any callbacks we no longer interact with cmd database
-							EXIT_LOCK("readThread: src=MN_SRC_NODE");
 							// Process the buffer and signal information
 							processNodeInitiatedPkt(pNCS->cNum, respAddr, pNCS, readBuf);
 						} // src=MN_SRC_MODE
@@ -1518,7 +2116,6 @@ int readPktThread::Run(void *context)
 				}
 				else { // theErr != MN_OK (infcGetResponse failed)
 					if (theNet.OpenState == FLASHING) {
-						EXIT_LOCK("readThread: inserial");
 						// Halt ourselves
 						ReadLock.Lock();
 						NextState(READ_HALT_REQ);
@@ -1528,16 +2125,26 @@ int readPktThread::Run(void *context)
 					else {
 						// Shutting down
 						if (((m_pTermFlag != NULL) && *m_pTermFlag)) {
-							EXIT_LOCK("readThread(read failure, shutting down)");
 							goto exit_thread;
 						}
 						// Read failed, create a "null" receive record in the trace
 						_RPT3(_CRT_WARN, "%.1f readThread(%d): read failed code=0x%x\n",
 							infcCoreTime(), pNCS->cNum, theErr);
-						EXIT_LOCK("readThread(read failure)");
 					}
 				} // (2) infcGetResponse
 			} // (1) if (doRead && !*m_pTermFlag)
+			// Time-out and deliver the asynchronously submitted commands
+			// and retire those the senders gave up on
+			pNCS->expireAsyncItems();
+			pNCS->reapDBitems();
+			pNCS->dispatchAsyncDone();
+			// Consume a wake that brought no packet so the next wait
+			// blocks. A packet queued before the reset re-arms it.
+			if (!pNCS->pSerialPort->IsPacketAvailable()) {
+				pNCS->ReadCommEvent.ResetEvent();
+				if (pNCS->pSerialPort->IsPacketAvailable())
+					pNCS->ReadCommEvent.SetEvent();
+			}
 			break;
 		case READ_HALT_REQ:
 			#if TRACE_RD_THRD
@@ -2501,8 +3108,11 @@ int autoDiscoverThread::Run(void *context)
 			if (m_goneOnline) {
 				// Assume OK at start
 				inventoryChanged = false;
-				// Verify we still are OK and look for node count changes
-				theErr = netEnumerate(cNum);
+				// Same nodes as before the break keep their setup,
+				// otherwise verify we still are OK and look for node
+				// count changes
+				nodebool reattached = netReattach(cNum) == MN_OK;
+				theErr = reattached ? MN_OK : netEnumerate(cNum);
 				// Glitched out, try again
 				if (theErr != MN_OK) {
 					_RPT3(_CRT_WARN, "%.1f autoDiscoverThread(%d): "
@@ -2527,9 +3137,10 @@ int autoDiscoverThread::Run(void *context)
 					inventoryChanged = true;
 					exitCode = 500 + cNum;
 				}
-				// Verify the nodes types are the same as last time
+				// Verify the nodes types are the same as last time, a
+				// re-attach already checked their serial numbers
 				nodeaddr nAddr;
-				for (nAddr = 0; nAddr<SysInventory[cNum].InventoryNow.NumOfNodes; nAddr++) {
+				for (nAddr = 0; !reattached && nAddr<SysInventory[cNum].InventoryNow.NumOfNodes; nAddr++) {
 					devID_t dID;
 					theErr = coreBaseGetParameterInt(cNum, nAddr,
 						MN_P_NODEID, &dID.devCode);
@@ -3085,61 +3696,68 @@ MN_EXPORT cnErrCode MN_DECL  infcSetNetRate(
 
 //******************************************************************************
 //	NAME																	   *
-//		infcRunCommand
+//		infcQueueCommand
 //
 //	DESCRIPTION:
-//		This function will send the buffer specified in <theCommand> and
-//		wait for the response and store it in <theResponse>. If no response
-//		is desired, a NULL pointer is passed to <theResponse> parameter. In
-//		this case, the function will always returns MN_OK.
-//
-//		Commands are run by:
-//			1) acquiring the command semaphore to limit the number of
-//			   simultaneous commands in the network
-//			2) the command lock semaphore is then acquired
-//			3) the command is sent
-//			4) the response database is created and updated with the desired
-//			   handling for this command
-//		    5) The command lock is released
-//			6) If no response is desired, this function returns MN_OK
-//			   else
-//			   We go to sleep waiting for the read thread to wake us up via
-//			   an APC being queued to this thread.
-//			7) If there is a valid response, this function returns MN_OK, else
-//			   it returns the appropriate code.
+//		This is the submission half shared by infcRunCommand,
+//		infcRunCommandAsync and infcRunCommandBatch. The commands are paced,
+//		their response trackers are published to the addressed node's
+//		tracker ring and they are sent.
+//
+//		The first pacing slot is waited for; further slots up to <nCmds>
+//		are only taken if they are free right now. All the commands that
+//		got a slot go out in a single serial write and their count is
+//		returned in <pnQueued>.
+//
+//		Once this returns MN_OK the trackers are owned by the read thread,
+//		which completes them in per-node order. A non-NULL <asyncFunc>
+//		marks the trackers as asynchronous; the read thread then delivers
+//		their outcomes to <asyncFunc> and handles their time-outs as no
+//		thread is waiting on the tracker's event. Synchronous callers get
+//		the tracker of the first command, its state token and the ticket
+//		for its event via <ppRespInfo>, <pRespToken> and <pRespTicket>.
+//		These may be NULL.
+//
+//		With <stopLane> the commands take the slots held back for the
+//		stop lane rather than the pacing window's. Only the stop lane
+//		thread sets it.
 //
 //	RETURNS:
 //		Standard return codes
 //
 //	SYNOPSIS:
-MN_EXPORT cnErrCode MN_DECL infcRunCommand(
+static cnErrCode infcQueueCommand(
 	netaddr cNum,
-	packetbuf *theCommand,				// pointer to filled in command
-	packetbuf *theResponse)				// pointer to response area
+	packetbuf *theCommands,				// pointer to filled in command(s)
+	packetbuf *theResponses,			// pointer to response area(s)
+	size_t nCmds,						// number of commands to attempt
+	size_t *pnQueued,					// number of commands sent
+	double funcStartAt,					// time the caller started
+	infcCmdAsyncCallback asyncFunc,		// completion func if asynchronous
+	void *asyncContext,					// context for <asyncFunc>
+	respTrackInfo **ppRespInfo,			// tracker assigned to first command
+	LONG *pRespToken,					// its state token
+	LONG *pRespTicket,					// its event ticket
+	nodebool stopLane)					// use the stop lane's slots
 {
-	double funcStartAt = infcCoreTime();					// Time we started this function
 	cnErrCode theErr = MN_OK;
-	respNodeList *pRespArea;								// By node address & type data areas
-	respTrackInfo *pRespInfo;								// Thread / response info data
+	respTrackInfo *pRespInfos[SEND_PKTS_PER_WRITE];			// Thread / response info data
+	respNodeList *pRespArea;								// By node address & type data area
+	respTrackInfo *pRespInfo;
+	packetbuf *theCommand;
+	size_t iCmd, nSlots;
+	double cmdStartAt;
+	nodeulong ringDepth;
+	LONG token, firstTicket = 0;
 	BOOL sleepOK;
-	BOOL dataOK, inRecovery;
-	mnCompletionInfo stats;									// Command completion statistics
+	BOOL inRecovery;
+	CCSemaphore *pPace;
+	long *pSemaCount = NULL;
 
-	register netStateInfo *pNCS;							// Quick access to net info
-
-															// Is the device in our range?
-	if (cNum >= NET_CONTROLLER_MAX)
-		return MN_ERR_DEV_ADDR;
-
-	// We must have defined buffers
-	if (!theResponse || !theCommand)
-		return MN_ERR_BADARG;
-
-	// Initialize fast pointer to our data
 	mnNetInvRecords &theNet = SysInventory[cNum];
-	pNCS = theNet.pNCS;
-	// RAII Lock on pNCS until return
-	netStateInfo::cmdsIdleEvt idleChecker(*pNCS);
+	register netStateInfo *pNCS = theNet.pNCS;				// Quick access to net info
+
+	*pnQueued = 0;
 
 	// Don't allow if the port is not open
 	if (!pNCS || !pNCS->pSerialPort || !pNCS->pSerialPort->IsOpen())
@@ -3155,24 +3773,17 @@ MN_EXPORT cnErrCode MN_DECL infcRunCommand(
 		return(MN_ERR_CMD_IN_ATTN);
 	}
 
-
-	theCommand->Fld.StartOfPacket = 1;
-	theResponse->Byte.BufferSize = 0;
-	theResponse->Fld.PktLen = 0;
-	//#ifdef _DEBUG
-	//	theResponse->Byte.Buffer[0] = 0x00;
-	//	theResponse->Byte.Buffer[1] = 0x11;
-	//	theResponse->Byte.Buffer[10] = 0xaaU;
-	//	theResponse->Byte.Buffer[11] = 0xbbU;
-	//#endif
-
 	// Check for outstanding responses
-	if (pNCS->nRespOutstanding == 0 && inDebugging) {
-		if (SysPortCount > 1) {
-			// Check for outstanding responses on other ports
+	if (pNCS->nRespOutstanding.Value() == 0 && inDebugging) {
+		// Every port must be quiet before the locking thread can step
+		netaddr iPort;
+		for (iPort = 0; iPort < SysPortCount; iPort++) {
+			netStateInfo *pOther = SysInventory[iPort].pNCS;
+			if (pOther && pOther->nRespOutstanding.Value() != 0)
+				break;
 		}
-		else {
-			// Release the debugging thread lock gate, allowing us to step 
+		if (iPort == SysPortCount) {
+			// Release the debugging thread lock gate, allowing us to step
 			// through code
 			debugThreadLockResponseGate.SetEvent();
 		}
@@ -3189,6 +3800,13 @@ MN_EXPORT cnErrCode MN_DECL infcRunCommand(
 	// Are we in recovery thread?
 	inRecovery = pNCS->isRecoveryThread();
 
+	// Stops take the slots held back for them instead of the window's
+	pPace = stopLane ? &pNCS->StopPaceSemaphore : &pNCS->CmdPaceSemaphore;
+	#ifdef _DEBUG
+	if (!stopLane)
+		pSemaCount = &pNCS->SemaCount;
+	#endif
+
 	// If diagnostic is running we slowly cancel user's requests to
 	// prevent application spinout.
 	if (!inRecovery && !pNCS->CmdGate.WaitFor(FRAME_WRITE_TIMEOUT))
@@ -3197,7 +3815,7 @@ MN_EXPORT cnErrCode MN_DECL infcRunCommand(
 	// Block here if too many commands are attempted at once, the read
 	// thread will release each of these if the send is successful.
 	// If the transmission fails, we releave this semaphore.
-	sleepOK = pNCS->CmdPaceSemaphore.Lock(INFINITE);
+	sleepOK = pPace->Lock(INFINITE);
 
 	// Too long to release, this should only occur if there is a deadlock
 	if (!sleepOK) {
@@ -3209,43 +3827,30 @@ MN_EXPORT cnErrCode MN_DECL infcRunCommand(
 		semaErr.errCode = MN_ERR_SEND_LOCKED;
 		semaErr.cNum = cNum;
 		semaErr.node = -1;
-		infcCopyPktToPkt18(&semaErr.response, theCommand);
+		infcCopyPktToPkt18(&semaErr.response, theCommands);
 		infcFireErrCallback(&semaErr);
 		// Log the problem
-		theNet.logSend(theCommand, MN_ERR_SEND_LOCKED, infcCoreTime());
+		theNet.logSend(theCommands, MN_ERR_SEND_LOCKED, infcCoreTime());
 		// We are screwed, kill all pending work to flush
 		infcFlush(cNum);
 		return(MN_ERR_SEND_LOCKED);
 	}
+	// Take any other slots that are free now for the rest of a batch
+	nSlots = 1;
+	while (nSlots < nCmds && nSlots < SEND_PKTS_PER_WRITE
+		&& pPace->Lock(0)) {
+		nSlots++;
+	}
 	// Attempt to send command while not initializing?
 	if (!inRecovery && SysInventory[cNum].OpenState != OPENED_ONLINE
 		&& !(SysInventory[cNum].Initializing)) {
 		// Log the send attempt and the error it caused
-		theNet.logSend(theCommand, MN_ERR_CMD_OFFLINE, infcCoreTime());
+		theNet.logSend(theCommands, MN_ERR_CMD_OFFLINE, infcCoreTime());
 		// Prevent leaking locks!
-		#ifdef _DEBUG
-		pNCS->CmdPaceSemaphore.Unlock(1, &pNCS->SemaCount);
-		#else
-		pNCS->CmdPaceSemaphore.Unlock();
-		#endif
+		pPace->Unlock((long)nSlots, pSemaCount);
 		return(MN_ERR_CMD_OFFLINE);
 	}
 
-	// Setup the response area for this command while sending/wait.
-	if (MN_PKT_IS_HIGH_PRIO(theCommand->Fld.PktType)) {
-		// Control packets are not node related, queue separately
-		pRespArea = &pNCS->controlNodeState;
-		#if TRACE_LOW_PRINT&&TRACE_SEND_RESP
-		_RPT2(_CRT_WARN, "\nS%d<%d>", theCommand->Fld.Addr, pRespArea->sendCnt + 1);
-		#endif
-	}
-	else {
-		// Regular packets queue at each node
-		pRespArea = &pNCS->respNodeState[theCommand->Fld.Addr];
-		#if TRACE_LOW_PRINT&&TRACE_SEND_RESP
-		_RPT2(_CRT_WARN, "\nS%d(%d)", theCommand->Fld.Addr, pRespArea->sendCnt + 1);
-		#endif
-	}
 	//
 	// Lock out the other threads until we have this sent out
 	// and the response database entries have been made.
@@ -3261,99 +3866,240 @@ MN_EXPORT cnErrCode MN_DECL infcRunCommand(
 	// If a node can finish ahead of another node in the ring, it may
 	// transmit its result ahead of the transmit order.
 	//
+	// The command lock only serializes the senders, which makes each
+	// tracker ring single producer. The trackers are published before the
+	// write as the read thread may see the responses before it returns.
+	//
 	ENTER_LOCK("infcRunCommand (cmd init)");
 
-	// Assign a response tracking database element.
-	if (!pNCS->pTrkTail) {
+	// Trackers are gone if we are being destroyed
+	if (!pNCS->pTrkStore) {
 		EXIT_LOCK("infcRunCommand(going away)");
 		// Prevent leaking locks!
-		#ifdef _DEBUG
-		pNCS->CmdPaceSemaphore.Unlock(1, &pNCS->SemaCount);
-		#else
-		pNCS->CmdPaceSemaphore.Unlock();
-		#endif
+		pPace->Unlock((long)nSlots, pSemaCount);
 		return(MN_ERR_CMD_OFFLINE);
 	}
-	pRespInfo = *pNCS->pTrkTail;
-	*pNCS->pTrkTail-- = NULL;
-	//_RPT2(_CRT_WARN, "infcRunCommand: trk list %d @ 0x%x\n", pNCS->pTrkTail-pNCS->pTrkList, pRespInfo);
-	if (pNCS->pTrkTail < &pNCS->pTrkList[-1]) {
-		_RPT0(_CRT_ASSERT, "infcRunCommand: oops using illegal tracker\n");
-	}
-
-	// Initialize the response database tracking info
-	pRespInfo->stats.cmd = *theCommand;		// Save our command
-	pRespInfo->next = NULL;					// We are always a leaf
-	pRespInfo->buf = theResponse;			// Where to finally store resp
-	pRespInfo->bufOK = FALSE;				// Nothing here yet
-	pRespInfo->funcStartAt = funcStartAt;	// Record function start
-	pRespInfo->nSentAtAddr = ++pRespArea->sendCnt;
+	// Record time when commands hit the net
+	cmdStartAt = infcCoreTime();
+	// We expect these to return
+	ringDepth = (nodeulong)pNCS->nRespOutstanding.Add((LONG)nSlots);
+	for (iCmd = 0; iCmd < nSlots; iCmd++) {
+		theCommand = &theCommands[iCmd];
+		theCommand->Fld.StartOfPacket = 1;
+		theResponses[iCmd].Byte.BufferSize = 0;
+		theResponses[iCmd].Fld.PktLen = 0;
+
+		// Setup the response area for this command while sending/wait.
+		if (MN_PKT_IS_HIGH_PRIO(theCommand->Fld.PktType)) {
+			// Control packets are not node related, queue separately
+			pRespArea = &pNCS->controlNodeState;
+			#if TRACE_LOW_PRINT&&TRACE_SEND_RESP
+			_RPT2(_CRT_WARN, "\nS%d<%d>", theCommand->Fld.Addr, pRespArea->sendCnt + 1);
+			#endif
+		}
+		else {
+			// Regular packets queue at each node
+			pRespArea = &pNCS->respNodeState[theCommand->Fld.Addr];
+			#if TRACE_LOW_PRINT&&TRACE_SEND_RESP
+			_RPT2(_CRT_WARN, "\nS%d(%d)", theCommand->Fld.Addr, pRespArea->sendCnt + 1);
+			#endif
+		}
 
-	if (theErr == MN_OK) {
-		// Record time when command hits the net
-		pRespInfo->cmdStartAt = infcCoreTime();
-		++pNCS->nRespOutstanding;
-		theErr = infcSendCommand(cNum, theCommand);
-		if (theErr != MN_OK) {
-			--pNCS->nRespOutstanding;
+		// Take the next tracker of the ring, pacing keeps it from overfilling
+		if (pRespArea->count() > pRespArea->trkMask) {
+			_RPT0(_CRT_ASSERT, "infcRunCommand: oops tracker ring overrun\n");
+		}
+		pRespInfo = pRespArea->at((Uint32)pRespArea->putIdx.Value());
+
+		// Initialize the response database tracking info
+		pRespInfo->stats.cmd = *theCommand;		// Save our command
+		pRespInfo->buf = &theResponses[iCmd];	// Where to finally store resp
+		pRespInfo->bufOK = FALSE;				// Nothing here yet
+		pRespInfo->funcStartAt = funcStartAt;	// Record function start
+		pRespInfo->cmdStartAt = cmdStartAt;
+		pRespInfo->stats.sendTime = 0;
+		pRespInfo->stats.ringDepth = ringDepth;
+		pRespInfo->nSentAtAddr = ++pRespArea->sendCnt;
+		// Completion is delivered by the read thread if asynchronous
+		pRespInfo->asyncFunc = asyncFunc;
+		pRespInfo->asyncContext = asyncContext;
+		pRespInfo->stopLane = stopLane;
+		if (asyncFunc) {
+			pNCS->nAsyncPending.Incr();
+		}
+		// Save our serial number
+		pRespInfo->sendSerNum = theNet.logSend(theCommand, MN_OK, cmdStartAt);
+		if (iCmd == 0) {
+			firstTicket = pRespInfo->evtRespWait.Ticket();
 		}
-		pRespInfo->stats.sendTime = infcCoreTime() - pRespInfo->cmdStartAt;
+		pRespInfos[iCmd] = pRespInfo;
+
+		// Hand it to the read thread
+		pRespInfo->state.Set(TRK_TOKEN(pRespInfo->nSentAtAddr) | TRK_PENDING);
+		pRespArea->putIdx.Incr();
 	}
+
+	theErr = infcSendCommands(cNum, theCommands, nSlots);
 	// If we sent command, continue processing for the expected response.
 	if (theErr == MN_OK) {
-		// We expect one to return
-		pRespInfo->stats.ringDepth = pNCS->nRespOutstanding;
+		for (iCmd = 0; iCmd < nSlots; iCmd++) {
+			pRespInfos[iCmd]->stats.sendTime = infcCoreTime() - cmdStartAt;
+		}
+		// Wake the read thread if this command falls due before any it
+		// is waiting to time out
+		if (asyncFunc && (pNCS->AsyncDueAt == 0
+		|| cmdStartAt + InfcRespTimeOut < pNCS->AsyncDueAt)) {
+			pNCS->ReadCommEvent.SetEvent();
+		}
+		// Time the stops from their event to the wire
+		if (stopLane && pNCS->StopBurstReqAt != 0) {
+			pNCS->StopLaneHist.record(infcCoreTime() - pNCS->StopBurstReqAt);
+			pNCS->StopBurstReqAt = 0;
+		}
+
+		// Make sure the read thread starts running
+		pNCS->ReadThread.Start();
+
+		//_RPT1(_CRT_WARN, "ReadThreadState: %d\n", pNCS->readThreadState );
+		// Unlock previous lock now that the commands are out
+		EXIT_LOCK("infcRunCommand (restart read)");
+		*pnQueued = nSlots;
+		if (ppRespInfo)
+			*ppRespInfo = pRespInfos[0];
+		if (pRespToken)
+			*pRespToken = TRK_TOKEN(pRespInfos[0]->nSentAtAddr);
+		if (pRespTicket)
+			*pRespTicket = firstTicket;
+	}
+	else {
+		_RPT2(_CRT_WARN, "infcRunCommand: failed send 0x%0x @ %f\n", theErr, infcCoreTime());
+		// Give the trackers up, the read thread retires them and releases
+		// their pacing slots.
+		for (iCmd = 0; iCmd < nSlots; iCmd++) {
+			pRespInfo = pRespInfos[iCmd];
+			// Our caller reports this failure, not the completion function
+			if (pRespInfo->asyncFunc) {
+				pRespInfo->asyncFunc = NULL;
+				pNCS->nAsyncPending.Decr();
+			}
+			token = TRK_TOKEN(pRespInfo->nSentAtAddr);
+			pRespInfo->state.Swap(token | TRK_PENDING, token | TRK_CANCELED);
+		}
+		// Command failed, make sure there is someone to clean up
+		// any remaining items.
+		pNCS->ReadThread.Start();
+		pNCS->ReadCommEvent.SetEvent();
+		// Release lock, started upon command attempt
+		EXIT_LOCK("infcRunCommand (send fail)");
+		// Log transfer timeout to a special error
+		if (theErr == MN_ERR_TIMEOUT) {
+			theErr = MN_ERR_SEND_FAILED;
+		}
+		for (iCmd = 0; iCmd < nSlots; iCmd++) {
+			theNet.logSend(&theCommands[iCmd], theErr, infcCoreTime());
+		}
+		// Send off the callback if it exists
+		{
+			infcErrInfo errInfo;
+			// Fill in the relevant information
+			errInfo.errCode = theErr;
+			errInfo.cNum = cNum;
+			infcCopyPktToPkt18(&errInfo.response, theCommands);
+			errInfo.node = 0;
+			// Notify the user
+			infcFireErrCallback(&errInfo);
+		}
+	}
+	// Return the last error
+	return theErr;
+}
+//																			 *
+//******************************************************************************
+
+
+//******************************************************************************
+//	NAME																	   *
+//		infcRunCommand
+//
+//	DESCRIPTION:
+//		This function will send the buffer specified in <theCommand> and
+//		wait for the response and store it in <theResponse>. If no response
+//		is desired, a NULL pointer is passed to <theResponse> parameter. In
+//		this case, the function will always returns MN_OK.
+//
+//		Commands are run by:
+//			1) acquiring the command semaphore to limit the number of
+//			   simultaneous commands in the network
+//			2) the command lock semaphore is then acquired
+//			3) the command is sent
+//			4) the response database is created and updated with the desired
+//			   handling for this command
+//		    5) The command lock is released
+//			6) If no response is desired, this function returns MN_OK
+//			   else
+//			   We go to sleep waiting for the read thread to wake us up via
+//			   an APC being queued to this thread.
+//			7) If there is a valid response, this function returns MN_OK, else
+//			   it returns the appropriate code.
+//
+//		Steps 1 through 5 are shared with infcRunCommandAsync via
+//		infcQueueCommand.
+//
+//	RETURNS:
+//		Standard return codes
+//
+//	SYNOPSIS:
+MN_EXPORT cnErrCode MN_DECL infcRunCommand(
+	netaddr cNum,
+	packetbuf *theCommand,				// pointer to filled in command
+	packetbuf *theResponse)				// pointer to response area
+{
+	double funcStartAt = infcCoreTime();					// Time we started this function
+	cnErrCode theErr = MN_OK;
+	respTrackInfo *pRespInfo;								// Thread / response info data
+	LONG respToken, respTicket;								// Identify our use of it
+	size_t nQueued;
+
+	register netStateInfo *pNCS;							// Quick access to net info
+
+															// Is the device in our range?
+	if (cNum >= NET_CONTROLLER_MAX)
+		return MN_ERR_DEV_ADDR;
 
-		// Initialize database pointers if first time through here
-		if (pRespArea->head == NULL) {
-			pRespArea->head = pRespInfo;	// Head = first one
-			pRespArea->tail = NULL;		// Reset the tail
-		}
-		// Link previous item to this one if there was one
-		if (pRespArea->tail != NULL) {
-			pRespArea->tail->next = pRespInfo;
-		}
-		// Tail always points to latest sent item
-		pRespArea->tail = pRespInfo;		// DB tail ptr to the end
-											// Save our serial number
-		pRespInfo->sendSerNum = theNet.logSend(theCommand, theErr, pRespInfo->cmdStartAt);
-		// Make sure response wait event is unsignalled??
-		pRespInfo->evtRespWait.ResetEvent();
+	// We must have defined buffers
+	if (!theResponse || !theCommand)
+		return MN_ERR_BADARG;
 
-		// Make sure the read thread starts running
-		pNCS->ReadThread.Start();
+	// Initialize fast pointer to our data
+	mnNetInvRecords &theNet = SysInventory[cNum];
+	pNCS = theNet.pNCS;
+	// RAII Lock on pNCS until return
+	netStateInfo::cmdsIdleEvt idleChecker(*pNCS);
 
-		//_RPT1(_CRT_WARN, "ReadThreadState: %d\n", pNCS->readThreadState );
-		// Unlock previous lock now that the response database is updated
-		EXIT_LOCK("infcRunCommand (restart read)");
-		// This thread is waiting for the response, wait for event or timeout
-		#if TRACE_LOW_PRINT&&TRACE_SEND_RESP
-		_RPT0(_CRT_WARN, "W");
-		#endif
-		//_RPT1(_CRT_WARN, "%.1f start response wait\n", infcCoreTime());
-		BOOL waitOK = pRespInfo->evtRespWait.WaitFor(InfcRespTimeOut);
-		#if TRACE_LOW_PRINT&&TRACE_SEND_RESP
-		_RPT1(_CRT_WARN, ".<%d>", sleepOK);
-		#endif
-		if (!waitOK) {
+	// Send it and publish our tracker to the read thread
+	theErr = infcQueueCommand(cNum, theCommand, theResponse, 1, &nQueued,
+		funcStartAt, NULL, NULL, &pRespInfo, &respToken, &respTicket, FALSE);
+	if (theErr != MN_OK)
+		return theErr;
+
+	// This thread is waiting for the response, wait for event or timeout
+	#if TRACE_LOW_PRINT&&TRACE_SEND_RESP
+	_RPT0(_CRT_WARN, "W");
+	#endif
+	//_RPT1(_CRT_WARN, "%.1f start response wait\n", infcCoreTime());
+	BOOL waitOK = pRespInfo->evtRespWait.WaitFor(respTicket, InfcRespTimeOut);
+	#if TRACE_LOW_PRINT&&TRACE_SEND_RESP
+	_RPT1(_CRT_WARN, ".<%d>", waitOK);
+	#endif
+	if (!waitOK) {
+		// Mark it expired, the read thread logs and retires it. If we lose
+		// this race the response is being delivered, wait for it.
+		if (pRespInfo->state.Swap(respToken | TRK_PENDING, respToken | TRK_EXPIRED)) {
 			// -------------------------------------------------- //
 			// We are restarted via time-out                      //
 			// -------------------------------------------------- //
 			theErr = MN_ERR_RESP_TIMEOUT;
-			//_RPT2(_CRT_WARN, "%.1f cmd timeout! hndl=0x%x\n",
-			//				 infcCoreTime(),pRespInfo->hRespWait);
-			DUMP_PKT(cNum, "**Timeout cmd ", &pRespInfo->stats.cmd);
-			ENTER_LOCK("infcRunCommand (timeout)");
-			// Add failure to the rx log file
-			if (SysInventory[cNum].TraceActive) {
-				packetbuf nullPkt;
-
-				// Create null packet buffer
-				nullPkt.Byte.BufferSize = 0;
-				nullPkt.Byte.Buffer[0] = nullPkt.Byte.Buffer[1] = 0;
-				// Assign a receive trace record
-				theNet.logReceive(&nullPkt, MN_ERR_RESP_TIMEOUT, pRespInfo, infcCoreTime());
-			}
+			DUMP_PKT(cNum, "**Timeout cmd ", theCommand);
 			if (SysInventory[cNum].OpenState == OPENED_ONLINE) {
 				// Send off the error callback, fill in the relevant
 				// error information
@@ -3365,73 +4111,16 @@ MN_EXPORT cnErrCode MN_DECL infcRunCommand(
 				// Notify the user
 				infcFireErrCallback(&errInfo);
 			}
-			// Remove this as an expected item
-			pNCS->removeThisDBitem(pRespInfo, pRespArea);
-			EXIT_LOCK("infcRunCommand (resp timeout)");
-		}
-		//else {
-		//	//_RPT1(_CRT_WARN, "infcRunCommand: response wait OK\n", sleepOK);
-		//}
-	}
-	else {
-		_RPT2(_CRT_WARN, "infcRunCommand: failed send 0x%0x @ %f\n", theErr, infcCoreTime());
-		// Return the tracking DB item
-		pNCS->pTrkTail++;
-		*pNCS->pTrkTail = pRespInfo;
-		// Release the command semaphore allowing one more (if even possible)
-		// - note we have the command lock when we get here, don't forget to
-		// release it.
-		#ifdef _DEBUG
-		dataOK = pNCS->CmdPaceSemaphore.Unlock(1, &pNCS->SemaCount);
-		#else
-		dataOK = pNCS->CmdPaceSemaphore.Unlock();
-		#endif
-		if (dataOK) {
-			// Make sure read thread keeps running
-			if (pNCS->nRespOutstanding > 0) {
-				if (--pNCS->nRespOutstanding > 0) {
-					pNCS->ReadThread.Start();
-				}
-			}
+			// Get the read thread to retire it
+			pNCS->ReadCommEvent.SetEvent();
 		}
 		else {
-			infcErrInfo semaErr;
-			int semaErrCode = GetLastError();
-			_RPT1(_CRT_ERROR, "readThread: semaphore release err 0x%X\n",
-				semaErrCode);
-			semaErr.errCode = MN_ERR_SEND_UNLOCK;
-			semaErr.cNum = cNum;
-			semaErr.node = semaErrCode;
-			EXIT_LOCK("infcRunCommand: (sema rel err)");
-			infcFireErrCallback(&semaErr);
-			theErr = (cnErrCode)GetLastError();
-			_RPT1(_CRT_ERROR, "infcRunCommand: semaphore release err 0x%X\n",
-				theErr);
-			theNet.logSend(theCommand, MN_ERR_SEND_UNLOCK, infcCoreTime());
-			return(theErr);
-		}
-		// Release lock, started upon command attempt
-		EXIT_LOCK("infcRunCommand (send fail)");
-		// Command failed, make sure there is someone to clean up
-		// any remaining items.
-		pNCS->ReadThread.Start();
-		// Log transfer timeout to a special error
-		if (theErr == MN_ERR_TIMEOUT) {
-			theErr = MN_ERR_SEND_FAILED;
-		}
-		theNet.logSend(theCommand, theErr, infcCoreTime());
-		// Send off the callback if it exists
-		{
-			infcErrInfo errInfo;
-			// Fill in the relevant information
-			errInfo.errCode = theErr;
-			errInfo.cNum = cNum;
-			infcCopyPktToPkt18(&errInfo.response, theCommand);
-			errInfo.node = 0;
-			// Notify the user
-			infcFireErrCallback(&errInfo);
+			pRespInfo->evtRespWait.WaitFor(respTicket, InfcRespTimeOut);
 		}
 	}
+	//else {
+	//	//_RPT1(_CRT_WARN, "infcRunCommand: response wait OK\n", sleepOK);
+	//}
 	// Return the last error
 	return theErr;
 }
@@ -3439,6 +4128,220 @@ MN_EXPORT cnErrCode MN_DECL infcRunCommand(
 //******************************************************************************
 
 
+//******************************************************************************
+//	NAME																	   *
+//		infcRunCommandAsync
+//
+//	DESCRIPTION:
+//		Pipelined form of infcRunCommand. The command is sent under the same
+//		pacing and by-node ordering rules, but this function returns as
+//		soon as the command has been transmitted. The outcome is delivered
+//		later to <completeFunc> from the port's read thread:
+//
+//			MN_OK					- the response is in <theResponse>
+//			MN_ERR_RESP_TIMEOUT		- no response within the time-out
+//			MN_ERR_CANCELED			- the port was flushed
+//			MN_ERR_CLOSED			- the port was closed
+//
+//		<theCommand> may be reused once this returns, <theResponse> must
+//		remain valid until <completeFunc> runs. When the ring is full this
+//		function blocks until a slot frees up, which lets a single thread
+//		keep the ring full across all the nodes on the port.
+//
+//		The time-out runs from the call, and the read thread wakes for it,
+//		so MN_ERR_RESP_TIMEOUT is normally delivered within a millisecond
+//		or so of it. It can be late by up to 100 ms if this command was
+//		sent while the read thread was scanning the time-outs.
+//
+//	RETURNS:
+//		MN_OK if the command was sent and <completeFunc> will be called,
+//		else the error code; <completeFunc> is not called in that case.
+//
+//	SYNOPSIS:
+MN_EXPORT cnErrCode MN_DECL infcRunCommandAsync(
+	netaddr cNum,
+	packetbuf *theCommand,				// pointer to filled in command
+	packetbuf *theResponse,				// pointer to response area
+	infcCmdAsyncCallback completeFunc,	// completion function
+	void *context)						// passed to <completeFunc>
+{
+	double funcStartAt = infcCoreTime();					// Time we started this function
+	size_t nQueued;
+
+	// Is the device in our range?
+	if (cNum >= NET_CONTROLLER_MAX)
+		return MN_ERR_DEV_ADDR;
+
+	// We must have defined buffers and someone to tell
+	if (!theResponse || !theCommand || !completeFunc)
+		return MN_ERR_BADARG;
+
+	// RAII Lock on pNCS while submitting
+	netStateInfo::cmdsIdleEvt idleChecker(*SysInventory[cNum].pNCS);
+
+	return infcQueueCommand(cNum, theCommand, theResponse, 1, &nQueued,
+		funcStartAt, completeFunc, context, NULL, NULL, NULL, FALSE);
+}
+//																			 *
+//******************************************************************************
+
+
+//******************************************************************************
+//	NAME																	   *
+//		infcBatchCmdDone
+//
+//	DESCRIPTION:
+//		Completion function for the commands of an infcRunCommandBatch call.
+//		It records the first error and releases the batch when its last
+//		command completes.
+//
+//	SYNOPSIS:
+// Completion tracking for one infcRunCommandBatch call
+typedef struct _batchState {
+	CCatomicUpdate pending;					// Commands not completed + 1
+	CCEvent allDone;						// Set when <pending> hits 0
+	cnErrCode firstErr;						// First error reported
+	packetbuf *pResps;						// The caller's response areas
+	double *pDoneAt;						// Completion times or NULL
+} batchState;
+
+static void nodeCallback infcBatchCmdDone(
+	netaddr cNum,
+	cnErrCode theErr,
+	packetbuf *theResponse,
+	void *context)
+{
+	batchState *pBatch = static_cast<batchState *>(context);
+
+	if (theErr != MN_OK && pBatch->firstErr == MN_OK)
+		pBatch->firstErr = theErr;
+	if (pBatch->pDoneAt)
+		pBatch->pDoneAt[theResponse - pBatch->pResps] = infcCoreTime();
+	if (pBatch->pending.Decr() == 0)
+		pBatch->allDone.SetEvent();
+}
+//																			 *
+//******************************************************************************
+
+
+//******************************************************************************
+//	NAME																	   *
+//		infcRunBatch
+//
+//	DESCRIPTION:
+//		Run the <nCmds> commands in <theCommands> and wait for them all,
+//		for infcRunCommandBatch and the stop lane. With <stopLane> they
+//		use the stop lane's slots, see infcQueueCommand.
+//
+//	RETURNS:
+//		MN_OK if all commands got a response, else the first error found.
+//
+//	SYNOPSIS:
+static cnErrCode infcRunBatch(
+	netaddr cNum,
+	packetbuf *theCommands,				// pointer to filled in commands
+	packetbuf *theResponses,			// pointer to response areas
+	size_t nCmds,						// number of commands
+	double *theDoneTimes,				// completion times or NULL
+	nodebool stopLane)					// use the stop lane's slots
+{
+	double funcStartAt = infcCoreTime();					// Time we started this function
+	cnErrCode theErr = MN_OK;
+	batchState batch;
+	size_t iCmd, nQueued;
+
+	// Is the device in our range?
+	if (cNum >= NET_CONTROLLER_MAX)
+		return MN_ERR_DEV_ADDR;
+
+	// We must have defined buffers
+	if (!theResponses || !theCommands)
+		return MN_ERR_BADARG;
+
+	// RAII Lock on pNCS until return
+	netStateInfo::cmdsIdleEvt idleChecker(*SysInventory[cNum].pNCS);
+
+	if (theDoneTimes) {
+		for (iCmd = 0; iCmd < nCmds; iCmd++)
+			theDoneTimes[iCmd] = 0;
+	}
+
+	// Hold one count until all commands are submitted
+	batch.firstErr = MN_OK;
+	batch.pResps = theResponses;
+	batch.pDoneAt = theDoneTimes;
+	batch.allDone.ResetEvent();
+	batch.pending.Incr();
+	for (iCmd = 0; iCmd < nCmds; iCmd += nQueued) {
+		// Account for the most this pass could send
+		size_t iCnt, nTry = nCmds - iCmd;
+		if (nTry > SEND_PKTS_PER_WRITE)
+			nTry = SEND_PKTS_PER_WRITE;
+		for (iCnt = 0; iCnt < nTry; iCnt++)
+			batch.pending.Incr();
+		theErr = infcQueueCommand(cNum, &theCommands[iCmd], &theResponses[iCmd],
+			nTry, &nQueued, funcStartAt, infcBatchCmdDone, &batch,
+			NULL, NULL, NULL, stopLane);
+		// Give back the counts of the commands not sent
+		for (iCnt = nQueued; iCnt < nTry; iCnt++)
+			batch.pending.Decr();
+		if (theErr != MN_OK) {
+			// Fail the remaining commands
+			for (iCnt = iCmd + nQueued; iCnt < nCmds; iCnt++) {
+				theResponses[iCnt].Byte.BufferSize = 0;
+				theResponses[iCnt].Fld.PktLen = 0;
+			}
+			break;
+		}
+	}
+	// Release our hold and wait for the read thread to finish the rest
+	if (batch.pending.Decr() != 0)
+		batch.allDone.WaitFor(INFINITE);
+
+	if (theErr == MN_OK)
+		theErr = batch.firstErr;
+	return theErr;
+}
+//																			 *
+//******************************************************************************
+
+
+//******************************************************************************
+//	NAME																	   *
+//		infcRunCommandBatch
+//
+//	DESCRIPTION:
+//		Run the <nCmds> commands in <theCommands> and store their responses
+//		in the matching entries of <theResponses>. The commands are framed
+//		back to back and sent with as few serial writes as the ring pacing
+//		allows, then the responses are collected through the by-node
+//		response database like infcRunCommandAsync.
+//
+//		This function returns after all the commands have completed. The
+//		response of a failed command is left empty.
+//
+//		If <theDoneTimes> is not NULL, each entry is set to the infcCoreTime
+//		its command completed at, or zero if it was never sent. Responses
+//		delivered by the same read are given the same time.
+//
+//	RETURNS:
+//		MN_OK if all commands got a response, else the first error found.
+//
+//	SYNOPSIS:
+MN_EXPORT cnErrCode MN_DECL infcRunCommandBatch(
+	netaddr cNum,
+	packetbuf *theCommands,				// pointer to filled in commands
+	packetbuf *theResponses,			// pointer to response areas
+	size_t nCmds,						// number of commands
+	double *theDoneTimes)				// completion times or NULL
+{
+	return infcRunBatch(cNum, theCommands, theResponses, nCmds,
+						theDoneTimes, FALSE);
+}
+//																			 *
+//******************************************************************************
+
+
 //****************************************************************************
 //	NAME
 //		infcOnline
@@ -3531,6 +4434,9 @@ MN_EXPORT cnErrCode MN_DECL infcStartController(
 		if (!pNCS) {
 			return(MN_ERR_MEM_LOW);
 		}
+		// Restore the command window mode
+		if (SysInventory[cNum].CmdWindowAdaptive)
+			pNCS->paceAdapt(TRUE);
 	}
 
 	/****** Open and Setup Serial Port  *******/
@@ -3747,7 +4653,6 @@ nodeulong infcFlushProc(netaddr cNum)
 {
 	nodeulong lostCount = 0;
 	nodeushort i;
-	respTrackInfo *nextWaiter, *head;
 	packetbuf theCmd;
 	netStateInfo *pNCS = SysInventory[cNum].pNCS;
 
@@ -3778,25 +4683,14 @@ nodeulong infcFlushProc(netaddr cNum)
 	// flush all data out of the serial port
 	// Clean up threads waiting
 	for (i = 0; i<MN_API_MAX_NODES; i++) {
-		// Return all storage for threads waiting past head
-		head = pNCS->respNodeState[i].head;
-		while (head != NULL) {
-			nextWaiter = head->next;
-			pNCS->removeThisDBitem(head, &pNCS->respNodeState[i]);
-			head = nextWaiter;
-		}
+		// Return all trackers for threads waiting
+		while (pNCS->respNodeState[i].head())
+			pNCS->removeHeadDBitem(&pNCS->respNodeState[i]);
 	}
 
 	// Clean up the control command buffers
-	head = pNCS->controlNodeState.head;
-	while (head != NULL) {
-		nextWaiter = head->next;
-		pNCS->removeThisDBitem(head, &pNCS->controlNodeState);
-		// Record the next head
-		head = nextWaiter;
-	}
-	// There are no responses left now
-	pNCS->nRespOutstanding = 0;	// This should have already been 0
+	while (pNCS->controlNodeState.head())
+		pNCS->removeHeadDBitem(&pNCS->controlNodeState);
 	infcSleep(0);					// Yield our quantum
 									// Get rid of any other detritus
 	if (pNCS->pSerialPort) {
@@ -3920,6 +4814,46 @@ MN_EXPORT cnErrCode MN_DECL infcSendCommand(
 }
 
 
+//******************************************************************************
+//	NAME																	   *
+//		infcSendCommands
+//
+//	DESCRIPTION:
+//		This function will send the <nCmds> commands at <theCommands> to
+//		the current network controller in as few serial writes as possible.
+//
+//	RETURNS:
+//		#cnErrCode of send success
+//
+//	SYNOPSIS:
+cnErrCode MN_DECL infcSendCommands(
+	netaddr cNum,
+	packetbuf *theCommands,			// pointer to command buffer areas
+	size_t nCmds)					// number of commands
+{
+	netStateInfo *pNCS = SysInventory[cNum].pNCS;
+	// Interface gone?
+	if (!pNCS->pSerialPort)
+		return(MN_ERR_CLOSED);
+
+	#if TRACE_SEND_RESP
+	for (size_t iCmd = 0; iCmd < nCmds; iCmd++) {
+		theCommands[iCmd].Fld.StartOfPacket = 1;
+		DUMP_PKT(cNum, "SendCommands  ", &theCommands[iCmd]);
+	}
+	#endif
+
+	// Send atomically via the serial port
+	if (pNCS->pSerialPort->SendPkts(theCommands, nCmds)) {
+		pNCS->nPktsSent += (nodeulong)nCmds;
+		return(MN_OK);
+	}
+
+	// Something went wrong!
+	return(MN_ERR_SEND_FAILED);
+}
+
+
 // Same as infcSendCommand, but log in send log, we are not expecting response.
 cnErrCode MN_DECL infcSendCommandLog(
 	nodeushort cNum,					// Port Index
@@ -4204,7 +5138,7 @@ MN_EXPORT cnErrCode MN_DECL infcSetCmdQueueLimit(
 {
 	cnErrCode theErr = MN_OK;
 	// Bounds check arguments
-	if (nCmds == 0 || nCmds > 14 || cNum > NET_CONTROLLER_MAX)
+	if (nCmds == 0 || nCmds > N_CMDS_IN_RING_MAX || cNum > NET_CONTROLLER_MAX)
 		return(MN_ERR_BADARG);
 	// See if the network exists
 	netStateInfo *pNCS = SysInventory[cNum].pNCS;
@@ -4235,6 +5169,175 @@ MN_EXPORT cnErrCode MN_DECL infcSetCmdQueueLimit(
 //******************************************************************************
 
 
+//******************************************************************************
+//	NAME																	   *
+//		infcSetCmdWindowAdaptive
+//
+//	DESCRIPTION:
+//		Let the number of simultaneous commands in the ring adapt to the
+//		ring's latency. The window never exceeds the command queue limit set
+//		by infcSetCmdQueueLimit. Turning adaptation off restores the full
+//		limit. The setting survives controller restarts.
+//
+//	RETURNS:
+//		#cnErrCode
+//
+//	SYNOPSIS:
+MN_EXPORT cnErrCode MN_DECL infcSetCmdWindowAdaptive(
+	netaddr cNum,
+	nodebool adaptive)
+{
+	// Bounds check arguments
+	if (cNum >= NET_CONTROLLER_MAX)
+		return(MN_ERR_BADARG);
+	SysInventory[cNum].CmdWindowAdaptive = adaptive;
+	// Apply to the running network
+	netStateInfo *pNCS = SysInventory[cNum].pNCS;
+	if (pNCS)
+		pNCS->paceAdapt(adaptive);
+	return(MN_OK);
+}
+//																			   *
+//******************************************************************************
+
+
+
+//******************************************************************************
+//	NAME																	   *
+//		infcGetCmdWindow
+//
+//	DESCRIPTION:
+//		Get the number of simultaneous commands allowed in the ring now, the
+//		most allowed and whether the window adapts. Any pointer may be NULL.
+//
+//	RETURNS:
+//		#cnErrCode
+//
+//	SYNOPSIS:
+MN_EXPORT cnErrCode MN_DECL infcGetCmdWindow(
+	netaddr cNum,
+	nodeulong *pWindow,
+	nodeulong *pCeiling,
+	nodebool *pAdaptive)
+{
+	nodeulong window, ceiling;
+
+	// Bounds check arguments
+	if (cNum >= NET_CONTROLLER_MAX)
+		return(MN_ERR_BADARG);
+	netStateInfo *pNCS = SysInventory[cNum].pNCS;
+	if (pNCS) {
+		pNCS->PaceLock.Lock();
+		window = pNCS->PaceWindow;
+		ceiling = pNCS->RingCmdsMax;
+		pNCS->PaceLock.Unlock();
+	}
+	else {
+		// Not running, report what the next start would use
+		window = ceiling = SysInventory[cNum].NumCmdsInRing;
+	}
+	if (pWindow)
+		*pWindow = window;
+	if (pCeiling)
+		*pCeiling = ceiling;
+	if (pAdaptive)
+		*pAdaptive = SysInventory[cNum].CmdWindowAdaptive;
+	return(MN_OK);
+}
+//																			   *
+//******************************************************************************
+
+
+
+//******************************************************************************
+//	NAME																	   *
+//		infcGetLatencyStats
+//
+//	DESCRIPTION:
+//		Summarize the command round trips of node <theNode>, or of the whole
+//		port if it is MN_API_MAX_NODES, for command group <latClass> or all
+//		of them with MN_LAT_ALL. With <reset> the summarized samples are
+//		cleared so the next call covers a fresh window. The port's
+//		histograms start empty each time it is opened.
+//
+//	RETURNS:
+//		#cnErrCode
+//
+//	SYNOPSIS:
+MN_EXPORT cnErrCode MN_DECL infcGetLatencyStats(
+	netaddr cNum,
+	nodeaddr theNode,
+	mnLatencyClass latClass,
+	nodebool reset,
+	mnLatencyStats *pStats)
+{
+	Uint32 counts[LAT_HIST_BUCKETS];
+	Uint32 maxUsec = 0, timeouts = 0;
+	unsigned row, rowEnd, iClass, classEnd;
+
+	// Bounds check arguments
+	if (cNum >= NET_CONTROLLER_MAX || theNode > MN_API_MAX_NODES
+	|| (unsigned)latClass > MN_LAT_ALL || !pStats)
+		return(MN_ERR_BADARG);
+	memset(counts, 0, sizeof(counts));
+	netStateInfo *pNCS = SysInventory[cNum].pNCS;
+	if (pNCS) {
+		// Whole port includes the control packets
+		row = (theNode == MN_API_MAX_NODES) ? 0 : theNode;
+		rowEnd = (theNode == MN_API_MAX_NODES) ? MN_API_MAX_NODES : theNode;
+		iClass = (latClass == MN_LAT_ALL) ? 0 : latClass;
+		classEnd = (latClass == MN_LAT_ALL) ? MN_LAT_ALL - 1 : latClass;
+		for ( ; row <= rowEnd; row++) {
+			for (unsigned i = iClass; i <= classEnd; i++) {
+				pNCS->LatHist[row][i].collect(counts, &maxUsec, &timeouts, reset);
+			}
+		}
+	}
+	latencyHist::summarize(counts, maxUsec, timeouts, pStats);
+	return(MN_OK);
+}
+//																			   *
+//******************************************************************************
+
+
+
+//******************************************************************************
+//	NAME																	   *
+//		infcGetStopLaneStats
+//
+//	DESCRIPTION:
+//		Summarize the group shutdown stop latencies of port <cNum>. Each
+//		sample runs from the request, a CTS drop, a status event or an
+//		infcShutdownInitiate call, to the stops being written to the port.
+//		With <reset> the summarized samples are cleared.
+//
+//	RETURNS:
+//		#cnErrCode
+//
+//	SYNOPSIS:
+MN_EXPORT cnErrCode MN_DECL infcGetStopLaneStats(
+	netaddr cNum,
+	nodebool reset,
+	mnLatencyStats *pStats)
+{
+	Uint32 counts[LAT_HIST_BUCKETS];
+	Uint32 maxUsec = 0, timeouts = 0;
+
+	// Bounds check arguments
+	if (cNum >= NET_CONTROLLER_MAX || !pStats)
+		return(MN_ERR_BADARG);
+	memset(counts, 0, sizeof(counts));
+	netStateInfo *pNCS = SysInventory[cNum].pNCS;
+	if (pNCS)
+		pNCS->StopLaneHist.collect(counts, &maxUsec, &timeouts, reset);
+	latencyHist::summarize(counts, maxUsec, timeouts, pStats);
+	return(MN_OK);
+}
+//																			   *
+//******************************************************************************
+
+
+
 //******************************************************************************
 //	NAME																	   *
 //		infcSetTraceEnable
@@ -4450,8 +5553,12 @@ inline void processNodeInitiatedPkt(netaddr cNum, nodeaddr respAddr,
 {
 	infcErrInfo errInfo;		// Error reporting buffer
 	mnAttnReqReg attn;
-	dacqPacket *dataAcqPacket;
 	mnDataAcqPt dataAcqPt[2];
+	// Fields of the data acquisition packet, two points per packet
+	float dacqTrace[2];
+	Uint8 dacqState[2], dacqExcp[2], dacqIO[2], dacqSeq;
+	const dacqDecoded dacqFields = { dacqTrace, dacqState, dacqExcp,
+									 dacqIO, &dacqSeq };
 	nodebool lastOverflow;
 
 	nodeaddr changedNode;
@@ -4521,20 +5628,20 @@ inline void processNodeInitiatedPkt(netaddr cNum, nodeaddr respAddr,
 		case MN_CTL_EXT_DATA_ACQ:	// Data return originated from the node and is a dataAcq point
 			#if 1
 									// Record DataAcq in Queue - each data point from the node contains 2 point
-			dataAcqPacket = (dacqPacket*)&(readBuf.Byte.Buffer[RESP_LOC + 1]);
+			dacqDecodePackets((const Uint8 *)&readBuf.Byte.Buffer[RESP_LOC + 1],
+							  DACQ_PACKET_OCTETS, 1, dacqFields);
 
 			// Replicate the common information
-			dataAcqPt[1].Sequence = dataAcqPt[0].Sequence
-				= dataAcqPacket->Fld.Sequence;
+			dataAcqPt[1].Sequence = dataAcqPt[0].Sequence = dacqSeq;
 
 			dataAcqPt[0].Bool0 = dataAcqPt[1].Bool0 = FALSE;
 			dataAcqPt[0].Bool1 = dataAcqPt[1].Bool1 = FALSE;
 
-			dataAcqPt[0].Exception = dataAcqPacket->Fld.Exception0;
-			dataAcqPt[1].Exception = dataAcqPacket->Fld.Exception1;
+			dataAcqPt[0].Exception = dacqExcp[0];
+			dataAcqPt[1].Exception = dacqExcp[1];
 
-			dataAcqPt[0].MoveState = dataAcqPacket->Fld.MoveState0;
-			dataAcqPt[1].MoveState = dataAcqPacket->Fld.MoveState1;
+			dataAcqPt[0].MoveState = dacqState[0];
+			dataAcqPt[1].MoveState = dacqState[1];
 			// Check for alignment issues
 			//dataAcqPt[0].Spare[1] = 0x0111;
 			//dataAcqPt[1].Spare[1] = 0x1111;
@@ -4543,9 +5650,15 @@ inline void processNodeInitiatedPkt(netaddr cNum, nodeaddr respAddr,
 
 
 			// Calculate fractional (+/-1) first point
-			dataAcqPt[0].TraceValue[0]
-				= (float)dataAcqPacket->Fld.T0p0
-				/ (1 << (P0_BITS - 1));
+			dataAcqPt[0].TraceValue[0] = dacqTrace[0];
+
+			// Packets lost on the link still took their time at the node,
+			// skip over them so the time stamps keep to the node's clock.
+			// A loss of four packets wraps the sequence and goes unseen.
+			if (!pNCS->DataAcqInit[respAddr]) {
+				pNCS->DataAcq[respAddr].SampleCount += 2
+					* ((dacqSeq - pNCS->DataAcq[respAddr].SeqCheck - 1) & 3);
+			}
 
 			dataAcqPt[0].TimeStamp
 				= (double)(pNCS->DataAcq[respAddr].SampleCount)
@@ -4557,19 +5670,19 @@ inline void processNodeInitiatedPkt(netaddr cNum, nodeaddr respAddr,
 			// We have processed two samples
 			pNCS->DataAcq[respAddr].SampleCount += 2;
 
+			// Pair the node's clock with ours for the acquisition merger
+			pNCS->DataAcq[respAddr].ClockSeq.WriteBegin();
+			pNCS->DataAcq[respAddr].ClockNodeMs = dataAcqPt[1].TimeStamp;
+			pNCS->DataAcq[respAddr].ClockHostMs = infcCoreTime();
+			pNCS->DataAcq[respAddr].ClockSeq.WriteEnd();
+
 			// Calculate fractional (+/-1) second point
-			dataAcqPt[1].TraceValue[0]
-				= (float)dataAcqPacket->Fld.T0p1
-				/ (1 << (P1_BITS - 1));
+			dataAcqPt[1].TraceValue[0] = dacqTrace[1];
 
 			// If the I/O state was sent in this packet, copy the data to trace 1
 			if (readBuf.Byte.BufferSize == 9) {
-				dataAcqPt[0].TraceValue[1] = (float)((dataAcqPacket->Fld.Trigger0 << (INPUT_BITS + 1))
-					| (dataAcqPacket->Fld.Inputs0 << 1)
-					| dataAcqPacket->Fld.Output0);
-				dataAcqPt[1].TraceValue[1] = (float)((dataAcqPacket->Fld.Trigger1 << (INPUT_BITS + 1))
-					| (dataAcqPacket->Fld.Inputs1 << 1)
-					| dataAcqPacket->Fld.Output1);
+				dataAcqPt[0].TraceValue[1] = (float)dacqIO[0];
+				dataAcqPt[1].TraceValue[1] = (float)dacqIO[1];
 			}
 
 
@@ -4611,19 +5724,28 @@ inline void processNodeInitiatedPkt(netaddr cNum, nodeaddr respAddr,
 			pNCS->DataAcq[respAddr].SeqCheck = dataAcqPt[0].Sequence;
 			//_RPT1(_CRT_WARN, "%d", respAddr); // Show activity
 
-			// Write the points to the queue, locking out reader
-			pNCS->DataAcq[respAddr].AcqLock.Lock();
-
-			// On overflow deprecate the two oldest points to make room
-			// in buffer for 2 new points marking gap at front
-			lastOverflow = pNCS->DataAcq[respAddr].Overflow;
-			pNCS->DataAcq[respAddr].Overflow
-				= pNCS->DataAcq[respAddr].Points.size()
-				>= (DATAACQ_OVERFLOW_LVL - 2);
-			if (pNCS->DataAcq[respAddr].Overflow) {
-				pNCS->DataAcq[respAddr].Points.pop();
-				pNCS->DataAcq[respAddr].Points.pop();
-				pNCS->DataAcq[respAddr].Points.front().Valid = VB_FALSE;
+			// Store the points in the ring without waiting on the reader.
+			// When it is full the new points are dropped and counted, the
+			// first point stored after the gap is marked invalid.
+			{
+				dataAcqInfo &acq = pNCS->DataAcq[respAddr];
+				Uint32 head = (Uint32)acq.Head.Value();
+				lastOverflow = acq.Overflow;
+				if (head - (Uint32)acq.Tail.Fetch() > DATAACQ_RING_LEN - 2) {
+					acq.Dropped.Add(2);
+					acq.Overflow = TRUE;
+					acq.GapPending = TRUE;
+				}
+				else {
+					if (acq.GapPending) {
+						dataAcqPt[0].Valid = VB_FALSE;
+						acq.GapPending = FALSE;
+					}
+					acq.Points[head & (DATAACQ_RING_LEN - 1)] = dataAcqPt[0];
+					acq.Points[(head + 1) & (DATAACQ_RING_LEN - 1)] = dataAcqPt[1];
+					// Publish both points to the reader
+					acq.Head.Add(2);
+				}
 			}
 
 			// If an overflow occurred, signal back to app
@@ -4637,13 +5759,6 @@ inline void processNodeInitiatedPkt(netaddr cNum, nodeaddr respAddr,
 				_RPT2(_CRT_WARN, "%.1f dacq overrun @%d\n",
 					infcCoreTime(), respAddr); // Show activity
 			}
-
-			// Add the two points on queue
-			pNCS->DataAcq[respAddr].Points.push(dataAcqPt[0]);
-			pNCS->DataAcq[respAddr].Points.push(dataAcqPt[1]);
-
-			// Allow reader now
-			pNCS->DataAcq[respAddr].AcqLock.Unlock();
 			#endif
 			break;
 		case MN_CTL_EXT_PARAM_CHANGED:	//A parameter on the node has changed
@@ -4747,8 +5862,7 @@ inline void processAttention(
 		#endif
 		// See we are enabled to cause shutdowns
 		if (theNet.GroupShutdownInfo[theAddr].enabled) {
-			theNet.GroupShutdownRequest = true;
-			pNCS->GroupShutdownEvent.SetEvent();
+			pNCS->stopLaneRequest(infcCoreTime());
 	}
 	}
 
@@ -5752,11 +6866,12 @@ MN_EXPORT cnErrCode MN_DECL infcFlushDataAcq(multiaddr multiAddr)
 
 	pNCS->DataAcq[respAddr].AcqLock.Lock();
 
-	while (!(pNCS->DataAcq[respAddr].Points.empty())) {
-		pNCS->DataAcq[respAddr].Points.pop();
-	}
+	// Consume everything the read thread has published
+	pNCS->DataAcq[respAddr].Tail.Set(pNCS->DataAcq[respAddr].Head.Fetch());
 
 	pNCS->DataAcq[respAddr].Overflow = FALSE;
+	// The read thread may be counting a drop, take the count atomically
+	pNCS->DataAcq[respAddr].Dropped.Exchange(0);
 	pNCS->DataAcq[respAddr].SampleCount = 0;
 	pNCS->DataAcq[respAddr].AcqLock.Unlock();
 
@@ -5803,6 +6918,11 @@ cnErrCode infcInitDataAcq(
 ///		Get up to \e ptsToRead samples in the user supplied \e pTheDataAcqPt
 ///		buffer. The actual number of samples returned is stored in
 ///		\e pPtsRead.
+///
+///		When the node's ring is full the points arriving are dropped and
+///		the older points waiting here are kept. The first point stored
+///		after the gap has \e Valid clear, infcGetDataAcqDropped counts the
+///		points lost.
 //
 //	SYNOPSIS:
 MN_EXPORT cnErrCode MN_DECL infcGetDataAcqPt(
@@ -5826,27 +6946,36 @@ MN_EXPORT cnErrCode MN_DECL infcGetDataAcqPt(
 	if (pPtsRead == NULL)
 		return MN_ERR_BADARG;
 
-	// Lock out the writer until we are done copying
-	pNCS->DataAcq[theAddr].AcqLock.Lock();
+	// Lock out other readers, the read thread keeps running
+	dataAcqInfo &acq = pNCS->DataAcq[theAddr];
+	acq.AcqLock.Lock();
 
+	Uint32 tail = (Uint32)acq.Tail.Value();
+	Uint32 avail = (Uint32)acq.Head.Fetch() - tail;
 	// If empty avoid dequeue error on read
-	if (pNCS->DataAcq[theAddr].Points.empty()) {
-		pNCS->DataAcq[theAddr].AcqLock.Unlock();
+	if (avail == 0) {
+		acq.AcqLock.Unlock();
 		return MN_ERR_DATAACQ_EMPTY;
 	}
+	if (avail > ptsToRead)
+		avail = ptsToRead;
 
-	*pPtsRead = 0;
 	//_RPT3(_CRT_WARN, "%.1f infcGetDataAcqPt(%d) len=%d\n", infcCoreTime(), multiAddr, ptsToRead);
-	// Copy up to the requester's defined buffer length
-	while (!(pNCS->DataAcq[theAddr].Points.empty())
-		&& *pPtsRead<ptsToRead) {
-		pTheDataAcqPt[*pPtsRead] = pNCS->DataAcq[theAddr].Points.front();
-		pNCS->DataAcq[theAddr].Points.pop();
-		(*pPtsRead)++;
-	}
-	pNCS->DataAcq[theAddr].Overflow = FALSE;
-	// Writer can now run
-	pNCS->DataAcq[theAddr].AcqLock.Unlock();
+	// Copy up to the requester's defined buffer length, in two runs when
+	// the points wrap the end of the ring
+	Uint32 first = tail & (DATAACQ_RING_LEN - 1);
+	Uint32 run = DATAACQ_RING_LEN - first;
+	if (run > avail)
+		run = avail;
+	memcpy(pTheDataAcqPt, &acq.Points[first], run * sizeof(mnDataAcqPt));
+	memcpy(pTheDataAcqPt + run, &acq.Points[0],
+		   (avail - run) * sizeof(mnDataAcqPt));
+	// Hand the slots back to the read thread
+	acq.Tail.Add(LONG(avail));
+	*pPtsRead = avail;
+	acq.Overflow = FALSE;
+	// Other readers can now run
+	acq.AcqLock.Unlock();
 
 	return errRet;
 }
@@ -5874,8 +7003,178 @@ MN_EXPORT cnErrCode MN_DECL infcGetDataAcqPtCount(
 		|| (pNCS = SysInventory[cNum].pNCS, pNCS == NULL)
 		|| pPointCount == NULL)
 		return MN_ERR_BADARG;
-	*pPointCount
-		= (nodeulong)pNCS->DataAcq[NODE_ADDR(multiAddr)].Points.size();
+	*pPointCount = pNCS->DataAcq[NODE_ADDR(multiAddr)].Count();
+	return MN_OK;
+}
+//																			   *
+//******************************************************************************
+
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		infcGetDataAcqClock
+//
+//	DESCRIPTION:
+///		Return the time stamp of the node's latest data acquisition point
+///		in \e pNodeMs and the infcCoreTime it arrived at in \e pHostMs.
+//
+//	SYNOPSIS:
+MN_EXPORT cnErrCode MN_DECL infcGetDataAcqClock(
+	multiaddr multiAddr,
+	double *pNodeMs,
+	double *pHostMs)
+{
+	netaddr cNum = NET_NUM(multiAddr);
+	netStateInfo *pNCS;
+	LONG seq;
+	// Bounds and arg check
+	if ((multiAddr == MN_UNSET_ADDR) || cNum > SysPortCount
+		|| (pNCS = SysInventory[cNum].pNCS, pNCS == NULL)
+		|| pNodeMs == NULL || pHostMs == NULL)
+		return MN_ERR_BADARG;
+
+	dataAcqInfo &acq = pNCS->DataAcq[NODE_ADDR(multiAddr)];
+	do {
+		seq = acq.ClockSeq.ReadBegin();
+		*pNodeMs = acq.ClockNodeMs;
+		*pHostMs = acq.ClockHostMs;
+	} while (acq.ClockSeq.ReadRetry(seq));
+	return (*pHostMs == 0) ? MN_ERR_DATAACQ_EMPTY : MN_OK;
+}
+//																			   *
+//******************************************************************************
+
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		infcGetDataAcqPeriod
+//
+//	DESCRIPTION:
+///		Return the nominal time between the node's data acquisition points
+///		in \e pPeriodMs, as set by infcInitDataAcq.
+//
+//	SYNOPSIS:
+MN_EXPORT cnErrCode MN_DECL infcGetDataAcqPeriod(
+	multiaddr multiAddr,
+	double *pPeriodMs)
+{
+	netaddr cNum = NET_NUM(multiAddr);
+	netStateInfo *pNCS;
+	// Bounds and arg check
+	if ((multiAddr == MN_UNSET_ADDR) || cNum > SysPortCount
+		|| (pNCS = SysInventory[cNum].pNCS, pNCS == NULL)
+		|| pPeriodMs == NULL)
+		return MN_ERR_BADARG;
+
+	*pPeriodMs = pNCS->DataAcq[NODE_ADDR(multiAddr)].SampRateMilliSec;
+	return MN_OK;
+}
+//																			   *
+//******************************************************************************
+
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		infcPeekDataAcqPts
+//
+//	DESCRIPTION:
+///		Point \e ppPts at the oldest data acquisition points still in the
+///		node's ring and return in \e pPtsAvail how many follow it without
+///		wrapping. The points stay in place until infcReleaseDataAcqPts
+///		hands them back, so only one reader may peek at a node and it must
+///		not read or flush the node until it has released them.
+//
+//	SYNOPSIS:
+MN_EXPORT cnErrCode MN_DECL infcPeekDataAcqPts(
+	multiaddr multiAddr,
+	const mnDataAcqPt **ppPts,
+	nodeulong *pPtsAvail)
+{
+	netaddr cNum = NET_NUM(multiAddr);
+	netStateInfo *pNCS;
+	// Bounds and arg check
+	if ((multiAddr == MN_UNSET_ADDR) || cNum > SysPortCount
+		|| (pNCS = SysInventory[cNum].pNCS, pNCS == NULL)
+		|| ppPts == NULL || pPtsAvail == NULL)
+		return MN_ERR_BADARG;
+
+	dataAcqInfo &acq = pNCS->DataAcq[NODE_ADDR(multiAddr)];
+	Uint32 tail = (Uint32)acq.Tail.Value();
+	Uint32 avail = (Uint32)acq.Head.Fetch() - tail;
+	if (avail == 0)
+		return MN_ERR_DATAACQ_EMPTY;
+	Uint32 first = tail & (DATAACQ_RING_LEN - 1);
+	if (avail > DATAACQ_RING_LEN - first)
+		avail = DATAACQ_RING_LEN - first;
+	*ppPts = &acq.Points[first];
+	*pPtsAvail = avail;
+	return MN_OK;
+}
+//																			   *
+//******************************************************************************
+
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		infcReleaseDataAcqPts
+//
+//	DESCRIPTION:
+///		Hand back the first \e ptsUsed points of the last infcPeekDataAcqPts
+///		span to the read thread.
+//
+//	SYNOPSIS:
+MN_EXPORT cnErrCode MN_DECL infcReleaseDataAcqPts(
+	multiaddr multiAddr,
+	nodeulong ptsUsed)
+{
+	netaddr cNum = NET_NUM(multiAddr);
+	netStateInfo *pNCS;
+	// Bounds and arg check
+	if ((multiAddr == MN_UNSET_ADDR) || cNum > SysPortCount
+		|| (pNCS = SysInventory[cNum].pNCS, pNCS == NULL))
+		return MN_ERR_BADARG;
+
+	dataAcqInfo &acq = pNCS->DataAcq[NODE_ADDR(multiAddr)];
+	if (ptsUsed > acq.Count())
+		return MN_ERR_BADARG;
+	acq.Tail.Add(LONG(ptsUsed));
+	acq.Overflow = FALSE;
+	return MN_OK;
+}
+//																			   *
+//******************************************************************************
+
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		infcGetDataAcqDropped
+//
+//	DESCRIPTION:
+///		Return the number of points the read thread dropped because the
+///		node's ring was full, and restart the count if \e reset is set.
+//
+//	SYNOPSIS:
+MN_EXPORT cnErrCode MN_DECL infcGetDataAcqDropped(
+	multiaddr multiAddr,
+	nodebool reset,
+	nodeulong *pDropped)
+{
+	netaddr cNum = NET_NUM(multiAddr);
+	netStateInfo *pNCS;
+	// Bounds and arg check
+	if ((multiAddr == MN_UNSET_ADDR) || cNum > SysPortCount
+		|| (pNCS = SysInventory[cNum].pNCS, pNCS == NULL)
+		|| pDropped == NULL)
+		return MN_ERR_BADARG;
+
+	dataAcqInfo &acq = pNCS->DataAcq[NODE_ADDR(multiAddr)];
+	*pDropped = (nodeulong)(reset ? acq.Dropped.Exchange(0)
+								  : acq.Dropped.Value());
 	return MN_OK;
 }
 //																			   *
@@ -6535,7 +7834,7 @@ MN_EXPORT cnErrCode MN_DECL infcTraceDump(
 	#if defined(__linux__)||defined(__GNUC__)
 	char utf8Path[MAX_PATH];
 	wcstombs(utf8Path, pFilePath, MAX_PATH);
-	outStream.open(utf8Path, ios::out | ios::binary);
+	outStream.open(utf8Path, std::ios::out | std::ios::binary);
 	#else
 	outStream.open(pFilePath, std::ios::out | std::ios::binary);
 	#endif
@@ -6888,7 +8187,7 @@ netPollerThread::netPollerThread(netStateInfo *pTheNetInfo)
 	m_InternalSyncAck.ResetEvent();
 	m_halted = true;
 	pNCS = pTheNetInfo;
-	pNCS->GroupShutdownEvent.ResetEvent();
+	pNCS->PollWakeEvent.ResetEvent();
 }
 
 netPollerThread::~netPollerThread() {
@@ -6933,7 +8232,6 @@ int netPollerThread::Run(void *context)
 	pNCS = (netStateInfo *)context;
 	netaddr cNum = pNCS->cNum;
 	multiaddr theNodeAddr = MULTI_ADDR(cNum, 0);
-	mnNetInvRecords &theNet = SysInventory[pNCS->cNum];
 
 	#if TRACE_POLL_THRD||TRACE_THREAD
 	_RPT3(_CRT_WARN, "%.1f netPollerThread(%d): id=" THREAD_RADIX " starting\n",
@@ -6975,83 +8273,61 @@ int netPollerThread::Run(void *context)
 		if (!m_halted) {
 			// Driver state allows operations?
 			if (SysInventory[cNum].OpenState == OPENED_ONLINE) {
-				// Issue node stops if we had detected the need or externally
-				// issued.
-				if (theNet.GroupShutdownRequest) {
-					_RPT1(_CRT_WARN, "%.1f Group Shutdown Request\n", infcCoreTime());
-					// Is there group node stop request?
-					// Process the ClearPath SC nodes
-					for (size_t i = 0; i < theNet.InventoryNow.mnCpScInfo.count; i++) {
-						multiaddr theAddr = theNet.InventoryNow.mnCpScInfo.node[i];
-						ShutdownInfo &sInfo = theNet.GroupShutdownInfo[NODE_ADDR(theAddr)];
-						if (sInfo.enabled) {
-							_RPT3(_CRT_WARN, "%.1f Group Shutdown(%d) type %0x\n",
-								infcCoreTime(), theAddr,
-								sInfo.theStopType.bits);
-							theErr = netNodeStop(theAddr, sInfo.theStopType, false);
-						}
-					}
-					// If other node types implement the GroupShutdown feature, process them here
-
-					// Wait for next request
-					theNet.GroupShutdownRequest = false;
+				// Runnning. Send low-level get to insure no caching. Group
+				// shutdowns are sent by the stop lane.
+				theErr = infcRunCommand(cNum, &outPkt, &inPkt);
+
+				// Check that the contents of the return packet match the contents of the sent packet
+				bool pktMismatch = outPkt.Byte.BufferSize != inPkt.Byte.BufferSize;
+				for (nodeulong iByte = 0; iByte < outPkt.Byte.BufferSize && !pktMismatch; iByte++) {
+					pktMismatch = pktMismatch || outPkt.Byte.Buffer[iByte] != inPkt.Byte.Buffer[iByte];
 				}
-				else {
-					// Runnning. Send low-level get to insure no caching
-					theErr = infcRunCommand(cNum, &outPkt, &inPkt);
-
-					// Check that the contents of the return packet match the contents of the sent packet
-					bool pktMismatch = outPkt.Byte.BufferSize != inPkt.Byte.BufferSize;
-					for (nodeulong iByte = 0; iByte < outPkt.Byte.BufferSize && !pktMismatch; iByte++) {
-						pktMismatch = pktMismatch || outPkt.Byte.Buffer[iByte] != inPkt.Byte.Buffer[iByte];
-					}
-					// If the command failed, it is handled elsewhere
-					pktMismatch = pktMismatch && theErr == MN_OK;
-
-					cntr++;
-					outPkt.Byte.Buffer[CMD_LOC + 1] = cntr & 0xff;
+				// If the command failed, it is handled elsewhere
+				pktMismatch = pktMismatch && theErr == MN_OK;
+
+				cntr++;
+				outPkt.Byte.Buffer[CMD_LOC + 1] = cntr & 0xff;
+				#if TRACE_POLL_THRD||TRACE_THREAD
+				if ((cntr % 10) == 0) {
+					_RPT0(_CRT_WARN, "Polled 10 more\n");
+				}
+				#endif
+				// Ack we have started
+				m_InternalSyncAck.SetEvent();
+				if (theErr != MN_OK || pktMismatch) {
 					#if TRACE_POLL_THRD||TRACE_THREAD
-					if ((cntr % 10) == 0) {
-						_RPT0(_CRT_WARN, "Polled 10 more\n");
-					}
+					_RPT3(_CRT_WARN, "%.1f netPollerThread(%d): probe cmd err=0x%x\n",
+						infcCoreTime(), cNum, theErr);
 					#endif
-					// Ack we have started
-					m_InternalSyncAck.SetEvent();
-					if (theErr != MN_OK || pktMismatch) {
-						#if TRACE_POLL_THRD||TRACE_THREAD
-						_RPT3(_CRT_WARN, "%.1f netPollerThread(%d): probe cmd err=0x%x\n",
-							infcCoreTime(), cNum, theErr);
-						#endif
-						if (pktMismatch) {
-							// Fire off the error callback
-							errInfo.cNum = cNum;
-							errInfo.node = theNodeAddr;
-							errInfo.errCode = MN_ERR_CMD_OFFLINE;
-							infcFireErrCallback(&errInfo);
-							_RPT3(_CRT_WARN, "%.1f netPollerThread::Run(%d): response err 0x%x\n",
-								infcCoreTime(), cNum, errInfo.errCode);
-							// Create dump file on this error
-							infcTraceDumpNext(cNum);
-						}
-						// Stop this until recovery occurs
-						m_critSection.Lock();
-						m_halted = true;
-						// Don't allow loop to run again.
-						m_RunControl.ResetEvent();
-						m_critSection.Unlock();
-						#if TRACE_POLL_THRD||TRACE_THREAD
-						_RPT2(_CRT_WARN, "%.1f netPollerThread(%d): Error Halted!\n",
-							infcCoreTime(), cNum);
-						#endif
-					}
-					#if 0
-					else {
-						// Probe was OK, perform additional polling
-						_RPT2(_CRT_WARN, "%.1f netPollerThread(%d): probe OK\n",
-							infcCoreTime(), cNum);
+					if (pktMismatch) {
+						// Fire off the error callback
+						errInfo.cNum = cNum;
+						errInfo.node = theNodeAddr;
+						errInfo.errCode = MN_ERR_CMD_OFFLINE;
+						infcFireErrCallback(&errInfo);
+						_RPT3(_CRT_WARN, "%.1f netPollerThread::Run(%d): response err 0x%x\n",
+							infcCoreTime(), cNum, errInfo.errCode);
+						// Create dump file on this error
+						infcTraceDumpNext(cNum);
 					}
-					#endif				
-				} // else not group shutdown
+					// Stop this until recovery occurs
+					m_critSection.Lock();
+					m_halted = true;
+					// Don't allow loop to run again.
+					m_RunControl.ResetEvent();
+					m_critSection.Unlock();
+					#if TRACE_POLL_THRD||TRACE_THREAD
+					_RPT2(_CRT_WARN, "%.1f netPollerThread(%d): Error Halted!\n",
+						infcCoreTime(), cNum);
+					#endif
+				}
+				#if 0
+				else {
+					// Probe was OK, perform additional polling
+					_RPT2(_CRT_WARN, "%.1f netPollerThread(%d): probe OK\n",
+						infcCoreTime(), cNum);
+				}
+				#endif				
 			}
 			else {
 				// Say we started now, even offline
@@ -7059,8 +8335,8 @@ int netPollerThread::Run(void *context)
 			}
 			// Wait until we try again
 			//CThread::Sleep(pNCS->pollDelayTimeMS);
-			pNCS->GroupShutdownEvent.WaitFor(pNCS->pollDelayTimeMS);
-			pNCS->GroupShutdownEvent.ResetEvent();
+			pNCS->PollWakeEvent.WaitFor(pNCS->pollDelayTimeMS);
+			pNCS->PollWakeEvent.ResetEvent();
 			#if TRACE_POLL_THRD||TRACE_THREAD
 			_RPT2(_CRT_WARN, "%.1f netPollerThread(%d): Poll delay complete\n",
 				infcCoreTime(), cNum);
@@ -7244,7 +8520,7 @@ void *netPollerThread::Terminate()
 	#endif
 	*m_pTermFlag = true;
 	m_RunControl.SetEvent();
-	pNCS->GroupShutdownEvent.SetEvent();
+	pNCS->PollWakeEvent.SetEvent();
 
 	// Set the terminate flag
 	void *rVal = CThread::Terminate();
@@ -7252,6 +8528,167 @@ void *netPollerThread::Terminate()
 }
 //																			  *
 //*****************************************************************************
+
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		netStopLaneThread::netStopLaneThread construction and destruction
+//
+//	DESCRIPTION:
+/**
+Create the stop lane for a port.
+**/
+//	SYNOPSIS:
+netStopLaneThread::netStopLaneThread(netStateInfo *pTheNetInfo)
+{
+	#if (defined(_WIN32)||defined(_WIN64))
+	SetDLLterm(true);
+	#endif
+	pNCS = pTheNetInfo;
+	pNCS->StopLaneEvent.ResetEvent();
+}
+
+netStopLaneThread::~netStopLaneThread() {
+	// Insure we exit
+	Terminate();
+	WaitForTerm();
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		netStopLaneThread::Run
+//
+//	DESCRIPTION:
+/**
+Wait for group shutdown requests and send their stops. A request made
+while the port is not online is kept and retried every STOP_LANE_RETRY_MS.
+**/
+//	SYNOPSIS:
+int netStopLaneThread::Run(void *context)
+{
+	mnNetInvRecords &theNet = SysInventory[pNCS->cNum];
+
+	while (!Terminating()) {
+		pNCS->StopLaneEvent.WaitFor(theNet.GroupShutdownRequest
+									? STOP_LANE_RETRY_MS : INFINITE);
+		// Reset before looking so a new request signals us again
+		pNCS->StopLaneEvent.ResetEvent();
+		if (Terminating())
+			break;
+		if (theNet.GroupShutdownRequest && theNet.OpenState == OPENED_ONLINE)
+			sendStops();
+	}
+	return(0);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		netStopLaneThread::sendStops
+//
+//	DESCRIPTION:
+/**
+Send the stop of every node in the group shutdown in one write and wait
+for the nodes to take them. A request arriving meanwhile is served by the
+next pass. Each stop's response is checked as netRunCommand does and the
+error callbacks fired for those that failed.
+**/
+//	SYNOPSIS:
+void netStopLaneThread::sendStops()
+{
+	mnNetInvRecords &theNet = SysInventory[pNCS->cNum];
+	size_t iNode, iStop, nStops = 0;
+	cnErrCode theErr, stopErr;
+	infcErrInfo errInfo;					// Error reporting buffer
+
+	// Take the request, the send below records its latency
+	pNCS->StopLaneLock.Lock();
+	theNet.GroupShutdownRequest = false;
+	pNCS->StopBurstReqAt = pNCS->StopReqAt;
+	pNCS->StopReqAt = 0;
+	pNCS->StopLaneLock.Unlock();
+
+	// Process the ClearPath SC nodes
+	for (iNode = 0; iNode < theNet.InventoryNow.mnCpScInfo.count; iNode++) {
+		multiaddr theAddr = theNet.InventoryNow.mnCpScInfo.node[iNode];
+		ShutdownInfo &sInfo = theNet.GroupShutdownInfo[NODE_ADDR(theAddr)];
+		if (!sInfo.enabled)
+			continue;
+		packetbuf &theCmd = m_cmds[nStops++];
+		theCmd.Fld.PktType = MN_PKT_TYPE_CMD;
+		theCmd.Fld.Src = MN_SRC_HOST;
+		theCmd.Fld.Mode = 0;
+		theCmd.Fld.Zero1 = 0;
+		theCmd.Fld.Addr = NODE_ADDR(theAddr);
+		theCmd.Fld.PktLen = 2;
+		theCmd.Byte.Buffer[CMD_LOC] = MN_CMD_NODE_STOP;
+		theCmd.Byte.Buffer[CMD_LOC + 1] = nodechar(sInfo.theStopType.bits);
+		theCmd.Byte.BufferSize = theCmd.Fld.PktLen + MN_API_PACKET_HDR_LEN;
+	}
+	// If other node types implement the GroupShutdown feature, process them here
+
+	if (nStops == 0) {
+		pNCS->StopBurstReqAt = 0;
+		return;
+	}
+	_RPT2(_CRT_WARN, "%.1f Group Shutdown(%d)\n", infcCoreTime(), pNCS->cNum);
+	theErr = infcRunBatch(pNCS->cNum, m_cmds, m_resps, nStops, NULL, TRUE);
+	for (iStop = 0; iStop < nStops; iStop++) {
+		packetbuf &theCmd = m_cmds[iStop];
+		packetbuf &theResp = m_resps[iStop];
+		// A stop that was not answered has an empty response
+		if (theResp.Byte.BufferSize == 0)
+			stopErr = (theErr != MN_OK) ? theErr : MN_ERR_RESP_FMT;
+		else if ((theResp.Fld.PktLen + MN_API_PACKET_HDR_LEN)
+				 != theResp.Byte.BufferSize)
+			stopErr = MN_ERR_PKT_ERR;
+		else
+			stopErr = coreGenErrCode(pNCS->cNum, &theResp, theCmd.Fld.Addr);
+		if (stopErr == MN_OK)
+			continue;
+		_RPT4(_CRT_WARN, "%.1f netStopLaneThread(%d): node %d stop err=0x%x\n",
+			infcCoreTime(), pNCS->cNum, theCmd.Fld.Addr, stopErr);
+		// Fire off the error callback
+		errInfo.cNum = pNCS->cNum;
+		errInfo.node = MULTI_ADDR(pNCS->cNum, theCmd.Fld.Addr);
+		infcCopyPktToPkt18(&errInfo.response, &theResp);
+		if (stopErr == MN_ERR_OFFLINE)
+			errInfo.errCode = (cnErrCode)(MN_ERR_OFFLINE_00 + theCmd.Fld.Addr);
+		else
+			errInfo.errCode = stopErr;
+		infcFireErrCallback(&errInfo);
+		// Create dump file on this error
+		infcTraceDumpNext(pNCS->cNum);
+	}
+	pNCS->StopBurstReqAt = 0;
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		netStopLaneThread::Terminate
+//
+//	DESCRIPTION:
+/**
+Insure the thread exits in a timely manner.
+**/
+//	SYNOPSIS:
+void *netStopLaneThread::Terminate()
+{
+	void *rVal = CThread::Terminate();
+	pNCS->StopLaneEvent.SetEvent();
+	return rVal;
+}
+//																			  *
+//*****************************************************************************
 /// \endcond 
 
 /// \cond CPM_CLIB
@@ -7744,7 +9181,14 @@ MN_EXPORT cnErrCode MN_DECL infcShutdownInfoSet(
 	ShutdownInfo &info = inv.GroupShutdownInfo[theAddr];
 
 	// Clear GroupShutdownRequest to allow any failure to reissue the nodestop
-	inv.GroupShutdownRequest = false;
+	if (inv.pNCS) {
+		inv.pNCS->StopLaneLock.Lock();
+		inv.GroupShutdownRequest = false;
+		inv.pNCS->StopReqAt = 0;
+		inv.pNCS->StopLaneLock.Unlock();
+	}
+	else
+		inv.GroupShutdownRequest = false;
 
 	// Adjust the polling list as necessary, watch out for VB 
 	// booleans for compares.
@@ -7843,8 +9287,7 @@ MN_EXPORT cnErrCode MN_DECL infcShutdownInitiate(
 	if (!pNCS)
 		return MN_ERR_DEV_ADDR;
 
-	SysInventory[cNum].GroupShutdownRequest = true;
-	pNCS->GroupShutdownEvent.SetEvent();
+	pNCS->stopLaneRequest(infcCoreTime());
 
 	return MN_OK;
 }
@@ -7877,6 +9320,7 @@ mnNetInvRecords::mnNetInvRecords() {
 	clearNodes(false);
 	Initializing = 0;
 	NumCmdsInRing = N_CMDS_IN_RING;
+	CmdWindowAdaptive = FALSE;
 	AutoDiscoveryEnable = true;
 	KeepAlivePollEnable = true;
 	KeepAlivePollRestoreState = true;
@@ -7992,6 +9436,8 @@ void mnNetInvRecords::clearNodes(bool portIsClosed)
 			pNodes[i]->Refresh();
 	}
 	if (portIsClosed) {
+		// The nodes are set up again from scratch when reopened
+		InventoryGood.isValid = false;
 		OpenStateNext(CLOSED);
 	}
 	else {
@@ -280,9 +280,12 @@ cnErrCode MN_DECL mnInitializeProc(
 		// ---- END - Diagnostics: Run if node initialize not successful ----
 
 
-		// We got some nodes, enumerate them
+		// We got some nodes, re-attach them if they are the ones we had
+		// set up, else enumerate them. Reset nodes are always enumerated.
 		if (initErr == MN_OK && foundNetworkNodes) {
-			startErr = netEnumerate(cNum);
+			startErr = resetNodes ? MN_ERR_PARAM_NOT_INIT : netReattach(cNum);
+			if (startErr != MN_OK)
+				startErr = netEnumerate(cNum);
 		}
 		else
 			lastErr = startErr = initErr;
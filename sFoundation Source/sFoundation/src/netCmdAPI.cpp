@@ -70,6 +70,7 @@
 	#include "converterLib.h"
 	#include "pubMonPort.h"
 	#include "SerialEx.h"
+	#include "paramCache.h"
 	#include <math.h>
 	#include <assert.h>
 	#include <time.h>
@@ -139,6 +140,9 @@
 #define NET_FRAGS_BAD 		1
 #define NET_STRAYS_BAD 		1
 #define NET_OVERRUN_BAD 	1
+// A real-time value read by netGetParameterGroup is served to readers
+// for this long (ms), long enough for the caller to collect the group
+#define PARAM_GROUP_MAX_AGE	5.0
 
 //- - - - - - - - - - - - - - - - - - - -
 // TRACING/DEBUG SETUP
@@ -297,6 +301,53 @@ static void infcCopyPktToPkt18(packetbuf18 *pDest, packetbuf *pSrc)
 //******************************************************************************
 
 
+//******************************************************************************
+//	NAME																	   *
+//		coreValCacheGen
+//
+//	DESCRIPTION:
+///		Return the cache generation of the values in \a pBank. Both counters
+///		only grow so their sum changes whenever either is bumped.
+///
+/// 	\param pNodeInfo The node owning the bank
+///		\param pBank  The parameter bank
+//
+//	SYNOPSIS:
+static inline nodeulong coreValCacheGen(const byNodeDB *pNodeInfo,
+										const paramBank *pBank)
+{
+	return(pNodeInfo->valGeneration + pBank->valGeneration);
+}
+//																			   *
+//******************************************************************************
+
+
+//******************************************************************************
+//	NAME																	   *
+//		coreValFresh
+//
+//	DESCRIPTION:
+///		Return true if \a pValueDB was read from the node more recently
+///		than its max age, or than PARAM_GROUP_MAX_AGE if a group read left
+///		it.
+///
+/// 	\param pValueDB The cached value
+//
+//	SYNOPSIS:
+static inline nodebool coreValFresh(const paramValue *pValueDB)
+{
+	double age, maxAge = pValueDB->maxAge;
+	if (pValueDB->fromGroup && maxAge < PARAM_GROUP_MAX_AGE)
+		maxAge = PARAM_GROUP_MAX_AGE;
+	if (maxAge <= 0 || !pValueDB->exists)
+		return(FALSE);
+	age = infcCoreTime() - pValueDB->readTime;
+	return(age < maxAge);
+}
+//																			   *
+//******************************************************************************
+
+
 //****************************************************************************
 //	NAME
 //		coreController
@@ -321,6 +372,62 @@ netaddr coreController(multiaddr theMultiAddr)
 
 
 
+//****************************************************************************
+//	NAME
+//		coreReadSerNums
+//
+//	DESCRIPTION:
+//		Read the serial number of the first <nNodes> nodes on <cNum> in one
+//		pipelined burst. The raw octets are kept, they are only compared.
+//
+//	RETURNS:
+//		#cnErrCode: MN_OK if every node answered
+//
+//	SYNOPSIS:
+static cnErrCode coreReadSerNums(
+	netaddr cNum,				// Controller number
+	nodeulong nNodes,			// Nodes to read
+	Uint32 *pSerNums)			// Serial number of each
+{
+	packetbuf cmds[MN_API_MAX_NODES], resps[MN_API_MAX_NODES], rawVal;
+	cnErrCode theErr;
+	nodeulong i;
+
+	if (nNodes > MN_API_MAX_NODES)
+		return(MN_ERR_BADARG);
+	for (i = 0; i < nNodes; i++) {
+		theErr = netGetParameterFmt(&cmds[i], nodeaddr(i), MN_P_SER_NUM);
+		if (theErr != MN_OK)
+			return(theErr);
+		// Initialize the command invariant information like netRunCommand
+		cmds[i].Fld.PktType = MN_PKT_TYPE_CMD;
+		cmds[i].Fld.Src = MN_SRC_HOST;
+		cmds[i].Fld.Mode = 0;
+		cmds[i].Fld.Zero1 = 0;
+		cmds[i].Byte.BufferSize = cmds[i].Fld.PktLen + MN_API_PACKET_HDR_LEN;
+	}
+	theErr = infcRunCommandBatch(cNum, cmds, resps, nNodes, NULL);
+	for (i = 0; theErr == MN_OK && i < nNodes; i++) {
+		if (resps[i].Byte.BufferSize == 0
+		|| (resps[i].Fld.PktLen + MN_API_PACKET_HDR_LEN) != resps[i].Byte.BufferSize) {
+			theErr = MN_ERR_RESP_FMT;
+			break;
+		}
+		theErr = coreGenErrCode(cNum, &resps[i], cmds[i].Fld.Addr);
+		if (theErr == MN_OK)
+			theErr = netGetParameterExtract(&resps[i], &rawVal);
+		if (theErr != MN_OK)
+			break;
+		pSerNums[i] = 0;
+		memcpy(&pSerNums[i], rawVal.Byte.Buffer,
+			   rawVal.Byte.BufferSize < sizeof(Uint32)
+			   ? rawVal.Byte.BufferSize : sizeof(Uint32));
+	}
+	return(theErr);
+}
+/****************************************************************************/
+
+
 //****************************************************************************
 //	NAME
 //		netEnumerate
@@ -349,6 +456,8 @@ MN_EXPORT cnErrCode MN_DECL netEnumerate(
 	infcFireNetEvent(cNum, NODES_SENDING);
 	// Clear our initial set of counts until we rediscover
 	netInv.clearNodes(false);
+	// The node databases are rebuilt, nothing to re-attach to until done
+	netInv.InventoryGood.isValid = false;
 
 	maxNode=0;
 	lastErr = netSetAddress(cNum, &maxNode);
@@ -444,6 +553,16 @@ MN_EXPORT cnErrCode MN_DECL netEnumerate(
 		netInv.NodeInfo[i].rank = 0;
 	}
 
+	// Remember a clean inventory for netReattach
+	if (lastErr == MN_OK && maxNode > 0) {
+		netInv.InventoryGood = netInv.InventoryNow;
+		for (i = 0; i < maxNode; i++)
+			netInv.InventoryGood.LastIDs[i] = netInv.NodeInfo[i].theID;
+		netInv.InventoryGood.isValid
+			= coreReadSerNums(cNum, maxNode, netInv.InventoryGood.SerNums)
+			  == MN_OK;
+	}
+
 	// Force Initialize mode to determine if online
 	netInv.OpenStateNext(OPENED_ONLINE);
 
@@ -455,6 +574,101 @@ MN_EXPORT cnErrCode MN_DECL netEnumerate(
 /****************************************************************************/
 
 
+//****************************************************************************
+//	NAME
+//		netReattach
+//
+//	DESCRIPTION:
+//		Bring the nodes of the last complete enumeration back online without
+//		enumerating them again. The nodes are addressed and their serial
+//		numbers read in one burst, if the count and every serial number
+//		match the saved inventory it is restored and the node databases and
+//		class objects are kept. Cached values are dropped as the nodes may
+//		have lost power.
+//
+//		On a mismatch the inventory is left cleared, as netEnumerate starts
+//		it, and the caller falls back to netEnumerate.
+//
+//	RETURNS:
+//		#cnErrCode: MN_OK if the nodes were re-attached
+//
+//	SYNOPSIS:
+MN_EXPORT cnErrCode MN_DECL netReattach(
+	netaddr cNum)				// Controller number
+{
+	cnErrCode theErr = MN_OK;
+	nodeulong i, maxNode = 0;
+	Uint32 serNums[MN_API_MAX_NODES];
+	mnNetInvRecords &netInv = SysInventory[cNum];
+
+	if (cNum >= NET_CONTROLLER_MAX)
+		return(MN_ERR_DEV_ADDR);
+	if (!netInv.InventoryGood.isValid || !netInv.pNCS)
+		return(MN_ERR_PARAM_NOT_INIT);
+
+	infcSetInitializeMode(cNum, TRUE, MN_OK);
+	infcFireNetEvent(cNum, NODES_SENDING);
+	netInv.clearNodes(false);
+
+	theErr = netSetAddress(cNum, &maxNode);
+	if (theErr == MN_OK && maxNode != netInv.InventoryGood.NumOfNodes)
+		theErr = MN_ERR_WRONG_NODE_TYPE;
+	if (theErr == MN_OK
+	&& netInv.PhysPortSpecifier.PortRate != netInv.pNCS->pSerialPort->GetBaudrate())
+		theErr = infcSetNetRate(cNum, netInv.PhysPortSpecifier.PortRate);
+	if (theErr == MN_OK)
+		theErr = coreReadSerNums(cNum, maxNode, serNums);
+	for (i = 0; theErr == MN_OK && i < maxNode; i++) {
+		if (serNums[i] != netInv.InventoryGood.SerNums[i]
+		|| netInv.NodeInfo[i].paramBankList == NULL)
+			theErr = MN_ERR_WRONG_NODE_TYPE;
+	}
+	if (theErr != MN_OK) {
+		// Not a network failure, full discovery follows
+		infcSetInitializeMode(cNum, FALSE, MN_OK);
+		return(theErr);
+	}
+
+	// Same nodes at the same addresses
+	netInv.InventoryNow = netInv.InventoryGood;
+	coreInvalidateValCache(cNum);
+	if (netInv.pPortCls) {
+		// Read what the class objects sync up with in one burst
+		multiaddr refreshAddrs[2*MN_API_MAX_NODES];
+		nodeparam refreshParams[2*MN_API_MAX_NODES];
+		size_t nRefresh = 0;
+		for (i = 0; i < maxNode; i++) {
+			if (netInv.NodeInfo[i].theID.fld.devType != NODEID_CS)
+				continue;
+			refreshAddrs[nRefresh] = MULTI_ADDR(cNum, i);
+			refreshParams[nRefresh++] = MN_P_OPTION_REG;
+			refreshAddrs[nRefresh] = MULTI_ADDR(cNum, i);
+			refreshParams[nRefresh++] = MN_P_FW_VERSION;
+		}
+		netGetParameterGroup(cNum, nRefresh, refreshAddrs, refreshParams, NULL);
+		for (i = 0; i < maxNode; i++) {
+			if (netInv.NodeInfo[i].theID.fld.devType != NODEID_CS
+			|| !netInv.pNodes[i])
+				continue;
+			try {
+				// sync up the node
+				netInv.pNodes[i]->Refresh();
+			}
+			catch (sFnd::mnErr &err) {
+				infcSetInitializeMode(cNum, FALSE, MN_OK);
+				return(err.ErrorCode);
+			}
+		}
+	}
+
+	// Force Initialize mode to determine if online
+	netInv.OpenStateNext(OPENED_ONLINE);
+	infcSetInitializeMode(cNum, FALSE, MN_OK);
+	return(MN_OK);
+}
+/****************************************************************************/
+
+
 //****************************************************************************
 //	NAME
 //		netGetUserDescription
@@ -1137,6 +1351,7 @@ MN_EXPORT cnErrCode MN_DECL netSetParameterEx(
 			if (theErr == MN_OK) {
 				if (pTheValDB) {
 					pTheValDB->exists = TRUE;
+					pTheValDB->generation = coreValCacheGen(pNodeInfo, pParamBank);
 					paramChgObj.newValue = pTheValDB->value;
 					pTheValDB->value = coreBufToDouble(pTheInfoDB, pTheValDB);
 				}
@@ -1742,7 +1957,7 @@ cnErrCode coreUpdateParamInfo(
             #endif
 			pFixedInfoDB = &pParamBank->fixedInfoDB[pNum];
 			pValueDB = &pParamBank->valueDB[pNum];
-			pValueDB->isPolled = FALSE;
+			pValueDB->fromGroup = FALSE;
 			pValueDB->exists = FALSE;			// Mark "un-read"
 			pValueDB->value = 0;
 			if (pFixedInfoDB->info.paramType != PT_NONE)  {
@@ -1813,6 +2028,7 @@ MN_EXPORT cnErrCode MN_DECL netGetParameterInfo(
 	paramInfoLcl dummyInfo;			// Dummy information
 	paramValue *pValueDB;			// Current value DB
 	netaddr cNum;					// Current network
+	CCCriticalSection *pShareLock = NULL;	// Held while using the value DB
 
 	cNum = coreController(theMultiAddr);
 
@@ -1840,6 +2056,8 @@ MN_EXPORT cnErrCode MN_DECL netGetParameterInfo(
 
 	if (coreParam.fld.param < pParamBank->nParams)  {
 		paramValue optVal;
+		// Taken before the read so an invalidate during it is not lost
+		nodeulong cacheGen = coreValCacheGen(pNodeInfo, pParamBank);
 		// We are within our database, copy the basic information
 		// to the user if requested. First speed up the operations
 		// and clutter by initializing local values.
@@ -1848,8 +2066,20 @@ MN_EXPORT cnErrCode MN_DECL netGetParameterInfo(
 		pFixedInfoDB = pParamBank->fixedInfoDB + coreParam.fld.param;
 		if (coreParam.fld.option)
 			pValueDB = &optVal;
-		else
+		else {
 			pValueDB = pParamBank->valueDB + coreParam.fld.param;
+			// The entry is used under the node's shared read lock, which
+			// netGetParameterGroup publishes under. Held across the node
+			// read, so readers of a real-time value with a max age take
+			// turns and a late arrival uses the read in flight.
+			pShareLock = &SysInventory[cNum].SharedReadLock[NODE_ADDR(theMultiAddr)];
+			pShareLock->Lock();
+			// Invalidated since cached? Finish the flush now.
+			if (pValueDB->exists && pValueDB->generation != cacheGen) {
+				pValueDB->exists = FALSE;
+				pValueDB->value = 0;
+			}
+		}
 		// Save initial value
 		initialVal = pValueDB->value;
 
@@ -1863,12 +2093,16 @@ MN_EXPORT cnErrCode MN_DECL netGetParameterInfo(
 		// Option Bit is set update the value DB now. If option bit
 		// is set the acquired value is not cached.
 		//
-		if (((pFixedInfoDB->info.paramType & PT_RT) != 0)
+		if ((((pFixedInfoDB->info.paramType & PT_RT) != 0)
+		     && !coreValFresh(pValueDB))
 		  || coreParam.fld.option
 		  || !pValueDB->exists
 		  || (pFixedInfoDB->info.paramType == PT_NONE)) {
 
-			// Read from the node directly, real-time, EEPROM type or first time
+			// Read from the node directly, real-time, EEPROM type or first
+			// time
+			pValueDB->readTime = infcCoreTime();
+			pValueDB->fromGroup = FALSE;
 			theErr = netGetParameter(theMultiAddr, theParam, &pValueDB->raw);
 			// Kill the command execute bit for all opstates
 			//_RPT2(_CRT_WARN, "netCore: get param(RT) node=%d, param=%d\n", theMultiAddr, theParam);
@@ -1882,8 +2116,11 @@ MN_EXPORT cnErrCode MN_DECL netGetParameterInfo(
 
 		// This parameter converted OK
 		pValueDB->exists = (theErr == MN_OK);
+		pValueDB->generation = cacheGen;
 		// So far so good?
 		if (theErr != MN_OK)  {
+			if (pShareLock)
+				pShareLock->Unlock();
 			// Nope, make sure value is marked as junk
 			if (pRetValInfo) {
 				pRetValInfo->unitType = NO_UNIT;
@@ -1906,6 +2143,8 @@ MN_EXPORT cnErrCode MN_DECL netGetParameterInfo(
 								   | (unsigned long)initialVal;
 			pValueDB->value = 0;
 		}
+		if (pShareLock)
+			pShareLock->Unlock();
 		// Signal parameter change if this occurred	using user unit values
 		if(initialVal != pRetVal->value) {
 			paramChgObj.net = cNum;
@@ -1915,9 +2154,6 @@ MN_EXPORT cnErrCode MN_DECL netGetParameterInfo(
 			// Call the callback
 			infcFireParamCallback(pNodeInfo->pClassInfo->paramChngFunc,
 								  &paramChgObj);
-			// If clear-on-read, kill the old value
-			if (pFixedInfoDB->info.paramType & PT_CLR)
-				pValueDB->value = 0;
 		}
 	}
 	else {
@@ -1959,6 +2195,169 @@ MN_EXPORT cnErrCode MN_DECL netGetParameterInfo(
 /*																 !end!		*/
 /****************************************************************************/
 
+
+//****************************************************************************
+//	NAME
+//		netGetParameterGroup
+//
+//	DESCRIPTION:
+/**
+	Read a group of parameters from the nodes on port \a cNum in one
+	pipelined burst. The parameters netGetParameterInfo would read from
+	the node are sent as back to back get parameter commands and their
+	values are stored in the value database. A real-time value read this
+	way is served by netGetParameterInfo for PARAM_GROUP_MAX_AGE ms, or its
+	own max age if longer, so the caller can collect the group without
+	reading the node again. After that the value is read as usual.
+
+	Each value is converted on the side and published under the node's
+	shared read lock, the lock netGetParameterInfo reads under, so the
+	caller need not hold the nodes.
+
+	Parameters served from the cache, option accesses, parameters outside
+	the database and nodes on other ports are skipped.
+
+	\param[in] cNum Port index.
+	\param[in] nParams Number of parameters in the group.
+	\param[in] theMultiAddrs Node address of each parameter.
+	\param[in] theParams Parameter number of each parameter.
+	\param[out] theReadTimes If not NULL, set to the infcCoreTime each
+	parameter's response arrived at, or zero if it was not read.
+
+	\return MN_OK if the burst ran, else the first error. A parameter whose
+	read failed is left for netGetParameterInfo to read and report.
+**/
+//	SYNOPSIS:
+MN_EXPORT cnErrCode MN_DECL netGetParameterGroup(
+		netaddr cNum,				// Port index
+		size_t nParams,				// Number of parameters
+		const multiaddr *theMultiAddrs,	// Node address of each
+		const nodeparam *theParams,	// Parameter number of each
+		double *theReadTimes)		// Response time of each or NULL
+{
+	appNodeParam coreParam;			// The core parameter number
+	cnErrCode theErr=MN_OK;
+	byNodeDB *pNodeInfo;			// Node information
+	paramBank *pParamBank;			// Current parameter bank
+	paramInfoLcl const *pFixedInfoDB;	// Current parameter fixed info
+	paramValue *pValueDB;			// Current value DB
+	packetbuf *pCmds, *pResps;		// The burst
+	paramValue **ppDest;			// Value DB entry for each command
+	paramValue newVal;				// Value read, before it is published
+	CCCriticalSection *pShareLock;	// Node's value DB lock
+	size_t *pParamIndex;			// Parameter of each command
+	nodeulong *pCacheGen;			// Cache generation of each command
+	double startAt;
+	double *pDoneAt = NULL;			// Completion time of each command
+	size_t iParam, iCmd, nCmds = 0;
+
+	if (cNum >= NET_CONTROLLER_MAX)
+		return(MN_ERR_DEV_ADDR);
+	if (nParams == 0)
+		return(MN_OK);
+	if (!theMultiAddrs || !theParams)
+		return(MN_ERR_BADARG);
+	if (theReadTimes) {
+		for (iParam = 0; iParam < nParams; iParam++)
+			theReadTimes[iParam] = 0;
+	}
+	// Bail if port closed/offline
+	netStateInfo *pNCS = SysInventory[cNum].pNCS;
+	if (!pNCS || !(pNCS->pSerialPort) || !pNCS->pSerialPort->IsOpen())
+		return(MN_ERR_CLOSED);
+
+	pCmds = new packetbuf[nParams];
+	pResps = new packetbuf[nParams];
+	ppDest = new paramValue *[nParams];
+	pParamIndex = new size_t[nParams];
+	pCacheGen = new nodeulong[nParams];
+	if (theReadTimes)
+		pDoneAt = new double[nParams];
+
+	// Build a get parameter command for each one that needs the node
+	for (iParam = 0; iParam < nParams; iParam++) {
+		if (coreController(theMultiAddrs[iParam]) != cNum)
+			continue;
+		pNodeInfo = &SysInventory[cNum].NodeInfo[NODE_ADDR(theMultiAddrs[iParam])];
+		coreParam.bits = theParams[iParam];
+		if (pNodeInfo->paramBankList == NULL
+		|| coreParam.fld.option
+		|| coreParam.fld.bank >= pNodeInfo->bankCount)
+			continue;
+		pParamBank = &(pNodeInfo->paramBankList)[coreParam.fld.bank];
+		if (coreParam.fld.param >= pParamBank->nParams)
+			continue;
+		pFixedInfoDB = pParamBank->fixedInfoDB + coreParam.fld.param;
+		pValueDB = pParamBank->valueDB + coreParam.fld.param;
+		// Same test as netGetParameterInfo
+		if ((((pFixedInfoDB->info.paramType & PT_RT) == 0)
+		     || coreValFresh(pValueDB))
+		  && pValueDB->exists
+		  && pValueDB->generation == coreValCacheGen(pNodeInfo, pParamBank)
+		  && (pFixedInfoDB->info.paramType != PT_NONE))
+			continue;
+		if (netGetParameterFmt(&pCmds[nCmds], NODE_ADDR(theMultiAddrs[iParam]),
+							   theParams[iParam]) != MN_OK)
+			continue;
+		// Initialize the command invariant information like netRunCommand
+		pCmds[nCmds].Fld.PktType = MN_PKT_TYPE_CMD;
+		pCmds[nCmds].Fld.Src = MN_SRC_HOST;
+		pCmds[nCmds].Fld.Mode = 0;
+		pCmds[nCmds].Fld.Zero1 = 0;
+		pCmds[nCmds].Byte.BufferSize = pCmds[nCmds].Fld.PktLen
+									 + MN_API_PACKET_HDR_LEN;
+		pParamIndex[nCmds] = iParam;
+		// Taken before the read so an invalidate during it is not lost
+		pCacheGen[nCmds] = coreValCacheGen(pNodeInfo, pParamBank);
+		ppDest[nCmds++] = pValueDB;
+	}
+
+	startAt = infcCoreTime();
+	if (nCmds)
+		theErr = infcRunCommandBatch(cNum, pCmds, pResps, nCmds, pDoneAt);
+
+	// Store the good responses like netGetParameterInfo would
+	for (iCmd = 0; iCmd < nCmds; iCmd++) {
+		packetbuf *pResp = &pResps[iCmd];
+		iParam = pParamIndex[iCmd];
+		pValueDB = ppDest[iCmd];
+		if (pResp->Byte.BufferSize == 0
+		|| (pResp->Fld.PktLen + MN_API_PACKET_HDR_LEN) != pResp->Byte.BufferSize
+		|| coreGenErrCode(cNum, pResp, pCmds[iCmd].Fld.Addr) != MN_OK)
+			continue;
+		if (netGetParameterExtract(pResp, &newVal.raw) != MN_OK)
+			continue;
+		pNodeInfo = &SysInventory[cNum].NodeInfo[NODE_ADDR(theMultiAddrs[iParam])];
+		coreParam.bits = theParams[iParam];
+		pParamBank = &(pNodeInfo->paramBankList)[coreParam.fld.bank];
+		fromBaseUnit(theMultiAddrs[iParam], coreParam, pNodeInfo,
+					 pParamBank->fixedInfoDB + coreParam.fld.param,
+					 pParamBank, &newVal);
+		// Publish whole, a reader never sees half of it
+		pShareLock = &SysInventory[cNum].SharedReadLock[NODE_ADDR(theMultiAddrs[iParam])];
+		pShareLock->Lock();
+		pValueDB->raw = newVal.raw;
+		pValueDB->value = newVal.value;
+		pValueDB->readTime = startAt;
+		pValueDB->fromGroup = TRUE;
+		pValueDB->generation = pCacheGen[iCmd];
+		pValueDB->exists = TRUE;
+		pShareLock->Unlock();
+		if (theReadTimes)
+			theReadTimes[iParam] = pDoneAt[iCmd];
+	}
+
+	delete[] pDoneAt;
+	delete[] pCacheGen;
+	delete[] pParamIndex;
+	delete[] ppDest;
+	delete[] pResps;
+	delete[] pCmds;
+	return(theErr);
+}
+/*																 !end!		*/
+/****************************************************************************/
+
  
 /*****************************************************************************
  *	NAME
@@ -2072,6 +2471,7 @@ cnErrCode netSetParameterInfo(
 	if (theErr == MN_OK	|| (coreParam.fld.param > pParamBank->nParams)) {
 		// Mark value OK if we sent OK
 		pVal->exists = (theErr == MN_OK);
+		pVal->generation = coreValCacheGen(pNodeInfo, pParamBank);
 		// Make copy of the value
 		newParamValue = *pVal;
 		paramChgObj.net = cNum;
@@ -2614,23 +3014,34 @@ void coreInvalidateValCache(netaddr cNum)
  *		coreInvalidateValCacheByNode
  *
  *	DESCRIPTION:
- *		Invalidate all the value cache items for a particular node
+ *		Invalidate all the value cache items for a particular node. The
+ *		values are not touched, bumping the generation makes the next
+ *		netGetParameterInfo of each one re-read it from the node.
  *
  *	SYNOPSIS: 															    */
 void coreInvalidateValCacheByNode(netaddr cNum, nodeaddr nodeAddr)
 {
-	unsigned bank, param;
-	paramBank *pBank;
+	SysInventory[cNum].NodeInfo[nodeAddr].valGeneration++;
+}
+/*																 !end!		*/
+/****************************************************************************/
 
-        for (bank=0; bank < SysInventory[cNum].NodeInfo[nodeAddr].bankCount; bank++) {
-            pBank = &SysInventory[cNum].NodeInfo[nodeAddr].paramBankList[bank];
-			for (param=0; pBank && param < pBank->nParams; param++) {
-				if (pBank && pBank->valueDB) {
-					pBank->valueDB[param].exists = FALSE;
-					pBank->valueDB[param].value = 0;
-				}
-            }
-        }
+
+/*****************************************************************************
+ *	NAME
+ *		coreInvalidateValCacheByBank
+ *
+ *	DESCRIPTION:
+ *		Invalidate the value cache items of one parameter bank of a node.
+ *
+ *	SYNOPSIS: 															    */
+void coreInvalidateValCacheByBank(netaddr cNum, nodeaddr nodeAddr,
+								  unsigned bank)
+{
+	byNodeDB *pNodeInfo = &SysInventory[cNum].NodeInfo[nodeAddr];
+
+	if (pNodeInfo->paramBankList && bank < pNodeInfo->bankCount)
+		pNodeInfo->paramBankList[bank].valGeneration++;
 }
 /*																 !end!		*/
 /****************************************************************************/
@@ -2678,6 +3089,7 @@ MN_EXPORT cnErrCode MN_DECL netClrParamCache(
 
 	// Kill the cached value and mark as unread
 	pBank->valueDB[pCrack.fld.param].exists = FALSE;
+	pBank->valueDB[pCrack.fld.param].fromGroup = FALSE;
 	pBank->valueDB[pCrack.fld.param].value = 0;
 
 	return(MN_OK);
@@ -2686,6 +3098,62 @@ MN_EXPORT cnErrCode MN_DECL netClrParamCache(
 
 
 
+//****************************************************************************
+//	NAME
+//		netSetParamMaxAge
+//
+//	DESCRIPTION:
+//		Set how old a real-time parameter's cached value may be and still
+//		be returned by netGetParameterInfo. Concurrent readers of the
+//		parameter share one node read. Zero, the default, reads the node
+//		every time. The setting lasts until the node is re-initialized.
+//
+//	RETURNS:
+//		#cnErrCode: MN_OK on success, otherwise a specific error
+//
+//	SYNOPSIS:
+MN_EXPORT cnErrCode MN_DECL netSetParamMaxAge(
+	multiaddr theMultiAddr,
+	mnParams parameter,
+	double maxAgeMsec)
+{
+	paramBank *pBank;
+	appNodeParam pCrack;
+	const paramInfoLcl *pFixedInfoDB;
+
+	pCrack.bits = parameter;
+
+	netaddr cNum = coreController(theMultiAddr);
+	nodeaddr nodeAddr = NODE_ADDR(theMultiAddr);
+	byNodeDB *pNodeInfo = &SysInventory[cNum].NodeInfo[nodeAddr];
+
+	// Is the address ok for this net
+	if (nodeAddr >= SysInventory[cNum].InventoryNow.NumOfNodes)
+		return(MN_ERR_PARAM_RANGE);
+
+	// Param out of range?
+	if (!pNodeInfo->paramBankList || pCrack.fld.option
+	|| pCrack.fld.bank >= pNodeInfo->bankCount)
+		return(MN_ERR_PARAM_RANGE);
+	pBank = &pNodeInfo->paramBankList[pCrack.fld.bank];
+	if (pBank->nParams <= pCrack.fld.param)
+		return(MN_ERR_PARAM_RANGE);
+
+	// Only real-time values are re-read, a clear-on-read value cannot be
+	// served twice
+	pFixedInfoDB = &pBank->fixedInfoDB[pCrack.fld.param];
+	if (!(pFixedInfoDB->info.paramType & PT_RT)
+	|| (pFixedInfoDB->info.paramType & PT_CLR)
+	|| maxAgeMsec < 0)
+		return(MN_ERR_BADARG);
+
+	pBank->valueDB[pCrack.fld.param].maxAge = float(maxAgeMsec);
+	return(MN_OK);
+}
+/****************************************************************************/
+
+
+
 //****************************************************************************
 //	NAME
 //		coreSetParamFromBytes
@@ -2757,6 +3225,57 @@ cnErrCode coreSetParamFromBytes(multiaddr theMultiAddr,
 /****************************************************************************/
 
 
+
+//****************************************************************************
+//	NAME
+//		coreSeedParamValue
+//
+//	DESCRIPTION:
+//		Fill the value database entry of <paramNum> from the byte string
+//		<pVal> as though it had just been read from the node. The entry is
+//		served from the cache until the next invalidate, no change callback
+//		is fired.
+//
+//	RETURNS:
+//		cnErrCode
+//
+//	SYNOPSIS:
+cnErrCode coreSeedParamValue(multiaddr theMultiAddr,
+							 nodeparam paramNum,
+							 const nodeuchar *pVal,
+							 unsigned sizeInBytes)
+{
+	appNodeParam coreParam;				// Parameter cracker
+	byNodeDB *pNodeInfo;				// Node Data
+	paramBank *pParamBank;				// Current parameter bank
+	paramValue *pTheVal;				// Ptr to current value item
+
+	pNodeInfo = &SysInventory[coreController(theMultiAddr)]
+					.NodeInfo[NODE_ADDR(theMultiAddr)];
+	if (pNodeInfo->paramBankList == NULL)
+		return(MN_ERR_PARAM_NOT_INIT);
+	coreParam.bits = paramNum;
+	if (coreParam.fld.option || pNodeInfo->bankCount <= coreParam.fld.bank)
+		return(MN_ERR_PARAM_RANGE);
+	pParamBank = pNodeInfo->paramBankList + coreParam.fld.bank;
+	if (pParamBank->nParams <= coreParam.fld.param
+	|| sizeInBytes > MN_API_PAYLOAD_MAX)
+		return(MN_ERR_PARAM_RANGE);
+	pTheVal = &pParamBank->valueDB[coreParam.fld.param];
+	memcpy(&pTheVal->raw.Byte.Buffer[0], pVal, sizeInBytes);
+	pTheVal->raw.Byte.BufferSize = sizeInBytes;
+	fromBaseUnit(theMultiAddr, coreParam, pNodeInfo,
+			   &pParamBank->fixedInfoDB[coreParam.fld.param], pParamBank,
+			   pTheVal);
+	pTheVal->fromGroup = FALSE;
+	pTheVal->readTime = infcCoreTime();
+	pTheVal->generation = coreValCacheGen(pNodeInfo, pParamBank);
+	pTheVal->exists = TRUE;
+	return(MN_OK);
+}
+/****************************************************************************/
+
+
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 /*  C O M M O N    C O N V E R T E R S   								   */
@@ -4272,6 +4791,52 @@ bailOut:
 //*****************************************************************************
 
 
+//*****************************************************************************
+//	NAME																	  *
+//		formatConfigValue
+//
+//	DESCRIPTION:
+/**
+	Format a parameter value the way it is written in a configuration file,
+	without the unit comment.
+
+	\param[in] info Parameter information structure for this parameter.
+	\param[in] paramVal The value to format.
+	\param[out] valStr Buffer for the formatted value.
+	\param[in] maxChars Size of \a valStr.
+**/
+//	SYNOPSIS:
+void formatConfigValue(
+	const paramInfo &info,
+	const paramValue &paramVal,
+	char *valStr,
+	size_t maxChars)
+{
+	if (info.unitType == BIT_FIELD) {
+		if (info.paramSize == 2)
+			snprintf(valStr, maxChars, "&H%04X", nodeulong(paramVal.value));
+		else
+			snprintf(valStr, maxChars, "&H%08X", nodeulong(paramVal.value));
+	}
+	else if (info.paramSize > 4) {
+		const size_t BYTE_REPR_WIDTH = 2;
+		char byteRepr[BYTE_REPR_WIDTH + 1];
+
+		memset(valStr, 0, maxChars);
+		strncpy(valStr, "&H", 2);
+		
+		for (int i = info.paramSize - 1; i >= 0; i--) {
+			snprintf(byteRepr, sizeof(byteRepr), "%02X", (unsigned char) paramVal.raw.Byte.Buffer[i]);
+			strncat(valStr, byteRepr, BYTE_REPR_WIDTH);
+		}
+	}
+	else
+		snprintf(valStr, maxChars, "%lf", paramVal.value);
+}
+//																			  *
+//*****************************************************************************
+
+
 //*****************************************************************************
 //	NAME																	  *
 //		setConfigItem
@@ -4332,25 +4897,8 @@ cnErrCode setConfigItem(
 		return theErr;
 	}
 	
-	if (info.unitType == BIT_FIELD) {
-		if (info.paramSize == 2)
-			snprintf(valStr, sizeof(valStr), "&H%04X", nodeulong(paramVal.value));
-		else
-			snprintf(valStr, sizeof(valStr), "&H%08X", nodeulong(paramVal.value));
-	}
-	else if (info.paramSize > 4) {
-		const size_t BYTE_REPR_WIDTH = 2;
-		char byteRepr[BYTE_REPR_WIDTH + 1];
-
-		memset(valStr, 0, sizeof(valStr));
-		strncpy(valStr, "&H", 2);
-		
-		for (int i = info.paramSize - 1; i >= 0; i--) {
-			snprintf(byteRepr, sizeof(byteRepr), "%02X", (unsigned char) paramVal.raw.Byte.Buffer[i]);
-			strncat(valStr, byteRepr, BYTE_REPR_WIDTH);
-		}
-	}
-	else {
+	formatConfigValue(info, paramVal, valStr, sizeof(valStr));
+	if (info.unitType != BIT_FIELD && info.paramSize <= 4) {
 		switch (info.unitType) {
 		case TIME_USEC:
 			unitStr = "usec";
@@ -4387,10 +4935,10 @@ cnErrCode setConfigItem(
 		default:
 			break;
 		}
-		if (unitStr) 
-			snprintf(valStr, sizeof(valStr), "%lf\t;(%s)", paramVal.value, unitStr);
-		else
-			snprintf(valStr, sizeof(valStr), "%lf", paramVal.value);
+		if (unitStr) {
+			size_t valLen = strlen(valStr);
+			snprintf(valStr+valLen, sizeof(valStr)-valLen, "\t;(%s)", unitStr);
+		}
 	}
 	// Check for issues
 	if ((size_t)info.keyID > sizeof(ConfigKeys)/sizeof(char *))
@@ -4410,36 +4958,29 @@ cnErrCode setConfigItem(
 
 //*****************************************************************************
 //	NAME																	  *
-//		getAndSetConfigItem
+//		getConfigItem
 //
 //	DESCRIPTION:
 /**
-	This functions retrieves the value in the configuration file and storing
-	it in the drive as run-time and non-volatile locations.
+	This function retrieves the value of a parameter from the configuration
+	file, stripped of any comment.
 
 	\param[in] d Point to the dictionary.
 	\param[in] theSection Section of file.
-	\param[in] theMultiAddr The address of the node to update.
- 	\param[in] theParam The parameter number in the drive.
 	\param[in] info Parameter information structure for this parameter.
+	\param[out] valStr Buffer for the value, at least CONFIG_ITEM_CHARS.
 **/
 //	SYNOPSIS:
-cnErrCode getAndSetConfigItem(
+#define SCAN_MAX "100"
+const size_t CONFIG_ITEM_CHARS = 150;
+cnErrCode getConfigItem(
 	dictionary *d,
 	const char *theSection,
-	multiaddr theMultiAddr,
-	nodeparam theParam,
-	const paramInfo &info)
+	const paramInfo &info,
+	char *valStr)
 {
-	#define SCAN_MAX "100"
-	const size_t MAX_ITEM_CHARS = 150;
-	char valStr[MAX_ITEM_CHARS], keyStr[MAX_ITEM_CHARS];
+	char keyStr[CONFIG_ITEM_CHARS];
 	const char* DEFAULT_VAL = "__XZYZY42__", *iniItem;
-	// Extract out the node address parts, the netGetFirmwareID verified the
-	// multi-address is OK.
-	//netaddr cNum = NET_NUM(theMultiAddr);
-	//nodeaddr theNode = NODE_ADDR(theMultiAddr);
-	cnErrCode theErr;
 	if ((size_t)info.keyID > sizeof(ConfigKeys) / sizeof(char *))
 		//throw "valkeys.h is too short";
 		throwSystemError("valkeys.h is too short");
@@ -4459,6 +5000,44 @@ cnErrCode getAndSetConfigItem(
 		_RPT0(_CRT_WARN, "Missing item value is null\n");
 		return	MN_ERR_FILE_BAD;
 	}
+	return MN_OK;
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		getAndSetConfigItem
+//
+//	DESCRIPTION:
+/**
+	This functions retrieves the value in the configuration file and storing
+	it in the drive as run-time and non-volatile locations.
+
+	\param[in] d Point to the dictionary.
+	\param[in] theSection Section of file.
+	\param[in] theMultiAddr The address of the node to update.
+ 	\param[in] theParam The parameter number in the drive.
+	\param[in] info Parameter information structure for this parameter.
+**/
+//	SYNOPSIS:
+cnErrCode getAndSetConfigItem(
+	dictionary *d,
+	const char *theSection,
+	multiaddr theMultiAddr,
+	nodeparam theParam,
+	const paramInfo &info)
+{
+	char valStr[CONFIG_ITEM_CHARS];
+	// Extract out the node address parts, the netGetFirmwareID verified the
+	// multi-address is OK.
+	//netaddr cNum = NET_NUM(theMultiAddr);
+	//nodeaddr theNode = NODE_ADDR(theMultiAddr);
+	cnErrCode theErr;
+	theErr = getConfigItem(d, theSection, info, valStr);
+	if (theErr != MN_OK)
+		return theErr;
 	size_t theLength = strlen(valStr);
 	if (info.paramSize > 4) {
 		// Parameter too wide to read as a nodelong; do byte-by-byte hex conversion
@@ -4552,44 +5131,301 @@ cnErrCode getAndSetConfigItem(
 }
 //																			  *
 //*****************************************************************************
- /// \endcond
+
+//*****************************************************************************
+//	NAME																	  *
+//		readConfigItems
+//
+//	DESCRIPTION:
+/**
+	Read the run-time and non-volatile values of a set of parameters from
+	a node in one pipelined burst.
+
+	\param[in] theMultiAddr The address of the node.
+	\param[in] nParams Number of parameters.
+	\param[in] theParams The run-time parameter numbers.
+	\param[out] ramVals Run-time value of each parameter.
+	\param[out] nvVals Non-volatile value of each parameter.
+	\param[out] gotVals Set where both values of a parameter were read.
+**/
+//	SYNOPSIS:
+static void readConfigItems(
+	multiaddr theMultiAddr,
+	size_t nParams,
+	const nodeparam *theParams,
+	paramValue *ramVals,
+	paramValue *nvVals,
+	bool *gotVals)
+{
+	netaddr cNum = coreController(theMultiAddr);
+	byNodeDB *pNodeInfo = &SysInventory[cNum].NodeInfo[NODE_ADDR(theMultiAddr)];
+	paramBank *pParamBank;
+	appNodeParam coreParam;
+	size_t iCmd, nCmds = 2*nParams;
+	packetbuf *pCmds = new packetbuf[nCmds];
+	packetbuf *pResps = new packetbuf[nCmds];
+	bool *pGot = new bool[nCmds];
+	bool fmtOK = true;
+
+	// Even commands read the run-time value, odd ones the non-volatile
+	for (iCmd = 0; iCmd < nCmds && fmtOK; iCmd++) {
+		fmtOK = netGetParameterFmt(&pCmds[iCmd], NODE_ADDR(theMultiAddr),
+			theParams[iCmd/2] + ((iCmd & 1) ? PARAM_OPT_MASK : 0)) == MN_OK;
+		// Initialize the command invariant information like netRunCommand
+		pCmds[iCmd].Fld.PktType = MN_PKT_TYPE_CMD;
+		pCmds[iCmd].Fld.Src = MN_SRC_HOST;
+		pCmds[iCmd].Fld.Mode = 0;
+		pCmds[iCmd].Fld.Zero1 = 0;
+		pCmds[iCmd].Byte.BufferSize = pCmds[iCmd].Fld.PktLen
+									+ MN_API_PACKET_HDR_LEN;
+	}
+	// Failures are picked up from the responses
+	if (fmtOK)
+		infcRunCommandBatch(cNum, pCmds, pResps, nCmds, NULL);
+
+	for (iCmd = 0; iCmd < nCmds; iCmd++) {
+		packetbuf *pResp = &pResps[iCmd];
+		paramValue *pVal = (iCmd & 1) ? &nvVals[iCmd/2] : &ramVals[iCmd/2];
+		pGot[iCmd] = false;
+		if (!fmtOK
+		|| pResp->Byte.BufferSize == 0
+		|| (pResp->Fld.PktLen + MN_API_PACKET_HDR_LEN) != pResp->Byte.BufferSize
+		|| coreGenErrCode(cNum, pResp, pCmds[iCmd].Fld.Addr) != MN_OK
+		|| netGetParameterExtract(pResp, &pVal->raw) != MN_OK)
+			continue;
+		// Convert like netGetParameterInfo
+		coreParam.bits = theParams[iCmd/2] + ((iCmd & 1) ? PARAM_OPT_MASK : 0);
+		pParamBank = &pNodeInfo->paramBankList[coreParam.fld.bank];
+		fromBaseUnit(theMultiAddr, coreParam, pNodeInfo,
+					 pParamBank->fixedInfoDB + coreParam.fld.param,
+					 pParamBank, pVal);
+		pGot[iCmd] = true;
+	}
+	for (iCmd = 0; iCmd < nParams; iCmd++)
+		gotVals[iCmd] = pGot[2*iCmd] && pGot[2*iCmd+1];
+
+	delete[] pGot;
+	delete[] pResps;
+	delete[] pCmds;
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		loadConfigItemsDiff
+//
+//	DESCRIPTION:
+/**
+	Load the motor and node sections of the configuration file into the
+	node, writing only the items whose run-time or non-volatile value does
+	not match the file.
+
+	The node's values are read in pipelined bursts. Writing an item can
+	change how others convert, so the items not written yet are read again
+	after each pass of writes until a pass writes nothing. Each item is
+	written at most once.
+
+	The configuration is poisoned just before the first write, so a load
+	that finds nothing to change writes nothing at all.
+
+	\param[in] d Point to the dictionary.
+	\param[in] theMultiAddr The address of the node to update.
+	\param[in] firmwareID Section holding the node items.
+	\param[in] isAdvanced Load the advanced items as well.
+	\param[out] pWritten Number of items written.
+
+	\return MN_OK unless the poisoning failed.
+**/
+//	SYNOPSIS:
+static cnErrCode loadConfigItemsDiff(
+	dictionary *d,
+	multiaddr theMultiAddr,
+	const char *firmwareID,
+	bool isAdvanced,
+	size_t *pWritten)
+{
+	netaddr cNum = NET_NUM(theMultiAddr);
+	byNodeDB &nodeInfo = SysInventory[cNum].NodeInfo[NODE_ADDR(theMultiAddr)];
+	char fileStr[CONFIG_ITEM_CHARS], nodeStr[CONFIG_ITEM_CHARS];
+	size_t nItems = 0, nPending, iItem, iPend, nWritten, nTotal = 0;
+	cnErrCode theErr = MN_OK;
+
+	for (size_t bank = 0; bank < nodeInfo.bankCount; bank++)
+		nItems += nodeInfo.paramBankList[bank].nParams;
+	// Worst case every parameter is in both sections
+	nItems *= 2;
+	nodeparam *pParams = new nodeparam[nItems];
+	const paramInfo **ppInfo = new const paramInfo *[nItems];
+	const char **ppSection = new const char *[nItems];
+	size_t *pPending = new size_t[nItems];
+	nodeparam *pReadParams = new nodeparam[nItems];
+	paramValue *pRamVals = new paramValue[nItems];
+	paramValue *pNvVals = new paramValue[nItems];
+	bool *pGotVals = new bool[nItems];
+
+	// Motor parts first, then the rest like netConfigLoad
+	nItems = 0;
+	for (int pass = 0; pass < 2; pass++) {
+		for (size_t bank = 0; bank < nodeInfo.bankCount; bank++) {
+			for (size_t pIndx = 0; pIndx < nodeInfo.paramBankList[bank].nParams;
+				 pIndx++) {
+				const paramInfo &p
+					= nodeInfo.paramBankList[bank].fixedInfoDB[pIndx].info;
+				if (p.paramType & PT_IN_FACT_CFG)
+					continue;
+				if (pass == 0 ? !(p.paramType & PT_IN_MTR_CFG)
+					: (!(p.paramType & PT_IN_NODE_CFG)
+					   || ((p.paramType & PT_ADV) && !isAdvanced)))
+					continue;
+				pParams[nItems] = nodeparam(256*bank+pIndx);
+				ppInfo[nItems] = &p;
+				ppSection[nItems] = pass == 0 ? MOTOR_SECTION : firmwareID;
+				pPending[nItems] = nItems;
+				nItems++;
+			}
+		}
+	}
+
+	nPending = nItems;
+	do {
+		for (iPend = 0; iPend < nPending; iPend++)
+			pReadParams[iPend] = pParams[pPending[iPend]];
+		readConfigItems(theMultiAddr, nPending, pReadParams,
+						pRamVals, pNvVals, pGotVals);
+		// Write what differs, keep the matches to check again
+		size_t nStillPending = 0;
+		nWritten = 0;
+		for (iPend = 0; iPend < nPending; iPend++) {
+			iItem = pPending[iPend];
+			if (getConfigItem(d, ppSection[iItem], *ppInfo[iItem],
+							  fileStr) != MN_OK)
+				continue;
+			if (pGotVals[iPend]) {
+				formatConfigValue(*ppInfo[iItem], pRamVals[iPend],
+								  nodeStr, sizeof(nodeStr));
+				bool same = strcmp(fileStr, nodeStr) == 0;
+				formatConfigValue(*ppInfo[iItem], pNvVals[iPend],
+								  nodeStr, sizeof(nodeStr));
+				if (same && strcmp(fileStr, nodeStr) == 0) {
+					pPending[nStillPending++] = iItem;
+					continue;
+				}
+			}
+			// Poison the configuration in case of failure
+			if (nTotal + nWritten == 0) {
+				theErr = netSetParameterDbl(theMultiAddr, MN_P_EE_UPD_ACK, 0);
+				if (theErr != MN_OK) {
+					_RPT1(_CRT_WARN,"Failed config poisoning err %0X\n", theErr);
+					break;
+				}
+			}
+			getAndSetConfigItem(d, ppSection[iItem], theMultiAddr,
+								pParams[iItem], *ppInfo[iItem]);
+			nWritten++;
+		}
+		nPending = nStillPending;
+		nTotal += nWritten;
+	} while (theErr == MN_OK && nWritten && nPending);
+
+	delete[] pGotVals;
+	delete[] pNvVals;
+	delete[] pRamVals;
+	delete[] pReadParams;
+	delete[] pPending;
+	delete[] ppSection;
+	delete[] ppInfo;
+	delete[] pParams;
+	*pWritten = nTotal;
+	return theErr;
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		configIsFinalized
+//
+//	DESCRIPTION:
+/**
+	Return true if the node already holds a finished load of \a pFilePath:
+	the file name matches, the modified indicator is clear and both update
+	acknowledgements match. A diff load that writes nothing can then leave
+	the node untouched.
+
+	\param[in] theMultiAddr The node.
+	\param[in] pFilePath File being loaded.
+**/
+//	SYNOPSIS:
+static bool configIsFinalized(
+	multiaddr theMultiAddr,
+	const char *pFilePath)
+{
+	char nodeFile[MN_FILENAME_SIZE], cfgFileName[MN_FILENAME_SIZE];
+	double changed, eeVer, eeAck, romSum, romAck;
+
+	if (cpmGetMotorFileName(theMultiAddr, nodeFile, sizeof(nodeFile)) != MN_OK
+	|| strcmp(nodeFile, extractFileNameBase(pFilePath, cfgFileName,
+											sizeof(cfgFileName))) != 0)
+		return false;
+	if (cpmGetParameter(theMultiAddr, CPM_P_DRV_CONFIG_CHANGED, &changed) != MN_OK
+	|| changed != 0)
+		return false;
+	if (netGetParameterDbl(theMultiAddr, MN_P_EE_VER, &eeVer) != MN_OK
+	|| netGetParameterDbl(theMultiAddr, MN_P_EE_UPD_ACK, &eeAck) != MN_OK
+	|| netGetParameterDbl(theMultiAddr, MN_P_ROM_SUM, &romSum) != MN_OK
+	|| netGetParameterDbl(theMultiAddr, MN_P_ROM_SUM_ACK, &romAck) != MN_OK)
+		return false;
+	return eeVer == eeAck && romSum == romAck;
+}
+//																			  *
+//*****************************************************************************
 
 
 //******************************************************************************
 //	NAME																	   *
-//		netConfigLoad
+//		configLoadNode
 //
 //	DESCRIPTION:
 /**
-	Query the node and build up the firmware ID used as the key for 
-	a configuration file. This is in the format:
-		TEK32{moniker}{model}-{amps}-{pwba}
+	Load \a pFilePath into one node as #netConfigLoad does, except that a
+	due restart is left to the caller.
 
 	\param[in] theMultiAddr The address code for this node.
- 	\param[in] loadFmt Expected format of the data  
+ 	\param[in] loadFmt Expected format of the data
 	\param[in] pFilePath Pointer to configuration file.
-	
+	\param[out] pRestartDue Set true if the node must be restarted to use
+	the new settings. This is always so for CLASSIC, and for CLASSIC_DIFF
+	when items were written.
 **/
 //	SYNOPSIS:
-MN_EXPORT cnErrCode MN_DECL netConfigLoad(
+static cnErrCode configLoadNode(
 		multiaddr theMultiAddr,
 		configFmts loadFmt,
-		const char *pFilePath)
+		const char *pFilePath,
+		bool *pRestartDue)
 {
 	dictionary *d;
 	char firmwareID[20];
 	char keyStr[100];
+	char nodeStr[100];
 	cnErrCode theErr;
 	bool isAdvanced = false;
 	bool hasMtrPart = false;
 	bool hasNodePart = false;
+	size_t nWritten = 0;
+	bool idsChanged = false;
  	// Extract out the node address parts, the netGetFirmwareID verified the
 	// multi-address is OK.
 	netaddr cNum = NET_NUM(theMultiAddr);
 	nodeaddr theNode = NODE_ADDR(theMultiAddr);
 
+	*pRestartDue = false;
 	// TODO: add other formats
-	if (loadFmt != CLASSIC && loadFmt != CLASSIC_NO_RESET)
+	if (loadFmt != CLASSIC && loadFmt != CLASSIC_NO_RESET
+	&& loadFmt != CLASSIC_DIFF)
 		return MN_ERR_NOT_IMPL;
 
 	// Make sure node is not enabled
@@ -4670,48 +5506,68 @@ MN_EXPORT cnErrCode MN_DECL netConfigLoad(
 		theErr = MN_ERR_FILE_WRONG;
 		goto bailOut;
 	}
-	// Poison the configuration in case of failure
-	theErr = netSetParameterDbl(theMultiAddr, MN_P_EE_UPD_ACK, 0);
-	if (theErr != MN_OK) {
-		_RPT1(_CRT_WARN,"Failed config poisoning err %0X\n", theErr);
-		goto bailOut;
+	// The node's cached values no longer describe it
+	coreParamCacheForget(theMultiAddr);
+	// Poison the configuration in case of failure, the diff load does
+	// this before its first write
+	if (loadFmt != CLASSIC_DIFF) {
+		theErr = netSetParameterDbl(theMultiAddr, MN_P_EE_UPD_ACK, 0);
+		if (theErr != MN_OK) {
+			_RPT1(_CRT_WARN,"Failed config poisoning err %0X\n", theErr);
+			goto bailOut;
+		}
 	}
 	try {
-		// Load the motor parts first
-		for (size_t bank=0; bank < SysInventory[cNum].NodeInfo[theNode].bankCount; bank++) {
-			for (size_t pIndx=0; 
-				pIndx < SysInventory[cNum].NodeInfo[theNode].paramBankList[bank].nParams ;
-				pIndx++) {
-					const paramInfo &p 
-						= SysInventory[cNum].NodeInfo[theNode].paramBankList[bank].fixedInfoDB[pIndx].info;
-					if ((p.paramType & PT_IN_MTR_CFG) && !(p.paramType & PT_IN_FACT_CFG)) {
-						getAndSetConfigItem(d, MOTOR_SECTION, theMultiAddr, 
-											nodeparam(256*bank+pIndx), p);
-					}
+		if (loadFmt == CLASSIC_DIFF) {
+			theErr = loadConfigItemsDiff(d, theMultiAddr, firmwareID,
+										 isAdvanced, &nWritten);
+			if (theErr != MN_OK)
+				goto bailOut;
+		}
+		else {
+			// Load the motor parts first
+			for (size_t bank=0; bank < SysInventory[cNum].NodeInfo[theNode].bankCount; bank++) {
+				for (size_t pIndx=0; 
+					pIndx < SysInventory[cNum].NodeInfo[theNode].paramBankList[bank].nParams ;
+					pIndx++) {
+						const paramInfo &p 
+							= SysInventory[cNum].NodeInfo[theNode].paramBankList[bank].fixedInfoDB[pIndx].info;
+						if ((p.paramType & PT_IN_MTR_CFG) && !(p.paramType & PT_IN_FACT_CFG)) {
+							getAndSetConfigItem(d, MOTOR_SECTION, theMultiAddr, 
+												nodeparam(256*bank+pIndx), p);
+						}
 
+				}
 			}
-		}
-		// Load the rest of the configuration
-		for (size_t bank=0; bank < SysInventory[cNum].NodeInfo[theNode].bankCount; bank++) {
-			for (size_t pIndx=0; 
-				pIndx < SysInventory[cNum].NodeInfo[theNode].paramBankList[bank].nParams ;
-				pIndx++) {
-					const paramInfo &p 
-						= SysInventory[cNum].NodeInfo[theNode].paramBankList[bank].fixedInfoDB[pIndx].info;
-					// Load if a non factory config item and skip advanced 
-					// items when we are not advanced.
-					if ((p.paramType & PT_IN_NODE_CFG) && !(p.paramType & PT_IN_FACT_CFG)
-					&& (!(p.paramType & PT_ADV) || (isAdvanced && (p.paramType & PT_ADV)))) {
-						getAndSetConfigItem(d, firmwareID, theMultiAddr, 
-											nodeparam(256*bank+pIndx), p);
-					}
+			// Load the rest of the configuration
+			for (size_t bank=0; bank < SysInventory[cNum].NodeInfo[theNode].bankCount; bank++) {
+				for (size_t pIndx=0; 
+					pIndx < SysInventory[cNum].NodeInfo[theNode].paramBankList[bank].nParams ;
+					pIndx++) {
+						const paramInfo &p 
+							= SysInventory[cNum].NodeInfo[theNode].paramBankList[bank].fixedInfoDB[pIndx].info;
+						// Load if a non factory config item and skip advanced 
+						// items when we are not advanced.
+						if ((p.paramType & PT_IN_NODE_CFG) && !(p.paramType & PT_IN_FACT_CFG)
+						&& (!(p.paramType & PT_ADV) || (isAdvanced && (p.paramType & PT_ADV)))) {
+							getAndSetConfigItem(d, firmwareID, theMultiAddr, 
+												nodeparam(256*bank+pIndx), p);
+						}
 
+				}
 			}
 		}
 		// Restore the user ID
 		snprintf(keyStr, sizeof(keyStr), "%s:%s", (const char *)firmwareID, CNFG_USERID);
 		theItem = iniparser_getstring(d, keyStr, "");
-		theErr = netSetUserID(theMultiAddr, theItem);
+		if (loadFmt == CLASSIC_DIFF
+		&& netGetUserID(theMultiAddr, nodeStr, sizeof(nodeStr)) == MN_OK
+		&& strcmp(nodeStr, theItem) == 0)
+			theErr = MN_OK;
+		else {
+			idsChanged = true;
+			theErr = netSetUserID(theMultiAddr, theItem);
+		}
 		if (theErr != MN_OK) {
 			_RPT1(_CRT_WARN, "Failed to set user ID, err=0x%x\n", theErr);
 			goto bailOut;
@@ -4719,11 +5575,24 @@ MN_EXPORT cnErrCode MN_DECL netConfigLoad(
 		// Restore the user description
 		snprintf(keyStr, sizeof(keyStr), "%s:%s", (const char *)firmwareID, CNFG_USER_DESC);
 		theItem = iniparser_getstring(d, keyStr, "");
-		theErr = netSetUserDescription(theMultiAddr, theItem);
+		if (loadFmt == CLASSIC_DIFF
+		&& netGetUserDescription(theMultiAddr, nodeStr, sizeof(nodeStr)) == MN_OK
+		&& strcmp(nodeStr, theItem) == 0)
+			theErr = MN_OK;
+		else {
+			idsChanged = true;
+			theErr = netSetUserDescription(theMultiAddr, theItem);
+		}
 		if (theErr != MN_OK) {
 			_RPT1(_CRT_WARN, "Failed to set user description, err=0x%x\n", theErr);
 			goto bailOut;
 		}
+		// Nothing differed and the last load finished, leave the node be
+		if (loadFmt == CLASSIC_DIFF && nWritten == 0 && !idsChanged
+		&& configIsFinalized(theMultiAddr, pFilePath)) {
+			theErr = MN_OK;
+			goto bailOut;
+		}
 		double paramVal;
 		// We have succeeded, update EE and ROM Ack parameters to clear any
 		// errors.
@@ -4754,15 +5623,10 @@ MN_EXPORT cnErrCode MN_DECL netConfigLoad(
 			_RPT1(_CRT_WARN,"Failed config finalize err %0X\n", theErr);
 			goto bailOut;
 		}
-		if (loadFmt != CLASSIC_NO_RESET){
-			// All Done, Restart node to insure its using the new settings
-			theErr = mnRestartNode(theMultiAddr);
-			if (theErr != MN_OK) {
-				_RPT1(_CRT_WARN, "Failed to restart, err=0x%x\n", theErr);
-				goto bailOut;
-			}
-		}
-		else{
+		// Written items only take effect after a restart
+		if (loadFmt == CLASSIC || (loadFmt == CLASSIC_DIFF && nWritten > 0))
+			*pRestartDue = true;
+		else {
 			theErr = netAlertClear(theMultiAddr);
 			if (theErr != MN_OK) {
 				_RPT1(_CRT_WARN, "Failed to clear shutdowns, err=0x%x\n", theErr);
@@ -4782,6 +5646,159 @@ bailOut:
 	return theErr;
 }
 //																			  *
+//*****************************************************************************
+ /// \endcond
+
+
+//******************************************************************************
+//	NAME																	   *
+//		netConfigLoad
+//
+//	DESCRIPTION:
+/**
+	Query the node and build up the firmware ID used as the key for 
+	a configuration file. This is in the format:
+		TEK32{moniker}{model}-{amps}-{pwba}
+
+	A CLASSIC load, and a CLASSIC_DIFF load that wrote items, restarts
+	the node at the end so it uses the new settings. A CLASSIC_DIFF load
+	that finds nothing to change writes nothing.
+
+	\param[in] theMultiAddr The address code for this node.
+ 	\param[in] loadFmt Expected format of the data  
+	\param[in] pFilePath Pointer to configuration file.
+	
+**/
+//	SYNOPSIS:
+MN_EXPORT cnErrCode MN_DECL netConfigLoad(
+		multiaddr theMultiAddr,
+		configFmts loadFmt,
+		const char *pFilePath)
+{
+	bool restartDue;
+	cnErrCode theErr = configLoadNode(theMultiAddr, loadFmt, pFilePath,
+									  &restartDue);
+	if (theErr == MN_OK && restartDue) {
+		// All Done, Restart node to insure its using the new settings
+		theErr = mnRestartNode(theMultiAddr);
+		if (theErr != MN_OK) {
+			_RPT1(_CRT_WARN, "Failed to restart, err=0x%x\n", theErr);
+		}
+	}
+	return theErr;
+}
+//																			  *
+//*****************************************************************************
+
+//*****************************************************************************
+//	NAME																	  *
+//		configLoadThread
+//
+//	DESCRIPTION:
+//		Worker running one node's netConfigLoad for netConfigLoadPort.
+//
+//	SYNOPSIS:
+class configLoadThread : public CThread {
+public:
+	multiaddr m_addr;					// Node loaded
+	configFmts m_fmt;					// Load format
+	const char *m_pFilePath;			// File loaded
+	cnErrCode m_result;					// Result of the load
+	bool m_restartDue;					// Node needs a restart
+	CCEvent m_done;						// Set when the load finishes
+	int Run(void * /*context*/) {
+		m_result = configLoadNode(m_addr, m_fmt, m_pFilePath, &m_restartDue);
+		m_done.SetEvent();
+		return 0;
+	}
+};
+//																			  *
+//*****************************************************************************
+
+
+//******************************************************************************
+//	NAME																	   *
+//		netConfigLoadPort
+//
+//	DESCRIPTION:
+/**
+	Load a configuration file into each node on a port at the same time.
+	Each node is loaded as by #netConfigLoad on its own thread, the
+	commands of the nodes share the ring. Nodes that need a restart, every
+	node of a CLASSIC load and the nodes a CLASSIC_DIFF load wrote to, are
+	restarted one at a time after every load finishes. A node that loaded
+	is restarted even if another node's load or restart failed.
+
+	\param[in] cNum The port.
+ 	\param[in] loadFmt Expected format of the data, CLASSIC_DIFF writes
+	only the items that differ.
+	\param[in] nNodes Number of entries in \a pFilePaths.
+	\param[in] pFilePaths Configuration file of each node by address, NULL
+	to skip the node.
+
+	\return MN_OK if every node loaded and restarted, else the first
+	error, the loads' before the restarts'.
+**/
+//	SYNOPSIS:
+MN_EXPORT cnErrCode MN_DECL netConfigLoadPort(
+		netaddr cNum,
+		configFmts loadFmt,
+		size_t nNodes,
+		const char *const *pFilePaths)
+{
+	configLoadThread *pLoaders;
+	cnErrCode theErr = MN_OK, restartErr;
+	size_t iNode;
+
+	if (cNum >= NET_CONTROLLER_MAX)
+		return MN_ERR_DEV_ADDR;
+	if (!pFilePaths || nNodes > SysInventory[cNum].InventoryNow.NumOfNodes)
+		return MN_ERR_BADARG;
+
+	pLoaders = new configLoadThread[nNodes];
+	for (iNode = 0; iNode < nNodes; iNode++) {
+		pLoaders[iNode].m_addr = MULTI_ADDR(cNum, iNode);
+		// A restart would disturb the other loads, the loaders leave them
+		// for afterwards
+		pLoaders[iNode].m_fmt = loadFmt;
+		pLoaders[iNode].m_pFilePath = pFilePaths[iNode];
+		pLoaders[iNode].m_result = MN_OK;
+		pLoaders[iNode].m_restartDue = false;
+		if (!pFilePaths[iNode])
+			continue;
+		try {
+			pLoaders[iNode].LaunchThread();
+		}
+		catch (...) {
+			// Load it here instead
+			pLoaders[iNode].Run(NULL);
+		}
+	}
+	for (iNode = 0; iNode < nNodes; iNode++) {
+		if (!pFilePaths[iNode])
+			continue;
+		pLoaders[iNode].m_done.WaitFor();
+		pLoaders[iNode].TerminateAndWait();
+		if (theErr == MN_OK)
+			theErr = pLoaders[iNode].m_result;
+	}
+
+	// Restart every loaded node to insure it uses the new settings
+	for (iNode = 0; iNode < nNodes; iNode++) {
+		if (!pFilePaths[iNode] || !pLoaders[iNode].m_restartDue)
+			continue;
+		restartErr = mnRestartNode(MULTI_ADDR(cNum, iNode));
+		if (restartErr != MN_OK) {
+			_RPT2(_CRT_WARN, "Failed to restart node %d, err=0x%x\n",
+				  int(iNode), restartErr);
+			if (theErr == MN_OK)
+				theErr = restartErr;
+		}
+	}
+	delete[] pLoaders;
+	return theErr;
+}
+//																			  *
 //*****************************************************************************
 //*****************************************************************************
 //	NAME																	  *
@@ -0,0 +1,586 @@
+//*****************************************************************************
+// NAME
+//		paramCache.cpp
+//
+// DESCRIPTION:
+/**
+		\file
+		On-disk cache of the parameter values a node keeps between power
+		cycles.
+
+		The parameter descriptions are compiled into the driver, what an
+		open spends its time on is reading the values. A cache file holds
+		the read-only values of a node and, while the node is running the
+		configuration last loaded into it, its non-volatile values. The
+		file is named by the node's serial number, firmware version and
+		part number and is only used when the firmware checksum, the
+		non-volatile layout version, the non-volatile modified counter and
+		the configuration file name the node reports still match it. The
+		node clears its modified counter on every configuration load, so a
+		sample of the non-volatile values is also read back and compared.
+
+		The file is written when the node is deleted, from the values the
+		session read. Opening a node reads nothing for the cache beyond
+		its identity and the sample.
+**/
+//
+// CREATION DATE:
+//		10/18/2026 08:05:12
+//
+// COPYRIGHT NOTICE:
+//		(C)Copyright 2026  Teknic, Inc.  All rights reserved.
+//
+//		This copyright notice must be reproduced in any copy, modification,
+//		or portion thereof merged into another program. A copy of the
+//		copyright notice must be included in the object library of a user
+//		program.
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	paramCache.cpp headers
+//
+	#include "paramCache.h"
+	#include "meridianHdrs.h"
+	#include "netCmdAPI.h"
+	#include "netCmdPrivate.h"
+	#include "lnkAccessCommon.h"
+	#include <stdio.h>
+	#include <string.h>
+	#include <ctype.h>
+
+#if defined(_MSC_VER)
+	#pragma warning(disable:4996)
+	#if _MSC_VER<=1800
+	#define snprintf sprintf_s
+	#endif
+#endif
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	paramCache.cpp types
+//
+#pragma pack(push,1)
+// File header
+typedef struct _paramCacheHdr {
+	Uint32 magic;						// PARAM_CACHE_MAGIC
+	Uint16 version;						// PARAM_CACHE_VERSION
+	paramCacheKey key;					// Node state when written
+	Uint16 nvValid;						// Non-volatile values included
+	Uint16 nItems;						// Values that follow
+} paramCacheHdr;
+// Each value, followed by <size> raw octets
+typedef struct _paramCacheItem {
+	Uint16 param;						// Parameter number
+	Uint8 size;							// Raw octets
+} paramCacheItem;
+#pragma pack(pop)
+// A value read from the file
+typedef struct _paramCacheFileItem {
+	nodeparam param;					// Parameter number
+	unsigned size;						// Raw octets
+	bool isNV;							// Non-volatile value
+	bool isCfg;							// Configuration file item
+	nodeuchar raw[MN_API_PAYLOAD_MAX];	// Raw value
+} paramCacheFileItem;
+// Cache state of a node set up this session
+typedef struct _paramCacheNode {
+	bool active;						// Set up with the cache on
+	bool fileCurrent;					// File held everything it could
+	bool nvOK;							// Non-volatile values were seeded
+	size_t nSeeded;						// Values seeded from the file
+	nodeulong startGen;					// Value generations at set up
+	paramCacheKey key;					// Node state at set up
+} paramCacheNode;
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	paramCache.cpp static variables
+//
+	extern mnNetInvRecords SysInventory[NET_CONTROLLER_MAX];
+	// Cache directory, empty when the cache is off
+	static char cacheDir[PARAM_CACHE_PATH_MAX] = "";
+	static CCCriticalSection cacheDirLock;
+	// Nodes set up with the cache on
+	static paramCacheNode cacheNodes[NET_CONTROLLER_MAX][MN_API_MAX_NODES];
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		netSetParamCacheDir
+//
+//	DESCRIPTION:
+/**
+	Set the directory the node parameter cache files are kept in. Nodes
+	set up after this call are seeded from their cache file and write it
+	from the values read when they are deleted.
+
+	\param[in] dirPath Existing directory, NULL or empty to turn the cache
+	off.
+
+	\return MN_OK if the setting was accepted.
+**/
+//	SYNOPSIS:
+MN_EXPORT cnErrCode MN_DECL netSetParamCacheDir(
+		const char *dirPath)
+{
+	size_t len = dirPath ? strlen(dirPath) : 0;
+	if (len >= PARAM_CACHE_PATH_MAX)
+		return(MN_ERR_BADARG);
+	// Trailing separators are added back when the name is built
+	while (len > 1 && (dirPath[len-1] == '/' || dirPath[len-1] == '\\'))
+		len--;
+	cacheDirLock.Lock();
+	if (len)
+		memcpy(cacheDir, dirPath, len);
+	cacheDir[len] = 0;
+	cacheDirLock.Unlock();
+	return(MN_OK);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		coreParamCacheOn
+//
+//	DESCRIPTION:
+//		Return true if a cache directory has been set.
+//
+//	SYNOPSIS:
+nodebool coreParamCacheOn()
+{
+	nodebool isOn;
+	cacheDirLock.Lock();
+	isOn = cacheDir[0] != 0;
+	cacheDirLock.Unlock();
+	return(isOn);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		coreParamCacheable
+//
+//	DESCRIPTION:
+//		Return true if the value of a parameter described by <info> outlives
+//		the session. Read-only values the driver already reads only once
+//		qualify, non-volatile values qualify when <withNV> is set. Real-time,
+//		clear-on-read and RAM values never do.
+//
+//	SYNOPSIS:
+nodebool coreParamCacheable(const paramInfo &info, nodebool withNV)
+{
+	if (info.paramType == PT_NONE || info.paramType == PT_UNKNOWN)
+		return(FALSE);
+	if (info.paramType & (PT_RT | PT_CLR | PT_VOL | PT_RAM))
+		return(FALSE);
+	if (info.paramType & PT_RO)
+		return(TRUE);
+	return(withNV && (info.paramType & PT_NV) != 0);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		cacheFilePath
+//
+//	DESCRIPTION:
+//		Build the cache file path for the node described by <key>. Characters
+//		of the part number that may not appear in a file name are replaced.
+//
+//	\return false if the cache is off or the path does not fit.
+//
+//	SYNOPSIS:
+static bool cacheFilePath(const paramCacheKey &key, char *pPath,
+						  size_t maxChars)
+{
+	char partName[MN_PART_NUM_SIZE+1];
+	size_t i;
+	int len;
+
+	for (i = 0; i < MN_PART_NUM_SIZE && key.partNum[i]; i++) {
+		partName[i] = isalnum((unsigned char)key.partNum[i])
+					|| key.partNum[i] == '-' ? key.partNum[i] : '_';
+	}
+	partName[i] = 0;
+
+	cacheDirLock.Lock();
+	len = cacheDir[0] ? snprintf(pPath, maxChars, "%s/%08X-%04X-%s.sfpc",
+								 cacheDir, key.serialNum, key.fwVers,
+								 partName)
+					  : -1;
+	cacheDirLock.Unlock();
+	return(len > 0 && size_t(len) < maxChars);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		nodeCacheGen
+//
+//	DESCRIPTION:
+//		Return the sum of the node's and its banks' value generations. It
+//		moves whenever any of the node's values is invalidated.
+//
+//	SYNOPSIS:
+static nodeulong nodeCacheGen(const byNodeDB *pNodeInfo)
+{
+	nodeulong gen = pNodeInfo->valGeneration;
+	for (unsigned iBank = 0; iBank < pNodeInfo->bankCount; iBank++)
+		gen += pNodeInfo->paramBankList[iBank].valGeneration;
+	return(gen);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		nvValuesCurrent
+//
+//	DESCRIPTION:
+//		Read up to PARAM_CACHE_NV_CHECKS of the file's configuration file
+//		items from the node in one burst and compare them with the file's
+//		copy. The node resets its modified counter on every configuration
+//		load, so a load of a different file under the same name is only seen
+//		this way. The items checked are spread evenly over the file.
+//
+//	\return true if every item checked reads back as the file holds it.
+//
+//	SYNOPSIS:
+static bool nvValuesCurrent(
+		multiaddr theMultiAddr,
+		byNodeDB *pNodeInfo,
+		const paramCacheFileItem *pItems,
+		size_t nItems)
+{
+	multiaddr addrs[PARAM_CACHE_NV_CHECKS];
+	nodeparam params[PARAM_CACHE_NV_CHECKS];
+	size_t index[PARAM_CACHE_NV_CHECKS];
+	size_t nCfg = 0, nChecks = 0, iCfg = 0, iItem;
+	appNodeParam coreParam;
+	paramValue val;
+
+	for (iItem = 0; iItem < nItems; iItem++) {
+		if (pItems[iItem].isCfg)
+			nCfg++;
+	}
+	for (iItem = 0; iItem < nItems && nChecks < PARAM_CACHE_NV_CHECKS; iItem++) {
+		if (!pItems[iItem].isCfg)
+			continue;
+		// Take the item when its share of the checks comes up
+		if ((iCfg++ * PARAM_CACHE_NV_CHECKS) / nCfg == nChecks) {
+			addrs[nChecks] = theMultiAddr;
+			params[nChecks] = pItems[iItem].param;
+			index[nChecks++] = iItem;
+		}
+	}
+	// Read the checks fresh
+	for (size_t iCheck = 0; iCheck < nChecks; iCheck++) {
+		coreParam.bits = params[iCheck];
+		pNodeInfo->paramBankList[coreParam.fld.bank]
+			.valueDB[coreParam.fld.param].exists = FALSE;
+	}
+	if (netGetParameterGroup(NET_NUM(theMultiAddr), nChecks, addrs, params,
+							 NULL) != MN_OK)
+		return(false);
+	for (size_t iCheck = 0; iCheck < nChecks; iCheck++) {
+		const paramCacheFileItem &item = pItems[index[iCheck]];
+		if (netGetParameterInfo(theMultiAddr, mnParams(params[iCheck]), NULL,
+								&val) != MN_OK
+		|| val.raw.Byte.BufferSize != item.size
+		|| memcmp(val.raw.Byte.Buffer, item.raw, item.size)) {
+			_RPT1(_CRT_WARN, "paramCache: node %d non-volatile values "
+				  "changed, not used\n", theMultiAddr);
+			return(false);
+		}
+	}
+	return(true);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		coreParamCacheLoad
+//
+//	DESCRIPTION:
+/**
+	Seed the value database of a node from its cache file and remember the
+	node's state for #coreParamCacheSave. The read-only values are used
+	when the firmware checksum and non-volatile layout match. The
+	non-volatile values are used when the node reports no change since the
+	configuration file it was written with and a sample of them read back
+	from the node matches the file.
+
+	\param[in] theMultiAddr The node, its database is set up.
+	\param[in] key The node's identity and state just read from it.
+
+	\return MN_OK if every value the node's state allows was seeded. Other
+	codes mean the file is missing, stale or lacks the non-volatile values;
+	the values it did seed are good.
+**/
+//	SYNOPSIS:
+cnErrCode coreParamCacheLoad(
+		multiaddr theMultiAddr,
+		const paramCacheKey &key)
+{
+	char path[PARAM_CACHE_PATH_MAX+64];
+	paramCacheHdr hdr;
+	paramCacheItem item;
+	paramCacheFileItem *pItems = NULL;
+	appNodeParam coreParam;
+	byNodeDB *pNodeInfo;
+	paramBank *pParamBank;
+	paramCacheNode *pNode;
+	nodebool withNV;
+	cnErrCode theErr = MN_OK;
+	size_t nItems = 0;
+	FILE *fi;
+
+	pNodeInfo = &SysInventory[NET_NUM(theMultiAddr)].NodeInfo[NODE_ADDR(theMultiAddr)];
+	if (pNodeInfo->paramBankList == NULL)
+		return(MN_ERR_PARAM_NOT_INIT);
+	// Remember the node so the values read this session are saved
+	pNode = &cacheNodes[NET_NUM(theMultiAddr)][NODE_ADDR(theMultiAddr)];
+	pNode->active = true;
+	pNode->key = key;
+	pNode->fileCurrent = false;
+	pNode->nvOK = false;
+	pNode->nSeeded = 0;
+	pNode->startGen = nodeCacheGen(pNodeInfo);
+
+	if (!cacheFilePath(key, path, sizeof(path)))
+		return(MN_ERR_BADARG);
+	fi = fopen(path, "rb");
+	if (!fi)
+		return(MN_ERR_FILE_OPEN);
+	if (fread(&hdr, sizeof(hdr), 1, fi) != 1
+	|| hdr.magic != PARAM_CACHE_MAGIC || hdr.version != PARAM_CACHE_VERSION) {
+		fclose(fi);
+		return(MN_ERR_FILE_BAD);
+	}
+	// Same node running the same firmware and non-volatile layout?
+	if (hdr.key.serialNum != key.serialNum || hdr.key.fwVers != key.fwVers
+	|| hdr.key.romSum != key.romSum || hdr.key.eeVer != key.eeVer
+	|| strncmp(hdr.key.partNum, key.partNum, MN_PART_NUM_SIZE)) {
+		fclose(fi);
+		return(MN_ERR_FILE_WRONG);
+	}
+
+	// Collect the values this node has
+	pItems = new paramCacheFileItem[hdr.nItems];
+	for (unsigned iItem = 0; iItem < hdr.nItems; iItem++) {
+		if (fread(&item, sizeof(item), 1, fi) != 1
+		|| item.size > MN_API_PAYLOAD_MAX
+		|| fread(pItems[nItems].raw, 1, item.size, fi) != item.size) {
+			theErr = MN_ERR_FILE_BAD;
+			break;
+		}
+		coreParam.bits = item.param;
+		if (coreParam.fld.option || coreParam.fld.bank >= pNodeInfo->bankCount)
+			continue;
+		pParamBank = &pNodeInfo->paramBankList[coreParam.fld.bank];
+		if (coreParam.fld.param >= pParamBank->nParams
+		|| !coreParamCacheable(pParamBank->fixedInfoDB[coreParam.fld.param].info,
+							   TRUE))
+			continue;
+		const paramInfo &info = pParamBank->fixedInfoDB[coreParam.fld.param].info;
+		pItems[nItems].param = item.param;
+		pItems[nItems].size = item.size;
+		pItems[nItems].isNV = (info.paramType & PT_RO) == 0;
+		pItems[nItems++].isCfg = (info.paramType & PT_RO) == 0
+			&& (info.paramType & (PT_IN_NODE_CFG|PT_IN_MTR_CFG)) != 0;
+	}
+	fclose(fi);
+
+	// Non-volatile values are good while nothing changed since the same
+	// configuration file was loaded and they read back the same
+	withNV = theErr == MN_OK && hdr.nvValid && key.nvModified == 0
+		  && !strncmp(hdr.key.motorFile, key.motorFile, MN_FILENAME_SIZE)
+		  && nvValuesCurrent(theMultiAddr, pNodeInfo, pItems, nItems);
+
+	for (size_t iItem = 0; iItem < nItems; iItem++) {
+		if (pItems[iItem].isNV && !withNV)
+			continue;
+		if (coreSeedParamValue(theMultiAddr, pItems[iItem].param,
+							   pItems[iItem].raw, pItems[iItem].size) == MN_OK)
+			pNode->nSeeded++;
+	}
+	delete[] pItems;
+
+	pNode->nvOK = withNV;
+	// Node is clean but the file lacks its non-volatile values
+	if (theErr == MN_OK && !withNV && key.nvModified == 0)
+		theErr = MN_ERR_FILE_WRONG;
+	pNode->fileCurrent = theErr == MN_OK;
+	return(theErr);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		coreParamCacheSave
+//
+//	DESCRIPTION:
+/**
+	Write the cache file of a node from the values read from it this
+	session. Only values the database still holds as current are written,
+	nothing is read for the file. Non-volatile values are only written
+	while the node reported no change since its configuration file was
+	loaded and none of its values were invalidated since it was set up. A
+	file that already holds all the values the session read is left alone.
+	The file is written under a temporary name and renamed so a reader
+	never sees a partial file.
+
+	Call before the node's value database is freed.
+
+	\param[in] theMultiAddr The node.
+
+	\return MN_OK if the file was written or did not need to be.
+**/
+//	SYNOPSIS:
+cnErrCode coreParamCacheSave(
+		multiaddr theMultiAddr)
+{
+	char path[PARAM_CACHE_PATH_MAX+64], tmpPath[PARAM_CACHE_PATH_MAX+68];
+	netaddr cNum = NET_NUM(theMultiAddr);
+	paramCacheHdr hdr;
+	paramCacheItem item;
+	appNodeParam coreParam;
+	byNodeDB *pNodeInfo;
+	paramBank *pParamBank;
+	paramValue *pValueDB;
+	paramCacheNode *pNode;
+	nodebool withNV;
+	cnErrCode theErr = MN_OK;
+	unsigned iBank, iVal;
+	FILE *fo;
+
+	pNode = &cacheNodes[cNum][NODE_ADDR(theMultiAddr)];
+	if (!pNode->active)
+		return(MN_OK);
+	pNode->active = false;
+	pNodeInfo = &SysInventory[cNum].NodeInfo[NODE_ADDR(theMultiAddr)];
+	if (pNodeInfo->paramBankList == NULL)
+		return(MN_ERR_PARAM_NOT_INIT);
+	if (!cacheFilePath(pNode->key, path, sizeof(path)))
+		return(MN_ERR_BADARG);
+	withNV = pNode->key.nvModified == 0
+		  && nodeCacheGen(pNodeInfo) == pNode->startGen;
+
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.magic = PARAM_CACHE_MAGIC;
+	hdr.version = PARAM_CACHE_VERSION;
+	hdr.key = pNode->key;
+	hdr.nvValid = withNV;
+	for (iBank = 0; iBank < pNodeInfo->bankCount; iBank++) {
+		pParamBank = &pNodeInfo->paramBankList[iBank];
+		for (iVal = 0; iVal < pParamBank->nParams; iVal++) {
+			pValueDB = &pParamBank->valueDB[iVal];
+			if (pValueDB->exists
+			&& pValueDB->generation == nodeulong(pNodeInfo->valGeneration
+												 + pParamBank->valGeneration)
+			&& coreParamCacheable(pParamBank->fixedInfoDB[iVal].info, withNV))
+				hdr.nItems++;
+		}
+	}
+	// Nothing new since the file was read?
+	if (hdr.nItems == 0
+	|| (pNode->fileCurrent && hdr.nvValid == pNode->nvOK
+		&& hdr.nItems <= pNode->nSeeded))
+		return(MN_OK);
+
+	snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+	fo = fopen(tmpPath, "wb");
+	if (!fo)
+		return(MN_ERR_FILE_OPEN);
+	bool wrote = fwrite(&hdr, sizeof(hdr), 1, fo) == 1;
+	for (iBank = 0; wrote && iBank < pNodeInfo->bankCount; iBank++) {
+		pParamBank = &pNodeInfo->paramBankList[iBank];
+		for (iVal = 0; wrote && iVal < pParamBank->nParams; iVal++) {
+			pValueDB = &pParamBank->valueDB[iVal];
+			if (!pValueDB->exists
+			|| pValueDB->generation != nodeulong(pNodeInfo->valGeneration
+												 + pParamBank->valGeneration)
+			|| !coreParamCacheable(pParamBank->fixedInfoDB[iVal].info, withNV))
+				continue;
+			coreParam.bits = 0;
+			coreParam.fld.bank = iBank;
+			coreParam.fld.param = iVal;
+			item.param = Uint16(coreParam.bits);
+			item.size = Uint8(pValueDB->raw.Byte.BufferSize);
+			wrote = fwrite(&item, sizeof(item), 1, fo) == 1
+				&& fwrite(pValueDB->raw.Byte.Buffer, 1, item.size, fo)
+					== item.size;
+		}
+	}
+	wrote = (fclose(fo) == 0) && wrote;
+	// Replace the old file, rename will not overwrite on Windows
+	if (wrote)
+		remove(path);
+	if (!wrote || rename(tmpPath, path) != 0) {
+		remove(tmpPath);
+		theErr = MN_ERR_FILE_WRITE;
+	}
+	return(theErr);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		coreParamCacheForget
+//
+//	DESCRIPTION:
+//		Remove the cache file of a node whose configuration is about to be
+//		loaded and drop the values its session read, they no longer
+//		describe the node.
+//
+//	SYNOPSIS:
+void coreParamCacheForget(
+		multiaddr theMultiAddr)
+{
+	char path[PARAM_CACHE_PATH_MAX+64];
+	paramCacheNode *pNode
+		= &cacheNodes[NET_NUM(theMultiAddr)][NODE_ADDR(theMultiAddr)];
+
+	if (!pNode->active)
+		return;
+	pNode->active = false;
+	if (cacheFilePath(pNode->key, path, sizeof(path)))
+		remove(path);
+}
+//																			  *
+//*****************************************************************************
+
+
+//=============================================================================
+//	END OF FILE paramCache.cpp
+//=============================================================================
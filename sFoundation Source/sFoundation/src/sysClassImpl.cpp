@@ -40,9 +40,16 @@
 	#include "meridianHdrs.h"
 	#include "netCmdPrivate.h"
 	#include "mnParamDefs.h"
+	#include "telemetryPoller.h"
 	#include <stdarg.h>
 	#include <stdio.h>
 	#include <math.h>
+	#if !(defined(_WIN32)||defined(_WIN64))
+		// The Windows headers supply these as macros
+		#include <algorithm>
+		using std::max;
+		using std::min;
+	#endif
 
 // Disable windows warning about 'this' in constructor.
 #ifdef _MSC_VER
@@ -103,17 +110,19 @@
 	// Use our sFoundation namespace
 	using namespace sFnd;
 
-	// Static hack for attention handling by class lib
-	static CCCriticalSection AttnMutex;
+	// Static hack for attention handling by class lib, one lock per port
+	// so a busy handler on one port does not hold up the others
+	static CCCriticalSection AttnMutex[NET_CONTROLLER_MAX];
 
 	class UseAttnMutex {
 	private:
+		CCCriticalSection &m_lock;
 	public:
-		UseAttnMutex() {
-			AttnMutex.Lock();
+		UseAttnMutex(netaddr cNum) : m_lock(AttnMutex[cNum]) {
+			m_lock.Lock();
 		}
 		~UseAttnMutex() {
-			AttnMutex.Unlock();
+			m_lock.Unlock();
 		}
 	};
 //																		      *
@@ -477,6 +486,31 @@ void SysManager::PortsOpen(int portCount)
 //*****************************************************************************
 
 
+//*****************************************************************************
+//	NAME																	  *
+//		SysManager::ParamCacheDir
+//
+//	DESCRIPTION:
+/**
+	Set the directory node parameter cache files are kept in.
+
+ 	\param[in] dirPath Cache directory, NULL or empty to turn the cache off.
+**/
+//	SYNOPSIS:
+void SysManager::ParamCacheDir(const char *dirPath)
+{
+	cnErrCode theErr = netSetParamCacheDir(dirPath);
+	if (theErr != MN_OK) {
+		mnErr eInfo;
+		fillInErrs(eInfo, theErr, _TEK_FUNC_SIG_,
+			"Cache directory path too long");
+		throwSystemError(eInfo);
+	}
+}
+//																			  *
+//*****************************************************************************
+
+
 
 //*****************************************************************************
 //	NAME																	  *
@@ -529,6 +563,11 @@ void SysManager::PortsClose()
 		debugGate.SetEvent();
 		threadLockMutex.Unlock();
 	}
+	// Stop the samplers before their ports go away
+	for (int iPort = 0; iPort < NET_CONTROLLER_MAX; iPort++) {
+		if (SysInventory[iPort].pPortCls)
+			SysInventory[iPort].pPortCls->TelemetryStop();
+	}
 	mnShutdown();
 }
 //																			  *
@@ -785,6 +824,233 @@ INode &IPort::Nodes(size_t index)
 //*****************************************************************************
 
 
+//*****************************************************************************
+//	NAME																	  *
+//		IPort::RefreshGroup
+//
+//	DESCRIPTION:
+/**
+	Refresh a group of values with one pipelined burst of reads. The burst
+	stores the values in the parameter database, each Refresh then picks
+	its value up and reports its own errors. Values the burst could not
+	read are read again by their Refresh. The burst's samples are only
+	served for a few milliseconds, so if a Refresh throws, later reads of
+	the values after it still go to the node.
+
+ 	\param[in] values Values to refresh, NULL entries are skipped
+	\param[in] nValues Number of entries in \a values
+**/
+void IPort::RefreshGroup(ValueBase *const values[], size_t nValues)
+{
+	refreshGroup(values, nValues, NULL);
+}
+
+/**
+	Refresh a group of values and optionally return the time each value's
+	response arrived in \a readTimes. A value the burst missed is timed by
+	its own refresh.
+**/
+void IPort::refreshGroup(ValueBase *const values[], size_t nValues,
+						 double *readTimes)
+{
+	std::vector<multiaddr> addrs;
+	std::vector<nodeparam> params;
+	std::vector<double> groupTimes;
+	size_t iValue, iRead;
+
+	if (!values || nValues == 0)
+		return;
+	addrs.reserve(nValues);
+	params.reserve(nValues);
+	for (iValue = 0; iValue < nValues; iValue++) {
+		if (!values[iValue])
+			continue;
+		addrs.push_back(values[iValue]->Node().Info.Ex.Addr());
+		params.push_back(values[iValue]->ParamNum());
+	}
+	groupTimes.resize(addrs.size());
+	// Errors are reported by the Refresh of the values affected
+	if (addrs.size())
+		netGetParameterGroup(m_netNumber, addrs.size(), &addrs[0], &params[0],
+							 readTimes ? &groupTimes[0] : NULL);
+	for (iValue = 0, iRead = 0; iValue < nValues; iValue++) {
+		if (!values[iValue]) {
+			if (readTimes)
+				readTimes[iValue] = 0;
+			continue;
+		}
+		values[iValue]->Refresh();
+		if (readTimes)
+			readTimes[iValue] = groupTimes[iRead] ? groupTimes[iRead]
+												  : infcCoreTime();
+		iRead++;
+	}
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		IPort::Snapshot
+//
+//	DESCRIPTION:
+/**
+	Capture the position, velocity, torque and real-time status of every
+	node on the port with one pipelined sweep.
+
+ 	\param[out] snap Updated with the captured state
+**/
+void IPort::Snapshot(mnMachineSnapshot &snap)
+{
+	ValueBase *values[MN_SNAP_FIELDS*MN_API_MAX_NODES];
+	double readTimes[MN_SNAP_FIELDS*MN_API_MAX_NODES];
+	double firstRead, lastRead;
+	size_t nNodes = NodeCount();
+	size_t iNode, iField;
+
+	if (nNodes > MN_API_MAX_NODES)
+		nNodes = MN_API_MAX_NODES;
+	// Node major so each node's reads go out together
+	for (iNode = 0; iNode < nNodes; iNode++) {
+		INode &theNode = Nodes(iNode);
+		values[iNode*MN_SNAP_FIELDS+MN_SNAP_POSN] = &theNode.Motion.PosnMeasured;
+		values[iNode*MN_SNAP_FIELDS+MN_SNAP_VEL] = &theNode.Motion.VelMeasured;
+		values[iNode*MN_SNAP_FIELDS+MN_SNAP_TRQ] = &theNode.Motion.TrqMeasured;
+		values[iNode*MN_SNAP_FIELDS+MN_SNAP_STATUS] = &theNode.Status.RT;
+	}
+	snap.NodeCount = nNodes;
+	snap.SweepStartMsec = infcCoreTime();
+	snap.SkewMsec = 0;
+	if (nNodes == 0)
+		return;
+	refreshGroup(values, nNodes*MN_SNAP_FIELDS, readTimes);
+
+	firstRead = lastRead = readTimes[0];
+	for (iNode = 0; iNode < nNodes; iNode++) {
+		INode &theNode = Nodes(iNode);
+		snap.PosnMeasured[iNode] = theNode.Motion.PosnMeasured.m_currentValue;
+		snap.VelMeasured[iNode] = theNode.Motion.VelMeasured.m_currentValue;
+		snap.TrqMeasured[iNode] = theNode.Motion.TrqMeasured.m_currentValue;
+		snap.StatusRT[iNode] = theNode.Status.RT.m_currentValue;
+		for (iField = 0; iField < MN_SNAP_FIELDS; iField++) {
+			double readAt = readTimes[iNode*MN_SNAP_FIELDS+iField];
+			snap.SampleTimeMsec[iField][iNode] = readAt;
+			if (readAt < firstRead)
+				firstRead = readAt;
+			if (readAt > lastRead)
+				lastRead = readAt;
+		}
+	}
+	snap.SkewMsec = lastRead - firstRead;
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		IPort::TelemetryStart
+//
+//	DESCRIPTION:
+/**
+	Start the port's background sampler on a new set of values. The values
+	sampled before are released first.
+
+ 	\param[in] values Values to sample
+	\param[in] nValues Number of entries in \a values
+	\param[in] periodMs Time between samples
+**/
+void IPort::TelemetryStart(ValueBase *const values[], size_t nValues,
+						   double periodMs)
+{
+	multiaddr addrs[TELEMETRY_MAX_SAMPLES];
+	nodeparam params[TELEMETRY_MAX_SAMPLES];
+	cnErrCode theErr = MN_OK;
+	size_t iValue;
+
+	if (!values || nValues == 0 || nValues > TELEMETRY_MAX_SAMPLES)
+		theErr = MN_ERR_BADARG;
+	for (iValue = 0; theErr == MN_OK && iValue < nValues; iValue++) {
+		if (!values[iValue] || !values[iValue]->canSample()) {
+			theErr = MN_ERR_BADARG;
+			break;
+		}
+		addrs[iValue] = values[iValue]->Node().Info.Ex.Addr();
+		params[iValue] = values[iValue]->ParamNum();
+		if (coreController(addrs[iValue]) != m_netNumber)
+			theErr = MN_ERR_BADARG;
+	}
+	if (theErr == MN_OK) {
+		TelemetryStop();
+		if (!m_pTelemetry)
+			m_pTelemetry = new CTelemetryPoller(m_netNumber);
+		for (iValue = 0; iValue < nValues; iValue++)
+			values[iValue]->m_sampleSlot = int(iValue);
+		theErr = m_pTelemetry->Start(values, addrs, params, nValues,
+									 periodMs);
+		if (theErr != MN_OK)
+			TelemetryStop();
+	}
+	if (theErr == MN_OK)
+		return;
+	mnErr eInfo;
+	fillInErrs(eInfo, theErr, _TEK_FUNC_SIG_,
+		"Failure to start telemetry on network %d, value %d", m_netNumber,
+		iValue);
+	throwSystemError(eInfo);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		IPort::TelemetryStop
+//
+//	DESCRIPTION:
+/**
+	Stop the port's background sampler and release its values.
+**/
+void IPort::TelemetryStop()
+{
+	if (!m_pTelemetry)
+		return;
+	for (size_t iSlot = 0; iSlot < m_pTelemetry->Count(); iSlot++)
+		m_pTelemetry->Value(iSlot)->m_sampleSlot = -1;
+	m_pTelemetry->Stop();
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		IPort::ConfigLoad
+//
+//	DESCRIPTION:
+/**
+	Load a configuration file into each node on the port at once, writing
+	only the items that differ.
+
+ 	\param[in] filePaths Configuration file for each node, NULL to skip
+	\param[in] nNodes Number of entries in \a filePaths
+**/
+void IPort::ConfigLoad(const char *const filePaths[], size_t nNodes)
+{
+	cnErrCode theErr = netConfigLoadPort(m_netNumber, CLASSIC_DIFF, nNodes,
+										 filePaths);
+	if (theErr == MN_OK)
+		return;
+	mnErr eInfo;
+	fillInErrs(eInfo, theErr, _TEK_FUNC_SIG_,
+		"Failure to load configuration on network %d", m_netNumber);
+	throwSystemError(eInfo);
+}
+//																			  *
+//*****************************************************************************
+
+
 //*****************************************************************************
 //= = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = 
 //			INTERNAL DOCUMENTED BELOW HERE
@@ -794,12 +1060,30 @@ INode &IPort::Nodes(size_t index)
 //*****************************************************************************
 IPort::IPort(netaddr index, IBrakeControl &brake, IGrpShutdown &shtDwn, 
 			 IPortAdv &adv)
-	: m_netNumber(index), GrpShutdown(shtDwn), BrakeControl(brake), Adv(adv)
+	: m_netNumber(index), m_pTelemetry(NULL), GrpShutdown(shtDwn),
+	  BrakeControl(brake), Adv(adv)
 {
 }
 
 IPort::~IPort()
 {
+	TelemetryStop();
+	delete m_pTelemetry;
+}
+
+bool IPort::readTelemetry(const ValueBase *owner, size_t slot,
+						  double &value, void *raw, size_t rawSize,
+						  double &sampleTime)
+{
+	telemetrySample sample;
+	if (!m_pTelemetry || !m_pTelemetry->Read(slot, owner, sample))
+		return false;
+	value = sample.value;
+	if (raw)
+		memcpy(raw, sample.raw,
+			   rawSize < TELEMETRY_RAW_MAX ? rawSize : TELEMETRY_RAW_MAX);
+	sampleTime = sample.sampleTime;
+	return true;
 }
 
 
@@ -1085,7 +1369,7 @@ bool IAttnPort::HasAttnHandler()
 void IAttnPort::InvokeAttnHandler(const mnAttnReqReg &detected)
 {
 	// Serialize the calls from each port to avoid re-entrancy
-	UseAttnMutex lock;
+	UseAttnMutex lock(m_pPort->NetNumber());
 	if (AttnCallback) {
 		(*AttnCallback)(detected);
 	}
@@ -1477,6 +1761,13 @@ ValueBase::ValueBase(INode &node, nodeparam pNum)
 	m_scaleToUser = 1.0;
 	m_refreshOnAccess = false;
 	m_isVolatile = false;
+	m_snapshotMode = false;
+	m_sampleSlot = -1;
+	m_maxAge = 0;
+	m_skipSameWrites = true;
+	m_shadowValid = false;
+	m_shadowReq = 0;
+	m_shadowNode = 0;
 }
 
 
@@ -1488,6 +1779,7 @@ void ValueBase::Exists(bool newState)
 void ValueBase::ParamNum(nodeparam newParamNum)
 {
 	m_valid = false;
+	m_shadowValid = false;
 	m_paramNum = newParamNum;
 }
 
@@ -1495,12 +1787,52 @@ void ValueBase::Scale(double newScale)
 {
 	m_scaleToUser = newScale;
 	m_valid = false;
+	m_shadowValid = false;
 }
 
 void ValueBase::Valid(bool newState) 
 {
 	m_valid = false;
 }
+
+bool ValueBase::readSample(double &value, void *raw, size_t rawSize,
+						   double &sampleTime)
+{
+	if (!m_snapshotMode || m_sampleSlot < 0)
+		return false;
+	return Node().Port.readTelemetry(this, size_t(m_sampleSlot), value,
+									 raw, rawSize, sampleTime);
+}
+
+double ValueBase::SampleTimeMsec()
+{
+	double value, sampleTime;
+	if (!readSample(value, NULL, 0, sampleTime))
+		return 0;
+	return sampleTime;
+}
+
+bool ValueBase::shadowMatch(double newValue)
+{
+	if (!m_skipSameWrites || m_isVolatile || !m_shadowValid
+	|| newValue != m_shadowReq)
+		return false;
+	// Served from the value cache, which re-reads the node once invalidated
+	return Node().Info.Ex.Parameter(m_paramNum) == m_shadowNode;
+}
+
+void ValueBase::MaxAgeMsec(double maxAgeMsec)
+{
+	cnErrCode theErr = netSetParamMaxAge(Node().Info.Ex.Addr(),
+										 mnParams(ParamNum()), maxAgeMsec);
+	if (theErr == MN_OK) {
+		m_maxAge = maxAgeMsec;
+		return;
+	}
+	mnErr eInfo;
+	fillInErrs(eInfo, m_pNode, theErr, _TEK_FUNC_SIG_, "Parameter=%d", ParamNum());
+	throwSystemError(eInfo);
+}
 //= = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = 
 // ParamDouble Class Implementations
 //= = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = = 
@@ -1519,6 +1851,11 @@ void ValueDouble::Value(int32_t newValue, bool makeNonVolatile)
 
 void ValueDouble::Value(double newValue, bool makeNonVolatile)
 {
+	double nodeVal;
+	// Skip rewriting what the node already has
+	if (!makeNonVolatile && shadowMatch(newValue))
+		return;
+	m_shadowValid = false;
 	// Write out new value
 	Node().Info.Ex.Parameter(ParamNum(), newValue/m_scaleToUser);
 	// Save new power-on default as well
@@ -1528,8 +1865,10 @@ void ValueDouble::Value(double newValue, bool makeNonVolatile)
 	// Save last value
 	m_lastValue = m_currentValue;
 	// Account for truncations
-	m_currentValue = Node().Info.Ex.Parameter(ParamNum())*m_scaleToUser;
+	nodeVal = Node().Info.Ex.Parameter(ParamNum());
+	m_currentValue = nodeVal*m_scaleToUser;
 	m_valid = true;
+	shadowSet(newValue, nodeVal);
 }
 
 double ValueDouble::Value(bool getNonVolatile)
@@ -1549,6 +1888,9 @@ double ValueDouble::operator=(double newValue)
 **/
 ValueDouble::operator double() 
 {
+	double snapVal;
+	if (m_snapshotMode && snapshot(snapVal))
+		return(snapVal);
 	if (!m_valid || m_refreshOnAccess) {
 		Refresh();
 	}
@@ -1559,6 +1901,9 @@ Update a numeric parameter using a 32-bit integer value.
 **/
 ValueDouble::operator int32_t()
 {
+	double snapVal;
+	if (m_snapshotMode && snapshot(snapVal))
+		return(int32_t(snapVal));
 	if (!m_valid || m_refreshOnAccess) {
 		Refresh();
 	}
@@ -1567,12 +1912,29 @@ ValueDouble::operator int32_t()
 
 ValueDouble::operator uint32_t()
 {
+	double snapVal;
+	if (m_snapshotMode && snapshot(snapVal))
+		return(uint32_t(snapVal));
 	if (!m_valid || m_refreshOnAccess) {
 		Refresh();
 	}
 	return(uint32_t(m_currentValue));
 }
 
+/**
+	Read from the port's telemetry snapshot into \a userValue. The members
+	are left alone so any number of threads can read while another
+	refreshes.
+**/
+bool ValueDouble::snapshot(double &userValue)
+{
+	double baseValue, sampleTime;
+	if (!readSample(baseValue, NULL, 0, sampleTime))
+		return false;
+	userValue = baseValue*m_scaleToUser;
+	return true;
+}
+
 
 void ValueDouble::Refresh()
 {
@@ -1597,6 +1959,11 @@ ValueSigned::ValueSigned(INode &node, nodeparam pNum)
 
 void ValueSigned::Value(int32_t newValue, bool makeNonVolatile)
 {
+	double nodeVal;
+	// Skip rewriting what the node already has
+	if (!makeNonVolatile && shadowMatch(newValue))
+		return;
+	m_shadowValid = false;
 	// Write out new value
 	Node().Info.Ex.Parameter(ParamNum(), newValue);
 	// Save new power-on default as well
@@ -1605,8 +1972,10 @@ void ValueSigned::Value(int32_t newValue, bool makeNonVolatile)
 	// Save last value
 	m_lastValue = m_currentValue;
 	// Account for truncations
-	m_currentValue = int32_t(Node().Info.Ex.Parameter(ParamNum()));
+	nodeVal = Node().Info.Ex.Parameter(ParamNum());
+	m_currentValue = int32_t(nodeVal);
 	m_valid = true;
+	shadowSet(newValue, nodeVal);
 }
 
 int32_t ValueSigned::Value(bool getNonVolatile)
@@ -1668,6 +2037,11 @@ ValueUnsigned::ValueUnsigned(INode &node, nodeparam pNum)
 
 void ValueUnsigned::Value(uint32_t newValue, bool makeNonVolatile)
 {
+	double nodeVal;
+	// Skip rewriting what the node already has
+	if (!makeNonVolatile && shadowMatch(newValue))
+		return;
+	m_shadowValid = false;
 	// Write out new value
 	Node().Info.Ex.Parameter(ParamNum(), newValue);
 	// Save new power-on default as well
@@ -1676,8 +2050,10 @@ void ValueUnsigned::Value(uint32_t newValue, bool makeNonVolatile)
 	// Save last value
 	m_lastValue = m_currentValue;
 	// Account for truncations
-	m_currentValue = uint32_t(Node().Info.Ex.Parameter(ParamNum()));
+	nodeVal = Node().Info.Ex.Parameter(ParamNum());
+	m_currentValue = uint32_t(nodeVal);
 	m_valid = true;
+	shadowSet(newValue, nodeVal);
 }
 
 uint32_t ValueUnsigned::Value(bool getNonVolatile)
@@ -2257,12 +2633,27 @@ ValueStatus::ValueStatus(INode &node, nodeparam pNum, bool clearOnReadType)
 **/
 mnStatusReg ValueStatus::Value()
 {
+	mnStatusReg snapReg;
+	if (m_snapshotMode && snapshot(snapReg))
+		return snapReg;
 	if (!m_valid || m_refreshOnAccess) {
 		Refresh();
 	}
 	return m_currentValue;
 }
 
+/**
+	Read from the port's telemetry snapshot into \a reg. The members are
+	left alone so any number of threads can read while another refreshes.
+**/
+bool ValueStatus::snapshot(mnStatusReg &reg)
+{
+	double baseValue, sampleTime;
+	if (!readSample(baseValue, &reg, sizeof(mnStatusReg), sampleTime))
+		return false;
+	return true;
+}
+
 void ValueStatus::Value(const mnStatusReg &newValue)
 {
 	cnErrCode theErr;
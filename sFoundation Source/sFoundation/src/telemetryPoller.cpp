@@ -0,0 +1,277 @@
+//*****************************************************************************
+// NAME
+//		telemetryPoller.cpp
+//
+// DESCRIPTION:
+/**
+		\file
+		Background sampler of real-time parameters for one port.
+**/
+//
+// CREATION DATE:
+//		10/18/2026 11:20:05
+//
+// COPYRIGHT NOTICE:
+//		(C)Copyright 2026  Teknic, Inc.  All rights reserved.
+//
+//		This copyright notice must be reproduced in any copy, modification,
+//		or portion thereof merged into another program. A copy of the
+//		copyright notice must be included in the object library of a user
+//		program.
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+// NAME																	      *
+// 	telemetryPoller.cpp headers
+//
+	#include "telemetryPoller.h"
+	#include "meridianHdrs.h"
+	#include "netCmdAPI.h"
+	#include "lnkAccessAPI.h"
+	#include <string.h>
+//																			  *
+//*****************************************************************************
+
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CTelemetryPoller::CTelemetryPoller
+//
+//	DESCRIPTION:
+//		Construction/Destruction
+//
+//	SYNOPSIS:
+CTelemetryPoller::CTelemetryPoller(netaddr cNum)
+	: m_wake(false, false)
+{
+	m_cNum = cNum;
+	m_periodMs = 0;
+	m_nSamples = 0;
+	memset(m_samples, 0, sizeof(m_samples));
+	memset(m_values, 0, sizeof(m_values));
+}
+
+CTelemetryPoller::~CTelemetryPoller()
+{
+	Stop();
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CTelemetryPoller::Start
+//
+//	DESCRIPTION:
+/**
+	Replace the sample set and start sampling it every \a periodMs. The
+	first pass runs on the caller's thread so the snapshot is filled when
+	this returns.
+
+	\param[in] values The values sampled, slot n holds values[n].
+	\param[in] addrs Node address of each value.
+	\param[in] params Parameter number of each value.
+	\param[in] nValues Number of values.
+	\param[in] periodMs Time between the start of each burst.
+
+	\return MN_OK if sampling started.
+**/
+//	SYNOPSIS:
+cnErrCode CTelemetryPoller::Start(sFnd::ValueBase *const values[],
+								  const multiaddr *addrs,
+								  const nodeparam *params,
+								  size_t nValues, double periodMs)
+{
+	if (nValues == 0 || nValues > TELEMETRY_MAX_SAMPLES || !(periodMs > 0))
+		return(MN_ERR_BADARG);
+
+	m_ctlLock.Lock();
+	Stop();
+	// The poller is stopped, we are the only writer
+	m_seq.WriteBegin();
+	for (size_t iSlot = 0; iSlot < nValues; iSlot++) {
+		m_values[iSlot] = values[iSlot];
+		m_addrs[iSlot] = addrs[iSlot];
+		m_params[iSlot] = params[iSlot];
+		m_samples[iSlot].sampleTime = 0;
+	}
+	m_nSamples = nValues;
+	m_periodMs = periodMs;
+	m_seq.WriteEnd();
+
+	sampleAll();
+	try {
+		LaunchThread();
+	}
+	catch (...) {
+		m_ctlLock.Unlock();
+		Stop();
+		return(MN_ERR_THREAD_CREATE);
+	}
+	m_ctlLock.Unlock();
+	return(MN_OK);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CTelemetryPoller::Stop
+//
+//	DESCRIPTION:
+//		Stop the poller thread and empty the snapshot.
+//
+//	SYNOPSIS:
+void CTelemetryPoller::Stop()
+{
+	m_ctlLock.Lock();
+	TerminateAndWait();
+	m_seq.WriteBegin();
+	m_nSamples = 0;
+	m_seq.WriteEnd();
+	m_ctlLock.Unlock();
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CTelemetryPoller::Terminate
+//
+//	DESCRIPTION:
+//		Initiate the terminate sequence and cut short the wait for the next
+//		burst.
+//
+//	SYNOPSIS:
+HANDLE CTelemetryPoller::Terminate()
+{
+	HANDLE hThread = CThread::Terminate();
+	m_wake.SetEvent();
+	return(hThread);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CTelemetryPoller::Read
+//
+//	DESCRIPTION:
+/**
+	Copy the latest sample of \a slot. This never blocks, a copy torn by a
+	concurrent publish is simply taken again.
+
+	\param[in] slot Slot to read.
+	\param[in] value The value the caller expects in \a slot. A copy of a
+	sampled value carries its slot number but is not sampled.
+	\param[out] sample Updated with the sample.
+
+	\return true if the slot holds \a value and has been sampled.
+**/
+//	SYNOPSIS:
+bool CTelemetryPoller::Read(size_t slot, const sFnd::ValueBase *value,
+							telemetrySample &sample) const
+{
+	LONG seq;
+	bool inUse;
+	if (slot >= TELEMETRY_MAX_SAMPLES)
+		return(false);
+	do {
+		seq = m_seq.ReadBegin();
+		sample = m_samples[slot];
+		inUse = slot < m_nSamples && m_values[slot] == value;
+	} while (m_seq.ReadRetry(seq));
+	return(inUse && sample.sampleTime != 0);
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CTelemetryPoller::sampleAll
+//
+//	DESCRIPTION:
+//		Read every value in one burst and publish the reads that worked.
+//		A failed read leaves the previous sample, and its time stamp, in
+//		place. Each value is collected under its node's mutex like any
+//		other parameter access. The burst holds no node, it publishes
+//		each value under the node's value DB lock.
+//
+//	SYNOPSIS:
+void CTelemetryPoller::sampleAll()
+{
+	paramValue val;
+	size_t iSlot;
+
+	// Failures are picked up by the reads below
+	netGetParameterGroup(m_cNum, m_nSamples, m_addrs, m_params, m_readTimes);
+	for (iSlot = 0; iSlot < m_nSamples; iSlot++) {
+		{
+			sFnd::INode::UseMutex nodeLock(m_values[iSlot]->Node());
+			m_nextOK[iSlot] = netGetParameterInfo(m_addrs[iSlot],
+							mnParams(m_params[iSlot]), NULL, &val) == MN_OK;
+		}
+		if (!m_nextOK[iSlot])
+			continue;
+		m_next[iSlot].value = val.value;
+		// Values the burst missed were just read on their own
+		m_next[iSlot].sampleTime = m_readTimes[iSlot] ? m_readTimes[iSlot]
+													  : infcCoreTime();
+		memcpy(m_next[iSlot].raw, val.raw.Byte.Buffer, TELEMETRY_RAW_MAX);
+	}
+
+	m_seq.WriteBegin();
+	for (iSlot = 0; iSlot < m_nSamples; iSlot++) {
+		if (m_nextOK[iSlot])
+			m_samples[iSlot] = m_next[iSlot];
+	}
+	m_seq.WriteEnd();
+}
+//																			  *
+//*****************************************************************************
+
+
+//*****************************************************************************
+//	NAME																	  *
+//		CTelemetryPoller::Run
+//
+//	DESCRIPTION:
+//		Sample at the fixed rate until terminated. A pass that overruns
+//		its period is followed at once by the next, missed passes are not
+//		made up.
+//
+//	SYNOPSIS:
+int CTelemetryPoller::Run(void * /*context*/)
+{
+	double nextBurst = infcCoreTime() + m_periodMs;
+	double now;
+
+	while (!Terminating()) {
+		now = infcCoreTime();
+		if (now < nextBurst) {
+			m_wake.WaitFor(Uint32(nextBurst - now + 0.5));
+			continue;
+		}
+		nextBurst += m_periodMs;
+		if (nextBurst < now)
+			nextBurst = now + m_periodMs;
+		sampleAll();
+	}
+	return(0);
+}
+//																			  *
+//*****************************************************************************
+
+
+//=============================================================================
+//	END OF FILE telemetryPoller.cpp
+//=============================================================================
@@ -0,0 +1,244 @@
+//*****************************************************************************
+// DESCRIPTION:
+/**
+	\file
+	Check of CSerialEx::convert8to7 and convert7to8 against the character
+	loops they replaced, kept here as oldConvert8to7 and oldConvert7to8.
+
+	Every packet length from 0 to 31 is converted both ways with random
+	octets, 7-bit clean octets and clean octets with one top bit set, and
+	the whole output buffer must match the old loops' octet for octet.
+	The cases the word-at-a-time code treats apart all fall in that range:
+
+		- a short group of 8-bit octets also encodes the octet past it,
+		- a short group of characters writes one octet past its data,
+		- lengths from 28 octets up expand past the header's length field
+		  and are checksummed over the short count,
+		- a character with its top bit set drops back to the old loop.
+
+	The buffers sit in front of a guard area so a write past either loop
+	shows up too. The time per packet of each loop is then reported.
+
+	Build the library and run on Linux from the "sFoundation Source"
+	directory:
+
+		g++ -O2 -o convertCharsTest -ILibLinuxOS/inc -Iinc/inc-pub
+			-Iinc/inc-private -Iinc/inc-private/sFound -ILibINI/inc
+			test/convertCharsTest.cpp libsFoundation.a -lpthread -ldl
+
+	where libsFoundation.a is built as test/runTests.sh does. Exits
+	non-zero on the first failure.
+**/
+//
+// COPYRIGHT NOTICE:
+//		(C)Copyright 2026  Teknic, Inc.  All rights reserved.
+//
+//		This copyright notice must be reproduced in any copy, modification,
+//		or portion thereof merged into another program. A copy of the
+//		copyright notice must be included in the object library of a user
+//		program.
+//																			  *
+//*****************************************************************************
+
+#include "SerialEx.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Trials of each length and kind of data
+#define N_TRIALS		20000
+// Packets converted for each timing
+#define N_TIMED			(1 << 21)
+
+// A packet buffer with room behind it to catch stray writes
+struct guardedBuf {
+	packetbuf pkt;
+	Uint8 guard[16];
+};
+
+// Small fixed generator so every run checks the same packets
+static Uint32 rngState = 0x6c078965;
+static Uint32 nextRand()
+{
+	rngState ^= rngState << 13;
+	rngState ^= rngState >> 17;
+	rngState ^= rngState << 5;
+	return rngState;
+}
+
+// The kinds of data converted
+enum dataKind { DATA_RANDOM, DATA_CLEAN, DATA_CORRUPT, N_DATA_KINDS };
+static const char *dataKindName[N_DATA_KINDS] = {
+	"random", "7-bit clean", "corrupt"
+};
+
+// The octet loop convert8to7 used before
+static void oldConvert8to7(packetbuf& inBuf, packetbuf& outBuf)
+{
+	outBuf.Byte.Buffer[0] = inBuf.Byte.Buffer[0];
+	outBuf.Byte.Buffer[1] = inBuf.Byte.Buffer[1];
+
+	nodechar *s = &inBuf.Byte.Buffer[2];
+	nodechar *d = &outBuf.Byte.Buffer[2];
+	nodechar *origD = d;
+	unsigned long chksum = 0;
+
+	int num8 = inBuf.Fld.PktLen;
+	int consumeBytes;
+	int outBytes;
+
+	while(num8 > 0){
+		consumeBytes = num8 >= 7 ? 7 : num8;
+		outBytes = consumeBytes + 1;
+		switch(outBytes) {
+			case 8: d[7] = 0x7f &				 ((unsigned char)s[6] >> 1);
+			// fall through
+			case 7: d[6] = 0x7f & ((s[6] << 6) | ((unsigned char)s[5] >> 2));
+			// fall through
+			case 6: d[5] = 0x7f & ((s[5] << 5) | ((unsigned char)s[4] >> 3));
+			// fall through
+			case 5: d[4] = 0x7f & ((s[4] << 4) | ((unsigned char)s[3] >> 4));
+			// fall through
+			case 4: d[3] = 0x7f & ((s[3] << 3) | ((unsigned char)s[2] >> 5));
+			// fall through
+			case 3: d[2] = 0x7f & ((s[2] << 2) | ((unsigned char)s[1] >> 6));
+			// fall through
+			case 2: d[1] = 0x7f & ((s[1] << 1) | ((unsigned char)s[0] >> 7));
+			// fall through
+			case 1: d[0] = 0x7f &   s[0];
+		}
+		d += outBytes;
+		s += consumeBytes;
+		num8 -= consumeBytes;
+	}
+	outBuf.Fld.PktLen = (d - origD);
+	outBuf.Byte.BufferSize = (nodeulong)(inBuf.Byte.BufferSize
+		+ (d - origD)-inBuf.Fld.PktLen
+		+ MN_API_PACKET_TAIL_LEN);
+	for(unsigned i=0;i<(outBuf.Fld.PktLen+2U);i++) {
+		chksum+=outBuf.Byte.Buffer[i];
+	}
+	chksum = (-1*chksum)&0x7f;
+	outBuf.Byte.Buffer[outBuf.Fld.PktLen+2] = (nodechar) chksum;
+}
+
+// The character loop convert7to8 used before
+static void oldConvert7to8(packetbuf& inBuf, packetbuf& outBuf)
+{
+	outBuf.Byte.Buffer[0] = inBuf.Byte.Buffer[0];
+	outBuf.Byte.Buffer[1] = inBuf.Byte.Buffer[1];
+
+	int num7 = inBuf.Fld.PktLen;
+
+	nodechar *buf7 = &inBuf.Byte.Buffer[RESP_LOC];
+	nodechar *d = &outBuf.Byte.Buffer[RESP_LOC];
+	nodechar *origD = d;
+
+	int i, mod8;
+	for(i = 0; i < num7; ++i) {
+		mod8 = 0x07 & i;
+		*d |= 0xff & (buf7[i] << (8 - mod8));
+		d += mod8 != 0;
+		*d = buf7[i] >> mod8;
+	}
+
+	outBuf.Fld.PktLen = (num7==1) ? 1: d - origD;
+	outBuf.Byte.BufferSize=outBuf.Fld.PktLen+MN_API_PACKET_HDR_LEN;
+}
+
+// Fill <buf> with data of <kind> and a header giving <len>
+static void fill(guardedBuf &buf, unsigned len, dataKind kind)
+{
+	Uint8 *p = (Uint8 *)&buf;
+	for (size_t i = 0; i < sizeof(buf); i++) {
+		p[i] = Uint8(nextRand());
+		if (kind != DATA_RANDOM)
+			p[i] &= 0x7f;
+	}
+	// The caller may lie about the buffer size
+	buf.pkt.Byte.BufferSize = nextRand() % 64;
+	buf.pkt.Fld.PktLen = len;
+	if (kind == DATA_CORRUPT && len > 0)
+		buf.pkt.Byte.Buffer[RESP_LOC + nextRand() % len] |= 0x80;
+}
+
+// Convert with both loops from the same input into the same starting
+// output and require identical results
+static void compare(CSerialEx &port, unsigned len, dataKind kind, bool to7)
+{
+	guardedBuf in, inOld, out, outOld;
+	fill(in, len, kind);
+	fill(out, len, DATA_RANDOM);
+	inOld = in;
+	outOld = out;
+	if (to7) {
+		port.convert8to7(in.pkt, out.pkt);
+		oldConvert8to7(inOld.pkt, outOld.pkt);
+	}
+	else {
+		port.convert7to8(in.pkt, out.pkt);
+		oldConvert7to8(inOld.pkt, outOld.pkt);
+	}
+	if (memcmp(&out, &outOld, sizeof(out)) != 0
+		|| memcmp(&in, &inOld, sizeof(in)) != 0) {
+		fprintf(stderr, "convert%s of %u %s octets differs\n",
+				to7 ? "8to7" : "7to8", len, dataKindName[kind]);
+		exit(1);
+	}
+}
+
+static double msNow()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+// Octets read back from the timed output so the work is not dropped
+static volatile Uint8 timedSink;
+
+// Time <N_TIMED> conversions of clean packets of every length, returns
+// ns per packet
+template<typename convertFn>
+static double timeLoop(convertFn convert)
+{
+	guardedBuf in[32], out;
+	for (unsigned len = 0; len < 32; len++)
+		fill(in[len], len, DATA_CLEAN);
+	double start = msNow();
+	for (Uint32 i = 0; i < N_TIMED; i++) {
+		convert(in[i & 31].pkt, out.pkt);
+		timedSink = Uint8(out.pkt.Byte.Buffer[(i >> 5) % MN_NET_PACKET_MAX]);
+	}
+	return (msNow() - start) * 1e6 / N_TIMED;
+}
+
+int main()
+{
+	CSerialEx *pPort = new CSerialEx;
+
+	for (unsigned len = 0; len <= MN_HDR_LEN_MASK; len++) {
+		for (int kind = 0; kind < N_DATA_KINDS; kind++) {
+			for (int trial = 0; trial < N_TRIALS; trial++) {
+				compare(*pPort, len, dataKind(kind), true);
+				compare(*pPort, len, dataKind(kind), false);
+			}
+		}
+	}
+	printf("%d packets of each length 0-%u and kind match both ways\n",
+		   N_TRIALS, MN_HDR_LEN_MASK);
+
+	double new87 = timeLoop([pPort](packetbuf &i, packetbuf &o) {
+		pPort->convert8to7(i, o); });
+	double old87 = timeLoop(oldConvert8to7);
+	double new78 = timeLoop([pPort](packetbuf &i, packetbuf &o) {
+		pPort->convert7to8(i, o); });
+	double old78 = timeLoop(oldConvert7to8);
+	printf("convert8to7 %.1f ns per packet, old loop %.1f ns\n", new87, old87);
+	printf("convert7to8 %.1f ns per packet, old loop %.1f ns\n", new78, old78);
+	delete pPort;
+
+	printf("convertCharsTest passed\n");
+	return 0;
+}
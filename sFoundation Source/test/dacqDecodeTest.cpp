@@ -0,0 +1,155 @@
+//*****************************************************************************
+// DESCRIPTION:
+/**
+	\file
+	Bit exact check of dacqDecodePackets against the dacqPacket bit fields
+	the read thread used to unpack. Every field of every packet is compared
+	with the value the union gives on this compiler, as the read thread
+	computed it.
+
+	The packets are a million random ones, decoded both packed and at a
+	stride that leaves them unaligned, and every value of each pair of
+	adjacent octets with the other octets random, which crosses every
+	field boundary.
+
+	Build and run on Linux from the "sFoundation Source" directory:
+
+		g++ -o dacqDecodeTest -ILibLinuxOS/inc -Iinc/inc-pub
+			-Iinc/inc-private -Iinc/inc-private/sFound -ILibINI/inc
+			test/dacqDecodeTest.cpp sFoundation/src/dacqDecode.cpp
+
+	or use test/runTests.sh. Exits non-zero on the first failure.
+**/
+//
+// COPYRIGHT NOTICE:
+//		(C)Copyright 2026  Teknic, Inc.  All rights reserved.
+//
+//		This copyright notice must be reproduced in any copy, modification,
+//		or portion thereof merged into another program. A copy of the
+//		copyright notice must be included in the object library of a user
+//		program.
+//																			  *
+//*****************************************************************************
+
+#include "dacqDecode.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#define CHECK(cond) do { if (!(cond)) { \
+	fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+	exit(1); } } while (0)
+
+// Random packets checked
+#define N_RANDOM		(1 << 20)
+// Octets between packets in the unaligned run
+#define ODD_STRIDE		9
+
+// Small fixed generator so every run checks the same packets
+static Uint32 rngState = 0x2545f491;
+static Uint8 nextOctet()
+{
+	rngState ^= rngState << 13;
+	rngState ^= rngState >> 17;
+	rngState ^= rngState << 5;
+	return Uint8(rngState >> 24);
+}
+
+// What the read thread took from the union for one packet
+struct unionFields {
+	float trace[2];
+	Uint8 moveState[2], exception[2], io[2], sequence;
+};
+
+static unionFields fromUnion(const Uint8 *raw)
+{
+	dacqPacket pkt;
+	unionFields f;
+	memset(&pkt, 0, sizeof(pkt));
+	memcpy(pkt.bits, raw, DACQ_PACKET_OCTETS);
+	f.sequence = Uint8(pkt.Fld.Sequence);
+	f.trace[0] = (float)pkt.Fld.T0p0 / (1 << (P0_BITS - 1));
+	f.trace[1] = (float)pkt.Fld.T0p1 / (1 << (P1_BITS - 1));
+	f.moveState[0] = Uint8(pkt.Fld.MoveState0);
+	f.moveState[1] = Uint8(pkt.Fld.MoveState1);
+	f.exception[0] = Uint8(pkt.Fld.Exception0);
+	f.exception[1] = Uint8(pkt.Fld.Exception1);
+	f.io[0] = Uint8((pkt.Fld.Trigger0 << (INPUT_BITS + 1))
+		| (pkt.Fld.Inputs0 << 1) | pkt.Fld.Output0);
+	f.io[1] = Uint8((pkt.Fld.Trigger1 << (INPUT_BITS + 1))
+		| (pkt.Fld.Inputs1 << 1) | pkt.Fld.Output1);
+	return f;
+}
+
+// Decode <nPackets> packets at <stride> and compare each with the union
+static void checkRun(const Uint8 *raw, size_t stride, size_t nPackets)
+{
+	std::vector<float> trace(2 * nPackets);
+	std::vector<Uint8> moveState(2 * nPackets), exception(2 * nPackets);
+	std::vector<Uint8> io(2 * nPackets), sequence(nPackets);
+	const dacqDecoded out = { trace.data(), moveState.data(),
+							  exception.data(), io.data(), sequence.data() };
+
+	dacqDecodePackets(raw, stride, nPackets, out);
+	for (size_t iPkt = 0; iPkt < nPackets; iPkt++) {
+		unionFields f = fromUnion(raw + iPkt * stride);
+		CHECK(sequence[iPkt] == f.sequence);
+		for (size_t iPt = 0; iPt < 2; iPt++) {
+			// Same bits, not just the same value
+			CHECK(memcmp(&trace[2 * iPkt + iPt], &f.trace[iPt],
+						 sizeof(float)) == 0);
+			CHECK(moveState[2 * iPkt + iPt] == f.moveState[iPt]);
+			CHECK(exception[2 * iPkt + iPt] == f.exception[iPt]);
+			CHECK(io[2 * iPkt + iPt] == f.io[iPt]);
+		}
+	}
+}
+
+int main()
+{
+	// The union's fields must cover the packet's octets as the decoder
+	// reads them
+	CHECK(sizeof(dacqPacket) >= DACQ_PACKET_OCTETS);
+
+	// Random packets, packed and unaligned
+	std::vector<Uint8> packed(size_t(N_RANDOM) * DACQ_PACKET_OCTETS);
+	std::vector<Uint8> odd(size_t(N_RANDOM) * ODD_STRIDE + 1);
+	for (size_t i = 0; i < packed.size(); i++)
+		packed[i] = nextOctet();
+	for (size_t iPkt = 0; iPkt < N_RANDOM; iPkt++) {
+		memcpy(&odd[1 + iPkt * ODD_STRIDE],
+			   &packed[iPkt * DACQ_PACKET_OCTETS], DACQ_PACKET_OCTETS);
+	}
+	checkRun(packed.data(), DACQ_PACKET_OCTETS, N_RANDOM);
+	checkRun(&odd[1], ODD_STRIDE, N_RANDOM);
+
+	// Every value of each pair of adjacent octets
+	std::vector<Uint8> pairs(size_t(65536) * DACQ_PACKET_OCTETS);
+	for (size_t first = 0; first + 1 < DACQ_PACKET_OCTETS; first++) {
+		for (size_t iPkt = 0; iPkt < 65536; iPkt++) {
+			Uint8 *pPkt = &pairs[iPkt * DACQ_PACKET_OCTETS];
+			for (size_t iOct = 0; iOct < DACQ_PACKET_OCTETS; iOct++)
+				pPkt[iOct] = nextOctet();
+			pPkt[first] = Uint8(iPkt);
+			pPkt[first + 1] = Uint8(iPkt >> 8);
+		}
+		checkRun(pairs.data(), DACQ_PACKET_OCTETS, 65536);
+	}
+
+	// The extremes of the traces decode to -1 and just under +1
+	const Uint8 lowest[DACQ_PACKET_OCTETS] = { 0x00, 0x10, 0x00, 0, 0, 0 };
+	const Uint8 highest[DACQ_PACKET_OCTETS] = { 0xfc, 0xef, 0x7f, 0, 0, 0 };
+	float trace[2];
+	const dacqDecoded traceOnly = { trace, NULL, NULL, NULL, NULL };
+	dacqDecodePackets(lowest, DACQ_PACKET_OCTETS, 1, traceOnly);
+	CHECK(trace[0] == -1.0f && trace[1] == 0.0f);
+	dacqDecodePackets(highest, DACQ_PACKET_OCTETS, 1, traceOnly);
+	CHECK(trace[0] == 1.0f - 1.0f / (1 << (P0_BITS - 1)));
+	CHECK(trace[1] == 1.0f - 1.0f / (1 << (P1_BITS - 1)));
+
+	printf("%d random packets and %d octet pairs match the union\n",
+		   N_RANDOM, 65536 * (DACQ_PACKET_OCTETS - 1));
+	printf("dacqDecodeTest passed\n");
+	return 0;
+}
@@ -0,0 +1,259 @@
+//*****************************************************************************
+// DESCRIPTION:
+/**
+	\file
+	Drift simulation of the data acquisition merger. Two nodes whose clocks
+	run 100 ppm fast and slow sample a sine of host time, and their packets
+	reach the host after a jittered transit. The host samples the same sine
+	itself. The link's data acquisition calls are played from the
+	simulation, so the merger sees only what the read thread would give
+	it.
+
+	The transit is at least MIN_TRANSIT_MS plus an exponential jitter, a
+	few packets are held up far longer and every packet of the first
+	seconds is held up, which a rate taken from the first arrival would
+	carry. Halfway through one node restarts its acquisition.
+
+	The test checks each node's measured clock rate against its true rate
+	to RATE_TOL. In every merged frame each channel must match the sine at
+	the frame's time, the node channels lagging by the minimum transit, to
+	within the change the sine makes in TIME_TOL_MS at its steepest.
+
+	Build and run on Linux from the "sFoundation Source" directory:
+
+		g++ -o dataAcqMergerTest -ILibLinuxOS/inc -Iinc/inc-pub
+			-Iinc/inc-private -Iinc/inc-private/sFound -ILibINI/inc
+			test/dataAcqMergerTest.cpp sFoundation/src/dataAcqMerger.cpp
+
+	or use test/runTests.sh. Exits non-zero on the first failure.
+**/
+//
+// COPYRIGHT NOTICE:
+//		(C)Copyright 2026  Teknic, Inc.  All rights reserved.
+//
+//		This copyright notice must be reproduced in any copy, modification,
+//		or portion thereof merged into another program. A copy of the
+//		copyright notice must be included in the object library of a user
+//		program.
+//																			  *
+//*****************************************************************************
+
+#include "dataAcqMerger.h"
+#include "lnkAccessAPI.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#define CHECK(cond) do { if (!(cond)) { \
+	fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+	exit(1); } } while (0)
+
+// Simulated run and how often the host pulls
+#define SIM_MS				120000.0
+#define PULL_MS				5.0
+// Node sample period, two points per packet
+#define NODE_PERIOD_MS		1.0
+// Host samples of its own channel
+#define HOST_PERIOD_MS		4.0
+// Transit: a minimum plus exponential jitter, some packets held up longer
+#define MIN_TRANSIT_MS		0.3
+#define MEAN_JITTER_MS		1.0
+#define HELD_EVERY			50
+#define HELD_MS				20.0
+// Every packet of the start is held up this much more
+#define START_HELD_UNTIL_MS	2000.0
+#define START_HELD_MS		15.0
+// Node 1 restarts its acquisition here
+#define RESTART_AT_MS		60000.0
+// Frames
+#define FRAME_MS			2.0
+#define MAX_LAG_MS			50.0
+// The sine sampled
+#define SINE_MS				1000.0
+#define SINE_AMPL			0.9
+// Checks start once the clocks settle, and again after the restart
+#define SETTLE_MS			12000.0
+#define RESTART_SETTLE_MS	1000.0
+#define TIME_TOL_MS			0.05
+#define RATE_TOL			2e-6
+
+#define N_NODES				2
+static const double nodePpm[N_NODES] = { 100.0, -100.0 };
+
+static double sine(double hostMs)
+{
+	return SINE_AMPL * sin(2 * M_PI * hostMs / SINE_MS);
+}
+
+// Small fixed generator so every run simulates the same transit
+static Uint32 rngState = 0x9e3779b9;
+static double uniform()
+{
+	rngState ^= rngState << 13;
+	rngState ^= rngState >> 17;
+	rngState ^= rngState << 5;
+	return (rngState + 0.5) / 4294967296.0;
+}
+
+// A node's points in arrival order, with the host time each arrived
+struct simPoint {
+	mnDataAcqPt pt;
+	double arriveMs;
+};
+struct simNode {
+	std::vector<simPoint> pts;
+	size_t next;					// First point not read yet
+	double clockNode, clockHost;	// Latest clock pair published
+};
+static simNode nodes[N_NODES];
+static double simNow;
+
+// Make a node's packets for the whole run
+static void simulate(unsigned node)
+{
+	simNode &sim = nodes[node];
+	double rate = 1 + nodePpm[node] * 1e-6;
+	double startMs = 0, lastArrive = 0;
+	Uint32 nPkt = 0;
+
+	for (double sampMs = 0; sampMs < SIM_MS;
+		 sampMs += 2 * NODE_PERIOD_MS / rate) {
+		if (node == 1 && startMs == 0 && sampMs >= RESTART_AT_MS)
+			startMs = sampMs;
+		// The packet leaves after its second point
+		double sentMs = sampMs + NODE_PERIOD_MS / rate;
+		double transit = MIN_TRANSIT_MS - MEAN_JITTER_MS * log(uniform());
+		if (++nPkt % HELD_EVERY == 0)
+			transit += HELD_MS;
+		if (sentMs < START_HELD_UNTIL_MS)
+			transit += START_HELD_MS;
+		// The link delivers in order
+		double arrive = sentMs + transit;
+		if (arrive < lastArrive)
+			arrive = lastArrive;
+		lastArrive = arrive;
+		for (int iPt = 0; iPt < 2; iPt++) {
+			simPoint p;
+			double trueMs = sampMs + iPt * NODE_PERIOD_MS / rate;
+			p.pt.TimeStamp = (trueMs - startMs) * rate;
+			p.pt.TraceValue[0] = float(sine(trueMs));
+			p.pt.Valid = true;
+			p.arriveMs = arrive;
+			sim.pts.push_back(p);
+		}
+	}
+}
+
+// The link's data acquisition calls the merger uses
+MN_EXPORT cnErrCode MN_DECL infcGetDataAcqPeriod(
+	multiaddr multiAddr,
+	double *pPeriodMs)
+{
+	if (multiAddr >= N_NODES || !pPeriodMs)
+		return MN_ERR_BADARG;
+	*pPeriodMs = NODE_PERIOD_MS;
+	return MN_OK;
+}
+
+MN_EXPORT cnErrCode MN_DECL infcGetDataAcqPt(
+	multiaddr multiAddr,
+	nodeulong ptsToRead,
+	mnDataAcqPt pTheDataAcqPt[],
+	nodeulong *pPtsRead)
+{
+	if (multiAddr >= N_NODES || !pTheDataAcqPt || !pPtsRead)
+		return MN_ERR_BADARG;
+	simNode &sim = nodes[multiAddr];
+	nodeulong nRead = 0;
+	while (nRead < ptsToRead && sim.next < sim.pts.size()
+		   && sim.pts[sim.next].arriveMs <= simNow) {
+		const simPoint &p = sim.pts[sim.next++];
+		pTheDataAcqPt[nRead++] = p.pt;
+		sim.clockNode = p.pt.TimeStamp;
+		sim.clockHost = p.arriveMs;
+	}
+	*pPtsRead = nRead;
+	return nRead ? MN_OK : MN_ERR_DATAACQ_EMPTY;
+}
+
+MN_EXPORT cnErrCode MN_DECL infcGetDataAcqClock(
+	multiaddr multiAddr,
+	double *pNodeMs,
+	double *pHostMs)
+{
+	if (multiAddr >= N_NODES || !pNodeMs || !pHostMs)
+		return MN_ERR_BADARG;
+	*pNodeMs = nodes[multiAddr].clockNode;
+	*pHostMs = nodes[multiAddr].clockHost;
+	return (*pHostMs == 0) ? MN_ERR_DATAACQ_EMPTY : MN_OK;
+}
+
+int main()
+{
+	CDataAcqMerger *pMerger = new CDataAcqMerger;
+	int nodeChan[N_NODES], hostChan;
+	dacqMergeFrame frame;
+
+	for (unsigned node = 0; node < N_NODES; node++) {
+		simulate(node);
+		nodeChan[node] = pMerger->AddNodeChannel(multiaddr(node),
+												 DACQ_REC_TRACE0);
+		CHECK(nodeChan[node] == int(node));
+	}
+	CHECK(pMerger->AddNodeChannel(multiaddr(N_NODES), DACQ_REC_TRACE0) == -1);
+	hostChan = pMerger->AddHostChannel(2.5 * HOST_PERIOD_MS);
+	CHECK(hostChan == N_NODES);
+	CHECK(pMerger->Start(FRAME_MS, MAX_LAG_MS) == MN_OK);
+	CHECK(pMerger->AddHostChannel(HOST_PERIOD_MS) == -1);
+
+	// Value change of TIME_TOL_MS at the sine's steepest
+	const double valueTol = SINE_AMPL * 2 * M_PI / SINE_MS * TIME_TOL_MS;
+	double worst[N_NODES + 1] = { 0, 0, 0 };
+	double hostSampMs = 0;
+	Uint32 nFrames = 0, nChecked = 0;
+	for (simNow = 0; simNow < SIM_MS; simNow += PULL_MS) {
+		for (; hostSampMs <= simNow; hostSampMs += HOST_PERIOD_MS) {
+			CHECK(pMerger->PushHost(hostChan, hostSampMs,
+									float(sine(hostSampMs))) == MN_OK);
+		}
+		CHECK(pMerger->Pull() == MN_OK);
+		while (pMerger->Next(frame)) {
+			nFrames++;
+			if (frame.time < SETTLE_MS
+				|| (frame.time >= RESTART_AT_MS
+					&& frame.time < RESTART_AT_MS + RESTART_SETTLE_MS))
+				continue;
+			CHECK(frame.validMask == (1U << (N_NODES + 1)) - 1);
+			for (unsigned chan = 0; chan <= N_NODES; chan++) {
+				double lag = (chan == unsigned(hostChan)) ? 0 : MIN_TRANSIT_MS;
+				double err = fabs(frame.value[chan] - sine(frame.time - lag));
+				if (err > worst[chan])
+					worst[chan] = err;
+				CHECK(err <= valueTol);
+			}
+			nChecked++;
+		}
+	}
+	// Frames kept up with the run
+	CHECK(nFrames > (SIM_MS - MAX_LAG_MS) / FRAME_MS - 100);
+	CHECK(nChecked > nFrames / 2);
+	CHECK(pMerger->Overruns() == 0);
+
+	for (unsigned node = 0; node < N_NODES; node++) {
+		double rate = 1 / (1 + nodePpm[node] * 1e-6);
+		double measured = pMerger->ClockRate(nodeChan[node]);
+		printf("node %u: %+.0f ppm, rate error %.2g, worst %.4f ms of sine\n",
+			   node, nodePpm[node], measured - rate,
+			   worst[node] / (SINE_AMPL * 2 * M_PI / SINE_MS));
+		CHECK(fabs(measured - rate) <= RATE_TOL);
+	}
+	CHECK(pMerger->ClockRate(hostChan) == 1);
+	printf("host: worst %.4f ms of sine, %u of %u frames checked\n",
+		   worst[N_NODES] / (SINE_AMPL * 2 * M_PI / SINE_MS), nChecked,
+		   nFrames);
+	delete pMerger;
+
+	printf("dataAcqMergerTest passed\n");
+	return 0;
+}
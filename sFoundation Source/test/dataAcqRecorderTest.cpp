@@ -0,0 +1,299 @@
+//*****************************************************************************
+// DESCRIPTION:
+/**
+	\file
+	Round trip of the data acquisition recorder. The link's data
+	acquisition calls are played by rings fed from a producer thread, the
+	recorder writes them to a file while it runs and CDataAcqRecReader
+	must read back every point: its time, each channel scaled to its
+	units, the gaps and the points the ring dropped.
+
+	One node's stream is long enough to grow the file past its first
+	extent, so the file extension and the chunk roll over are covered.
+
+	Build and run on Linux from the "sFoundation Source" directory:
+
+		g++ -o dataAcqRecorderTest -ILibLinuxOS/inc -Iinc/inc-pub
+			-Iinc/inc-private -Iinc/inc-private/sFound -ILibINI/inc
+			test/dataAcqRecorderTest.cpp sFoundation/src/dataAcqRecorder.cpp
+			LibLinuxOS/src/SerialLinux.cpp LibLinuxOS/src/tekEventsLinux.cpp
+			LibLinuxOS/src/tekThreadsLinux.cpp -lpthread
+
+	or use test/runTests.sh. Exits non-zero on the first failure.
+**/
+//
+// COPYRIGHT NOTICE:
+//		(C)Copyright 2026  Teknic, Inc.  All rights reserved.
+//
+//		This copyright notice must be reproduced in any copy, modification,
+//		or portion thereof merged into another program. A copy of the
+//		copyright notice must be included in the object library of a user
+//		program.
+//																			  *
+//*****************************************************************************
+
+#include "dataAcqRecorder.h"
+#include "lnkAccessAPI.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <mutex>
+#include <thread>
+
+#define CHECK(cond) do { if (!(cond)) { \
+	fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+	exit(1); } } while (0)
+
+// Nodes recorded and the points made for each
+#define N_NODES			2
+static const Uint32 nodePts[N_NODES] = { 300000, 20000 };
+static const double nodePeriodMs[N_NODES] = { 0.5, 2.0 };
+// Ring size, a power of two as in the link
+#define RING_LEN		4096
+// Every GAP_EVERY points the ring drops GAP_DROPS
+#define GAP_EVERY		7919
+#define GAP_DROPS		5
+
+// The ring of one node, as the link's read thread fills it
+struct testRing {
+	std::mutex lock;
+	mnDataAcqPt pts[RING_LEN];
+	Uint32 head, tail;
+	nodeulong dropped;
+	Uint32 made;					// Points pushed so far
+};
+static testRing rings[N_NODES];
+
+// Point <i> of node <node>
+static mnDataAcqPt makePoint(unsigned node, Uint32 i)
+{
+	mnDataAcqPt pt;
+	pt.TimeStamp = 1000.0 + i * nodePeriodMs[node];
+	pt.TraceValue[0] = float(i % 4096) / 4096 - 0.5f;
+	pt.TraceValue[1] = -float(i % 1024) / 1024;
+	pt.TraceValue[2] = float((i * 7) % 2048) / 2048;
+	pt.TraceValue[3] = 0.25f;
+	pt.MoveState = i % 8;
+	pt.Exception = (i / 8) % 4;
+	pt.Sequence = nodeushort(i);
+	pt.Valid = (i % GAP_EVERY) != 0;
+	return pt;
+}
+
+static multiaddr nodeAddr(unsigned node)
+{
+	return multiaddr(node);
+}
+
+// Push every point of <node>, waiting while its ring is full. Each gap
+// point follows a run the ring dropped.
+static void producer(unsigned node)
+{
+	testRing &ring = rings[node];
+	for (Uint32 i = 0; i < nodePts[node]; ) {
+		ring.lock.lock();
+		if (ring.head - ring.tail < RING_LEN) {
+			if (i % GAP_EVERY == 0 && i != 0)
+				ring.dropped += GAP_DROPS;
+			ring.pts[ring.head & (RING_LEN - 1)] = makePoint(node, i);
+			ring.head++;
+			ring.made = ++i;
+			ring.lock.unlock();
+		}
+		else {
+			ring.lock.unlock();
+			::usleep(200);
+		}
+	}
+}
+
+// The link's data acquisition calls the recorder uses
+static testRing *ringOf(multiaddr multiAddr)
+{
+	return (multiAddr < N_NODES) ? &rings[multiAddr] : NULL;
+}
+
+MN_EXPORT cnErrCode MN_DECL infcGetDataAcqPeriod(
+	multiaddr multiAddr,
+	double *pPeriodMs)
+{
+	if (!ringOf(multiAddr) || !pPeriodMs)
+		return MN_ERR_BADARG;
+	*pPeriodMs = nodePeriodMs[multiAddr];
+	return MN_OK;
+}
+
+MN_EXPORT cnErrCode MN_DECL infcPeekDataAcqPts(
+	multiaddr multiAddr,
+	const mnDataAcqPt **ppPts,
+	nodeulong *pPtsAvail)
+{
+	testRing *pRing = ringOf(multiAddr);
+	if (!pRing || !ppPts || !pPtsAvail)
+		return MN_ERR_BADARG;
+	std::lock_guard<std::mutex> hold(pRing->lock);
+	Uint32 avail = pRing->head - pRing->tail;
+	if (avail == 0)
+		return MN_ERR_DATAACQ_EMPTY;
+	Uint32 first = pRing->tail & (RING_LEN - 1);
+	if (avail > RING_LEN - first)
+		avail = RING_LEN - first;
+	*ppPts = &pRing->pts[first];
+	*pPtsAvail = avail;
+	return MN_OK;
+}
+
+MN_EXPORT cnErrCode MN_DECL infcReleaseDataAcqPts(
+	multiaddr multiAddr,
+	nodeulong ptsUsed)
+{
+	testRing *pRing = ringOf(multiAddr);
+	if (!pRing)
+		return MN_ERR_BADARG;
+	std::lock_guard<std::mutex> hold(pRing->lock);
+	if (ptsUsed > pRing->head - pRing->tail)
+		return MN_ERR_BADARG;
+	pRing->tail += Uint32(ptsUsed);
+	return MN_OK;
+}
+
+MN_EXPORT cnErrCode MN_DECL infcGetDataAcqDropped(
+	multiaddr multiAddr,
+	nodebool reset,
+	nodeulong *pDropped)
+{
+	testRing *pRing = ringOf(multiAddr);
+	if (!pRing || !pDropped)
+		return MN_ERR_BADARG;
+	std::lock_guard<std::mutex> hold(pRing->lock);
+	*pDropped = pRing->dropped;
+	if (reset)
+		pRing->dropped = 0;
+	return MN_OK;
+}
+
+int main()
+{
+	char path[] = "/tmp/dataAcqRecorderTestXXXXXX";
+	int fd = ::mkstemp(path);
+	CHECK(fd >= 0);
+	::close(fd);
+
+	// Node 0 records three channels, node 1 one. Node 1's channel comes
+	// between node 0's to check the channels are grouped by node.
+	const dacqRecChannelDef defs[] = {
+		{ nodeAddr(0), DACQ_REC_TRACE0, 200.0, 10.0, "torque", "%" },
+		{ nodeAddr(1), DACQ_REC_TRACE2, 0.5, -1.0, "speed", "rpm" },
+		{ nodeAddr(0), DACQ_REC_MOVE_STATE, 1.0, 0.0, "state", NULL },
+		{ nodeAddr(0), DACQ_REC_VALID, 1.0, 0.0, NULL, NULL },
+	};
+	const size_t nDefs = sizeof(defs) / sizeof(defs[0]);
+	// Channel table order the recorder must produce, and their node
+	const size_t hdrDef[nDefs] = { 0, 2, 3, 1 };
+
+	// Bad arguments are refused before the file is touched
+	CDataAcqRecorder recorder;
+	dacqRecChannelDef badDef = defs[0];
+	badDef.addr = nodeAddr(N_NODES);
+	CHECK(recorder.Start(path, &badDef, 1, 5) == MN_ERR_BADARG);
+	CHECK(recorder.Start(path, defs, nDefs, 0) == MN_ERR_BADARG);
+	CHECK(recorder.Start(NULL, defs, nDefs, 5) == MN_ERR_BADARG);
+
+	// Record while the producers run, following the file as it grows
+	CHECK(recorder.Start(path, defs, nDefs, 5) == MN_OK);
+	std::thread feed0(producer, 0);
+	std::thread feed1(producer, 1);
+	CDataAcqRecReader follower;
+	CHECK(follower.Open(path) == MN_OK);
+	CHECK(follower.Header()->state == DACQ_REC_RECORDING);
+	feed0.join();
+	feed1.join();
+	CHECK(follower.Chunks() > 0);
+	follower.Close();
+	CHECK(recorder.Stop() == MN_OK);
+	CHECK(recorder.Status() == MN_OK);
+	for (unsigned node = 0; node < N_NODES; node++)
+		CHECK(rings[node].head == rings[node].tail);
+
+	// Read it all back
+	CDataAcqRecReader reader;
+	CHECK(reader.Open(path) == MN_OK);
+	const dacqRecHeader *pHdr = reader.Header();
+	CHECK(pHdr->state == DACQ_REC_CLOSED);
+	CHECK(pHdr->nStreams == N_NODES);
+	CHECK(pHdr->nChannels == nDefs);
+	for (size_t iChan = 0; iChan < nDefs; iChan++) {
+		const dacqRecChannelDef &def = defs[hdrDef[iChan]];
+		const dacqRecChannel &chan = pHdr->channels[iChan];
+		CHECK(chan.stream == NODE_ADDR(def.addr));
+		CHECK(chan.source == def.source);
+		CHECK(chan.scale == def.scale && chan.offset == def.offset);
+		CHECK(strcmp(chan.name, def.name ? def.name : "") == 0);
+		CHECK(strcmp(chan.units, def.units ? def.units : "") == 0);
+	}
+	CHECK(pHdr->streams[0].firstChannel == 0 && pHdr->streams[0].nChannels == 3);
+	CHECK(pHdr->streams[1].firstChannel == 3 && pHdr->streams[1].nChannels == 1);
+
+	Uint32 rowsRead[N_NODES] = { 0, 0 };
+	Uint32 gapsRead[N_NODES] = { 0, 0 };
+	Uint32 chunksOf[N_NODES] = { 0, 0 };
+	for (Uint32 iChunk = 0; iChunk < reader.Chunks(); iChunk++) {
+		const dacqRecChunk *pChunk = reader.Chunk(iChunk);
+		CHECK(pChunk != NULL);
+		CHECK(pChunk->magic == DACQ_REC_CHUNK_MAGIC);
+		unsigned node = pChunk->stream;
+		CHECK(node < N_NODES);
+		const dacqRecStream &stream = pHdr->streams[node];
+		CHECK(stream.addr == nodeAddr(node));
+		CHECK(stream.pointPeriodMs == nodePeriodMs[node]);
+		CHECK(pChunk->rowCapacity == stream.rowCapacity);
+		CHECK(pChunk->firstRow == rowsRead[node]);
+		Uint32 rows = reader.Rows();
+		CHECK(rows > 0 && rows <= pChunk->rowCapacity);
+		// Only a stream's last chunk may be short
+		if (rowsRead[node] + rows < nodePts[node])
+			CHECK(rows == pChunk->rowCapacity);
+		const float *pTimes = reader.Column(0);
+		CHECK(pTimes != NULL);
+		Uint32 gaps = 0;
+		for (Uint32 iRow = 0; iRow < rows; iRow++) {
+			mnDataAcqPt pt = makePoint(node, rowsRead[node] + iRow);
+			CHECK(pChunk->baseTime + pTimes[iRow] == pt.TimeStamp);
+			for (Uint16 iChan = 0; iChan < stream.nChannels; iChan++) {
+				size_t chan = stream.firstChannel + iChan;
+				const float *pCol = reader.Column(iChan + 1);
+				CHECK(pCol != NULL);
+				CHECK(pCol[iRow] == dacqRecSourceValue(pt,
+										pHdr->channels[chan].source));
+				CHECK(reader.Scaled(chan, pCol[iRow])
+					  == pCol[iRow] * pHdr->channels[chan].scale
+						 + pHdr->channels[chan].offset);
+			}
+			if (!pt.Valid)
+				gaps++;
+		}
+		CHECK(pChunk->gaps == gaps);
+		CHECK(reader.Column(stream.nChannels + 1) == NULL);
+		gapsRead[node] += gaps;
+		rowsRead[node] += rows;
+		chunksOf[node]++;
+	}
+	CHECK(reader.Chunk(reader.Chunks()) == NULL);
+	for (unsigned node = 0; node < N_NODES; node++) {
+		Uint32 gaps = (nodePts[node] + GAP_EVERY - 1) / GAP_EVERY;
+		CHECK(rowsRead[node] == nodePts[node]);
+		CHECK(gapsRead[node] == gaps);
+		CHECK(pHdr->streams[node].dropped == (gaps - 1) * GAP_DROPS);
+		printf("node %u: %u points in %u chunks, %u gaps, %u dropped\n", node,
+			   rowsRead[node], chunksOf[node], gapsRead[node],
+			   pHdr->streams[node].dropped);
+	}
+	// The long stream grew the file past its first extent
+	CHECK(reader.Chunks() > DACQ_REC_EXTENT_CHUNKS);
+	reader.Close();
+	::unlink(path);
+
+	printf("dataAcqRecorderTest passed\n");
+	return 0;
+}
@@ -0,0 +1,278 @@
+//*****************************************************************************
+// DESCRIPTION:
+/**
+	\file
+	A pseudo-terminal stand in for a hub and its ring of nodes, for the
+	tests that open a port through the library.
+
+	The library opens the slave side by name and the hub plays the ring on
+	the master side. It frames the link characters, checks their checksum,
+	decodes them with its own bit loop and answers each packet as the ring
+	would:
+
+		- set address packets come back with the address advanced past
+		  the hub's nodes,
+		- other control and extended packets come back as sent,
+		- commands to a node come back as its response, with the payload
+		  from Answer, or as a command error if the node is set to fail.
+
+	Every packet received is logged with the infcCoreTime it arrived at.
+	A pseudo-terminal cannot carry a break, so the library's break check
+	at port open never sees one and reports MN_ERR_NO_NET_CONNECTIVITY;
+	the port is open and in packet mode regardless.
+**/
+//
+// COPYRIGHT NOTICE:
+//		(C)Copyright 2026  Teknic, Inc.  All rights reserved.
+//
+//		This copyright notice must be reproduced in any copy, modification,
+//		or portion thereof merged into another program. A copy of the
+//		copyright notice must be included in the object library of a user
+//		program.
+//																			  *
+//*****************************************************************************
+
+#ifndef __FAKEHUB_H__
+#define __FAKEHUB_H__
+
+#include "lnkAccessAPI.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A packet the hub received
+struct hubPkt {
+	packetbuf pkt;						// Decoded to octets
+	double at;							// infcCoreTime it arrived
+};
+
+class fakeHub {
+public:
+	// Play a ring of <nNodes> nodes
+	explicit fakeHub(unsigned nNodes)
+		: m_nNodes(nNodes), m_failMask(0), m_quit(false), m_nBad(0)
+	{
+		struct termios tio;
+		m_master = ::posix_openpt(O_RDWR | O_NOCTTY);
+		if (m_master < 0 || ::grantpt(m_master) != 0
+			|| ::unlockpt(m_master) != 0) {
+			m_name[0] = 0;
+			return;
+		}
+		strncpy(m_name, ::ptsname(m_master), sizeof(m_name) - 1);
+		m_name[sizeof(m_name) - 1] = 0;
+		// Raw so nothing is echoed or translated
+		::tcgetattr(m_master, &tio);
+		::cfmakeraw(&tio);
+		::tcsetattr(m_master, TCSANOW, &tio);
+		m_thread = std::thread(&fakeHub::run, this);
+	}
+
+	virtual ~fakeHub()
+	{
+		m_quit = true;
+		if (m_thread.joinable())
+			m_thread.join();
+		if (m_master >= 0)
+			::close(m_master);
+	}
+
+	// Device name the library opens, empty if the pair failed
+	const char *PortName() const { return m_name; }
+
+	// Answer the commands to the nodes in <mask> with a command error
+	void FailNodes(Uint32 mask) { m_failMask = mask; }
+
+	// Packets received so far, and packets that failed their checksum
+	std::vector<hubPkt> Received()
+	{
+		std::lock_guard<std::mutex> lock(m_logLock);
+		return m_log;
+	}
+	void ClearReceived()
+	{
+		std::lock_guard<std::mutex> lock(m_logLock);
+		m_log.clear();
+	}
+	unsigned BadPackets() const { return m_nBad; }
+
+	// Decode the <nChars> link characters of a packet, header and
+	// checksum included. Returns false if the checksum fails.
+	static bool Decode(const Uint8 *chars, size_t nChars, packetbuf &pkt)
+	{
+		unsigned sum = 0, bits = 0, nBits = 0;
+		size_t i, n7 = nChars - MN_API_PACKET_HDR_LEN - MN_API_PACKET_TAIL_LEN;
+		for (i = 0; i < nChars; i++)
+			sum += chars[i];
+		if (sum & 0x7f)
+			return false;
+		pkt = packetbuf();
+		pkt.Byte.Buffer[0] = chars[0];
+		pkt.Byte.Buffer[1] = chars[1];
+		size_t n8 = 0;
+		for (i = 0; i < n7; i++) {
+			bits |= unsigned(chars[MN_API_PACKET_HDR_LEN + i] & 0x7f) << nBits;
+			nBits += 7;
+			if (nBits >= 8) {
+				pkt.Byte.Buffer[MN_API_PACKET_HDR_LEN + n8++] = nodechar(bits);
+				bits >>= 8;
+				nBits -= 8;
+			}
+		}
+		pkt.Fld.PktLen = unsigned(n8);
+		pkt.Byte.BufferSize = nodeulong(n8 + MN_API_PACKET_HDR_LEN);
+		return true;
+	}
+
+	// Encode <pkt> to link characters, returns their count
+	static size_t Encode(const packetbuf &pkt, Uint8 *chars)
+	{
+		unsigned bits = 0, nBits = 0, sum = 0;
+		size_t i, n7 = 0, n8 = pkt.Fld.PktLen;
+		chars[0] = pkt.Byte.Buffer[0] | 0x80;
+		for (i = 0; i < n8; i++) {
+			bits |= unsigned(Uint8(pkt.Byte.Buffer[MN_API_PACKET_HDR_LEN + i]))
+				<< nBits;
+			nBits += 8;
+			while (nBits >= 7) {
+				chars[MN_API_PACKET_HDR_LEN + n7++] = Uint8(bits & 0x7f);
+				bits >>= 7;
+				nBits -= 7;
+			}
+		}
+		if (nBits)
+			chars[MN_API_PACKET_HDR_LEN + n7++] = Uint8(bits & 0x7f);
+		chars[1] = Uint8((pkt.Byte.Buffer[1] & ~MN_HDR_LEN_MASK) | n7);
+		for (i = 0; i < n7 + MN_API_PACKET_HDR_LEN; i++)
+			sum += chars[i];
+		chars[n7 + MN_API_PACKET_HDR_LEN] = Uint8(-sum & 0x7f);
+		return n7 + MN_API_PACKET_HDR_LEN + MN_API_PACKET_TAIL_LEN;
+	}
+
+protected:
+	// Fill in the response payload of a command to a node. The default
+	// returns four octets of the command's node and code for the get
+	// parameter commands, two zero octets, which read as the application
+	// net, for the net access level and nothing for the rest.
+	virtual void Answer(const packetbuf &cmd, packetbuf &resp)
+	{
+		switch (cmd.Byte.Buffer[CMD_LOC]) {
+		case MN_CMD_GET_PARAM0:
+		case MN_CMD_GET_PARAM1:
+		case MN_CMD_GET_PARAM2:
+			resp.Fld.PktLen = 4;
+			resp.Byte.Buffer[RESP_LOC] = nodechar(cmd.Fld.Addr);
+			resp.Byte.Buffer[RESP_LOC + 1] = cmd.Byte.Buffer[CMD_LOC + 1];
+			resp.Byte.Buffer[RESP_LOC + 2] = 0x5a;
+			resp.Byte.Buffer[RESP_LOC + 3] = 0;
+			break;
+		case MN_CMD_NET_ACCESS:
+			resp.Fld.PktLen = 2;
+			break;
+		default:
+			resp.Fld.PktLen = 0;
+			break;
+		}
+	}
+
+private:
+	// Play the ring until told to quit
+	void run()
+	{
+		Uint8 chunk[256], frame[MN_NET_PACKET_MAX + 1];
+		size_t nFrame = 0;
+		while (!m_quit) {
+			struct pollfd pfd = { m_master, POLLIN, 0 };
+			if (::poll(&pfd, 1, 10) != 1 || !(pfd.revents & POLLIN))
+				continue;
+			ssize_t nRead = ::read(m_master, chunk, sizeof(chunk));
+			if (nRead <= 0)
+				continue;
+			double at = infcCoreTime();
+			for (ssize_t i = 0; i < nRead; i++) {
+				// A start of packet drops any fragment
+				if (chunk[i] & 0x80)
+					nFrame = 0;
+				else if (nFrame == 0)
+					continue;
+				frame[nFrame++] = chunk[i];
+				if (nFrame < MN_API_PACKET_HDR_LEN)
+					continue;
+				size_t want = MN_API_PACKET_HDR_LEN + (frame[1] & MN_HDR_LEN_MASK)
+					+ MN_API_PACKET_TAIL_LEN;
+				if (nFrame < want)
+					continue;
+				hubPkt rx;
+				rx.at = at;
+				if (Decode(frame, nFrame, rx.pkt)) {
+					{
+						std::lock_guard<std::mutex> lock(m_logLock);
+						m_log.push_back(rx);
+					}
+					reply(rx.pkt);
+				}
+				else {
+					m_nBad++;
+				}
+				nFrame = 0;
+			}
+		}
+	}
+
+	// Send back what the ring would for <cmd>
+	void reply(const packetbuf &cmd)
+	{
+		packetbuf resp;
+		Uint8 chars[MN_NET_PACKET_MAX + 1];
+		resp = cmd;
+		switch (cmd.Fld.PktType) {
+		case MN_PKT_TYPE_SET_ADDR: {
+			// Each node takes the next address
+			unsigned next = cmd.Fld.Addr + m_nNodes;
+			resp.Fld.Addr = next & MN_API_ADDR_MASK;
+			resp.Fld.Mode = next >= MN_API_MAX_NODES;
+			break;
+		}
+		case MN_PKT_TYPE_CMD:
+			if (cmd.Fld.Addr >= m_nNodes)
+				return;
+			if (m_failMask & (1U << cmd.Fld.Addr)) {
+				netErrGeneric *pErr = (netErrGeneric *)&resp.Byte.Buffer[RESP_LOC];
+				resp.Fld.PktType = MN_PKT_TYPE_ERROR;
+				resp.Fld.PktLen = 2;
+				pErr->bits = 0;
+				pErr->Fld.ErrCls = ND_ERRCLS_CMD;
+				pErr->Fld.ErrCode = 1;
+			}
+			else {
+				resp.Fld.PktType = MN_PKT_TYPE_RESP;
+				Answer(cmd, resp);
+			}
+			break;
+		default:
+			// The ring hands the rest back as sent
+			break;
+		}
+		size_t nChars = Encode(resp, chars);
+		if (::write(m_master, chars, nChars) != ssize_t(nChars))
+			m_nBad++;
+	}
+
+	unsigned m_nNodes;
+	volatile Uint32 m_failMask;
+	volatile bool m_quit;
+	volatile unsigned m_nBad;
+	int m_master;
+	char m_name[64];
+	std::thread m_thread;
+	std::mutex m_logLock;
+	std::vector<hubPkt> m_log;
+};
+
+#endif
@@ -0,0 +1,355 @@
+//*****************************************************************************
+// DESCRIPTION:
+/**
+	\file
+	Equivalence check of CSerialEx::ProcessChunk against the per character
+	framer it replaced, kept here as oldFramer with its ProcessNextChar
+	and TestAndPushHiPacket as they were.
+
+	Each of the random streams strings together good packets of both
+	priorities, high priority packets interleaved into others, packets
+	with a bad checksum, packets cut short, stray runs and random octets.
+	The stream is fed to oldFramer a character at a time and to
+	ProcessChunk in chunks split at random points. Both must hand up the
+	same packets and errors in the same order and end in the same parser
+	state.
+
+	Build the library and run on Linux from the "sFoundation Source"
+	directory:
+
+		g++ -O2 -o frameChunkTest -ILibLinuxOS/inc -Iinc/inc-pub
+			-Iinc/inc-private -Iinc/inc-private/sFound -ILibINI/inc
+			test/frameChunkTest.cpp libsFoundation.a -lpthread -ldl
+
+	where libsFoundation.a is built as test/runTests.sh does. Exits
+	non-zero on the first failure.
+**/
+//
+// COPYRIGHT NOTICE:
+//		(C)Copyright 2026  Teknic, Inc.  All rights reserved.
+//
+//		This copyright notice must be reproduced in any copy, modification,
+//		or portion thereof merged into another program. A copy of the
+//		copyright notice must be included in the object library of a user
+//		program.
+//																			  *
+//*****************************************************************************
+
+#include "SerialEx.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#define CHECK(cond) do { if (!(cond)) { \
+	fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+	exit(1); } } while (0)
+
+// Streams checked and the segments in each
+#define N_STREAMS		20000
+#define MAX_SEGMENTS	10
+
+#define PKT_OVERHEAD_LEN (MN_API_PACKET_HDR_LEN+MN_API_PACKET_TAIL_LEN)
+
+// Small fixed generator so every run checks the same streams
+static Uint32 rngState = 0x1b873593;
+static Uint32 nextRand()
+{
+	rngState ^= rngState << 13;
+	rngState ^= rngState >> 17;
+	rngState ^= rngState << 5;
+	return rngState;
+}
+
+// The port with its framer and read thread batch opened up
+class chunkSerial : public CSerialEx {
+public:
+	using CSerialEx::ProcessChunk;
+	using CSerialEx::PacketParseReset;
+	using CSerialEx::m_rxBatch;
+	using CSerialEx::m_state;
+	using CSerialEx::m_pushedState;
+	using CSerialEx::m_lowPrioPktIndx;
+	using CSerialEx::m_hiPrioPktIndx;
+	using CSerialEx::m_lowChecksum;
+	using CSerialEx::m_hiChecksum;
+	using CSerialEx::m_strayCount;
+	using CSerialEx::m_lowInProcPacket;
+	using CSerialEx::m_hiInProcPacket;
+};
+
+// The per character framer ProcessChunk replaced. The packets and errors
+// it would have sent to the application are kept in <sent>.
+class oldFramer {
+public:
+	explicit oldFramer(CSerialEx &port) : m_port(port) { PacketParseReset(); }
+
+	void PacketParseReset() {
+		m_state = m_pushedState = CSerialEx::READ_STATE_IDLE;
+		m_lowPrioPktIndx = m_hiPrioPktIndx = 0;
+		m_strayCount = 0;
+	}
+
+	std::vector<packetbuf> sent;
+	CSerialEx::ReadStates m_state, m_pushedState;
+	unsigned int m_lowPrioPktIndx, m_lowChecksum;
+	unsigned int m_hiPrioPktIndx, m_hiChecksum;
+	unsigned m_strayCount;
+	packetbuf m_lowInProcPacket, m_hiInProcPacket;
+
+	bool inHighPrioState() {
+		return(m_state == CSerialEx::READ_STATE_HP_PAYLOAD);
+	}
+
+	void SendPacketToApp(packetbuf &thePacket, BOOL Convert7To8Bit) {
+		packetbuf pkt;
+		if (Convert7To8Bit)
+			m_port.convert7to8(thePacket, pkt);
+		else
+			pkt = thePacket;
+		sent.push_back(pkt);
+	}
+
+	void SendErrToApp(mnNetErrs errorType, unsigned addr, unsigned data) {
+		packetbuf errpacket;
+		errpacket.Fld.Addr=addr;
+		errpacket.Fld.Mode=errpacket.Fld.Zero1=0;
+		errpacket.Fld.Src=MN_SRC_HOST;
+		errpacket.Fld.PktType = MN_PKT_TYPE_ERROR;
+		errpacket.Fld.PktLen = 2;
+		errpacket.Byte.BufferSize = errpacket.Fld.PktLen + MN_API_PACKET_HDR_LEN;
+		errpacket.Byte.Buffer[RESP_LOC] = (nodechar)errorType;
+		errpacket.Byte.Buffer[RESP_LOC+1] = (nodechar)data;
+		SendPacketToApp(errpacket, false);
+	}
+
+	bool TestAndPushHiPacket(char nextChar) {
+		packetFields *parser = (packetFields *)&nextChar;
+		if (!parser->StartOfPacket)
+			return(false);
+		if (inHighPrioState()
+		|| (!MN_PKT_IS_HIGH_PRIO(parser->PktType)
+			&& m_state != CSerialEx::READ_STATE_IDLE)) {
+			SendErrToApp(ND_ERRNET_FRAG, 0,0);
+			PacketParseReset();
+			ProcessNextChar(nextChar);
+			return(true);
+		}
+		if (MN_PKT_IS_HIGH_PRIO(parser->PktType)) {
+			m_hiPrioPktIndx = 0;
+			m_hiInProcPacket.Byte.Buffer[m_hiPrioPktIndx++] = nextChar;
+			m_hiInProcPacket.Fld.PktLen = MN_HDR_LEN_MASK;
+			m_hiChecksum = nextChar;
+			m_pushedState = m_state;
+			m_state = CSerialEx::READ_STATE_HP_PAYLOAD;
+			return(true);
+		}
+		return(false);
+	}
+
+	void ProcessNextChar(char nextChar) {
+		packetFields *parser = (packetFields *)&nextChar;
+		switch(m_state) {
+		case CSerialEx::READ_STATE_IDLE:
+			m_hiPrioPktIndx = m_lowPrioPktIndx = 0;
+			if (parser->StartOfPacket) {
+				if (m_strayCount>0) {
+					SendErrToApp(ND_ERRNET_STRAY, 0, m_strayCount);
+					m_strayCount=0;
+					m_pushedState = CSerialEx::READ_STATE_IDLE;
+				}
+				if (TestAndPushHiPacket(nextChar))
+					break;
+				m_lowInProcPacket.Byte.Buffer[m_lowPrioPktIndx++] = nextChar;
+				m_lowInProcPacket.Fld.PktLen = MN_HDR_LEN_MASK;
+				m_lowChecksum = nextChar;
+				m_state = CSerialEx::READ_STATE_LP_PAYLOAD;
+			}
+			else {
+				if (m_strayCount < 127)
+					m_strayCount++;
+			}
+			break;
+		case CSerialEx::READ_STATE_LP_PAYLOAD:
+			if (TestAndPushHiPacket(nextChar))
+				break;
+			m_lowInProcPacket.Byte.Buffer[m_lowPrioPktIndx++] = nextChar;
+			m_lowChecksum += nextChar;
+			if (m_lowPrioPktIndx >= m_lowInProcPacket.Fld.PktLen+PKT_OVERHEAD_LEN) {
+				if(m_lowChecksum & 0x7F) {
+					SendErrToApp(ND_ERRNET_CHKSUM, m_lowInProcPacket.Fld.Addr, 0);
+				}
+				else {
+					m_lowInProcPacket.Byte.BufferSize=m_lowPrioPktIndx;
+					SendPacketToApp(m_lowInProcPacket,true);
+				}
+				m_state = CSerialEx::READ_STATE_IDLE;
+			}
+			break;
+		case CSerialEx::READ_STATE_HP_PAYLOAD:
+			if (TestAndPushHiPacket(nextChar))
+				break;
+			m_hiInProcPacket.Byte.Buffer[m_hiPrioPktIndx++] = nextChar;
+			m_hiChecksum += nextChar;
+			if (m_hiPrioPktIndx >= m_hiInProcPacket.Fld.PktLen+PKT_OVERHEAD_LEN) {
+				if(m_hiChecksum & 0x7F) {
+					SendErrToApp(ND_ERRNET_CHKSUM, m_hiInProcPacket.Fld.Addr,0 );
+				}
+				else {
+					m_hiInProcPacket.Byte.BufferSize=m_hiPrioPktIndx;
+					SendPacketToApp(m_hiInProcPacket,true);
+				}
+				m_state = m_pushedState;
+				m_pushedState = CSerialEx::READ_STATE_IDLE;
+				m_hiPrioPktIndx = 0;
+			}
+			break;
+		default:
+			PacketParseReset();
+			break;
+		}
+	}
+
+private:
+	CSerialEx &m_port;
+};
+
+// Link characters of a packet of priority <high>, the checksum made bad
+// if <badSum>
+static std::vector<char> makePacket(bool high, bool badSum)
+{
+	std::vector<char> chars;
+	unsigned len = nextRand() % (MN_HDR_LEN_MASK + 1), sum;
+	unsigned type = (high ? 4 : 0) | (nextRand() % 4);
+	chars.push_back(char(0x80 | (type << 4) | (nextRand() & 0x0f)));
+	chars.push_back(char(len | (nextRand() & 0x60)));
+	for (unsigned i = 0; i < len; i++)
+		chars.push_back(char(nextRand() & 0x7f));
+	sum = 0;
+	for (size_t i = 0; i < chars.size(); i++)
+		sum += Uint8(chars[i]);
+	sum = -sum & 0x7f;
+	if (badSum)
+		sum ^= 1 + nextRand() % 0x7f;
+	chars.push_back(char(sum));
+	return chars;
+}
+
+// Append a random segment to <stream>
+static void addSegment(std::vector<char> &stream)
+{
+	std::vector<char> pkt, inner;
+	size_t n, at;
+	switch (nextRand() % 8) {
+	case 0:
+		pkt = makePacket(false, false);
+		break;
+	case 1:
+		pkt = makePacket(true, false);
+		break;
+	case 2:
+	case 3:
+		// A high priority packet interleaved into a low or high one
+		pkt = makePacket(nextRand() % 4 == 0, false);
+		inner = makePacket(true, nextRand() % 8 == 0);
+		at = 1 + nextRand() % (pkt.size() - 1);
+		pkt.insert(pkt.begin() + at, inner.begin(), inner.end());
+		break;
+	case 4:
+		pkt = makePacket(nextRand() % 2 == 0, true);
+		break;
+	case 5:
+		// Cut short, the next start of packet finds the fragment
+		pkt = makePacket(nextRand() % 2 == 0, false);
+		pkt.resize(1 + nextRand() % (pkt.size() - 1));
+		break;
+	case 6:
+		// Stray run, long enough at times to reach the 127 cap
+		n = 1 + nextRand() % 300;
+		for (size_t i = 0; i < n; i++)
+			pkt.push_back(char(nextRand() & 0x7f));
+		break;
+	default:
+		n = 1 + nextRand() % 40;
+		for (size_t i = 0; i < n; i++)
+			pkt.push_back(char(nextRand()));
+		break;
+	}
+	stream.insert(stream.end(), pkt.begin(), pkt.end());
+}
+
+int main()
+{
+	chunkSerial *pPort = new chunkSerial;
+	oldFramer *pOld = new oldFramer(*pPort);
+	CCEvent appEvent;
+	Uint32 nSent = 0, nChunks = 0;
+
+	// Packets are only kept with an application to send them to
+	pPort->RegisterUserPktCommEvent(&appEvent);
+	pPort->AutoFlush(false);
+
+	for (int iStream = 0; iStream < N_STREAMS; iStream++) {
+		std::vector<char> stream;
+		std::vector<packetbuf> sent;
+		unsigned nSegments = 1 + nextRand() % MAX_SEGMENTS;
+		for (unsigned i = 0; i < nSegments; i++)
+			addSegment(stream);
+
+		pOld->PacketParseReset();
+		pOld->sent.clear();
+		for (size_t i = 0; i < stream.size(); i++)
+			pOld->ProcessNextChar(stream[i]);
+
+		// Chunks from single characters up to the whole stream
+		size_t maxChunk = 1 + nextRand() % stream.size();
+		pPort->PacketParseReset();
+		for (size_t at = 0; at < stream.size(); nChunks++) {
+			size_t nChunk = 1 + nextRand() % maxChunk;
+			if (nChunk > stream.size() - at)
+				nChunk = stream.size() - at;
+			pPort->ProcessChunk(&stream[at], nChunk);
+			at += nChunk;
+			for (size_t i = 0; i < pPort->m_rxBatch.size(); i++) {
+				sent.push_back(*pPort->m_rxBatch[i]);
+				delete pPort->m_rxBatch[i];
+			}
+			pPort->m_rxBatch.clear();
+		}
+
+		CHECK(sent.size() == pOld->sent.size());
+		for (size_t i = 0; i < sent.size(); i++) {
+			CHECK(sent[i].Byte.BufferSize == pOld->sent[i].Byte.BufferSize);
+			CHECK(memcmp(sent[i].Byte.Buffer, pOld->sent[i].Byte.Buffer,
+						 MN_NET_PACKET_MAX) == 0);
+		}
+		nSent += Uint32(sent.size());
+
+		// The same state to carry into the next chunk
+		CHECK(pPort->m_state == pOld->m_state);
+		CHECK(pPort->m_pushedState == pOld->m_pushedState);
+		CHECK(pPort->m_strayCount == pOld->m_strayCount);
+		CHECK(pPort->m_lowPrioPktIndx == pOld->m_lowPrioPktIndx);
+		CHECK(pPort->m_hiPrioPktIndx == pOld->m_hiPrioPktIndx);
+		if (pOld->m_state == CSerialEx::READ_STATE_LP_PAYLOAD
+			|| pOld->m_pushedState == CSerialEx::READ_STATE_LP_PAYLOAD) {
+			CHECK(pPort->m_lowChecksum == pOld->m_lowChecksum);
+			CHECK(memcmp(pPort->m_lowInProcPacket.Byte.Buffer,
+						 pOld->m_lowInProcPacket.Byte.Buffer,
+						 pOld->m_lowPrioPktIndx) == 0);
+		}
+		if (pOld->m_state == CSerialEx::READ_STATE_HP_PAYLOAD) {
+			CHECK(pPort->m_hiChecksum == pOld->m_hiChecksum);
+			CHECK(memcmp(pPort->m_hiInProcPacket.Byte.Buffer,
+						 pOld->m_hiInProcPacket.Byte.Buffer,
+						 pOld->m_hiPrioPktIndx) == 0);
+		}
+	}
+	delete pOld;
+	delete pPort;
+
+	printf("%d streams in %u chunks, %u packets and errors match\n",
+		   N_STREAMS, nChunks, nSent);
+	printf("frameChunkTest passed\n");
+	return 0;
+}
@@ -0,0 +1,157 @@
+//*****************************************************************************
+// DESCRIPTION:
+/**
+	\file
+	End to end check of the library over a pseudo-terminal. The port is
+	opened through infcStartController on the slave side of a pair and
+	test/fakeHub.h plays a hub with three nodes on the master side.
+
+	Set address finds the nodes, then single commands, a batch and a
+	command the node rejects run through the read thread and the response
+	trackers. The hub decodes what it receives with its own bit loop, so
+	the commands it saw are checked against what was sent.
+
+	Build the library and run on Linux from the "sFoundation Source"
+	directory:
+
+		g++ -o linkPtyTest -ILibLinuxOS/inc -Iinc/inc-pub
+			-Iinc/inc-private -Iinc/inc-private/sFound -ILibINI/inc
+			test/linkPtyTest.cpp sFoundation/src/(all).cpp
+			sFoundation/src-linux/lnkAccessLinux.cpp
+			LibLinuxOS/src/(all).cpp LibINI/src/dictionary.cpp
+			LibINI/src/iniparser.cpp -lpthread -ldl
+
+	or use test/runTests.sh. Exits non-zero on the first failure.
+**/
+//
+// COPYRIGHT NOTICE:
+//		(C)Copyright 2026  Teknic, Inc.  All rights reserved.
+//
+//		This copyright notice must be reproduced in any copy, modification,
+//		or portion thereof merged into another program. A copy of the
+//		copyright notice must be included in the object library of a user
+//		program.
+//																			  *
+//*****************************************************************************
+
+#include "fakeHub.h"
+#include "lnkAccessCommon.h"
+#include "netCmdAPI.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK(cond) do { if (!(cond)) { \
+	fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+	exit(1); } } while (0)
+
+#define N_NODES		3
+#define PORT		0
+
+// The library's port records
+extern mnNetInvRecords SysInventory[NET_CONTROLLER_MAX];
+
+// Make a get parameter command for <node>
+static void getParamCmd(packetbuf &cmd, nodeaddr node, nodechar param)
+{
+	cmd = packetbuf();
+	cmd.Fld.SetupHdr(MN_PKT_TYPE_CMD, node);
+	cmd.Fld.PktLen = 2;
+	cmd.Byte.Buffer[CMD_LOC] = MN_CMD_GET_PARAM0;
+	cmd.Byte.Buffer[CMD_LOC + 1] = param;
+	cmd.Byte.BufferSize = cmd.Fld.PktLen + MN_API_PACKET_HDR_LEN;
+}
+
+// Check <resp> is the hub's answer to getParamCmd(<node>, <param>)
+static void checkParamResp(const packetbuf &resp, nodeaddr node,
+						   nodechar param)
+{
+	CHECK(resp.Fld.PktType == MN_PKT_TYPE_RESP);
+	CHECK(resp.Fld.Src == MN_SRC_HOST);
+	CHECK(resp.Fld.Addr == node);
+	CHECK(resp.Fld.PktLen == 4);
+	CHECK(resp.Byte.BufferSize == 4 + MN_API_PACKET_HDR_LEN);
+	CHECK(resp.Byte.Buffer[RESP_LOC] == nodechar(node));
+	CHECK(resp.Byte.Buffer[RESP_LOC + 1] == param);
+	CHECK(Uint8(resp.Byte.Buffer[RESP_LOC + 2]) == 0x5a);
+}
+
+int main()
+{
+	fakeHub hub(N_NODES);
+	packetbuf cmd, resp, cmds[N_NODES], resps[N_NODES];
+	double doneAt[N_NODES];
+	nodeulong nNodes = 0;
+	cnErrCode theErr;
+
+	CHECK(hub.PortName()[0] != 0);
+
+	// No background traffic, the test makes all of it
+	infcBackgroundPollControl(PORT, FALSE);
+	infcSetAutoNetDiscovery(PORT, FALSE);
+	portSpec spec(hub.PortName(), CPM_COMHUB);
+	CHECK(infcSetPortSpecifier(PORT, &spec) == MN_OK);
+
+	// The pseudo-terminal has no break to loop back, see fakeHub.h
+	theErr = infcStartController(PORT);
+	CHECK(theErr == MN_OK || theErr == MN_ERR_NO_NET_CONNECTIVITY);
+	CHECK(SysInventory[PORT].PortIsOpen());
+
+	// Find the nodes as mnInitializeNets does
+	infcSetInitializeMode(PORT, TRUE, MN_OK);
+	CHECK(netSetAddress(PORT, &nNodes) == MN_OK);
+	CHECK(nNodes == N_NODES);
+
+	// A single command round trip
+	getParamCmd(cmd, 2, 7);
+	CHECK(netRunCommand(PORT, &cmd, &resp) == MN_OK);
+	checkParamResp(resp, 2, 7);
+
+	// A batch across the nodes
+	for (nodeaddr node = 0; node < N_NODES; node++)
+		getParamCmd(cmds[node], node, nodechar(20 + node));
+	CHECK(infcRunCommandBatch(PORT, cmds, resps, N_NODES, doneAt) == MN_OK);
+	for (nodeaddr node = 0; node < N_NODES; node++) {
+		checkParamResp(resps[node], node, nodechar(20 + node));
+		CHECK(doneAt[node] > 0);
+	}
+
+	// A node rejecting the command reports the node's error
+	hub.FailNodes(1U << 1);
+	getParamCmd(cmd, 1, 9);
+	theErr = netRunCommand(PORT, &cmd, &resp);
+	CHECK(theErr == cnErrCode(MN_ERR_CMD_ERR_BASE + 1));
+	hub.FailNodes(0);
+
+	// The hub saw every packet intact, and the commands to the nodes in
+	// the order sent
+	std::vector<hubPkt> rx = hub.Received();
+	std::vector<packetbuf> sent;
+	CHECK(hub.BadPackets() == 0);
+	for (size_t iRx = 0; iRx < rx.size(); iRx++) {
+		if (rx[iRx].pkt.Fld.PktType == MN_PKT_TYPE_CMD)
+			sent.push_back(rx[iRx].pkt);
+	}
+	// Net access level of the first node, then the commands above
+	const nodeaddr sentTo[] = { 0, 2, 0, 1, 2, 1 };
+	const nodechar sentParam[] = { 0, 7, 20, 21, 22, 9 };
+	CHECK(sent.size() == sizeof(sentTo) / sizeof(sentTo[0]));
+	CHECK(sent[0].Fld.Addr == 0);
+	CHECK(sent[0].Byte.Buffer[CMD_LOC] == MN_CMD_NET_ACCESS);
+	for (size_t i = 1; i < sent.size(); i++) {
+		CHECK(sent[i].Fld.Src == MN_SRC_HOST);
+		CHECK(sent[i].Fld.Addr == sentTo[i]);
+		CHECK(sent[i].Fld.PktLen == 2);
+		CHECK(sent[i].Byte.Buffer[CMD_LOC] == MN_CMD_GET_PARAM0);
+		CHECK(sent[i].Byte.Buffer[CMD_LOC + 1] == sentParam[i]);
+	}
+
+	infcSetInitializeMode(PORT, FALSE, MN_ERR_TEST_INCOMPLETE);
+	CHECK(infcStopController(PORT) == MN_OK);
+	CHECK(!SysInventory[PORT].PortIsOpen());
+
+	printf("%u nodes found, %u packets received at the hub\n",
+		   unsigned(nNodes), unsigned(rx.size()));
+	printf("linkPtyTest passed\n");
+	return 0;
+}
@@ -0,0 +1,145 @@
+//*****************************************************************************
+// DESCRIPTION:
+/**
+	\file
+	Aggregate command throughput over one to NET_CONTROLLER_MAX ports. Each
+	port is opened through the library on its own test/fakeHub.h hub with
+	N_NODES nodes, then for each count of ports every active port runs
+	get parameter commands round robin over its nodes from its own thread
+	for RUN_MS.
+
+	The commands per second of each port and of all of them together are
+	reported for each count. With each port on its own read, poll and
+	dispatch threads the aggregate should grow with the ports until the
+	machine runs out of processors; the fake hubs run on the same machine
+	and use their share. Every command must succeed and every port must
+	make progress, the rates themselves are not checked.
+
+	Build the library and run on Linux from the "sFoundation Source"
+	directory:
+
+		g++ -O2 -o portScaleBench -ILibLinuxOS/inc -Iinc/inc-pub
+			-Iinc/inc-private -Iinc/inc-private/sFound -ILibINI/inc
+			test/portScaleBench.cpp libsFoundation.a -lpthread -ldl
+
+	where libsFoundation.a is built as test/runTests.sh does. Exits
+	non-zero on the first failure.
+**/
+//
+// COPYRIGHT NOTICE:
+//		(C)Copyright 2026  Teknic, Inc.  All rights reserved.
+//
+//		This copyright notice must be reproduced in any copy, modification,
+//		or portion thereof merged into another program. A copy of the
+//		copyright notice must be included in the object library of a user
+//		program.
+//																			  *
+//*****************************************************************************
+
+#include "fakeHub.h"
+#include "lnkAccessCommon.h"
+#include "netCmdAPI.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+
+#define CHECK(cond) do { if (!(cond)) { \
+	fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+	exit(1); } } while (0)
+
+#define N_NODES		4
+// Time each count of ports runs
+#define RUN_MS		1000.0
+
+// The library's port records
+extern mnNetInvRecords SysInventory[NET_CONTROLLER_MAX];
+
+// What one port did in a run
+struct portRun {
+	Uint32 nCmds;
+	cnErrCode firstErr;
+};
+
+// Run commands on <cNum> until <stopAt>
+static void runPort(netaddr cNum, double stopAt, portRun *pRun)
+{
+	packetbuf cmd, resp;
+	pRun->nCmds = 0;
+	pRun->firstErr = MN_OK;
+	while (infcCoreTime() < stopAt) {
+		nodeaddr node = nodeaddr(pRun->nCmds % N_NODES);
+		cmd = packetbuf();
+		cmd.Fld.SetupHdr(MN_PKT_TYPE_CMD, node);
+		cmd.Fld.PktLen = 2;
+		cmd.Byte.Buffer[CMD_LOC] = MN_CMD_GET_PARAM0;
+		cmd.Byte.Buffer[CMD_LOC + 1] = nodechar(pRun->nCmds & 0x3f);
+		cmd.Byte.BufferSize = cmd.Fld.PktLen + MN_API_PACKET_HDR_LEN;
+		cnErrCode theErr = netRunCommand(cNum, &cmd, &resp);
+		if (theErr != MN_OK) {
+			pRun->firstErr = theErr;
+			return;
+		}
+		pRun->nCmds++;
+	}
+}
+
+int main()
+{
+	std::vector<fakeHub *> hubs;
+	nodeulong nNodes;
+	cnErrCode theErr;
+	double oneRate = 0;
+	netaddr cNum;
+
+	// Open every port, the hubs have no break so each open reports it
+	for (cNum = 0; cNum < NET_CONTROLLER_MAX; cNum++) {
+		fakeHub *pHub = new fakeHub(N_NODES);
+		CHECK(pHub->PortName()[0] != 0);
+		hubs.push_back(pHub);
+		infcBackgroundPollControl(cNum, FALSE);
+		infcSetAutoNetDiscovery(cNum, FALSE);
+		portSpec spec(pHub->PortName(), CPM_COMHUB);
+		CHECK(infcSetPortSpecifier(cNum, &spec) == MN_OK);
+		theErr = infcStartController(cNum);
+		CHECK(theErr == MN_OK || theErr == MN_ERR_NO_NET_CONNECTIVITY);
+		CHECK(SysInventory[cNum].PortIsOpen());
+		infcSetInitializeMode(cNum, TRUE, MN_OK);
+		nNodes = 0;
+		CHECK(netSetAddress(cNum, &nNodes) == MN_OK);
+		CHECK(nNodes == N_NODES);
+	}
+
+	for (netaddr nPorts = 1; nPorts <= NET_CONTROLLER_MAX; nPorts++) {
+		std::vector<std::thread> threads;
+		portRun runs[NET_CONTROLLER_MAX];
+		double stopAt = infcCoreTime() + RUN_MS;
+		Uint32 nCmds = 0, minCmds = 0xffffffff;
+		for (cNum = 0; cNum < nPorts; cNum++)
+			threads.push_back(std::thread(runPort, cNum, stopAt, &runs[cNum]));
+		for (cNum = 0; cNum < nPorts; cNum++) {
+			threads[cNum].join();
+			CHECK(runs[cNum].firstErr == MN_OK);
+			CHECK(runs[cNum].nCmds > 0);
+			nCmds += runs[cNum].nCmds;
+			if (runs[cNum].nCmds < minCmds)
+				minCmds = runs[cNum].nCmds;
+		}
+		double rate = nCmds * 1000.0 / RUN_MS;
+		if (nPorts == 1)
+			oneRate = rate;
+		printf("%u port(s): %.0f commands/s in all, %.0f per port at least, "
+			   "%.2fx one port\n", unsigned(nPorts), rate,
+			   minCmds * 1000.0 / RUN_MS, rate / oneRate);
+	}
+
+	for (cNum = 0; cNum < NET_CONTROLLER_MAX; cNum++) {
+		CHECK(hubs[cNum]->BadPackets() == 0);
+		infcSetInitializeMode(cNum, FALSE, MN_ERR_TEST_INCOMPLETE);
+		CHECK(infcStopController(cNum) == MN_OK);
+		delete hubs[cNum];
+	}
+	printf("%u processor(s)\n", std::thread::hardware_concurrency());
+	printf("portScaleBench passed\n");
+	return 0;
+}
@@ -0,0 +1,44 @@
+#!/bin/sh
+# Build and run the standalone tests on Linux. Run from anywhere, the
+# binaries go to $TEST_OUT (default /tmp/sFoundTests). Each test exits
+# non-zero on failure and the script stops at the first one.
+set -e
+cd "$(dirname "$0")/.."
+OUT=${TEST_OUT:-/tmp/sFoundTests}
+CXX=${CXX:-g++}
+INCS="-ILibLinuxOS/inc -Iinc/inc-pub -Iinc/inc-private -Iinc/inc-private/sFound -ILibINI/inc"
+mkdir -p "$OUT"
+
+run() {
+	name=$1; shift
+	echo "== $name"
+	$CXX -O2 -w -o "$OUT/$name" $INCS "test/$name.cpp" "$@" -lpthread
+	"$OUT/$name"
+}
+
+# The whole library, for the tests that open a port through it
+LIB="$OUT/libsFoundation.a"
+lib() {
+	echo "== library"
+	mkdir -p "$OUT/obj"
+	printf '%s\n' sFoundation/src/*.cpp sFoundation/src-linux/*.cpp \
+		LibLinuxOS/src/*.cpp LibINI/src/dictionary.cpp LibINI/src/iniparser.cpp \
+	| xargs -P "$(nproc)" -I{} sh -c \
+		'$0 -O2 -w -c $1 "{}" -o "$2/obj/$(basename "{}" .cpp).o"' \
+		"$CXX" "$INCS" "$OUT"
+	rm -f "$LIB"
+	ar rcs "$LIB" "$OUT"/obj/*.o
+}
+
+lib
+run serialPtyTest LibLinuxOS/src/*.cpp
+run linkPtyTest "$LIB" -ldl
+run convertCharsTest "$LIB" -ldl
+run frameChunkTest "$LIB" -ldl
+run stopLaneTest "$LIB" -ldl
+run seqLockTest
+run portScaleBench "$LIB" -ldl
+run dataAcqRecorderTest sFoundation/src/dataAcqRecorder.cpp LibLinuxOS/src/*.cpp
+run dacqDecodeTest sFoundation/src/dacqDecode.cpp
+run dataAcqMergerTest sFoundation/src/dataAcqMerger.cpp
+echo "All tests passed"
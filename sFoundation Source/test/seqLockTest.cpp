@@ -0,0 +1,166 @@
+//*****************************************************************************
+// DESCRIPTION:
+/**
+	\file
+	Stress test of CCseqLock as the telemetry poller uses it. One writer
+	publishes a full snapshot of TELEMETRY_MAX_SAMPLES samples over and
+	over, each publish stamping every field of every sample with its pass
+	number, while several readers copy the snapshot the way
+	CTelemetryPoller::Read does.
+
+	Every copy a reader keeps must come from a single pass, and the passes
+	a reader sees must never go backwards. The copies ReadRetry sent back
+	are counted, with those that did mix passes, to show how often the
+	race was met.
+
+	Build and run on Linux from the "sFoundation Source" directory:
+
+		g++ -O2 -o seqLockTest -ILibLinuxOS/inc -Iinc/inc-pub
+			-Iinc/inc-private -Iinc/inc-private/sFound -ILibINI/inc
+			test/seqLockTest.cpp -lpthread
+
+	or use test/runTests.sh. Exits non-zero on the first failure.
+**/
+//
+// COPYRIGHT NOTICE:
+//		(C)Copyright 2026  Teknic, Inc.  All rights reserved.
+//
+//		This copyright notice must be reproduced in any copy, modification,
+//		or portion thereof merged into another program. A copy of the
+//		copyright notice must be included in the object library of a user
+//		program.
+//																			  *
+//*****************************************************************************
+
+#include "telemetryPoller.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <thread>
+#include <vector>
+
+#define CHECK(cond) do { if (!(cond)) { \
+	fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+	exit(1); } } while (0)
+
+// Length of the run and the readers
+#define RUN_MS			1000.0
+#define N_READERS		4
+
+// The published snapshot
+static CCseqLock seq;
+static telemetrySample samples[TELEMETRY_MAX_SAMPLES];
+static volatile bool done;
+
+static double msNow()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+// Fill <sample> of <slot> for <pass>
+static void stamp(telemetrySample &sample, size_t slot, Uint32 pass)
+{
+	sample.value = pass;
+	sample.sampleTime = pass + slot / 1000.0;
+	for (size_t i = 0; i < TELEMETRY_RAW_MAX; i++)
+		sample.raw[i] = Uint8(pass + slot + i);
+}
+
+// True if every sample in <copy> was stamped by the same pass, which is
+// returned in <pass>
+static bool onePass(const telemetrySample *copy, Uint32 &pass)
+{
+	pass = Uint32(copy[0].value);
+	for (size_t slot = 0; slot < TELEMETRY_MAX_SAMPLES; slot++) {
+		telemetrySample want;
+		stamp(want, slot, pass);
+		if (memcmp(&copy[slot], &want, sizeof(want)) != 0)
+			return false;
+	}
+	return true;
+}
+
+// Publish passes until told to stop, returns the count
+static Uint32 writer()
+{
+	telemetrySample next[TELEMETRY_MAX_SAMPLES];
+	Uint32 pass;
+	for (pass = 1; !done; pass++) {
+		for (size_t slot = 0; slot < TELEMETRY_MAX_SAMPLES; slot++)
+			stamp(next[slot], slot, pass);
+		seq.WriteBegin();
+		for (size_t slot = 0; slot < TELEMETRY_MAX_SAMPLES; slot++)
+			samples[slot] = next[slot];
+		seq.WriteEnd();
+	}
+	return pass - 1;
+}
+
+// What one reader saw
+struct readerStats {
+	Uint32 reads;					// Copies kept
+	Uint32 retries;					// Copies ReadRetry sent back
+	Uint32 torn;					// Of those, copies mixing passes
+	Uint32 lastPass;
+};
+
+static void reader(readerStats *pStats)
+{
+	telemetrySample copy[TELEMETRY_MAX_SAMPLES];
+	Uint32 pass;
+	LONG at;
+	memset(pStats, 0, sizeof(*pStats));
+	while (!done) {
+		for (;;) {
+			at = seq.ReadBegin();
+			memcpy(copy, (const void *)samples, sizeof(copy));
+			if (!seq.ReadRetry(at))
+				break;
+			pStats->retries++;
+			if (!onePass(copy, pass))
+				pStats->torn++;
+		}
+		CHECK(onePass(copy, pass));
+		CHECK(pass >= pStats->lastPass);
+		pStats->lastPass = pass;
+		pStats->reads++;
+	}
+}
+
+int main()
+{
+	std::vector<std::thread> readers;
+	readerStats stats[N_READERS];
+	Uint32 nPasses = 0, nReads = 0, nRetries = 0, nTorn = 0;
+
+	// Pass 0 is in place before anyone reads
+	for (size_t slot = 0; slot < TELEMETRY_MAX_SAMPLES; slot++)
+		stamp(samples[slot], slot, 0);
+
+	for (int i = 0; i < N_READERS; i++)
+		readers.push_back(std::thread(reader, &stats[i]));
+	std::thread writerThread([&nPasses] { nPasses = writer(); });
+	double stopAt = msNow() + RUN_MS;
+	while (msNow() < stopAt)
+		usleep(10000);
+	done = true;
+	writerThread.join();
+	for (int i = 0; i < N_READERS; i++) {
+		readers[i].join();
+		CHECK(stats[i].lastPass <= nPasses);
+		nReads += stats[i].reads;
+		nRetries += stats[i].retries;
+		nTorn += stats[i].torn;
+	}
+	// The readers raced the writer
+	CHECK(nPasses > 0 && nReads > 0);
+
+	printf("%u passes, %d readers kept %u copies, retried %u (%u torn)\n",
+		   nPasses, N_READERS, nReads, nRetries, nTorn);
+	printf("seqLockTest passed\n");
+	return 0;
+}
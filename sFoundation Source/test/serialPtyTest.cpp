@@ -0,0 +1,154 @@
+//*****************************************************************************
+// DESCRIPTION:
+/**
+	\file
+	End to end check of the Linux CSerial over a pseudo-terminal pair. The
+	port is opened on the slave side and the test plays the node on the
+	master side.
+
+	Build and run on Linux from the "sFoundation Source" directory:
+
+		g++ -o serialPtyTest -ILibLinuxOS/inc -Iinc/inc-pub
+			-Iinc/inc-private -Iinc/inc-private/sFound -ILibINI/inc
+			test/serialPtyTest.cpp LibLinuxOS/src/SerialLinux.cpp
+			LibLinuxOS/src/tekEventsLinux.cpp
+			LibLinuxOS/src/tekThreadsLinux.cpp -lpthread
+
+	or use test/runTests.sh. Exits non-zero on the first failure.
+**/
+//
+// COPYRIGHT NOTICE:
+//		(C)Copyright 2026  Teknic, Inc.  All rights reserved.
+//
+//		This copyright notice must be reproduced in any copy, modification,
+//		or portion thereof merged into another program. A copy of the
+//		copyright notice must be included in the object library of a user
+//		program.
+//																			  *
+//*****************************************************************************
+
+#include "SerialEx.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <termios.h>
+#include <time.h>
+#include <thread>
+
+#define CHECK(cond) do { if (!(cond)) { \
+	fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+	exit(1); } } while (0)
+
+// Reach the cancel the packet reader uses
+class testSerial : public CSerial {
+public:
+	using CSerial::CancelCommIo;
+};
+
+static double msNow()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+// Read exactly <len> octets from the master side or fail after 1 s
+static void masterRead(int fd, char *buf, size_t len)
+{
+	size_t got = 0;
+	double until = msNow() + 1000;
+	while (got < len) {
+		struct pollfd pfd = { fd, POLLIN, 0 };
+		int waitMs = int(until - msNow());
+		CHECK(waitMs > 0 && ::poll(&pfd, 1, waitMs) == 1);
+		ssize_t n = ::read(fd, buf + got, len - got);
+		CHECK(n > 0);
+		got += size_t(n);
+	}
+}
+
+int main()
+{
+	struct termios tio;
+	char buf[256];
+	DWORD nDone;
+
+	// Master side is the node, raw so nothing is echoed or translated
+	int master = ::posix_openpt(O_RDWR|O_NOCTTY);
+	CHECK(master >= 0);
+	CHECK(::grantpt(master) == 0 && ::unlockpt(master) == 0);
+	CHECK(::tcgetattr(master, &tio) == 0);
+	::cfmakeraw(&tio);
+	CHECK(::tcsetattr(master, TCSANOW, &tio) == 0);
+	const char *slave = ::ptsname(master);
+	CHECK(slave != NULL);
+
+	testSerial port;
+	CHECK(port.Open(slave) == CSerial::API_ERROR_SUCCESS);
+	CHECK(port.IsOpen());
+	CHECK(port.Open(slave) != CSerial::API_ERROR_SUCCESS);
+	CHECK(port.Setup(115200) == CSerial::API_ERROR_SUCCESS);
+	CHECK(port.GetBaudrate() == 115200);
+
+	// Host to node
+	const char hello[] = "\x01\x02\x7f\x80\xff node packet";
+	CHECK(port.Write(hello, sizeof(hello), &nDone, 1000) == CSerial::API_ERROR_SUCCESS);
+	CHECK(nDone == sizeof(hello));
+	masterRead(master, buf, sizeof(hello));
+	CHECK(memcmp(buf, hello, sizeof(hello)) == 0);
+
+	// Node to host, every octet value so raw mode is proven
+	unsigned char sent[256];
+	for (int i = 0; i < 256; i++)
+		sent[i] = (unsigned char)i;
+	CHECK(::write(master, sent, sizeof(sent)) == (ssize_t)sizeof(sent));
+	size_t got = 0;
+	double until = msNow() + 1000;
+	while (got < sizeof(sent) && msNow() < until) {
+		CHECK(port.Read(buf + got, sizeof(buf) - got, &nDone, 100) == CSerial::API_ERROR_SUCCESS);
+		got += nDone;
+	}
+	CHECK(got == sizeof(sent));
+	CHECK(memcmp(buf, sent, sizeof(sent)) == 0);
+
+	// An idle read times out with success and nothing read
+	double startAt = msNow();
+	CHECK(port.Read(buf, sizeof(buf), &nDone, 50) == CSerial::API_ERROR_SUCCESS);
+	CHECK(nDone == 0);
+	CHECK(msNow() - startAt >= 40);
+
+	// CancelCommIo releases a reader blocked forever
+	CSerial::SERAPI_ERR rdErr = CSerial::API_ERROR_SUCCESS;
+	std::thread reader([&]() { rdErr = port.Read(buf, sizeof(buf), &nDone); });
+	::usleep(20000);
+	CHECK(port.CancelCommIo() == CSerial::API_ERROR_SUCCESS);
+	reader.join();
+	CHECK(rdErr == CSerial::SERAPI_ERR(ECANCELED));
+
+	// A pty has no modem lines, a three wire link reads them asserted
+	CHECK(port.GetCTS());
+	CHECK(port.GetDSR());
+	CHECK(port.Break(1) == CSerial::API_ERROR_SUCCESS);
+
+	// ForceCommEvent releases the comm event waiter with no event
+	CSerial::SERAPI_ERR evtErr = CSerial::API_ERROR_UNKNOWN;
+	std::thread waiter([&]() { evtErr = port.CommEventWaitInitiate(); });
+	::usleep(20000);
+	port.ForceCommEvent();
+	waiter.join();
+	CHECK(evtErr == CSerial::API_ERROR_SUCCESS);
+	CHECK(port.GetEventType() == CSerial::EEventNone);
+
+	// Closed ports refuse I/O
+	CHECK(port.Close() == CSerial::API_ERROR_SUCCESS);
+	CHECK(!port.IsOpen());
+	CHECK(port.Read(buf, sizeof(buf), &nDone, 0) == CSerial::API_ERROR_INVALID_HANDLE);
+	CHECK(port.Write(hello, sizeof(hello), &nDone, 0) == CSerial::API_ERROR_INVALID_HANDLE);
+	::close(master);
+
+	printf("serialPtyTest passed\n");
+	return 0;
+}
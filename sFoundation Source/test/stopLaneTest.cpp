@@ -0,0 +1,288 @@
+//*****************************************************************************
+// DESCRIPTION:
+/**
+	\file
+	Check of the group shutdown stop lane through the library. The port is
+	opened through infcStartController on a pseudo-terminal with
+	test/fakeHub.h playing N_NODES nodes, the nodes but SKIP_NODE are put
+	in the group shutdown and infcShutdownInitiate asks for the stops.
+	Everything the lane sends is checked at the hub.
+
+	The time from each request to the hub receiving the last of its stops
+	is measured, as is the time from netRunCommand being called to the hub
+	receiving that command. The lane adds one thread wake to the command
+	path, so its median must be within the worst single command. Both are
+	reported.
+
+	The hub then holds its answers while more threads than the ring has
+	room for run commands to one node. That node must reach the full ring
+	depth and a stop asked for meanwhile must still be written, past the
+	full window. Last, a node that rejects its stop must fire the error
+	callback with the node's error, as netRunCommand would.
+
+	Build the library and run on Linux from the "sFoundation Source"
+	directory:
+
+		g++ -O2 -o stopLaneTest -ILibLinuxOS/inc -Iinc/inc-pub
+			-Iinc/inc-private -Iinc/inc-private/sFound -ILibINI/inc
+			test/stopLaneTest.cpp libsFoundation.a -lpthread -ldl
+
+	where libsFoundation.a is built as test/runTests.sh does. Exits
+	non-zero on the first failure.
+**/
+//
+// COPYRIGHT NOTICE:
+//		(C)Copyright 2026  Teknic, Inc.  All rights reserved.
+//
+//		This copyright notice must be reproduced in any copy, modification,
+//		or portion thereof merged into another program. A copy of the
+//		copyright notice must be included in the object library of a user
+//		program.
+//																			  *
+//*****************************************************************************
+
+#include "fakeHub.h"
+#include "lnkAccessCommon.h"
+#include "netCmdAPI.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#define CHECK(cond) do { if (!(cond)) { \
+	fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+	exit(1); } } while (0)
+
+#define N_NODES		4
+#define PORT		0
+// Node left out of the group shutdown
+#define SKIP_NODE	2
+#define N_STOPS		(N_NODES - 1)
+// Requests and commands timed
+#define N_SAMPLES	200
+// Longest wait for the library or the hub (ms)
+#define WAIT_MS		1000.0
+
+// The library's port records
+extern mnNetInvRecords SysInventory[NET_CONTROLLER_MAX];
+
+// A hub that can hold its answers, leaving the commands in flight
+class holdHub : public fakeHub {
+public:
+	explicit holdHub(unsigned nNodes) : fakeHub(nNodes), m_hold(false) {}
+	void Hold(bool hold) { m_hold = hold; }
+
+protected:
+	void Answer(const packetbuf &cmd, packetbuf &resp)
+	{
+		while (m_hold)
+			usleep(100);
+		fakeHub::Answer(cmd, resp);
+	}
+
+private:
+	volatile bool m_hold;
+};
+
+// Error callbacks seen and the last of them
+static std::atomic<unsigned> nErrCalls(0);
+static infcErrInfo lastErr;
+
+static void nodeCallback errFunc(infcErrInfo *pErrInfo)
+{
+	lastErr = *pErrInfo;
+	nErrCalls++;
+}
+
+// Stop type each node is given
+static nodeStopCodes stopType(nodeaddr node)
+{
+	return (node & 1) ? STOP_TYPE_RAMP : STOP_TYPE_ABRUPT;
+}
+
+// Make a get parameter command for <node>
+static void getParamCmd(packetbuf &cmd, nodeaddr node, nodechar param)
+{
+	cmd = packetbuf();
+	cmd.Fld.SetupHdr(MN_PKT_TYPE_CMD, node);
+	cmd.Fld.PktLen = 2;
+	cmd.Byte.Buffer[CMD_LOC] = MN_CMD_GET_PARAM0;
+	cmd.Byte.Buffer[CMD_LOC + 1] = param;
+	cmd.Byte.BufferSize = cmd.Fld.PktLen + MN_API_PACKET_HDR_LEN;
+}
+
+// Wait until <done> is true, false if it took over WAIT_MS
+template<typename doneFn>
+static bool waitFor(doneFn done)
+{
+	double giveUpAt = infcCoreTime() + WAIT_MS;
+	while (!done()) {
+		if (infcCoreTime() > giveUpAt)
+			return false;
+		usleep(100);
+	}
+	return true;
+}
+
+// The stops among <rx>, each checked against its node's group shutdown
+// setting. Returns the time the last one arrived in <pLastAt>.
+static size_t stopsIn(const std::vector<hubPkt> &rx, double *pLastAt)
+{
+	size_t nStops = 0;
+	Uint32 seen = 0;
+	for (size_t i = 0; i < rx.size(); i++) {
+		const packetbuf &pkt = rx[i].pkt;
+		if (pkt.Fld.PktType != MN_PKT_TYPE_CMD
+			|| pkt.Byte.Buffer[CMD_LOC] != MN_CMD_NODE_STOP)
+			continue;
+		CHECK(pkt.Fld.Addr != SKIP_NODE);
+		CHECK(!(seen & (1U << pkt.Fld.Addr)));
+		CHECK(pkt.Fld.PktLen == 2);
+		CHECK(Uint8(pkt.Byte.Buffer[CMD_LOC + 1]) == stopType(pkt.Fld.Addr));
+		seen |= 1U << pkt.Fld.Addr;
+		*pLastAt = rx[i].at;
+		nStops++;
+	}
+	return nStops;
+}
+
+// Median and worst of <ms>
+static void summary(std::vector<double> ms, double &median, double &worst)
+{
+	std::sort(ms.begin(), ms.end());
+	median = ms[ms.size() / 2];
+	worst = ms.back();
+}
+
+int main()
+{
+	holdHub hub(N_NODES);
+	mnNetInvRecords &theNet = SysInventory[PORT];
+	packetbuf cmd, resp;
+	nodeulong nNodes = 0;
+	cnErrCode theErr;
+	mnLatencyStats laneStats;
+	std::vector<double> cmdMs, stopMs;
+	double lastAt = 0;
+
+	CHECK(hub.PortName()[0] != 0);
+
+	// No background traffic, the test makes all of it
+	infcBackgroundPollControl(PORT, FALSE);
+	infcSetAutoNetDiscovery(PORT, FALSE);
+	portSpec spec(hub.PortName(), CPM_COMHUB);
+	CHECK(infcSetPortSpecifier(PORT, &spec) == MN_OK);
+
+	// The pseudo-terminal has no break to loop back, see fakeHub.h
+	theErr = infcStartController(PORT);
+	CHECK(theErr == MN_OK || theErr == MN_ERR_NO_NET_CONNECTIVITY);
+	CHECK(theNet.PortIsOpen());
+	netStateInfo *pNCS = theNet.pNCS;
+
+	// Find the nodes, then go online as the lane only sends then
+	infcSetInitializeMode(PORT, TRUE, MN_OK);
+	CHECK(netSetAddress(PORT, &nNodes) == MN_OK);
+	CHECK(nNodes == N_NODES);
+	infcSetInitializeMode(PORT, FALSE, MN_ERR_TEST_INCOMPLETE);
+	theNet.OpenStateNext(OPENED_ONLINE);
+	infcSetErrorFunc(errFunc);
+
+	// The nodes play ClearPath-SC motors, all but one in the shutdown
+	theNet.InventoryNow.mnCpScInfo.count = N_NODES;
+	for (nodeaddr node = 0; node < N_NODES; node++) {
+		theNet.InventoryNow.mnCpScInfo.node[node] = MULTI_ADDR(PORT, node);
+		theNet.GroupShutdownInfo[node].enabled = node != SKIP_NODE;
+		theNet.GroupShutdownInfo[node].theStopType.bits = stopType(node);
+	}
+
+	// A single command from the call to the hub
+	for (int i = 0; i < N_SAMPLES; i++) {
+		hub.ClearReceived();
+		getParamCmd(cmd, nodeaddr(i % N_NODES), nodechar(i & 0x3f));
+		double startAt = infcCoreTime();
+		CHECK(netRunCommand(PORT, &cmd, &resp) == MN_OK);
+		std::vector<hubPkt> rx = hub.Received();
+		CHECK(rx.size() == 1);
+		cmdMs.push_back(rx[0].at - startAt);
+	}
+
+	// The stops from the request to the hub, one request at a time
+	CHECK(infcGetStopLaneStats(PORT, TRUE, &laneStats) == MN_OK);
+	for (int i = 0; i < N_SAMPLES; i++) {
+		hub.ClearReceived();
+		double startAt = infcCoreTime();
+		CHECK(infcShutdownInitiate(PORT) == MN_OK);
+		CHECK(waitFor([&] { return hub.Received().size() >= N_STOPS; }));
+		CHECK(stopsIn(hub.Received(), &lastAt) == N_STOPS);
+		stopMs.push_back(lastAt - startAt);
+		// Let the lane collect the responses before the next request
+		CHECK(waitFor([&] { return pNCS->nRespOutstanding.Value() == 0; }));
+	}
+	CHECK(infcGetStopLaneStats(PORT, TRUE, &laneStats) == MN_OK);
+	CHECK(laneStats.Count == N_SAMPLES);
+	CHECK(laneStats.Timeouts == 0);
+
+	double cmdMedian, cmdWorst, stopMedian, stopWorst;
+	summary(cmdMs, cmdMedian, cmdWorst);
+	summary(stopMs, stopMedian, stopWorst);
+	printf("command to hub: median %.3f ms, worst %.3f ms\n",
+		   cmdMedian, cmdWorst);
+	printf("stops to hub: median %.3f ms, worst %.3f ms, lane's own P99 "
+		   "%.3f ms\n", stopMedian, stopWorst, laneStats.P99);
+	CHECK(stopMedian <= cmdWorst);
+
+	// Fill the ring at node 0 while the hub holds its answers, one more
+	// thread than the ring has room for
+	std::vector<std::thread> threads;
+	std::atomic<unsigned> nCmdErrs(0);
+	hub.Hold(true);
+	hub.ClearReceived();
+	for (unsigned i = 0; i <= N_CMDS_IN_RING; i++) {
+		threads.push_back(std::thread([&nCmdErrs, i] {
+			packetbuf tCmd, tResp;
+			getParamCmd(tCmd, 0, nodechar(40 + i));
+			if (netRunCommand(PORT, &tCmd, &tResp) != MN_OK)
+				nCmdErrs++;
+		}));
+	}
+	CHECK(waitFor([&] {
+		return pNCS->nRespOutstanding.Value() == N_CMDS_IN_RING; }));
+	usleep(20000);
+	CHECK(pNCS->nRespOutstanding.Value() == N_CMDS_IN_RING);
+	// The stops go out past the full window, node 0's included
+	CHECK(infcShutdownInitiate(PORT) == MN_OK);
+	CHECK(waitFor([&] {
+		infcGetStopLaneStats(PORT, FALSE, &laneStats);
+		return laneStats.Count == 1; }));
+	CHECK(pNCS->nRespOutstanding.Value() == N_CMDS_IN_RING + N_STOPS);
+	hub.Hold(false);
+	for (size_t i = 0; i < threads.size(); i++)
+		threads[i].join();
+	CHECK(nCmdErrs == 0);
+	CHECK(waitFor([&] { return pNCS->nRespOutstanding.Value() == 0; }));
+	CHECK(stopsIn(hub.Received(), &lastAt) == N_STOPS);
+	CHECK(nErrCalls == 0);
+
+	// A rejected stop fires the error callback with its node's error
+	hub.FailNodes(1U << 1);
+	CHECK(infcShutdownInitiate(PORT) == MN_OK);
+	CHECK(waitFor([&] { return nErrCalls > 0; }));
+	CHECK(waitFor([&] { return pNCS->nRespOutstanding.Value() == 0; }));
+	usleep(20000);
+	CHECK(nErrCalls == 1);
+	CHECK(lastErr.cNum == PORT);
+	CHECK(lastErr.node == MULTI_ADDR(PORT, 1));
+	CHECK(lastErr.errCode == cnErrCode(MN_ERR_CMD_ERR_BASE + 1));
+	hub.FailNodes(0);
+
+	CHECK(hub.BadPackets() == 0);
+	infcSetErrorFunc(NULL);
+	CHECK(infcStopController(PORT) == MN_OK);
+	CHECK(!theNet.PortIsOpen());
+
+	printf("stopLaneTest passed\n");
+	return 0;
+}